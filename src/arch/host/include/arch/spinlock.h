@@ -10,16 +10,33 @@
 #ifndef __ARCH_SPINLOCK_H__
 #define __ARCH_SPINLOCK_H__
 
+#include <stdint.h>
+
+/* The host library can run several pipelines in parallel threads */
 typedef struct {
+	uint32_t lock;
 } spinlock_t;
 
-static inline void arch_spinlock_init(spinlock_t *lock) { }
-static inline void arch_spin_lock(spinlock_t *lock) {}
+static inline void arch_spinlock_init(spinlock_t *lock)
+{
+	__atomic_store_n(&lock->lock, 0, __ATOMIC_RELEASE);
+}
+
+static inline void arch_spin_lock(spinlock_t *lock)
+{
+	while (__atomic_exchange_n(&lock->lock, 1, __ATOMIC_ACQUIRE))
+		;
+}
+
 static inline int arch_try_lock(spinlock_t *lock)
 {
-	return 1;
+	return !__atomic_exchange_n(&lock->lock, 1, __ATOMIC_ACQUIRE);
+}
+
+static inline void arch_spin_unlock(spinlock_t *lock)
+{
+	__atomic_store_n(&lock->lock, 0, __ATOMIC_RELEASE);
 }
-static inline void arch_spin_unlock(spinlock_t *lock) {}
 
 #endif /* __ARCH_SPINLOCK_H__ */
 
@@ -14,7 +14,7 @@
 #include <sof/lib/alloc.h>
 #include <sof/lib/notifier.h>
 
-static struct notify *host_notify;
+static __thread struct notify *host_notify;
 
 struct notify **arch_notify_get(void)
 {
@@ -74,6 +74,13 @@ struct comp_data {
 	int sink_frames;	/* Nominal # of frames to process at sink */
 	int source_frames_max;	/* Max # of frames to process at source */
 	int sink_frames_max;	/* Max # of frames to process at sink */
+	int cycle_source_frames;	/* Source frames in control cycle */
+	int cycle_sink_frames;	/* Sink frames in control cycle */
+	int cycle_source_pos;	/* Source frames processed in cycle */
+	int cycle_sink_pos;	/* Sink frames processed in cycle */
+	int ir_cache_size;	/* Impulse responses cache size */
+	int32_t *ir_cache;	/* Impulse responses of fixed control cycle */
+	enum asrc_control_mode control_mode;	/* Fixed or feedback control */
 	int data_shift;		/* Optional shift by 8 to process S24_4LE */
 	uint8_t *buf;		/* Samples buffer for input and output */
 	uint8_t *ibuf[PLATFORM_MAX_CHANNELS];	/* Input channels pointers */
@@ -315,6 +322,7 @@ static void asrc_free(struct comp_dev *dev)
 
 	comp_info(dev, "asrc_free()");
 
+	rfree(cd->ir_cache);
 	rfree(cd->buf);
 	rfree(cd->asrc_obj);
 	rfree(cd);
@@ -548,6 +556,7 @@ static int asrc_prepare(struct comp_dev *dev)
 	int frame_bytes;
 	int fs_prim;
 	int fs_sec;
+	int rate_gcd;
 	int ret;
 	int i;
 
@@ -670,16 +679,65 @@ static int asrc_prepare(struct comp_dev *dev)
 		fs_sec = cd->source_rate;
 	}
 
+	/* Without drift tracking the conversion ratio is fixed. The control
+	 * cycle is the shortest integer number of frames at both source
+	 * and sink, e.g. 147 and 160 frames for 44.1 to 48 kHz, or the
+	 * largest multiple of it that fits in a period. The impulse
+	 * responses of the cycle are computed once and cached.
+	 */
+	if (!cd->track_drift) {
+		cd->control_mode = ASRC_CM_FIXED;
+		rate_gcd = gcd(cd->source_rate, cd->sink_rate);
+		cd->cycle_source_frames = cd->source_rate / rate_gcd;
+		cd->cycle_sink_frames = cd->sink_rate / rate_gcd;
+		i = MAX(dev->frames / cd->cycle_sink_frames, 1);
+		cd->cycle_source_frames *= i;
+		cd->cycle_sink_frames *= i;
+		cd->cycle_source_pos = 0;
+		cd->cycle_sink_pos = 0;
+		comp_info(dev, "asrc_prepare(), control cycle source_frames=%d, sink_frames=%d",
+			  cd->cycle_source_frames, cd->cycle_sink_frames);
+	} else {
+		cd->control_mode = ASRC_CM_FEEDBACK;
+	}
+
 	ret = asrc_initialise(dev, cd->asrc_obj, sourceb->stream.channels,
 			      fs_prim, fs_sec,
 			      ASRC_IOF_INTERLEAVED, ASRC_IOF_INTERLEAVED,
 			      ASRC_BM_LINEAR, cd->frames, sample_bits,
-			      ASRC_CM_FEEDBACK, cd->mode);
+			      cd->control_mode, cd->mode);
 	if (ret) {
 		comp_err(dev, "initialise_asrc(), error %d", ret);
 		goto err_free_asrc;
 	}
 
+	if (cd->control_mode == ASRC_CM_FIXED) {
+		/* The cache is optional, process without it if there is
+		 * no memory for it. It is limited to the configured budget,
+		 * a partial cache holds the first responses of the cycle.
+		 */
+		cd->ir_cache_size =
+			MIN(asrc_get_ir_cache_size(cd->asrc_obj,
+						   cd->cycle_sink_frames),
+			    CONFIG_COMP_ASRC_IR_CACHE_SIZE);
+		cd->ir_cache = cd->ir_cache_size ?
+			rballoc(0, SOF_MEM_CAPS_RAM, cd->ir_cache_size) : NULL;
+		if (cd->ir_cache_size && !cd->ir_cache) {
+			comp_warn(dev, "asrc_prepare(), no impulse responses cache for size %d",
+				  cd->ir_cache_size);
+			cd->ir_cache_size = 0;
+		}
+
+		ret = asrc_set_ir_cache(dev, cd->asrc_obj, cd->ir_cache,
+					cd->ir_cache_size);
+		if (ret) {
+			comp_err(dev, "asrc_set_ir_cache(), error %d", ret);
+			goto err_free_asrc;
+		}
+
+		return 0;
+	}
+
 	/* Prefer previous skew factor. If the component has not yet been
 	 * run the skew is zero from new(). In that case use factor 1.0
 	 * to start with.
@@ -715,6 +773,8 @@ static int asrc_prepare(struct comp_dev *dev)
 	return 0;
 
 err_free_asrc:
+	rfree(cd->ir_cache);
+	cd->ir_cache = NULL;
 	rfree(cd->asrc_obj);
 	cd->asrc_obj = NULL;
 
@@ -809,12 +869,109 @@ static void asrc_process(struct comp_dev *dev, struct comp_buffer *source,
 	comp_dbg(dev, "asrc_copy(), consumed = %u,  produced = %u",
 		 consumed, produced);
 
+	if (cd->control_mode == ASRC_CM_FIXED) {
+		cd->cycle_source_pos += consumed;
+		cd->cycle_sink_pos += produced;
+		if (cd->cycle_source_pos >= cd->cycle_source_frames &&
+		    cd->cycle_sink_pos >= cd->cycle_sink_frames) {
+			cd->cycle_source_pos = 0;
+			cd->cycle_sink_pos = 0;
+		}
+	}
+
 	comp_update_buffer_consume(source, consumed *
 				   audio_stream_frame_bytes(&source->stream));
 	comp_update_buffer_produce(sink, produced *
 				   audio_stream_frame_bytes(&sink->stream));
 }
 
+/* Sets the frames to process in fixed control mode. A control cycle can
+ * be longer than the buffers, so it is processed in parts that do not
+ * cross the end of the cycle. From the beginning of a cycle the ASRC
+ * produces in push mode and consumes in pull mode at most the frames
+ * count of the other side scaled with the cycle ratio and rounded up,
+ * the part is limited by that to fit the buffers. The conversion ratio
+ * is set at the beginning of each cycle.
+ */
+static int asrc_fixed_frames(struct comp_dev *dev, struct comp_data *cd,
+			     int frames_src, int frames_snk)
+{
+	int source_left = cd->cycle_source_frames - cd->cycle_source_pos;
+	int sink_left = cd->cycle_sink_frames - cd->cycle_sink_pos;
+	int ret;
+
+	frames_src = MIN(frames_src, cd->source_frames_max);
+	frames_snk = MIN(frames_snk, cd->sink_frames_max);
+
+	if (cd->mode == ASRC_OM_PUSH) {
+		cd->source_frames = (frames_snk + cd->cycle_sink_pos) *
+			cd->cycle_source_frames / cd->cycle_sink_frames -
+			cd->cycle_source_pos;
+		cd->source_frames = MIN(cd->source_frames, source_left);
+		cd->source_frames = MIN(cd->source_frames, frames_src);
+		cd->sink_frames = frames_snk;
+	} else {
+		cd->sink_frames = (frames_src + cd->cycle_source_pos) *
+			cd->cycle_sink_frames / cd->cycle_source_frames -
+			cd->cycle_sink_pos;
+		cd->sink_frames = MIN(cd->sink_frames, sink_left);
+		cd->sink_frames = MIN(cd->sink_frames, frames_snk);
+		cd->source_frames = frames_src;
+	}
+
+	if (cd->source_frames <= 0 || cd->sink_frames <= 0) {
+		cd->source_frames = 0;
+		cd->sink_frames = 0;
+		return 0;
+	}
+
+	if (cd->cycle_source_pos || cd->cycle_sink_pos)
+		return 0;
+
+	if (cd->mode == ASRC_OM_PUSH)
+		ret = asrc_update_fs_ratio(dev, cd->asrc_obj,
+					   cd->cycle_source_frames,
+					   cd->cycle_sink_frames);
+	else
+		ret = asrc_update_fs_ratio(dev, cd->asrc_obj,
+					   cd->cycle_sink_frames,
+					   cd->cycle_source_frames);
+	if (ret) {
+		comp_err(dev, "asrc_update_fs_ratio(), error %d", ret);
+		return -EINVAL;
+	}
+
+	return 0;
+}
+
+/* Processes the available frames in fixed control mode. When a part ends
+ * at the end of the control cycle, the processing continues with the next
+ * cycle.
+ */
+static int asrc_copy_fixed(struct comp_dev *dev, struct comp_buffer *source,
+			   struct comp_buffer *sink, int frames_src,
+			   int frames_snk)
+{
+	struct comp_data *cd = comp_get_drvdata(dev);
+	int source_left;
+	int sink_left;
+	int ret;
+
+	do {
+		source_left = cd->cycle_source_frames - cd->cycle_source_pos;
+		sink_left = cd->cycle_sink_frames - cd->cycle_sink_pos;
+		ret = asrc_fixed_frames(dev, cd, frames_src, frames_snk);
+		if (ret || !cd->source_frames)
+			return ret;
+
+		asrc_process(dev, source, sink);
+		frames_src -= source_left;
+		frames_snk -= sink_left;
+	} while (!cd->cycle_source_pos && !cd->cycle_sink_pos);
+
+	return 0;
+}
+
 /* copy and process stream data from source to sink buffers */
 static int asrc_copy(struct comp_dev *dev)
 {
@@ -847,6 +1004,10 @@ static int asrc_copy(struct comp_dev *dev)
 	buffer_unlock(sink, flags);
 	buffer_unlock(source, flags);
 
+	if (cd->control_mode == ASRC_CM_FIXED)
+		return asrc_copy_fixed(dev, source, sink, frames_src,
+				       frames_snk);
+
 	if (cd->mode == ASRC_OM_PULL) {
 		/* Let ASRC access max number of source frames in pull mode.
 		 * The amount cd->sink_frames will be produced while
@@ -887,8 +1048,10 @@ static int asrc_reset(struct comp_dev *dev)
 		asrc_dai_stop_timestamp(cd);
 
 	/* Free the allocations those were done in prepare() */
+	rfree(cd->ir_cache);
 	rfree(cd->asrc_obj);
 	rfree(cd->buf);
+	cd->ir_cache = NULL;
 	cd->asrc_obj = NULL;
 	cd->buf = NULL;
 
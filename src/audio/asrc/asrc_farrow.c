@@ -218,8 +218,8 @@ static enum asrc_error_code initialise_filter(struct comp_dev *dev,
  * &buffer_pointer[0]            |int_x ring_buffer[num_channels       |
  * + num_channels*sizeof(int_x *)|               *buffer_size]         |
  * ------------------------------|---------------------------------_---|
- * &ring_buffer[0]               |int32 impulse_response[filter_length]|
- * + num_channels*buffer_size    |                                     |
+ * &ring_buffer[0]               |int32 impulse_response[block_frames  |
+ * + num_channels*buffer_size    |               *filter_length]       |
  * *sizeof(int_x)                |                                     |
  *
  * Info:
@@ -229,7 +229,12 @@ static enum asrc_error_code initialise_filter(struct comp_dev *dev,
  * the first of these pointers.
  *
  * int_x ring_buffer[num_channels * buffer_size]:
- * This is where the actual input data is buffered.
+ * This is where the actual input data is buffered. The buffers of
+ * the channels are contiguous.
+ *
+ * int32 impulse_response[block_frames * filter_length]:
+ * The impulse responses for a block of up to ASRC_MAX_BLOCK_FRAMES
+ * output frames those are produced between two input frames.
  */
 
 enum asrc_error_code asrc_get_required_size(struct comp_dev *dev,
@@ -276,8 +281,8 @@ enum asrc_error_code asrc_get_required_size(struct comp_dev *dev,
 	size += sizeof(int32_t *) * num_channels; /* pointers the the buffers */
 	/* size of the ring buffers */
 	size += buffer_length * num_channels * (bit_depth / 8);
-	/* size of the impulse response */
-	size += filter_length * sizeof(int32_t);
+	/* size of the impulse responses for a block of output frames */
+	size += ASRC_MAX_BLOCK_FRAMES * filter_length * sizeof(int32_t);
 
 	*required_size = size;
 
@@ -356,6 +361,10 @@ enum asrc_error_code asrc_initialise(struct comp_dev *dev,
 	src_obj->sec_num_frames = 0;
 	src_obj->sec_num_frames_targ = 0;
 	src_obj->calc_ir = NULL;
+	src_obj->ir_cache = NULL;
+	src_obj->ir_cache_size = 0;
+	src_obj->ir_cache_length = 0;
+	src_obj->ir_cache_count = 0;
 	src_obj->is_initialised = false;
 	src_obj->is_updated = false;
 
@@ -402,25 +411,24 @@ enum asrc_error_code asrc_initialise(struct comp_dev *dev,
 	}
 
 	/*
-	 * Set the pointer for the impulse response.
-	 * &m_impulse_response[0] = ring_buffers_x
-	 * + num_channels * (1 + buffer_length);
-	 * Here ring_buffer_x already points to the memory just behind
-	 * the src_obj.  The offset results from the number of pointers
-	 * pointing to each channel and each channels buffer data.
+	 * Set the pointer for the impulse responses of a block. The
+	 * ring buffers of the channels are contiguous and the impulse
+	 * responses follow the last one.
 	 */
 	if (src_obj->bit_depth == 32) {
 		src_obj->impulse_response =
-			(int32_t *)(src_obj->ring_buffers32 +
+			(int32_t *)(src_obj->ring_buffers32[0] +
 				    src_obj->num_channels *
-				    (1 + src_obj->buffer_length));
+				    src_obj->buffer_length);
 	} else if (src_obj->bit_depth == 16) {
 		src_obj->impulse_response =
-			(int32_t *)(src_obj->ring_buffers16 +
+			(int32_t *)(src_obj->ring_buffers16[0] +
 				    src_obj->num_channels *
-				    (1 + src_obj->buffer_length / 2));
+				    src_obj->buffer_length);
 	}
 
+	src_obj->ir_scratch = src_obj->impulse_response;
+
 	/* return ok, if everything worked out */
 	src_obj->is_initialised = true;
 	return ASRC_EC_OK;
@@ -493,21 +501,61 @@ enum asrc_error_code asrc_set_fs_ratio(struct comp_dev *dev,
 		return error_code;
 	}
 
-	/* Set the pointer for the impulse response */
+	/* Set the pointer for the impulse responses */
 	if (src_obj->bit_depth == 32) {
 		src_obj->impulse_response =
-			(int32_t *)(src_obj->ring_buffers32 +
-			src_obj->num_channels * (1 + src_obj->buffer_length));
+			(int32_t *)(src_obj->ring_buffers32[0] +
+				    src_obj->num_channels *
+				    src_obj->buffer_length);
 	} else if (src_obj->bit_depth == 16) {
 		src_obj->impulse_response =
-			(int32_t *)(src_obj->ring_buffers16 +
+			(int32_t *)(src_obj->ring_buffers16[0] +
 				    src_obj->num_channels *
-				    (1 + src_obj->buffer_length / 2));
+				    src_obj->buffer_length);
 	}
 
+	src_obj->ir_scratch = src_obj->impulse_response;
+
+	/* The cached responses are for the previous filter */
+	src_obj->ir_cache_length = src_obj->ir_cache_size /
+		(src_obj->filter_length * sizeof(int32_t));
+	src_obj->ir_cache_count = 0;
+
 	return ASRC_EC_OK;
 }
 
+enum asrc_error_code asrc_set_ir_cache(struct comp_dev *dev,
+				       struct asrc_farrow *src_obj,
+				       int32_t *ir_cache, int size)
+{
+	/* check for parameter errors */
+	if (!src_obj) {
+		comp_err(dev, "asrc_set_ir_cache(), null src_obj");
+		return ASRC_EC_INVALID_POINTER;
+	}
+
+	if (!src_obj->is_initialised) {
+		comp_err(dev, "asrc_set_ir_cache(), not initialised");
+		return ASRC_EC_INIT_FAILED;
+	}
+
+	if (!ir_cache || size < 0)
+		size = 0;
+
+	src_obj->ir_cache = ir_cache;
+	src_obj->ir_cache_size = size;
+	src_obj->ir_cache_length = size /
+		(src_obj->filter_length * sizeof(int32_t));
+	src_obj->ir_cache_count = 0;
+	src_obj->impulse_response = src_obj->ir_scratch;
+	return ASRC_EC_OK;
+}
+
+int asrc_get_ir_cache_size(struct asrc_farrow *src_obj, int num_frames)
+{
+	return num_frames * src_obj->filter_length * sizeof(int32_t);
+}
+
 enum asrc_error_code asrc_set_input_format(struct comp_dev *dev,
 					   struct asrc_farrow *src_obj,
 					   enum asrc_io_format input_format)
@@ -872,6 +920,11 @@ enum asrc_error_code asrc_update_fs_ratio(struct comp_dev *dev,
 	tmp_fs_ratio = ((uint64_t)secondary_num_frames) << 27;
 	src_obj->fs_ratio_inv = (tmp_fs_ratio / primary_num_frames) + 1;
 
+	/* The cached responses are valid for the same control cycle */
+	if (primary_num_frames != src_obj->prim_num_frames_targ ||
+	    secondary_num_frames != src_obj->sec_num_frames_targ)
+		src_obj->ir_cache_count = 0;
+
 	/* Reset the counter and set the new target level */
 	src_obj->prim_num_frames = 0;
 	src_obj->prim_num_frames_targ = primary_num_frames;
@@ -888,88 +941,184 @@ enum asrc_error_code asrc_update_fs_ratio(struct comp_dev *dev,
 	return ASRC_EC_OK;
 }
 
-void asrc_write_to_ring_buffer16(struct asrc_farrow  *src_obj,
-				 int16_t **input_buffers, int index_input_frame)
+/*
+ * Number of steps from time value to reach TIME_VALUE_ONE
+ */
+static inline int asrc_num_steps(uint32_t time_value, uint32_t step)
 {
-	int ch;
-	int j;
-	int k;
-	int m;
+	return (TIME_VALUE_ONE - 1 - time_value) / step + 1;
+}
 
-	/* update the buffer_write_position */
-	(src_obj->buffer_write_position)++;
+/*
+ * Number of input frames in pull mode until write_index or the end of
+ * the circular buffer
+ */
+static inline int asrc_num_avail_frames(struct asrc_farrow *src_obj,
+					int write_index)
+{
+	if (write_index > src_obj->io_buffer_idx)
+		return write_index - src_obj->io_buffer_idx;
+
+	return src_obj->io_buffer_length - src_obj->io_buffer_idx;
+}
+
+/*
+ * Update the pull mode time values for num_frames consumed input frames
+ */
+static inline void asrc_pull_update_time(struct asrc_farrow *src_obj,
+					 int num_frames)
+{
+	src_obj->time_value_pull += (num_frames - 1) * src_obj->fs_ratio;
+	src_obj->time_value = (((int64_t)TIME_VALUE_ONE -
+				src_obj->time_value_pull) *
+			       src_obj->fs_ratio_inv) >> 27;
+	src_obj->time_value_pull += src_obj->fs_ratio;
+}
+
+/*
+ * Compute the impulse responses for a block of num_frames output frames
+ * and advance the time value by step for each of them. The responses
+ * are consecutive from impulse_response on for the block filter. In
+ * fixed control mode the time value sequence restarts from zero every
+ * control cycle, so the response for the same frame index is reused
+ * from the cache after the first cycle. Frames are visited in order so
+ * the cache is filled sequentially.
+ */
+static void asrc_calc_ir(struct asrc_farrow *src_obj, int frame,
+			 int num_frames, uint32_t step)
+{
+	int32_t *ir;
+	int i;
+
+	if (src_obj->control_mode == ASRC_CM_FIXED &&
+	    frame + num_frames <= src_obj->ir_cache_length &&
+	    frame <= src_obj->ir_cache_count) {
+		ir = src_obj->ir_cache + frame * src_obj->filter_length;
+		for (i = frame; i < frame + num_frames; i++) {
+			if (i == src_obj->ir_cache_count) {
+				src_obj->impulse_response = src_obj->ir_cache +
+					i * src_obj->filter_length;
+				(*src_obj->calc_ir)(src_obj);
+				src_obj->ir_cache_count++;
+			}
+
+			src_obj->time_value += step;
+		}
+	} else {
+		ir = src_obj->ir_scratch;
+		for (i = 0; i < num_frames; i++) {
+			src_obj->impulse_response = src_obj->ir_scratch +
+				i * src_obj->filter_length;
+			(*src_obj->calc_ir)(src_obj);
+			src_obj->time_value += step;
+		}
+	}
 
-	/* since it's a ring buffer we need a wrap around */
-	if (src_obj->buffer_write_position >= src_obj->buffer_length)
-		src_obj->buffer_write_position -= (src_obj->buffer_length >> 1);
+	src_obj->impulse_response = ir;
+}
+
+void asrc_write_to_ring_buffer16(struct asrc_farrow  *src_obj,
+				 int16_t **input_buffers, int index_input_frame,
+				 int num_frames)
+{
+	int16_t *buffer;
+	int16_t *in;
+	int half = src_obj->buffer_length >> 1;
+	int j = src_obj->buffer_write_position;
+	int stride;
+	int ch;
+	int i;
 
 	/* handle input format */
 	if (src_obj->input_format == ASRC_IOF_INTERLEAVED)
-		m = src_obj->num_channels * index_input_frame;
+		stride = src_obj->num_channels;
 	else
-		m = index_input_frame; /* For SRC_IOF_DEINTERLEAVED */
+		stride = 1; /* For SRC_IOF_DEINTERLEAVED */
 
-	/* write data to each channel */
-	j = src_obj->buffer_write_position;
-	k = j - (src_obj->buffer_length >> 1);
+	/* write the block to each channel */
 	for (ch = 0; ch < src_obj->num_channels; ch++) {
-		/*
-		 * Since we want the filter function to load 64 bit of
-		 * buffer data in one cycle, this function writes each
-		 * input sample to the buffer twice, one with an
-		 * offset of half the buffer size. This way we don't
-		 * need a wrap around while loading #filter_length of
-		 * buffered samples. The upper and lower half of the
-		 * buffer are redundant. If the memory tradeoff is
-		 * critical, the buffer can be reduced to half the
-		 * size but therefore increased filter operations have
-		 * to be expected.
-		 */
-		src_obj->ring_buffers16[ch][j] = input_buffers[ch][m];
-		src_obj->ring_buffers16[ch][k] = input_buffers[ch][m];
+		buffer = src_obj->ring_buffers16[ch];
+		in = &input_buffers[ch][stride * index_input_frame];
+		j = src_obj->buffer_write_position;
+		for (i = 0; i < num_frames; i++) {
+			/* since it's a ring buffer we need a wrap around */
+			j++;
+			if (j >= src_obj->buffer_length)
+				j -= half;
+
+			/*
+			 * Since we want the filter function to load 64
+			 * bit of buffer data in one cycle, this function
+			 * writes each input sample to the buffer twice,
+			 * one with an offset of half the buffer size.
+			 * This way we don't need a wrap around while
+			 * loading #filter_length of buffered samples.
+			 * The upper and lower half of the buffer are
+			 * redundant. If the memory tradeoff is critical,
+			 * the buffer can be reduced to half the size but
+			 * therefore increased filter operations have to
+			 * be expected.
+			 */
+			buffer[j] = *in;
+			buffer[j - half] = *in;
+			in += stride;
+		}
 	}
+
+	/* update the buffer_write_position */
+	src_obj->buffer_write_position = j;
 }
 
 void asrc_write_to_ring_buffer32(struct asrc_farrow  *src_obj,
-				 int32_t **input_buffers, int index_input_frame)
+				 int32_t **input_buffers, int index_input_frame,
+				 int num_frames)
 {
+	int32_t *buffer;
+	int32_t *in;
+	int half = src_obj->buffer_length >> 1;
+	int j = src_obj->buffer_write_position;
+	int stride;
 	int ch;
-	int j;
-	int k;
-	int m;
-
-	/* update the buffer_write_position */
-	(src_obj->buffer_write_position)++;
-
-	/* since it's a ring buffer we need a wrap around */
-	if (src_obj->buffer_write_position >= src_obj->buffer_length)
-		src_obj->buffer_write_position -= (src_obj->buffer_length >> 1);
+	int i;
 
 	/* handle input format */
 	if (src_obj->input_format == ASRC_IOF_INTERLEAVED)
-		m = src_obj->num_channels * index_input_frame;
+		stride = src_obj->num_channels;
 	else
-		m = index_input_frame; /* For SRC_IOF_DEINTERLEAVED */
+		stride = 1; /* For SRC_IOF_DEINTERLEAVED */
 
-	/* write data to each channel */
-	j = src_obj->buffer_write_position;
-	k = j - (src_obj->buffer_length >> 1);
+	/* write the block to each channel */
 	for (ch = 0; ch < src_obj->num_channels; ch++) {
-		/*
-		 * Since we want the filter function to load 64 bit of
-		 * buffer data in one cycle, this function writes each
-		 * input sample to the buffer twice, one with an
-		 * offset of half the buffer size. This way we don't
-		 * need a wrap around while loading #filter_length of
-		 * buffered samples. The upper and lower half of the
-		 * buffer are redundant. If the memory tradeoff is
-		 * critical, the buffer can be reduced to half the
-		 * size but therefore increased filter operations have
-		 * to be expected.
-		 */
-		src_obj->ring_buffers32[ch][j] = input_buffers[ch][m];
-		src_obj->ring_buffers32[ch][k] = input_buffers[ch][m];
+		buffer = src_obj->ring_buffers32[ch];
+		in = &input_buffers[ch][stride * index_input_frame];
+		j = src_obj->buffer_write_position;
+		for (i = 0; i < num_frames; i++) {
+			/* since it's a ring buffer we need a wrap around */
+			j++;
+			if (j >= src_obj->buffer_length)
+				j -= half;
+
+			/*
+			 * Since we want the filter function to load 64
+			 * bit of buffer data in one cycle, this function
+			 * writes each input sample to the buffer twice,
+			 * one with an offset of half the buffer size.
+			 * This way we don't need a wrap around while
+			 * loading #filter_length of buffered samples.
+			 * The upper and lower half of the buffer are
+			 * redundant. If the memory tradeoff is critical,
+			 * the buffer can be reduced to half the size but
+			 * therefore increased filter operations have to
+			 * be expected.
+			 */
+			buffer[j] = *in;
+			buffer[j - half] = *in;
+			in += stride;
+		}
 	}
+
+	/* update the buffer_write_position */
+	src_obj->buffer_write_position = j;
 }
 
 enum asrc_error_code asrc_process_push16(struct comp_dev *dev,
@@ -983,6 +1132,7 @@ enum asrc_error_code asrc_process_push16(struct comp_dev *dev,
 {
 	int index_input_frame;
 	int max_num_free_frames;
+	int n;
 
 	/* parameter error handling */
 	if (!src_obj || !input_buffers || !output_buffers ||
@@ -1015,40 +1165,49 @@ enum asrc_error_code asrc_process_push16(struct comp_dev *dev,
 	/* Run the state machine until all input samples are read */
 	while (index_input_frame < input_num_frames) {
 		if (src_obj->time_value < TIME_VALUE_ONE) {
-			if (*output_num_frames < max_num_free_frames) {
-				/* Calculate impulse response */
-				(*src_obj->calc_ir)(src_obj);
-
-				/* Filter and write one output sample for each
-				 * channel to the output_buffer
-				 */
-				asrc_fir_filter16(src_obj, output_buffers,
-						  src_obj->io_buffer_idx);
-
-				/* Update time and buffer index */
-				src_obj->time_value += src_obj->fs_ratio;
-				src_obj->io_buffer_idx++;
-				if (src_obj->io_buffer_idx >=
-				    src_obj->io_buffer_length &&
-				    src_obj->io_buffer_mode == ASRC_BM_CIRCULAR)
-					/* Wrap around */
-					src_obj->io_buffer_idx = 0;
-
-				(*output_num_frames)++;
-			} else {
+			/* Number of output frames before next input frame */
+			n = asrc_num_steps(src_obj->time_value,
+					   src_obj->fs_ratio);
+			n = MIN(n, ASRC_MAX_BLOCK_FRAMES);
+			n = MIN(n, max_num_free_frames - *output_num_frames);
+			if (src_obj->io_buffer_mode == ASRC_BM_CIRCULAR)
+				n = MIN(n, src_obj->io_buffer_length -
+					src_obj->io_buffer_idx);
+
+			if (n <= 0) {
 				comp_err(dev, "error onf=%d, max=%d",
 					 *output_num_frames,
 					 max_num_free_frames);
 				break;
 			}
+
+			/* Calculate impulse responses and update time */
+			asrc_calc_ir(src_obj, src_obj->sec_num_frames +
+				     *output_num_frames, n, src_obj->fs_ratio);
+
+			/* Filter and write the output frames of the block */
+			asrc_fir_filter16(src_obj, output_buffers,
+					  src_obj->io_buffer_idx, n);
+
+			/* Update buffer index */
+			src_obj->io_buffer_idx += n;
+			if (src_obj->io_buffer_idx >=
+			    src_obj->io_buffer_length &&
+			    src_obj->io_buffer_mode == ASRC_BM_CIRCULAR)
+				/* Wrap around */
+				src_obj->io_buffer_idx = 0;
+
+			*output_num_frames += n;
 		} else {
-			/* Consume one input sample */
+			/* Consume the input frames before next output */
+			n = MIN((int)(src_obj->time_value / TIME_VALUE_ONE),
+				input_num_frames - index_input_frame);
 			asrc_write_to_ring_buffer16(src_obj, input_buffers,
-						    index_input_frame);
-			index_input_frame++;
+						    index_input_frame, n);
+			index_input_frame += n;
 
 			/* Update time */
-			src_obj->time_value -= TIME_VALUE_ONE;
+			src_obj->time_value -= n * TIME_VALUE_ONE;
 		}
 	}
 	*write_index = src_obj->io_buffer_idx;
@@ -1099,6 +1258,7 @@ enum asrc_error_code asrc_process_push32(struct comp_dev *dev,
 	 */
 	int index_input_frame;
 	int max_num_free_frames;
+	int n;
 
 	/* parameter error handling */
 	if (!src_obj || !input_buffers || !output_buffers ||
@@ -1126,42 +1286,49 @@ enum asrc_error_code asrc_process_push32(struct comp_dev *dev,
 	index_input_frame = 0;
 	while (index_input_frame < input_num_frames) {
 		if (src_obj->time_value < TIME_VALUE_ONE) {
-			if (*output_num_frames < max_num_free_frames) {
-				/* Calculate impulse response */
-				(*src_obj->calc_ir)(src_obj);
-
-				/* Filter and write output sample to
-				 * output_buffer
-				 */
-				asrc_fir_filter32(src_obj, output_buffers,
-						  src_obj->io_buffer_idx);
-
-				/* Update time and index */
-				src_obj->time_value += src_obj->fs_ratio;
-				src_obj->io_buffer_idx++;
-
-				/* Wrap around */
-				if (src_obj->io_buffer_mode ==
-				    ASRC_BM_CIRCULAR &&
-				    src_obj->io_buffer_idx >=
-				    src_obj->io_buffer_length)
-					src_obj->io_buffer_idx = 0;
-
-				(*output_num_frames)++;
-			} else {
+			/* Number of output frames before next input frame */
+			n = asrc_num_steps(src_obj->time_value,
+					   src_obj->fs_ratio);
+			n = MIN(n, ASRC_MAX_BLOCK_FRAMES);
+			n = MIN(n, max_num_free_frames - *output_num_frames);
+			if (src_obj->io_buffer_mode == ASRC_BM_CIRCULAR)
+				n = MIN(n, src_obj->io_buffer_length -
+					src_obj->io_buffer_idx);
+
+			if (n <= 0) {
 				comp_err(dev, "error onf=%d, max=%d",
 					 *output_num_frames,
 					 max_num_free_frames);
 				break;
 			}
+
+			/* Calculate impulse responses and update time */
+			asrc_calc_ir(src_obj, src_obj->sec_num_frames +
+				     *output_num_frames, n, src_obj->fs_ratio);
+
+			/* Filter and write the output frames of the block */
+			asrc_fir_filter32(src_obj, output_buffers,
+					  src_obj->io_buffer_idx, n);
+
+			/* Update buffer index */
+			src_obj->io_buffer_idx += n;
+			if (src_obj->io_buffer_idx >=
+			    src_obj->io_buffer_length &&
+			    src_obj->io_buffer_mode == ASRC_BM_CIRCULAR)
+				/* Wrap around */
+				src_obj->io_buffer_idx = 0;
+
+			*output_num_frames += n;
 		} else {
-			/* Consume input sample */
+			/* Consume the input frames before next output */
+			n = MIN((int)(src_obj->time_value / TIME_VALUE_ONE),
+				input_num_frames - index_input_frame);
 			asrc_write_to_ring_buffer32(src_obj, input_buffers,
-						    index_input_frame);
-			index_input_frame++;
+						    index_input_frame, n);
+			index_input_frame += n;
 
 			/* Update time */
-			src_obj->time_value -= TIME_VALUE_ONE;
+			src_obj->time_value -= n * TIME_VALUE_ONE;
 		}
 	}
 
@@ -1209,6 +1376,9 @@ enum asrc_error_code asrc_process_pull16(struct comp_dev *dev,
 					 int *read_index)
 {
 	int index_output_frame = 0;
+	int n;
+	int m;
+	int k;
 
 	/* parameter error handling */
 	if (!src_obj || !input_buffers || !output_buffers ||
@@ -1232,12 +1402,19 @@ enum asrc_error_code asrc_process_pull16(struct comp_dev *dev,
 	/* Run state machine until number of output samples are written */
 	while (index_output_frame < output_num_frames) {
 		if (src_obj->time_value_pull < TIME_VALUE_ONE) {
-			/* Consume one input sample */
-			if (src_obj->io_buffer_idx != write_index) {
+			/* Number of input frames before next output frame */
+			n = asrc_num_steps(src_obj->time_value_pull,
+					   src_obj->fs_ratio);
+
+			/* Consume the available input frames */
+			m = n;
+			while (m > 0 && src_obj->io_buffer_idx != write_index) {
+				k = asrc_num_avail_frames(src_obj, write_index);
+				k = MIN(k, m);
 				asrc_write_to_ring_buffer16(src_obj,
-							    input_buffers,
-							    src_obj->io_buffer_idx);
-				src_obj->io_buffer_idx++;
+					input_buffers, src_obj->io_buffer_idx,
+					k);
+				src_obj->io_buffer_idx += k;
 
 				/* Wrap around */
 				if (src_obj->io_buffer_idx >=
@@ -1245,26 +1422,31 @@ enum asrc_error_code asrc_process_pull16(struct comp_dev *dev,
 				    src_obj->io_buffer_mode == ASRC_BM_CIRCULAR)
 					src_obj->io_buffer_idx = 0;
 
-				(*input_num_frames)++;
+				*input_num_frames += k;
+				m -= k;
 			}
 
 			/* Update time as Q5.27 */
-			src_obj->time_value = (((int64_t)TIME_VALUE_ONE -
-						src_obj->time_value_pull) *
-					       src_obj->fs_ratio_inv) >> 27;
-			src_obj->time_value_pull += src_obj->fs_ratio;
+			asrc_pull_update_time(src_obj, n);
 		} else {
-			/* Calculate impulse response */
-			(*src_obj->calc_ir)(src_obj);
-
-			/* Filter and write output sample to output_buffer */
+			/* Number of output frames before next input frame */
+			n = MIN((int)(src_obj->time_value_pull /
+				      TIME_VALUE_ONE),
+				output_num_frames - index_output_frame);
+			n = MIN(n, ASRC_MAX_BLOCK_FRAMES);
+
+			/* Calculate impulse responses and update time */
+			asrc_calc_ir(src_obj, src_obj->prim_num_frames +
+				     index_output_frame, n,
+				     src_obj->fs_ratio_inv);
+
+			/* Filter and write the output frames of the block */
 			asrc_fir_filter16(src_obj, output_buffers,
-					  index_output_frame);
+					  index_output_frame, n);
 
 			/* Update time and index */
-			src_obj->time_value += src_obj->fs_ratio_inv;
-			src_obj->time_value_pull -= TIME_VALUE_ONE;
-			index_output_frame++;
+			src_obj->time_value_pull -= n * TIME_VALUE_ONE;
+			index_output_frame += n;
 		}
 	}
 	*read_index = src_obj->io_buffer_idx;
@@ -1311,6 +1493,9 @@ enum asrc_error_code asrc_process_pull32(struct comp_dev *dev,
 					 int *read_index)
 {
 	int index_output_frame = 0;
+	int n;
+	int m;
+	int k;
 
 	/* parameter error handling */
 	if (!src_obj || !input_buffers || !output_buffers ||
@@ -1335,12 +1520,19 @@ enum asrc_error_code asrc_process_pull32(struct comp_dev *dev,
 	*input_num_frames = 0;
 	while (index_output_frame < output_num_frames) {
 		if (src_obj->time_value_pull < TIME_VALUE_ONE) {
-			/* Consume input sample */
-			if (src_obj->io_buffer_idx != write_index) {
+			/* Number of input frames before next output frame */
+			n = asrc_num_steps(src_obj->time_value_pull,
+					   src_obj->fs_ratio);
+
+			/* Consume the available input frames */
+			m = n;
+			while (m > 0 && src_obj->io_buffer_idx != write_index) {
+				k = asrc_num_avail_frames(src_obj, write_index);
+				k = MIN(k, m);
 				asrc_write_to_ring_buffer32(src_obj,
-							    input_buffers,
-							    src_obj->io_buffer_idx);
-				src_obj->io_buffer_idx++;
+					input_buffers, src_obj->io_buffer_idx,
+					k);
+				src_obj->io_buffer_idx += k;
 
 				/* Wrap around */
 				if (src_obj->io_buffer_idx >=
@@ -1348,26 +1540,31 @@ enum asrc_error_code asrc_process_pull32(struct comp_dev *dev,
 				    src_obj->io_buffer_mode == ASRC_BM_CIRCULAR)
 					src_obj->io_buffer_idx = 0;
 
-				(*input_num_frames)++;
+				*input_num_frames += k;
+				m -= k;
 			}
 
 			/* Update time as Q5.27 */
-			src_obj->time_value = (((int64_t)TIME_VALUE_ONE -
-						src_obj->time_value_pull) *
-					       src_obj->fs_ratio_inv) >> 27;
-			src_obj->time_value_pull += src_obj->fs_ratio;
+			asrc_pull_update_time(src_obj, n);
 		} else {
-			/* Calculate impulse response */
-			(*src_obj->calc_ir)(src_obj);
-
-			/* Filter and write output sample to output_buffer */
+			/* Number of output frames before next input frame */
+			n = MIN((int)(src_obj->time_value_pull /
+				      TIME_VALUE_ONE),
+				output_num_frames - index_output_frame);
+			n = MIN(n, ASRC_MAX_BLOCK_FRAMES);
+
+			/* Calculate impulse responses and update time */
+			asrc_calc_ir(src_obj, src_obj->prim_num_frames +
+				     index_output_frame, n,
+				     src_obj->fs_ratio_inv);
+
+			/* Filter and write the output frames of the block */
 			asrc_fir_filter32(src_obj, output_buffers,
-					  index_output_frame);
+					  index_output_frame, n);
 
 			/* Update time and index */
-			src_obj->time_value += src_obj->fs_ratio_inv;
-			src_obj->time_value_pull -= TIME_VALUE_ONE;
-			index_output_frame++;
+			src_obj->time_value_pull -= n * TIME_VALUE_ONE;
+			index_output_frame += n;
 		}
 	}
 	*read_index = src_obj->io_buffer_idx;
@@ -10,102 +10,126 @@
 #include <sof/audio/format.h>
 
 void asrc_fir_filter16(struct asrc_farrow *src_obj, int16_t **output_buffers,
-		       int index_output_frame)
+		       int index_output_frame, int num_frames)
 {
 	int64_t prod;
 	int32_t prod32;
 	int16_t prod16;
 	int32_t *filter_p;
 	int16_t *buffer_p;
+	int16_t *buffer;
+	int16_t *out;
+	int stride;
 	int ch;
 	int n;
 	int i;
 
 	if (src_obj->output_format == ASRC_IOF_INTERLEAVED)
-		i = src_obj->num_channels * index_output_frame;
+		stride = src_obj->num_channels;
 	else
-		i = index_output_frame;
+		stride = 1;
 
 	/* Iterate over each channel */
 	for (ch = 0; ch < src_obj->num_channels; ch++) {
-		/* Pointer to the beginning of the impulse response */
+		/* Pointer to the beginning of the impulse responses */
 		filter_p = &src_obj->impulse_response[0];
 
-		/* Pointer to the buffered input data */
-		buffer_p = &src_obj->ring_buffers16[ch]
-			[src_obj->buffer_write_position];
-
-		/* Initialise the accumulator */
-		prod = 0;
-
-		/* Iterate over the filter bins.
-		 * Data is Q1.15, coefficients are Q1.30. Prod will be Qx.45.
-		 */
-		for (n = 0; n < src_obj->filter_length; n++)
-			prod += (int64_t)(*buffer_p--) * (*filter_p++);
-
-		/* Shift left after accumulation, because interim
-		 * results might saturate during filtering prod = prod
-		 * << 1; will shift after last addition
-		 */
-		prod32 = sat_int32(Q_SHIFT(prod, 45, 31));
-
-		/* Round 'prod' to 16 bit and store it in
-		 * (de-)interleaved format in the output buffers
+		/* Pointer to the buffered input data, the same input
+		 * is filtered for all output frames of the block.
 		 */
-		prod16 = sat_int16(Q_SHIFT_RND(prod32, 31, 15));
-		output_buffers[ch][i] = prod16;
+		buffer = &src_obj->ring_buffers16[ch]
+			[src_obj->buffer_write_position];
+		out = &output_buffers[ch][stride * index_output_frame];
+
+		for (i = 0; i < num_frames; i++) {
+			buffer_p = buffer;
+
+			/* Initialise the accumulator */
+			prod = 0;
+
+			/* Iterate over the filter bins. Data is Q1.15,
+			 * coefficients are Q1.30. Prod will be Qx.45.
+			 */
+			for (n = 0; n < src_obj->filter_length; n++)
+				prod += (int64_t)(*buffer_p--) * (*filter_p++);
+
+			/* Shift left after accumulation, because interim
+			 * results might saturate during filtering prod =
+			 * prod << 1; will shift after last addition
+			 */
+			prod32 = sat_int32(Q_SHIFT(prod, 45, 31));
+
+			/* Round 'prod' to 16 bit and store it in
+			 * (de-)interleaved format in the output buffers
+			 */
+			prod16 = sat_int16(Q_SHIFT_RND(prod32, 31, 15));
+			*out = prod16;
+			out += stride;
+		}
 	}
 }
 
 void asrc_fir_filter32(struct asrc_farrow *src_obj, int32_t **output_buffers,
-		       int index_output_frame)
+		       int index_output_frame, int num_frames)
 {
 	int64_t prod;
 	int32_t prod32;
 	const int32_t *filter_p;
 	int32_t *buffer_p;
+	int32_t *buffer;
+	int32_t *out;
+	int stride;
 	int ch;
 	int n;
 	int i;
 
 	if (src_obj->output_format == ASRC_IOF_INTERLEAVED)
-		i = src_obj->num_channels * index_output_frame;
+		stride = src_obj->num_channels;
 	else
-		i = index_output_frame;
+		stride = 1;
 
 	/* Iterate over each channel */
 	for (ch = 0; ch < src_obj->num_channels; ch++) {
-		/* Pointer to the beginning of the impulse response */
+		/* Pointer to the beginning of the impulse responses */
 		filter_p = &src_obj->impulse_response[0];
 
-		/* Pointer to the buffered input data */
-		buffer_p = &src_obj->ring_buffers32[ch]
-			[src_obj->buffer_write_position];
-
-		/* Initialise the accumulator */
-		prod = 0;
-
-		/* Iterate over the filter bins. Data is Q1.31, coefficients
-		 * are Q1.22. They are down scaled by 1 shift. In addition
-		 * there C is implementation specific right shift by 8. It
-		 * gives headroom to calculate up to 256 taps FIR. The use
-		 * of 24 bits of 32 bits is not a practical limitation for
-		 * quality. The product is Qx.54.
-		 */
-		for (n = 0; n < src_obj->filter_length; n++)
-			prod += (int64_t)(*buffer_p--) * (*filter_p++ >> 8);
-
-		/* Shift left after accumulation, because interim
-		 * results might saturate during filtering prod = prod
-		 * << 1; will shift after last addition
-		 */
-		prod32 = sat_int32(Q_SHIFT(prod, 53, 31));
-
-		/* Store 'prod' in (de-)interleaved format in the output
-		 * buffers
+		/* Pointer to the buffered input data, the same input
+		 * is filtered for all output frames of the block.
 		 */
-		output_buffers[ch][i] = prod32;
+		buffer = &src_obj->ring_buffers32[ch]
+			[src_obj->buffer_write_position];
+		out = &output_buffers[ch][stride * index_output_frame];
+
+		for (i = 0; i < num_frames; i++) {
+			buffer_p = buffer;
+
+			/* Initialise the accumulator */
+			prod = 0;
+
+			/* Iterate over the filter bins. Data is Q1.31,
+			 * coefficients are Q1.22. They are down scaled by
+			 * 1 shift. In addition there C is implementation
+			 * specific right shift by 8. It gives headroom to
+			 * calculate up to 256 taps FIR. The use of 24 bits
+			 * of 32 bits is not a practical limitation for
+			 * quality. The product is Qx.54.
+			 */
+			for (n = 0; n < src_obj->filter_length; n++)
+				prod += (int64_t)(*buffer_p--) *
+					(*filter_p++ >> 8);
+
+			/* Shift left after accumulation, because interim
+			 * results might saturate during filtering prod =
+			 * prod << 1; will shift after last addition
+			 */
+			prod32 = sat_int32(Q_SHIFT(prod, 53, 31));
+
+			/* Store 'prod' in (de-)interleaved format in the
+			 * output buffers
+			 */
+			*out = prod32;
+			out += stride;
+		}
 	}
 }
 
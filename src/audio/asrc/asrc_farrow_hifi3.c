@@ -10,15 +10,20 @@
 #include <xtensa/tie/xt_hifi3.h>
 
 void asrc_fir_filter16(struct asrc_farrow *src_obj, int16_t **output_buffers,
-		       int index_output_frame)
+		       int index_output_frame, int num_frames)
 {
 	ae_f32x2 prod;
 	ae_f32x2 filter01 = AE_ZERO32(); /* Note: Init is not needed */
 	ae_f32x2 filter23 = AE_ZERO32(); /* Note: Init is not needed */
 	ae_f16x4 buffer0123 = AE_ZERO16(); /* Note: Init is not needed */
+	ae_valign align_filter;
+	ae_valign align_buffer;
 	ae_f32x2 *filter_p;
 	ae_f16x4 *buffer_p;
+	int16_t *buffer;
+	int16_t *out;
 	int n_limit;
+	int stride;
 	int ch;
 	int n;
 	int i;
@@ -30,80 +35,97 @@ void asrc_fir_filter16(struct asrc_farrow *src_obj, int16_t **output_buffers,
 	 */
 	n_limit = src_obj->filter_length >> 2;
 	if (src_obj->output_format == ASRC_IOF_INTERLEAVED)
-		i = src_obj->num_channels * index_output_frame;
+		stride = src_obj->num_channels;
 	else
-		i = index_output_frame;
+		stride = 1;
 
 	/* Iterate over each channel */
 	for (ch = 0; ch < src_obj->num_channels; ch++) {
-		/* Pointer to the beginning of the impulse response */
+		/* Pointer to the beginning of the impulse responses */
 		filter_p = (ae_f32x2 *)&src_obj->impulse_response[0];
 
-		/* Pointer to the buffered input data */
-		buffer_p =
-			(ae_f16x4 *)&src_obj->ring_buffers16[ch]
+		/* Pointer to the buffered input data, the same input
+		 * is filtered for all output frames of the block.
+		 */
+		buffer = &src_obj->ring_buffers16[ch]
 			[src_obj->buffer_write_position];
+		out = &output_buffers[ch][stride * index_output_frame];
+
+		for (i = 0; i < num_frames; i++) {
+			buffer_p = (ae_f16x4 *)buffer;
+
+			/* Allows unaligned load of 64 bit per cycle */
+			align_filter = AE_LA64_PP(filter_p);
+			align_buffer = AE_LA64_PP(buffer_p);
+
+			/* Initialise the accumulator */
+			prod = AE_ZERO32();
+
+			/* Iterate over the filter bins */
+			for (n = 0; n < n_limit; n++) {
+				/* Read four buffered samples at once */
+				AE_LA16X4_RIP(buffer0123, align_buffer,
+					      buffer_p);
+
+				/* Store four bins of the impulse response */
+				AE_LA32X2_IP(filter01, align_filter, filter_p);
+				AE_LA32X2_IP(filter23, align_filter, filter_p);
+
+				/* Multiply and accumulate
+				 * the lower half bits in 'buffer0123' are used
+				 */
+				AE_MULAFP32X16X2RS_L(prod, filter23,
+						     buffer0123);
+				/* the upper half bits in 'buffer0123' are
+				 * used
+				 */
+				AE_MULAFP32X16X2RS_H(prod, filter01,
+						     buffer0123);
+			}
+
+			/* Shift left after accumulation, because interim
+			 * results might saturate during filtering prod =
+			 * prod << 1; will shift after last addition
+			 */
 
-		/* Allows unaligned load of 64 bit per cycle */
-		ae_valign align_filter = AE_LA64_PP(filter_p);
-		ae_valign align_buffer = AE_LA64_PP(buffer_p);
-
-		/* Initialise the accumulator */
-		prod = AE_ZERO32();
+			/* swap LL and HH reusing filter01 to perform
+			 * saturated addition of both halves
+			 */
+			filter01 = AE_SEL32_LH(prod, prod);
 
-		/* Iterate over the filter bins */
-		for (n = 0; n < n_limit; n++) {
-			/* Read four buffered samples at once */
-			AE_LA16X4_RIP(buffer0123, align_buffer, buffer_p);
+			/* Add up the lower and upper 32 bit data of the
+			 * 'prod' prod = AE_ADD32_HL_LH(prod, prod); fix
+			 * using saturated addition
+			 */
+			prod = AE_ADD32S(prod, filter01);
 
-			/* Store four bins of the impulse response */
-			AE_LA32X2_IP(filter01, align_filter, filter_p);
-			AE_LA32X2_IP(filter23, align_filter, filter_p);
+			/* Shift with saturation */
+			prod = AE_SLAI32S(prod, 1);
 
-			/* Multiply and accumulate
-			 * the lower half bits in 'buffer0123' are used
+			/* Round 'prod' to 16 bit and store it in
+			 * (de-)interleaved format in the output buffers
 			 */
-			AE_MULAFP32X16X2RS_L(prod, filter23, buffer0123);
-			/* the upper half bits in 'buffer0123' are used */
-			AE_MULAFP32X16X2RS_H(prod, filter01, buffer0123);
+			AE_S16_0_X(AE_ROUND16X4F32SSYM(prod, prod),
+				   (ae_f16 *)out, 0);
+			out += stride;
 		}
-
-		/* Shift left after accumulation, because interim
-		 * results might saturate during filtering prod = prod
-		 * << 1; will shift after last addition
-		 */
-
-		/* swap LL and HH reusing filter01 to perform
-		 * saturated addition of both halves
-		 */
-		filter01 = AE_SEL32_LH(prod, prod);
-
-		/* Add up the lower and upper 32 bit data of the
-		 * 'prod' prod = AE_ADD32_HL_LH(prod, prod); fix using
-		 * saturated addition
-		 */
-		prod = AE_ADD32S(prod, filter01);
-
-		/* Shift with saturation */
-		prod = AE_SLAI32S(prod, 1);
-
-		/* Round 'prod' to 16 bit and store it in
-		 * (de-)interleaved format in the output buffers
-		 */
-		AE_S16_0_X(AE_ROUND16X4F32SSYM(prod, prod),
-			   (ae_f16 *)&output_buffers[ch][i], 0);
 	}
 }
 
 void asrc_fir_filter32(struct asrc_farrow *src_obj, int32_t **output_buffers,
-		       int index_output_frame)
+		       int index_output_frame, int num_frames)
 {
 	ae_f32x2 prod;
 	ae_f32x2 buffer01 = AE_ZERO32(); /* Note: Init is not needed */
 	ae_f32x2 filter01 = AE_ZERO32(); /* Note: Init is not needed */
+	ae_valign align_filter;
+	ae_valign align_buffer;
 	ae_f32x2 *filter_p;
 	ae_f32x2 *buffer_p;
+	int32_t *buffer;
+	int32_t *out;
 	int n_limit;
+	int stride;
 	int ch;
 	int n;
 	int i;
@@ -115,62 +137,69 @@ void asrc_fir_filter32(struct asrc_farrow *src_obj, int32_t **output_buffers,
 	 */
 	n_limit = src_obj->filter_length >> 1;
 	if (src_obj->output_format == ASRC_IOF_INTERLEAVED)
-		i = src_obj->num_channels * index_output_frame;
+		stride = src_obj->num_channels;
 	else
-		i = index_output_frame;
+		stride = 1;
 
 	/* Iterate over each channel */
 	for (ch = 0; ch < src_obj->num_channels; ch++) {
-		/* Pointer to the beginning of the impulse response */
+		/* Pointer to the beginning of the impulse responses */
 		filter_p = (ae_f32x2 *)&src_obj->impulse_response[0];
 
-		/* Pointer to the buffered input data */
-		buffer_p =
-			(ae_f32x2 *)&src_obj->ring_buffers32[ch]
+		/* Pointer to the buffered input data, the same input
+		 * is filtered for all output frames of the block.
+		 */
+		buffer = &src_obj->ring_buffers32[ch]
 			[src_obj->buffer_write_position];
+		out = &output_buffers[ch][stride * index_output_frame];
 
-		/* Allows unaligned load of 64 bit per cycle */
-		ae_valign align_filter = AE_LA64_PP(filter_p);
-		ae_valign align_buffer = AE_LA64_PP(buffer_p);
+		for (i = 0; i < num_frames; i++) {
+			buffer_p = (ae_f32x2 *)buffer;
 
-		/* Initialise the accumulator */
-		prod = AE_ZERO32();
+			/* Allows unaligned load of 64 bit per cycle */
+			align_filter = AE_LA64_PP(filter_p);
+			align_buffer = AE_LA64_PP(buffer_p);
 
-		/* Iterate over the filter bins */
-		for (n = 0; n < n_limit; n++) {
-			/* Read two buffered samples at once */
-			AE_LA32X2_RIP(buffer01, align_buffer, buffer_p);
+			/* Initialise the accumulator */
+			prod = AE_ZERO32();
 
-			/* Store two bins of the impulse response */
-			AE_LA32X2_IP(filter01, align_filter, filter_p);
+			/* Iterate over the filter bins */
+			for (n = 0; n < n_limit; n++) {
+				/* Read two buffered samples at once */
+				AE_LA32X2_RIP(buffer01, align_buffer, buffer_p);
 
-			/* Multiply and accumulate */
-			AE_MULAFP32X2RS(prod, buffer01, filter01);
-		}
+				/* Store two bins of the impulse response */
+				AE_LA32X2_IP(filter01, align_filter, filter_p);
 
-		/* Shift left after accumulation, because interim
-		 * results might saturate during filtering prod = prod
-		 * << 1; will shift after last addition
-		 */
+				/* Multiply and accumulate */
+				AE_MULAFP32X2RS(prod, buffer01, filter01);
+			}
 
-		/* swap LL and HH reusing filter01 to perform
-		 * saturated addition of both halves
-		 */
-		filter01 = AE_SEL32_LH(prod, prod);
+			/* Shift left after accumulation, because interim
+			 * results might saturate during filtering prod =
+			 * prod << 1; will shift after last addition
+			 */
 
-		/* Add up the lower and upper 32 bit data of the
-		 * 'prod' prod = AE_ADD32_HL_LH(prod, prod); fix using
-		 * saturated addition
-		 */
-		prod = AE_ADD32S(prod, filter01);
+			/* swap LL and HH reusing filter01 to perform
+			 * saturated addition of both halves
+			 */
+			filter01 = AE_SEL32_LH(prod, prod);
 
-		/* Shift with saturation */
-		prod = AE_SLAI32S(prod, 1);
+			/* Add up the lower and upper 32 bit data of the
+			 * 'prod' prod = AE_ADD32_HL_LH(prod, prod); fix
+			 * using saturated addition
+			 */
+			prod = AE_ADD32S(prod, filter01);
 
-		/* Store 'prod' in (de-)interleaved format in the output
-		 * buffers
-		 */
-		AE_S32_L_X(prod, (ae_f32 *)&output_buffers[ch][i], 0);
+			/* Shift with saturation */
+			prod = AE_SLAI32S(prod, 1);
+
+			/* Store 'prod' in (de-)interleaved format in the
+			 * output buffers
+			 */
+			AE_S32_L_X(prod, (ae_f32 *)out, 0);
+			out += stride;
+		}
 	}
 }
 
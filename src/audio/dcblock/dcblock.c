@@ -125,6 +125,7 @@ static void dcblock_free(struct comp_dev *dev)
 	struct comp_data *cd = comp_get_drvdata(dev);
 
 	comp_info(dev, "dcblock_free()");
+	pcm_adapter_free(&cd->adapter);
 	rfree(cd);
 	rfree(dev);
 }
@@ -132,11 +133,32 @@ static void dcblock_free(struct comp_dev *dev)
 static int dcblock_verify_params(struct comp_dev *dev,
 				 struct sof_ipc_stream_params *params)
 {
+	struct comp_buffer *sourceb;
+	struct comp_buffer *sinkb;
+	enum sof_ipc_frame process_fmt;
+	uint32_t buffer_flag;
 	int ret;
 
 	comp_dbg(dev, "dcblock_verify_params()");
 
-	ret = comp_verify_params(dev, 0, params);
+	/* DC Filter component will only ever have one source and sink buffer */
+	sourceb = list_first_item(&dev->bsource_list, struct comp_buffer,
+				  sink_list);
+	sinkb = list_first_item(&dev->bsink_list, struct comp_buffer,
+				source_list);
+
+	/* keep different source and sink frame_fmt's if the format adapter
+	 * can convert them, otherwise both are set to pcm frame_fmt
+	 */
+	process_fmt = dcblock_process_format(sourceb->stream.frame_fmt,
+					     sinkb->stream.frame_fmt);
+	buffer_flag = dcblock_find_func(process_fmt) &&
+		      pcm_adapter_supported(sourceb->stream.frame_fmt,
+					    process_fmt,
+					    sinkb->stream.frame_fmt) ?
+		      BUFF_PARAMS_FRAME_FMT : 0;
+
+	ret = comp_verify_params(dev, buffer_flag, params);
 	if (ret < 0) {
 		comp_err(dev, "dcblock_verify_params() error: comp_verify_params() failed.");
 		return ret;
@@ -272,6 +294,15 @@ static int dcblock_trigger(struct comp_dev *dev, int cmd)
 	return comp_set_state(dev, cmd);
 }
 
+static void dcblock_run(void *ctx, const struct audio_stream *source,
+			struct audio_stream *sink, uint32_t frames)
+{
+	struct comp_dev *dev = ctx;
+	struct comp_data *cd = comp_get_drvdata(dev);
+
+	cd->dcblock_func(dev, source, sink, frames);
+}
+
 static void dcblock_process(struct comp_dev *dev, struct comp_buffer *source,
 			    struct comp_buffer *sink, int frames,
 			    uint32_t source_bytes, uint32_t sink_bytes)
@@ -280,7 +311,8 @@ static void dcblock_process(struct comp_dev *dev, struct comp_buffer *source,
 
 	buffer_invalidate(source, source_bytes);
 
-	cd->dcblock_func(dev, &source->stream, &sink->stream, frames);
+	pcm_adapter_process(&cd->adapter, &source->stream, &sink->stream,
+			    frames, dcblock_run, dev);
 
 	buffer_writeback(sink, sink_bytes);
 
@@ -327,6 +359,7 @@ static int dcblock_prepare(struct comp_dev *dev)
 	struct sof_ipc_comp_config *config = dev_comp_config(dev);
 	struct comp_buffer *sourceb;
 	struct comp_buffer *sinkb;
+	enum sof_ipc_frame process_format;
 	uint32_t sink_period_bytes;
 	int ret;
 
@@ -362,13 +395,23 @@ static int dcblock_prepare(struct comp_dev *dev)
 
 	dcblock_init_state(cd);
 
-	cd->dcblock_func = dcblock_find_func(cd->source_format);
+	process_format = dcblock_process_format(cd->source_format,
+						cd->sink_format);
+	cd->dcblock_func = dcblock_find_func(process_format);
 	if (!cd->dcblock_func) {
 		comp_err(dev, "dcblock_prepare(), No processing function matching frames format");
 		ret = -EINVAL;
 		goto err;
 	}
 
+	ret = pcm_adapter_init(&cd->adapter, cd->source_format,
+			       process_format, cd->sink_format,
+			       sourceb->stream.channels);
+	if (ret < 0) {
+		comp_err(dev, "dcblock_prepare(), format adapter init failed");
+		goto err;
+	}
+
 	comp_info(dev, "dcblock_prepare(), source_format=%d, sink_format=%d",
 		  cd->source_format, cd->sink_format);
 
@@ -386,8 +429,12 @@ err:
  */
 static int dcblock_reset(struct comp_dev *dev)
 {
+	struct comp_data *cd = comp_get_drvdata(dev);
+
 	comp_info(dev, "dcblock_reset()");
 
+	pcm_adapter_free(&cd->adapter);
+
 	comp_set_state(dev, COMP_TRIGGER_RESET);
 	return 0;
 }
@@ -9,118 +9,324 @@
 #include <sof/audio/format.h>
 #include <sof/audio/dcblock/dcblock.h>
 
+#if DCBLOCK_GENERIC
+
 /**
  *
  * Genereric processing function. Input is 32 bits.
  *
  */
-static int32_t dcblock_generic(struct dcblock_state *state,
-			       int64_t R, int32_t x)
+static inline int32_t dcblock_generic(int32_t *x_prev, int32_t *y_prev,
+				      int64_t R, int32_t x)
 {
 	/*
 	 * R: Q2.30, y_prev: Q1.31
 	 * R * y_prev: Q3.61
 	 */
-	int64_t out = ((int64_t)x) - state->x_prev +
-		      Q_SHIFT_RND(R * state->y_prev, 61, 31);
+	int64_t out = ((int64_t)x) - *x_prev +
+		      Q_SHIFT_RND(R * *y_prev, 61, 31);
+
+	*y_prev = sat_int32(out);
+	*x_prev = x;
+
+	return *y_prev;
+}
 
-	state->y_prev = sat_int32(out);
-	state->x_prev = x;
+/*
+ * The channels of interleaved frames are processed as lanes. The filter
+ * states are kept in local arrays for the span so the inner loop over
+ * channels has no dependencies between the lanes. The lanes count is a
+ * compile time constant in the common cases so the compiler can unroll
+ * and vectorize the channels.
+ */
+static inline void dcblock_load_state(struct comp_data *cd, int nch,
+				      int32_t *x_prev, int32_t *y_prev)
+{
+	int ch;
 
-	return state->y_prev;
+	for (ch = 0; ch < nch; ch++) {
+		x_prev[ch] = cd->state[ch].x_prev;
+		y_prev[ch] = cd->state[ch].y_prev;
+	}
+}
+
+static inline void dcblock_store_state(struct comp_data *cd, int nch,
+				       int32_t *x_prev, int32_t *y_prev)
+{
+	int ch;
+
+	for (ch = 0; ch < nch; ch++) {
+		cd->state[ch].x_prev = x_prev[ch];
+		cd->state[ch].y_prev = y_prev[ch];
+	}
 }
 
 #if CONFIG_FORMAT_S16LE
+static inline void dcblock_lanes_s16(const int32_t *R, int32_t *x_prev,
+				     int32_t *y_prev, const int lanes,
+				     const int16_t *x, int16_t *y, int frames)
+{
+	int32_t tmp;
+	int ch;
+	int i;
+
+	for (i = 0; i < frames; i++) {
+		for (ch = 0; ch < lanes; ch++) {
+			tmp = dcblock_generic(&x_prev[ch], &y_prev[ch], R[ch],
+					      x[ch] << 16);
+			y[ch] = sat_int16(Q_SHIFT_RND(tmp, 31, 15));
+		}
+		x += lanes;
+		y += lanes;
+	}
+}
+
+/* Processes a linear span of samples, ch is the channel of the first
+ * sample. Returns the channel of the next sample.
+ */
+static int dcblock_span_s16(struct comp_data *cd, int nch, int ch,
+			    const int16_t *x, int16_t *y, int samples)
+{
+	int32_t x_prev[PLATFORM_MAX_CHANNELS];
+	int32_t y_prev[PLATFORM_MAX_CHANNELS];
+	int32_t tmp;
+	int frames;
+
+	dcblock_load_state(cd, nch, x_prev, y_prev);
+
+	/* Complete a frame split by the buffer wrap */
+	while (ch && samples) {
+		tmp = dcblock_generic(&x_prev[ch], &y_prev[ch],
+				      cd->R_coeffs[ch], *x++ << 16);
+		*y++ = sat_int16(Q_SHIFT_RND(tmp, 31, 15));
+		ch = (ch + 1) % nch;
+		samples--;
+	}
+
+	frames = samples / nch;
+	switch (nch) {
+	case 2:
+		dcblock_lanes_s16(cd->R_coeffs, x_prev, y_prev, 2, x, y,
+				  frames);
+		break;
+	case 4:
+		dcblock_lanes_s16(cd->R_coeffs, x_prev, y_prev, 4, x, y,
+				  frames);
+		break;
+	case 8:
+		dcblock_lanes_s16(cd->R_coeffs, x_prev, y_prev, 8, x, y,
+				  frames);
+		break;
+	default:
+		dcblock_lanes_s16(cd->R_coeffs, x_prev, y_prev, nch, x, y,
+				  frames);
+		break;
+	}
+
+	/* Start of a frame split by the buffer wrap */
+	x += frames * nch;
+	y += frames * nch;
+	samples -= frames * nch;
+	while (samples--) {
+		tmp = dcblock_generic(&x_prev[ch], &y_prev[ch],
+				      cd->R_coeffs[ch], *x++ << 16);
+		*y++ = sat_int16(Q_SHIFT_RND(tmp, 31, 15));
+		ch++;
+	}
+
+	dcblock_store_state(cd, nch, x_prev, y_prev);
+	return ch;
+}
+
 static void dcblock_s16_default(const struct comp_dev *dev,
 				const struct audio_stream *source,
 				const struct audio_stream *sink,
 				uint32_t frames)
 {
 	struct comp_data *cd = comp_get_drvdata(dev);
-	struct dcblock_state *state;
-	int16_t *x;
-	int16_t *y;
-	int32_t R;
+	struct audio_stream_span span;
+	int nch = source->channels;
+	int ch = 0;
+	int n;
+
+	audio_stream_span_init(&span, source, 0, sizeof(int16_t), sink, 0,
+			       sizeof(int16_t), frames * nch);
+	while ((n = audio_stream_span_next(&span)))
+		ch = dcblock_span_s16(cd, nch, ch, span.src, span.snk, n);
+}
+#endif /* CONFIG_FORMAT_S16LE */
+
+#if CONFIG_FORMAT_S24LE
+static inline void dcblock_lanes_s24(const int32_t *R, int32_t *x_prev,
+				     int32_t *y_prev, const int lanes,
+				     const int32_t *x, int32_t *y, int frames)
+{
 	int32_t tmp;
-	int idx;
 	int ch;
 	int i;
-	int nch = source->channels;
 
-	for (ch = 0; ch < nch; ch++) {
-		state = &cd->state[ch];
-		R = cd->R_coeffs[ch];
-		idx = ch;
-		for (i = 0; i < frames; i++) {
-			x = audio_stream_read_frag_s16(source, idx);
-			y = audio_stream_read_frag_s16(sink, idx);
-			tmp = dcblock_generic(state, R, *x << 16);
-			*y = sat_int16(Q_SHIFT_RND(tmp, 31, 15));
-			idx += nch;
+	for (i = 0; i < frames; i++) {
+		for (ch = 0; ch < lanes; ch++) {
+			tmp = dcblock_generic(&x_prev[ch], &y_prev[ch], R[ch],
+					      x[ch] << 8);
+			y[ch] = sat_int24(Q_SHIFT_RND(tmp, 31, 23));
 		}
+		x += lanes;
+		y += lanes;
 	}
 }
-#endif /* CONFIG_FORMAT_S16LE */
 
-#if CONFIG_FORMAT_S24LE
+static int dcblock_span_s24(struct comp_data *cd, int nch, int ch,
+			    const int32_t *x, int32_t *y, int samples)
+{
+	int32_t x_prev[PLATFORM_MAX_CHANNELS];
+	int32_t y_prev[PLATFORM_MAX_CHANNELS];
+	int32_t tmp;
+	int frames;
+
+	dcblock_load_state(cd, nch, x_prev, y_prev);
+
+	while (ch && samples) {
+		tmp = dcblock_generic(&x_prev[ch], &y_prev[ch],
+				      cd->R_coeffs[ch], *x++ << 8);
+		*y++ = sat_int24(Q_SHIFT_RND(tmp, 31, 23));
+		ch = (ch + 1) % nch;
+		samples--;
+	}
+
+	frames = samples / nch;
+	switch (nch) {
+	case 2:
+		dcblock_lanes_s24(cd->R_coeffs, x_prev, y_prev, 2, x, y,
+				  frames);
+		break;
+	case 4:
+		dcblock_lanes_s24(cd->R_coeffs, x_prev, y_prev, 4, x, y,
+				  frames);
+		break;
+	case 8:
+		dcblock_lanes_s24(cd->R_coeffs, x_prev, y_prev, 8, x, y,
+				  frames);
+		break;
+	default:
+		dcblock_lanes_s24(cd->R_coeffs, x_prev, y_prev, nch, x, y,
+				  frames);
+		break;
+	}
+
+	x += frames * nch;
+	y += frames * nch;
+	samples -= frames * nch;
+	while (samples--) {
+		tmp = dcblock_generic(&x_prev[ch], &y_prev[ch],
+				      cd->R_coeffs[ch], *x++ << 8);
+		*y++ = sat_int24(Q_SHIFT_RND(tmp, 31, 23));
+		ch++;
+	}
+
+	dcblock_store_state(cd, nch, x_prev, y_prev);
+	return ch;
+}
+
 static void dcblock_s24_default(const struct comp_dev *dev,
 				const struct audio_stream *source,
 				const struct audio_stream *sink,
 				uint32_t frames)
 {
 	struct comp_data *cd = comp_get_drvdata(dev);
-	struct dcblock_state *state;
-	int32_t *x;
-	int32_t *y;
-	int32_t R;
-	int32_t tmp;
-	int idx;
-	int ch;
-	int i;
+	struct audio_stream_span span;
 	int nch = source->channels;
+	int ch = 0;
+	int n;
 
-	for (ch = 0; ch < nch; ch++) {
-		state = &cd->state[ch];
-		R = cd->R_coeffs[ch];
-		idx = ch;
-		for (i = 0; i < frames; i++) {
-			x = audio_stream_read_frag_s32(source, idx);
-			y = audio_stream_read_frag_s32(sink, idx);
-			tmp = dcblock_generic(state, R, *x << 8);
-			*y = sat_int24(Q_SHIFT_RND(tmp, 31, 23));
-			idx += nch;
-		}
-	}
+	audio_stream_span_init(&span, source, 0, sizeof(int32_t), sink, 0,
+			       sizeof(int32_t), frames * nch);
+	while ((n = audio_stream_span_next(&span)))
+		ch = dcblock_span_s24(cd, nch, ch, span.src, span.snk, n);
 }
 #endif /* CONFIG_FORMAT_S24LE */
 
 #if CONFIG_FORMAT_S32LE
+static inline void dcblock_lanes_s32(const int32_t *R, int32_t *x_prev,
+				     int32_t *y_prev, const int lanes,
+				     const int32_t *x, int32_t *y, int frames)
+{
+	int ch;
+	int i;
+
+	for (i = 0; i < frames; i++) {
+		for (ch = 0; ch < lanes; ch++)
+			y[ch] = dcblock_generic(&x_prev[ch], &y_prev[ch],
+						R[ch], x[ch]);
+		x += lanes;
+		y += lanes;
+	}
+}
+
+static int dcblock_span_s32(struct comp_data *cd, int nch, int ch,
+			    const int32_t *x, int32_t *y, int samples)
+{
+	int32_t x_prev[PLATFORM_MAX_CHANNELS];
+	int32_t y_prev[PLATFORM_MAX_CHANNELS];
+	int frames;
+
+	dcblock_load_state(cd, nch, x_prev, y_prev);
+
+	while (ch && samples) {
+		*y++ = dcblock_generic(&x_prev[ch], &y_prev[ch],
+				       cd->R_coeffs[ch], *x++);
+		ch = (ch + 1) % nch;
+		samples--;
+	}
+
+	frames = samples / nch;
+	switch (nch) {
+	case 2:
+		dcblock_lanes_s32(cd->R_coeffs, x_prev, y_prev, 2, x, y,
+				  frames);
+		break;
+	case 4:
+		dcblock_lanes_s32(cd->R_coeffs, x_prev, y_prev, 4, x, y,
+				  frames);
+		break;
+	case 8:
+		dcblock_lanes_s32(cd->R_coeffs, x_prev, y_prev, 8, x, y,
+				  frames);
+		break;
+	default:
+		dcblock_lanes_s32(cd->R_coeffs, x_prev, y_prev, nch, x, y,
+				  frames);
+		break;
+	}
+
+	x += frames * nch;
+	y += frames * nch;
+	samples -= frames * nch;
+	while (samples--) {
+		*y++ = dcblock_generic(&x_prev[ch], &y_prev[ch],
+				       cd->R_coeffs[ch], *x++);
+		ch++;
+	}
+
+	dcblock_store_state(cd, nch, x_prev, y_prev);
+	return ch;
+}
+
 static void dcblock_s32_default(const struct comp_dev *dev,
 				const struct audio_stream *source,
 				const struct audio_stream *sink,
 				uint32_t frames)
 {
 	struct comp_data *cd = comp_get_drvdata(dev);
-	struct dcblock_state *state;
-	int32_t *x;
-	int32_t *y;
-	int32_t R;
-	int idx;
-	int ch;
-	int i;
+	struct audio_stream_span span;
 	int nch = source->channels;
+	int ch = 0;
+	int n;
 
-	for (ch = 0; ch < nch; ch++) {
-		state = &cd->state[ch];
-		R = cd->R_coeffs[ch];
-		idx = ch;
-		for (i = 0; i < frames; i++) {
-			x = audio_stream_read_frag_s32(source, idx);
-			y = audio_stream_read_frag_s32(sink, idx);
-			*y = dcblock_generic(state, R, *x);
-			idx += nch;
-		}
-	}
+	audio_stream_span_init(&span, source, 0, sizeof(int32_t), sink, 0,
+			       sizeof(int32_t), frames * nch);
+	while ((n = audio_stream_span_next(&span)))
+		ch = dcblock_span_s32(cd, nch, ch, span.src, span.snk, n);
 }
 #endif /* CONFIG_FORMAT_S32LE */
 
@@ -138,3 +344,5 @@ const struct dcblock_func_map dcblock_fnmap[] = {
 };
 
 const size_t dcblock_fncount = ARRAY_SIZE(dcblock_fnmap);
+
+#endif /* DCBLOCK_GENERIC */
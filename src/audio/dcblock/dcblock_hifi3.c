@@ -0,0 +1,238 @@
+// SPDX-License-Identifier: BSD-3-Clause
+//
+// Copyright(c) 2020 Intel Corporation. All rights reserved.
+
+#include <stdint.h>
+#include <sof/audio/component.h>
+#include <sof/audio/format.h>
+#include <sof/audio/dcblock/dcblock.h>
+
+#if DCBLOCK_HIFI3
+
+#include <xtensa/tie/xt_hifi3.h>
+
+/*
+ * Two channels are processed at a time, the filter states of a channel
+ * pair are kept in the high and low lanes of the HiFi3 registers. With an
+ * odd number of channels the last channel is duplicated to both lanes, the
+ * loads and stores then access the same sample twice.
+ */
+
+static void dcblock_setup_circular(const struct audio_stream *buffer)
+{
+	AE_SETCBEGIN0(buffer->addr);
+	AE_SETCEND0(buffer->end_addr);
+}
+
+static inline void dcblock_load_state(struct comp_data *cd, int ch, int ch2,
+				      ae_int32x2 *R, ae_int32x2 *x_prev,
+				      ae_int32x2 *y_prev)
+{
+	*R = AE_MOVDA32X2(cd->R_coeffs[ch], cd->R_coeffs[ch2]);
+	*x_prev = AE_MOVDA32X2(cd->state[ch].x_prev, cd->state[ch2].x_prev);
+	*y_prev = AE_MOVDA32X2(cd->state[ch].y_prev, cd->state[ch2].y_prev);
+}
+
+static inline void dcblock_store_state(struct comp_data *cd, int ch, int ch2,
+				       ae_int32x2 x_prev, ae_int32x2 y_prev)
+{
+	cd->state[ch].x_prev = AE_MOVAD32_H(x_prev);
+	cd->state[ch].y_prev = AE_MOVAD32_H(y_prev);
+	cd->state[ch2].x_prev = AE_MOVAD32_L(x_prev);
+	cd->state[ch2].y_prev = AE_MOVAD32_L(y_prev);
+}
+
+/**
+ *
+ * Processing of two channels. Input is Q1.31 and R is Q2.30. The
+ * arithmetic matches the generic version bit exactly, the products are
+ * accumulated without rounding in Q3.61 and the result is rounded half
+ * up and saturated once to Q1.31.
+ *
+ */
+static inline ae_int32x2 dcblock_hifi3(ae_int32x2 R, ae_int32x2 *x_prev,
+				       ae_int32x2 *y_prev, ae_int32x2 x)
+{
+	ae_int32x2 one = AE_MOVDA32(ONE_Q2_30);
+	ae_int64 acc_h;
+	ae_int64 acc_l;
+
+	/* Q2.30 x Q1.31 -> Q3.61 */
+	acc_h = AE_MUL32_HH(R, *y_prev);
+	AE_MULA32_HH(acc_h, one, x);
+	AE_MULS32_HH(acc_h, one, *x_prev);
+	acc_l = AE_MUL32_LL(R, *y_prev);
+	AE_MULA32_LL(acc_l, one, x);
+	AE_MULS32_LL(acc_l, one, *x_prev);
+
+	/* Convert to Q1.63 with saturation, round and saturate to Q1.31 */
+	acc_h = AE_SLAI64S(acc_h, 2);
+	acc_l = AE_SLAI64S(acc_l, 2);
+	*y_prev = AE_ROUND32X2F64SASYM(acc_h, acc_l);
+	*x_prev = x;
+
+	return *y_prev;
+}
+
+#if CONFIG_FORMAT_S16LE
+static void dcblock_s16_default(const struct comp_dev *dev,
+				const struct audio_stream *source,
+				const struct audio_stream *sink,
+				uint32_t frames)
+{
+	struct comp_data *cd = comp_get_drvdata(dev);
+	ae_int16 *in;
+	ae_int16 *out;
+	ae_int16x4 in0;
+	ae_int16x4 in1;
+	ae_int16x4 sample;
+	ae_int32x2 R;
+	ae_int32x2 x_prev;
+	ae_int32x2 y_prev;
+	ae_int32x2 y;
+	int nch = source->channels;
+	int inc0;
+	int inc1;
+	int ch2;
+	int ch;
+	int i;
+
+	for (ch = 0; ch < nch; ch += 2) {
+		ch2 = MIN(ch + 1, nch - 1);
+		inc0 = (ch2 - ch) * sizeof(ae_int16);
+		inc1 = nch * sizeof(ae_int16) - inc0;
+		in = (ae_int16 *)audio_stream_read_frag_s16(source, ch);
+		out = (ae_int16 *)audio_stream_write_frag_s16(sink, ch);
+		dcblock_load_state(cd, ch, ch2, &R, &x_prev, &y_prev);
+		for (i = 0; i < frames; i++) {
+			dcblock_setup_circular(source);
+			AE_L16_XC(in0, in, inc0);
+			AE_L16_XC(in1, in, inc1);
+
+			y = dcblock_hifi3(R, &x_prev, &y_prev,
+					  AE_SEL32_HH(AE_CVT32X2F16_32(in0),
+						      AE_CVT32X2F16_32(in1)));
+
+			sample = AE_ROUND16X4F32SASYM(y, y);
+			dcblock_setup_circular(sink);
+			AE_S16_0_XC(AE_MOVAD16_1(sample), out, inc0);
+			AE_S16_0_XC(AE_MOVAD16_0(sample), out, inc1);
+		}
+		dcblock_store_state(cd, ch, ch2, x_prev, y_prev);
+	}
+}
+#endif /* CONFIG_FORMAT_S16LE */
+
+#if CONFIG_FORMAT_S24LE
+static void dcblock_s24_default(const struct comp_dev *dev,
+				const struct audio_stream *source,
+				const struct audio_stream *sink,
+				uint32_t frames)
+{
+	struct comp_data *cd = comp_get_drvdata(dev);
+	ae_int32 *in;
+	ae_int32 *out;
+	ae_int32x2 in0;
+	ae_int32x2 in1;
+	ae_int32x2 R;
+	ae_int32x2 x_prev;
+	ae_int32x2 y_prev;
+	ae_int32x2 y;
+	int nch = source->channels;
+	int inc0;
+	int inc1;
+	int ch2;
+	int ch;
+	int i;
+
+	for (ch = 0; ch < nch; ch += 2) {
+		ch2 = MIN(ch + 1, nch - 1);
+		inc0 = (ch2 - ch) * sizeof(ae_int32);
+		inc1 = nch * sizeof(ae_int32) - inc0;
+		in = (ae_int32 *)audio_stream_read_frag_s32(source, ch);
+		out = (ae_int32 *)audio_stream_write_frag_s32(sink, ch);
+		dcblock_load_state(cd, ch, ch2, &R, &x_prev, &y_prev);
+		for (i = 0; i < frames; i++) {
+			dcblock_setup_circular(source);
+			AE_L32_XC(in0, in, inc0);
+			AE_L32_XC(in1, in, inc1);
+
+			y = dcblock_hifi3(R, &x_prev, &y_prev,
+					  AE_SLAI32(AE_SEL32_HH(in0, in1), 8));
+
+			/* Shift with round half up and saturation to S24_LE */
+			y = AE_SRAI32R(y, 8);
+			y = AE_SLAI32S(y, 8);
+			y = AE_SRAI32(y, 8);
+
+			dcblock_setup_circular(sink);
+			AE_S32_L_XC(AE_SEL32_HH(y, y), out, inc0);
+			AE_S32_L_XC(y, out, inc1);
+		}
+		dcblock_store_state(cd, ch, ch2, x_prev, y_prev);
+	}
+}
+#endif /* CONFIG_FORMAT_S24LE */
+
+#if CONFIG_FORMAT_S32LE
+static void dcblock_s32_default(const struct comp_dev *dev,
+				const struct audio_stream *source,
+				const struct audio_stream *sink,
+				uint32_t frames)
+{
+	struct comp_data *cd = comp_get_drvdata(dev);
+	ae_int32 *in;
+	ae_int32 *out;
+	ae_int32x2 in0;
+	ae_int32x2 in1;
+	ae_int32x2 R;
+	ae_int32x2 x_prev;
+	ae_int32x2 y_prev;
+	ae_int32x2 y;
+	int nch = source->channels;
+	int inc0;
+	int inc1;
+	int ch2;
+	int ch;
+	int i;
+
+	for (ch = 0; ch < nch; ch += 2) {
+		ch2 = MIN(ch + 1, nch - 1);
+		inc0 = (ch2 - ch) * sizeof(ae_int32);
+		inc1 = nch * sizeof(ae_int32) - inc0;
+		in = (ae_int32 *)audio_stream_read_frag_s32(source, ch);
+		out = (ae_int32 *)audio_stream_write_frag_s32(sink, ch);
+		dcblock_load_state(cd, ch, ch2, &R, &x_prev, &y_prev);
+		for (i = 0; i < frames; i++) {
+			dcblock_setup_circular(source);
+			AE_L32_XC(in0, in, inc0);
+			AE_L32_XC(in1, in, inc1);
+
+			y = dcblock_hifi3(R, &x_prev, &y_prev,
+					  AE_SEL32_HH(in0, in1));
+
+			dcblock_setup_circular(sink);
+			AE_S32_L_XC(AE_SEL32_HH(y, y), out, inc0);
+			AE_S32_L_XC(y, out, inc1);
+		}
+		dcblock_store_state(cd, ch, ch2, x_prev, y_prev);
+	}
+}
+#endif /* CONFIG_FORMAT_S32LE */
+
+const struct dcblock_func_map dcblock_fnmap[] = {
+/* { SOURCE_FORMAT , PROCESSING FUNCTION } */
+#if CONFIG_FORMAT_S16LE
+	{ SOF_IPC_FRAME_S16_LE, dcblock_s16_default },
+#endif /* CONFIG_FORMAT_S16LE */
+#if CONFIG_FORMAT_S24LE
+	{ SOF_IPC_FRAME_S24_4LE, dcblock_s24_default },
+#endif /* CONFIG_FORMAT_S24LE */
+#if CONFIG_FORMAT_S32LE
+	{ SOF_IPC_FRAME_S32_LE, dcblock_s32_default },
+#endif /* CONFIG_FORMAT_S32LE */
+};
+
+const size_t dcblock_fncount = ARRAY_SIZE(dcblock_fnmap);
+
+#endif /* DCBLOCK_HIFI3 */
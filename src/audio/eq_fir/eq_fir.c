@@ -9,6 +9,7 @@
 #include <sof/audio/buffer.h>
 #include <sof/audio/component.h>
 #include <sof/audio/eq_fir/fir_config.h>
+#include <sof/audio/pcm_converter.h>
 #include <sof/audio/pipeline.h>
 #include <sof/common.h>
 #include <sof/debug/panic.h>
@@ -27,6 +28,7 @@
 #include <user/eq.h>
 #include <user/trace.h>
 #include <errno.h>
+#include <stdbool.h>
 #include <stddef.h>
 #include <stdint.h>
 
@@ -53,13 +55,21 @@ DECLARE_TR_CTX(eq_fir_tr, SOF_UUID(eq_fir_uuid), LOG_LEVEL_INFO);
 /* src component private data */
 struct comp_data {
 	struct fir_state_32x16 fir[PLATFORM_MAX_CHANNELS]; /**< filters state */
+#if FIR_FFT
+	struct fir_fft_state fft[PLATFORM_MAX_CHANNELS]; /**< FFT filters */
+#endif
 	struct sof_eq_fir_config *config;	/**< pointer to setup blob */
 	struct sof_eq_fir_config *config_new;	/**< pointer to new setup */
 	enum sof_ipc_frame source_format;	/**< source frame format */
 	enum sof_ipc_frame sink_format;		/**< sink frame format */
+	enum sof_ipc_frame process_format;	/**< processing frame format */
+	struct pcm_adapter adapter;	/**< source and sink format adapter */
 	int32_t *fir_delay;			/**< pointer to allocated RAM */
 	size_t fir_delay_size;			/**< allocated size */
 	bool config_ready;			/**< set when fully received */
+#if FIR_LANES
+	bool fir_lanes;				/**< channels share filter */
+#endif
 	void (*eq_fir_func)(struct fir_state_32x16 fir[],
 			    const struct audio_stream *source,
 			    struct audio_stream *sink,
@@ -115,19 +125,37 @@ static inline void set_s32_fir(struct comp_data *cd)
 #if CONFIG_FORMAT_S16LE
 static inline void set_s16_fir(struct comp_data *cd)
 {
-	cd->eq_fir_func = eq_fir_s16;
+#if FIR_LANES
+	if (cd->fir_lanes) {
+		cd->eq_fir_func = eq_fir_lanes_s16;
+		return;
+	}
+#endif
+	cd->eq_fir_func = eq_fir_4x_s16;
 }
 #endif /* CONFIG_FORMAT_S16LE */
 #if CONFIG_FORMAT_S24LE
 static inline void set_s24_fir(struct comp_data *cd)
 {
-	cd->eq_fir_func = eq_fir_s24;
+#if FIR_LANES
+	if (cd->fir_lanes) {
+		cd->eq_fir_func = eq_fir_lanes_s24;
+		return;
+	}
+#endif
+	cd->eq_fir_func = eq_fir_4x_s24;
 }
 #endif /* CONFIG_FORMAT_S24LE */
 #if CONFIG_FORMAT_S32LE
 static inline void set_s32_fir(struct comp_data *cd)
 {
-	cd->eq_fir_func = eq_fir_s32;
+#if FIR_LANES
+	if (cd->fir_lanes) {
+		cd->eq_fir_func = eq_fir_lanes_s32;
+		return;
+	}
+#endif
+	cd->eq_fir_func = eq_fir_4x_s32;
 }
 #endif /* CONFIG_FORMAT_S32LE */
 #endif
@@ -135,12 +163,8 @@ static inline void set_s32_fir(struct comp_data *cd)
 static inline int set_fir_func(struct comp_dev *dev)
 {
 	struct comp_data *cd = comp_get_drvdata(dev);
-	struct comp_buffer *sourceb;
-
-	sourceb = list_first_item(&dev->bsource_list, struct comp_buffer,
-				  sink_list);
 
-	switch (sourceb->stream.frame_fmt) {
+	switch (cd->process_format) {
 #if CONFIG_FORMAT_S16LE
 	case SOF_IPC_FRAME_S16_LE:
 		comp_info(dev, "set_fir_func(), SOF_IPC_FRAME_S16_LE");
@@ -195,12 +219,8 @@ static void eq_fir_s32_passthrough(struct fir_state_32x16 fir[],
 static inline int set_pass_func(struct comp_dev *dev)
 {
 	struct comp_data *cd = comp_get_drvdata(dev);
-	struct comp_buffer *sourceb;
 
-	sourceb = list_first_item(&dev->bsource_list, struct comp_buffer,
-				  sink_list);
-
-	switch (sourceb->stream.frame_fmt) {
+	switch (cd->process_format) {
 #if CONFIG_FORMAT_S16LE
 	case SOF_IPC_FRAME_S16_LE:
 		comp_info(dev, "set_pass_func(), SOF_IPC_FRAME_S16_LE");
@@ -221,6 +241,36 @@ static inline int set_pass_func(struct comp_dev *dev)
 	return 0;
 }
 
+/* Checks if there are processing functions for the frame format */
+static bool eq_fir_format_supported(enum sof_ipc_frame frame_fmt)
+{
+	switch (frame_fmt) {
+#if CONFIG_FORMAT_S16LE
+	case SOF_IPC_FRAME_S16_LE:
+		return true;
+#endif /* CONFIG_FORMAT_S16LE */
+#if CONFIG_FORMAT_S24LE
+	case SOF_IPC_FRAME_S24_4LE:
+		return true;
+#endif /* CONFIG_FORMAT_S24LE */
+#if CONFIG_FORMAT_S32LE
+	case SOF_IPC_FRAME_S32_LE:
+		return true;
+#endif /* CONFIG_FORMAT_S32LE */
+	default:
+		return false;
+	}
+}
+
+/* The source format is preferred for processing to keep its precision,
+ * other formats are handled by the format adapter.
+ */
+static enum sof_ipc_frame eq_fir_process_format(enum sof_ipc_frame src_fmt,
+						enum sof_ipc_frame sink_fmt)
+{
+	return eq_fir_format_supported(src_fmt) ? src_fmt : sink_fmt;
+}
+
 /*
  * EQ control code is next. The processing is in fir_ C modules.
  */
@@ -242,8 +292,15 @@ static void eq_fir_free_delaylines(struct comp_data *cd)
 	rfree(cd->fir_delay);
 	cd->fir_delay = NULL;
 	cd->fir_delay_size = 0;
-	for (i = 0; i < PLATFORM_MAX_CHANNELS; i++)
+#if FIR_LANES
+	cd->fir_lanes = false;
+#endif
+	for (i = 0; i < PLATFORM_MAX_CHANNELS; i++) {
 		fir[i].delay = NULL;
+#if FIR_FFT
+		fir[i].fft = NULL;
+#endif
+	}
 }
 
 static int eq_fir_init_coef(struct sof_eq_fir_config *config,
@@ -357,9 +414,57 @@ static void eq_fir_init_delay(struct fir_state_32x16 *fir,
 	}
 }
 
+#if FIR_FFT
+/* All channels are run with FFT convolution to have the same delay if
+ * any of the channels has a response long enough for it.
+ */
+static bool eq_fir_fft_mode(struct fir_state_32x16 *fir, int nch)
+{
+	int i;
+
+	for (i = 0; i < nch; i++) {
+		if (fir[i].taps >= FIR_FFT_MIN_TAPS)
+			return true;
+	}
+
+	return false;
+}
+
+static int eq_fir_fft_size(struct fir_state_32x16 *fir, int nch)
+{
+	int size = sizeof(struct fir_fft_work);
+	int i;
+
+	for (i = 0; i < nch; i++)
+		size += fir_fft_delay_size(&fir[i]);
+
+	return size;
+}
+
+static void eq_fir_init_fft(struct comp_data *cd, int nch)
+{
+	struct fir_fft_work *work = (struct fir_fft_work *)cd->fir_delay;
+	int32_t *data = (int32_t *)(work + 1);
+	int i;
+
+	/* The FFT work area is followed by channels data */
+	fir_fft_init_work(work);
+	for (i = 0; i < nch; i++) {
+		fir_fft_init(&cd->fft[i], &cd->fir[i], work, &data);
+		cd->fir[i].fft = &cd->fft[i];
+	}
+}
+#endif
+
 static int eq_fir_setup(struct comp_data *cd, int nch)
 {
+#if FIR_LANES
+	int32_t *fir_delay;
+#endif
 	int delay_size;
+#if FIR_FFT
+	bool fft_mode;
+#endif
 
 	/* Free existing FIR channels data if it was allocated */
 	eq_fir_free_delaylines(cd);
@@ -369,6 +474,14 @@ static int eq_fir_setup(struct comp_data *cd, int nch)
 	if (delay_size < 0)
 		return delay_size; /* Contains error code */
 
+#if FIR_FFT
+	fft_mode = eq_fir_fft_mode(cd->fir, nch);
+	if (fft_mode) {
+		delay_size = eq_fir_fft_size(cd->fir, nch);
+		comp_cl_info(&comp_eq_fir, "eq_fir_setup(), FFT convolution mode");
+	}
+#endif
+
 	/* If all channels were set to bypass there's no need to
 	 * allocate delay. Just return with success.
 	 */
@@ -386,6 +499,25 @@ static int eq_fir_setup(struct comp_data *cd, int nch)
 	memset(cd->fir_delay, 0, delay_size);
 	cd->fir_delay_size = delay_size;
 
+#if FIR_FFT
+	if (fft_mode) {
+		eq_fir_init_fft(cd, nch);
+		return 0;
+	}
+#endif
+
+#if FIR_LANES
+	/* Channels with the same response are filtered together */
+	cd->fir_lanes = fir_lanes_ok(cd->fir, nch);
+	if (cd->fir_lanes) {
+		fir_delay = cd->fir_delay;
+		fir_init_delay_lanes(cd->fir, nch, &fir_delay);
+		comp_cl_info(&comp_eq_fir, "eq_fir_setup(), %d channels share filter",
+			     nch);
+		return 0;
+	}
+#endif
+
 	/* Assign delay line to each channel EQ */
 	eq_fir_init_delay(cd->fir, cd->fir_delay, nch);
 	return 0;
@@ -412,8 +544,8 @@ static struct comp_dev *eq_fir_new(const struct comp_driver *drv,
 	/* Check first before proceeding with dev and cd that coefficients
 	 * blob size is sane.
 	 */
-	if (bs > SOF_EQ_FIR_MAX_SIZE) {
-		comp_cl_err(&comp_eq_fir, "eq_fir_new(): coefficients blob size = %u > SOF_EQ_FIR_MAX_SIZE",
+	if (bs > FIR_MAX_SIZE) {
+		comp_cl_err(&comp_eq_fir, "eq_fir_new(): coefficients blob size = %u > FIR_MAX_SIZE",
 			    bs);
 		return NULL;
 	}
@@ -474,6 +606,7 @@ static void eq_fir_free(struct comp_dev *dev)
 	eq_fir_free_delaylines(cd);
 	eq_fir_free_parameters(&cd->config);
 	eq_fir_free_parameters(&cd->config_new);
+	pcm_adapter_free(&cd->adapter);
 
 	rfree(cd);
 	rfree(dev);
@@ -558,9 +691,9 @@ static int fir_cmd_set_data(struct comp_dev *dev,
 			size = cdata->num_elems + cdata->elems_remaining;
 			comp_info(dev, "fir_cmd_set_data(), allocating %d for configuration blob",
 				  size);
-			if (size > SOF_EQ_FIR_MAX_SIZE) {
+			if (size > FIR_MAX_SIZE) {
 				comp_err(dev, "fir_cmd_set_data(), size exceeds %d",
-					 SOF_EQ_FIR_MAX_SIZE);
+					 FIR_MAX_SIZE);
 				return -EINVAL;
 			}
 
@@ -646,6 +779,58 @@ static int eq_fir_cmd(struct comp_dev *dev, int cmd, void *data,
 	return ret;
 }
 
+static int eq_fir_verify_params(struct comp_dev *dev,
+				struct sof_ipc_stream_params *params)
+{
+	struct comp_buffer *sourceb;
+	struct comp_buffer *sinkb;
+	enum sof_ipc_frame process_fmt;
+	uint32_t buffer_flag;
+	int ret;
+
+	comp_dbg(dev, "eq_fir_verify_params()");
+
+	sourceb = list_first_item(&dev->bsource_list, struct comp_buffer,
+				  sink_list);
+	sinkb = list_first_item(&dev->bsink_list, struct comp_buffer,
+				source_list);
+
+	/* keep different source and sink frame_fmt's if the format adapter
+	 * can convert them, otherwise both are set to pcm frame_fmt
+	 */
+	process_fmt = eq_fir_process_format(sourceb->stream.frame_fmt,
+					    sinkb->stream.frame_fmt);
+	buffer_flag = eq_fir_format_supported(process_fmt) &&
+		      pcm_adapter_supported(sourceb->stream.frame_fmt,
+					    process_fmt,
+					    sinkb->stream.frame_fmt) ?
+		      BUFF_PARAMS_FRAME_FMT : 0;
+
+	ret = comp_verify_params(dev, buffer_flag, params);
+	if (ret < 0) {
+		comp_err(dev, "eq_fir_verify_params(): comp_verify_params() failed.");
+		return ret;
+	}
+
+	return 0;
+}
+
+static int eq_fir_params(struct comp_dev *dev,
+			 struct sof_ipc_stream_params *params)
+{
+	int err;
+
+	comp_info(dev, "eq_fir_params()");
+
+	err = eq_fir_verify_params(dev, params);
+	if (err < 0) {
+		comp_err(dev, "eq_fir_params(): pcm params verification failed.");
+		return -EINVAL;
+	}
+
+	return 0;
+}
+
 static int eq_fir_trigger(struct comp_dev *dev, int cmd)
 {
 	struct comp_data *cd = comp_get_drvdata(dev);
@@ -658,6 +843,16 @@ static int eq_fir_trigger(struct comp_dev *dev, int cmd)
 	return comp_set_state(dev, cmd);
 }
 
+/* FIR processing function called through the format adapter */
+static void eq_fir_run(void *ctx, const struct audio_stream *source,
+		       struct audio_stream *sink, uint32_t frames)
+{
+	struct comp_dev *dev = ctx;
+	struct comp_data *cd = comp_get_drvdata(dev);
+
+	cd->eq_fir_func(cd->fir, source, sink, frames, source->channels);
+}
+
 static void eq_fir_process(struct comp_dev *dev, struct comp_buffer *source,
 			   struct comp_buffer *sink, int frames,
 			   uint32_t source_bytes, uint32_t sink_bytes)
@@ -666,8 +861,11 @@ static void eq_fir_process(struct comp_dev *dev, struct comp_buffer *source,
 
 	buffer_invalidate(source, source_bytes);
 
-	cd->eq_fir_func(cd->fir, &source->stream, &sink->stream, frames,
-			source->stream.channels);
+	/* The adapter blocks are even numbers of frames as needed by the
+	 * FIR functions.
+	 */
+	pcm_adapter_process(&cd->adapter, &source->stream, &sink->stream,
+			    frames, eq_fir_run, dev);
 
 	buffer_writeback(sink, sink_bytes);
 
@@ -701,6 +899,11 @@ static int eq_fir_copy(struct comp_dev *dev)
 			comp_err(dev, "eq_fir_copy(), failed FIR setup");
 			return ret;
 		}
+
+		/* The processing function depends on the setup */
+		ret = set_fir_func(dev);
+		if (ret < 0)
+			return ret;
 	}
 
 	sinkb = list_first_item(&dev->bsink_list, struct comp_buffer,
@@ -767,6 +970,16 @@ static int eq_fir_prepare(struct comp_dev *dev)
 		goto err;
 	}
 
+	cd->process_format = eq_fir_process_format(cd->source_format,
+						   cd->sink_format);
+	ret = pcm_adapter_init(&cd->adapter, cd->source_format,
+			       cd->process_format, cd->sink_format,
+			       sourceb->stream.channels);
+	if (ret < 0) {
+		comp_err(dev, "eq_fir_prepare(): format adapter init failed");
+		goto err;
+	}
+
 	/* Initialize EQ */
 	if (cd->config && cd->config_ready) {
 		ret = eq_fir_setup(cd, sourceb->stream.channels);
@@ -795,6 +1008,7 @@ static int eq_fir_reset(struct comp_dev *dev)
 	comp_info(dev, "eq_fir_reset()");
 
 	eq_fir_free_delaylines(cd);
+	pcm_adapter_free(&cd->adapter);
 
 	cd->eq_fir_func = NULL;
 	for (i = 0; i < PLATFORM_MAX_CHANNELS; i++)
@@ -811,6 +1025,7 @@ static const struct comp_driver comp_eq_fir = {
 	.ops = {
 		.create = eq_fir_new,
 		.free = eq_fir_free,
+		.params = eq_fir_params,
 		.cmd = eq_fir_cmd,
 		.trigger = eq_fir_trigger,
 		.copy = eq_fir_copy,
@@ -16,6 +16,7 @@
 #include <sof/audio/format.h>
 #include <user/eq.h>
 #include <errno.h>
+#include <stdbool.h>
 #include <stddef.h>
 #include <stdint.h>
 
@@ -26,9 +27,13 @@
 void fir_reset(struct fir_state_32x16 *fir)
 {
 	fir->rwi = 0;
+	fir->taps = 0;
 	fir->length = 0;
 	fir->out_shift = 0;
 	fir->coef = NULL;
+#if FIR_FFT
+	fir->fft = NULL;
+#endif
 	/* There may need to know the beginning of dynamic allocation after
 	 * reset so omitting setting also fir->delay to NULL.
 	 */
@@ -39,20 +44,24 @@ int fir_delay_size(struct sof_eq_fir_coef_data *config)
 	/* Check for sane FIR length. The generic version does not
 	 * have other constraints.
 	 */
-	if (config->length > SOF_EQ_FIR_MAX_LENGTH || config->length < 1)
+	if (config->length > FIR_MAX_LENGTH || config->length < 1)
 		return -EINVAL;
 
-	return config->length * sizeof(int32_t);
+	/* The multiple samples versions need more delay entries */
+	return (config->length + FIR_32X16_SAMPLES_MAX - 1) * sizeof(int32_t);
 }
 
 int fir_init_coef(struct fir_state_32x16 *fir,
 		  struct sof_eq_fir_coef_data *config)
 {
 	fir->rwi = 0;
-	fir->length = (int)config->length;
-	fir->taps = fir->length; /* The same for generic C version */
+	fir->taps = (int)config->length;
+	fir->length = fir->taps + FIR_32X16_SAMPLES_MAX - 1;
 	fir->out_shift = (int)config->out_shift;
 	fir->coef = ASSUME_ALIGNED(&config->coef[0], 4);
+#if FIR_FFT
+	fir->fft = NULL;
+#endif
 	return 0;
 }
 
@@ -63,79 +72,323 @@ void fir_init_delay(struct fir_state_32x16 *fir, int32_t **data)
 }
 
 #if CONFIG_FORMAT_S16LE
-void eq_fir_s16(struct fir_state_32x16 fir[], const struct audio_stream *source,
-		struct audio_stream *sink, int frames, int nch)
+/* For even frame counts use FIR filter that processes four sequential
+ * samples per call and the two samples version for the remainder.
+ */
+void eq_fir_4x_s16(struct fir_state_32x16 fir[],
+		   const struct audio_stream *source,
+		   struct audio_stream *sink, int frames, int nch)
 {
 	struct fir_state_32x16 *filter;
 	int16_t *x;
 	int16_t *y;
-	int32_t z;
-	int idx;
+	int32_t in[4];
+	int32_t out[4];
+	int ri;
+	int wi;
 	int ch;
 	int i;
+	int j;
 
 	for (ch = 0; ch < nch; ch++) {
 		filter = &fir[ch];
-		idx = ch;
-		for (i = 0; i < frames; i++) {
-			x = audio_stream_read_frag_s16(source, idx);
-			y = audio_stream_write_frag_s16(sink, idx);
-			z = fir_32x16(filter, *x << 16);
-			*y = sat_int16(Q_SHIFT_RND(z, 31, 15));
-			idx += nch;
+		ri = ch;
+		wi = ch;
+		for (i = 0; i + 4 <= frames; i += 4) {
+			for (j = 0; j < 4; j++) {
+				x = audio_stream_read_frag_s16(source, ri);
+				in[j] = *x << 16;
+				ri += nch;
+			}
+
+			fir_filter_4x(filter, in[0], in[1], in[2], in[3],
+				      &out[0], &out[1], &out[2], &out[3]);
+			for (j = 0; j < 4; j++) {
+				y = audio_stream_write_frag_s16(sink, wi);
+				*y = sat_int16(Q_SHIFT_RND(out[j], 31, 15));
+				wi += nch;
+			}
+		}
+
+		if (i == frames)
+			continue;
+
+		for (j = 0; j < 2; j++) {
+			x = audio_stream_read_frag_s16(source, ri);
+			in[j] = *x << 16;
+			ri += nch;
+		}
+
+		fir_filter_2x(filter, in[0], in[1], &out[0], &out[1]);
+		for (j = 0; j < 2; j++) {
+			y = audio_stream_write_frag_s16(sink, wi);
+			*y = sat_int16(Q_SHIFT_RND(out[j], 31, 15));
+			wi += nch;
 		}
 	}
 }
 #endif /* CONFIG_FORMAT_S16LE */
 
 #if CONFIG_FORMAT_S24LE
-void eq_fir_s24(struct fir_state_32x16 fir[], const struct audio_stream *source,
-		struct audio_stream *sink, int frames, int nch)
+/* For even frame counts use FIR filter that processes four sequential
+ * samples per call and the two samples version for the remainder.
+ */
+void eq_fir_4x_s24(struct fir_state_32x16 fir[],
+		   const struct audio_stream *source,
+		   struct audio_stream *sink, int frames, int nch)
 {
 	struct fir_state_32x16 *filter;
 	int32_t *x;
 	int32_t *y;
-	int32_t z;
-	int idx;
+	int32_t in[4];
+	int32_t out[4];
+	int ri;
+	int wi;
 	int ch;
 	int i;
+	int j;
 
 	for (ch = 0; ch < nch; ch++) {
 		filter = &fir[ch];
-		idx = ch;
-		for (i = 0; i < frames; i++) {
-			x = audio_stream_read_frag_s32(source, idx);
-			y = audio_stream_write_frag_s32(sink, idx);
-			z = fir_32x16(filter, *x << 8);
-			*y = sat_int24(Q_SHIFT_RND(z, 31, 23));
-			idx += nch;
+		ri = ch;
+		wi = ch;
+		for (i = 0; i + 4 <= frames; i += 4) {
+			for (j = 0; j < 4; j++) {
+				x = audio_stream_read_frag_s32(source, ri);
+				in[j] = *x << 8;
+				ri += nch;
+			}
+
+			fir_filter_4x(filter, in[0], in[1], in[2], in[3],
+				      &out[0], &out[1], &out[2], &out[3]);
+			for (j = 0; j < 4; j++) {
+				y = audio_stream_write_frag_s32(sink, wi);
+				*y = sat_int24(Q_SHIFT_RND(out[j], 31, 23));
+				wi += nch;
+			}
+		}
+
+		if (i == frames)
+			continue;
+
+		for (j = 0; j < 2; j++) {
+			x = audio_stream_read_frag_s32(source, ri);
+			in[j] = *x << 8;
+			ri += nch;
+		}
+
+		fir_filter_2x(filter, in[0], in[1], &out[0], &out[1]);
+		for (j = 0; j < 2; j++) {
+			y = audio_stream_write_frag_s32(sink, wi);
+			*y = sat_int24(Q_SHIFT_RND(out[j], 31, 23));
+			wi += nch;
 		}
 	}
 }
 #endif /* CONFIG_FORMAT_S24LE */
 
 #if CONFIG_FORMAT_S32LE
-void eq_fir_s32(struct fir_state_32x16 fir[], const struct audio_stream *source,
-		struct audio_stream *sink, int frames, int nch)
+/* For even frame counts use FIR filter that processes four sequential
+ * samples per call and the two samples version for the remainder.
+ */
+void eq_fir_4x_s32(struct fir_state_32x16 fir[],
+		   const struct audio_stream *source,
+		   struct audio_stream *sink, int frames, int nch)
 {
 	struct fir_state_32x16 *filter;
 	int32_t *x;
 	int32_t *y;
-	int idx;
+	int32_t in[4];
+	int32_t out[4];
+	int ri;
+	int wi;
 	int ch;
 	int i;
+	int j;
 
 	for (ch = 0; ch < nch; ch++) {
 		filter = &fir[ch];
-		idx = ch;
-		for (i = 0; i < frames; i++) {
-			x = audio_stream_read_frag_s32(source, idx);
-			y = audio_stream_write_frag_s32(sink, idx);
-			*y = fir_32x16(filter, *x);
-			idx += nch;
+		ri = ch;
+		wi = ch;
+		for (i = 0; i + 4 <= frames; i += 4) {
+			for (j = 0; j < 4; j++) {
+				x = audio_stream_read_frag_s32(source, ri);
+				in[j] = *x;
+				ri += nch;
+			}
+
+			fir_filter_4x(filter, in[0], in[1], in[2], in[3],
+				      &out[0], &out[1], &out[2], &out[3]);
+			for (j = 0; j < 4; j++) {
+				y = audio_stream_write_frag_s32(sink, wi);
+				*y = out[j];
+				wi += nch;
+			}
+		}
+
+		if (i == frames)
+			continue;
+
+		for (j = 0; j < 2; j++) {
+			x = audio_stream_read_frag_s32(source, ri);
+			in[j] = *x;
+			ri += nch;
+		}
+
+		fir_filter_2x(filter, in[0], in[1], &out[0], &out[1]);
+		for (j = 0; j < 2; j++) {
+			y = audio_stream_write_frag_s32(sink, wi);
+			*y = out[j];
+			wi += nch;
+		}
+	}
+}
+#endif /* CONFIG_FORMAT_S32LE */
+
+#if FIR_LANES
+/* The channels can be filtered as lanes if all have the same response.
+ * The lanes versions process two frames per call so the frame count must
+ * be even.
+ */
+bool fir_lanes_ok(struct fir_state_32x16 *fir, int nch)
+{
+	int i;
+
+	if (nch != 2 && nch != 4 && nch != 8)
+		return false;
+
+	if (!fir[0].length)
+		return false;
+
+	for (i = 1; i < nch; i++) {
+		if (fir[i].coef != fir[0].coef ||
+		    fir[i].length != fir[0].length ||
+		    fir[i].out_shift != fir[0].out_shift)
+			return false;
+	}
+
+	return true;
+}
+
+/* All channels use the state and interleaved delay line of the first
+ * channel.
+ */
+void fir_init_delay_lanes(struct fir_state_32x16 *fir, int nch,
+			  int32_t **data)
+{
+	fir->delay = *data;
+	*data += fir->length * nch; /* Point to next delay line start */
+}
+
+/* Filters two frames, with eight channels the accumulators of two frames
+ * would not fit to registers.
+ */
+static inline void fir_lanes(struct fir_state_32x16 *fir, int nch,
+			     const int32_t *x, int32_t *y)
+{
+	switch (nch) {
+	case 2:
+		fir_32x16_lanes_2x(fir, 2, x, y);
+		break;
+	case 4:
+		fir_32x16_lanes_2x(fir, 4, x, y);
+		break;
+	default:
+		fir_32x16_lanes(fir, 8, x, y);
+		fir_32x16_lanes(fir, 8, x + 8, y + 8);
+		break;
+	}
+}
+
+#if CONFIG_FORMAT_S16LE
+void eq_fir_lanes_s16(struct fir_state_32x16 fir[],
+		      const struct audio_stream *source,
+		      struct audio_stream *sink, int frames, int nch)
+{
+	int32_t in[2 * FIR_LANES_MAX];
+	int32_t out[2 * FIR_LANES_MAX];
+	int16_t *x;
+	int16_t *y;
+	int idx = 0;
+	int ch;
+	int i;
+
+	for (i = 0; i < frames; i += 2) {
+		for (ch = 0; ch < 2 * nch; ch++) {
+			x = audio_stream_read_frag_s16(source, idx + ch);
+			in[ch] = *x << 16;
+		}
+
+		fir_lanes(fir, nch, in, out);
+		for (ch = 0; ch < 2 * nch; ch++) {
+			y = audio_stream_write_frag_s16(sink, idx + ch);
+			*y = sat_int16(Q_SHIFT_RND(out[ch], 31, 15));
+		}
+
+		idx += 2 * nch;
+	}
+}
+#endif /* CONFIG_FORMAT_S16LE */
+
+#if CONFIG_FORMAT_S24LE
+void eq_fir_lanes_s24(struct fir_state_32x16 fir[],
+		      const struct audio_stream *source,
+		      struct audio_stream *sink, int frames, int nch)
+{
+	int32_t in[2 * FIR_LANES_MAX];
+	int32_t out[2 * FIR_LANES_MAX];
+	int32_t *x;
+	int32_t *y;
+	int idx = 0;
+	int ch;
+	int i;
+
+	for (i = 0; i < frames; i += 2) {
+		for (ch = 0; ch < 2 * nch; ch++) {
+			x = audio_stream_read_frag_s32(source, idx + ch);
+			in[ch] = *x << 8;
+		}
+
+		fir_lanes(fir, nch, in, out);
+		for (ch = 0; ch < 2 * nch; ch++) {
+			y = audio_stream_write_frag_s32(sink, idx + ch);
+			*y = sat_int24(Q_SHIFT_RND(out[ch], 31, 23));
+		}
+
+		idx += 2 * nch;
+	}
+}
+#endif /* CONFIG_FORMAT_S24LE */
+
+#if CONFIG_FORMAT_S32LE
+void eq_fir_lanes_s32(struct fir_state_32x16 fir[],
+		      const struct audio_stream *source,
+		      struct audio_stream *sink, int frames, int nch)
+{
+	int32_t in[2 * FIR_LANES_MAX];
+	int32_t out[2 * FIR_LANES_MAX];
+	int32_t *x;
+	int32_t *y;
+	int idx = 0;
+	int ch;
+	int i;
+
+	for (i = 0; i < frames; i += 2) {
+		for (ch = 0; ch < 2 * nch; ch++) {
+			x = audio_stream_read_frag_s32(source, idx + ch);
+			in[ch] = *x;
 		}
+
+		fir_lanes(fir, nch, in, out);
+		for (ch = 0; ch < 2 * nch; ch++) {
+			y = audio_stream_write_frag_s32(sink, idx + ch);
+			*y = out[ch];
+		}
+
+		idx += 2 * nch;
 	}
 }
 #endif /* CONFIG_FORMAT_S32LE */
+#endif /* FIR_LANES */
 
 #endif
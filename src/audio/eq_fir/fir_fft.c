@@ -0,0 +1,241 @@
+// SPDX-License-Identifier: BSD-3-Clause
+//
+// Copyright(c) 2020 Intel Corporation. All rights reserved.
+
+#include <sof/audio/eq_fir/fir_config.h>
+
+#if FIR_FFT
+
+#include <sof/common.h>
+#include <sof/audio/eq_fir/fir.h>
+#include <sof/audio/eq_fir/fir_fft.h>
+#include <sof/audio/format.h>
+#include <sof/math/fft.h>
+#include <sof/math/numbers.h>
+#include <stddef.h>
+#include <stdint.h>
+
+/*
+ * EQ FIR overlap-save convolution code
+ *
+ * The input spectrum of every block is computed with FFT of the previous
+ * and current input blocks and stored into a frequency domain delay line.
+ * The output block is the second half of the IFFT of the sum of the
+ * input spectra multiplied with the spectra of the coefficient partitions.
+ * The spectra of real signals are conjugate symmetric so only the bins up
+ * to Nyquist frequency are stored and multiplied.
+ */
+
+static int fir_fft_partitions(struct fir_state_32x16 *fir)
+{
+	return (fir->taps + FIR_FFT_BLOCK_LEN - 1) / FIR_FFT_BLOCK_LEN;
+}
+
+int fir_fft_delay_size(struct fir_state_32x16 *fir)
+{
+	int n = fir_fft_partitions(fir);
+
+	/* Coefficients and input spectra, input spectra exponents rounded
+	 * up to even count to keep the alignment of complex data, input
+	 * and output blocks.
+	 */
+	return 2 * n * FIR_FFT_BINS * sizeof(struct icomplex32) +
+		ALIGN_UP(n, 2) * sizeof(int32_t) +
+		(FIR_FFT_SIZE + FIR_FFT_BLOCK_LEN) * sizeof(int32_t);
+}
+
+void fir_fft_init_work(struct fir_fft_work *work)
+{
+	fft_plan_init(&work->plan, FIR_FFT_SIZE, work->twiddle);
+}
+
+void fir_fft_init(struct fir_fft_state *fft, struct fir_state_32x16 *fir,
+		  struct fir_fft_work *work, int32_t **data)
+{
+	struct icomplex32 *h;
+	int n = fir_fft_partitions(fir);
+	int shift;
+	int i;
+	int j;
+	int k;
+
+	fft->work = work;
+	fft->partitions = n;
+	fft->out_shift = fir->out_shift;
+	fft->h_shift = 0;
+	fft->pos = 0;
+	fft->newest = 0;
+
+	fft->h = (struct icomplex32 *)*data;
+	*data += 2 * n * FIR_FFT_BINS;
+	fft->fdl = (struct icomplex32 *)*data;
+	*data += 2 * n * FIR_FFT_BINS;
+	fft->fdl_shift = *data;
+	*data += ALIGN_UP(n, 2);
+	fft->in = *data;
+	*data += FIR_FFT_SIZE;
+	fft->out = *data;
+	*data += FIR_FFT_BLOCK_LEN;
+
+	/* Spectra of the zero padded coefficient partitions, Q1.15 to
+	 * Q1.31. The exponents are stored temporarily to fdl_shift[].
+	 */
+	for (i = 0; i < n; i++) {
+		for (j = 0; j < FIR_FFT_SIZE; j++) {
+			k = i * FIR_FFT_BLOCK_LEN + j;
+			work->data[j].real = j < FIR_FFT_BLOCK_LEN &&
+				k < fir->taps ? fir->coef[k] << 16 : 0;
+			work->data[j].imag = 0;
+		}
+
+		fft->fdl_shift[i] = fft_execute_32(&work->plan, work->data,
+						   false);
+		fft->h_shift = MAX(fft->h_shift, fft->fdl_shift[i]);
+		for (j = 0; j < FIR_FFT_BINS; j++)
+			fft->h[i * FIR_FFT_BINS + j] = work->data[j];
+	}
+
+	/* Align all partitions to common exponent */
+	for (i = 0; i < n; i++) {
+		shift = fft->h_shift - fft->fdl_shift[i];
+		fft->fdl_shift[i] = 0;
+		if (!shift)
+			continue;
+
+		h = &fft->h[i * FIR_FFT_BINS];
+		for (j = 0; j < FIR_FFT_BINS; j++) {
+			h[j].real = Q_SHIFT_RND(h[j].real, shift, 0);
+			h[j].imag = Q_SHIFT_RND(h[j].imag, shift, 0);
+		}
+	}
+}
+
+/* Sums the products of input and coefficient spectra, returns the largest
+ * input spectrum exponent that is the exponent of the sum.
+ */
+static int fir_fft_accumulate(struct fir_fft_state *fft)
+{
+	struct icomplex32 *x;
+	struct icomplex32 *h;
+	int64_t *acc = fft->work->acc;
+	int64_t xr;
+	int64_t xi;
+	int max_shift = 0;
+	int shift;
+	int slot;
+	int i;
+	int k;
+
+	for (i = 0; i < fft->partitions; i++)
+		max_shift = MAX(max_shift, fft->fdl_shift[i]);
+
+	for (k = 0; k < 2 * FIR_FFT_BINS; k++)
+		acc[k] = 0;
+
+	/* Partition i is multiplied with input spectrum of i blocks ago */
+	slot = fft->newest;
+	for (i = 0; i < fft->partitions; i++) {
+		x = &fft->fdl[slot * FIR_FFT_BINS];
+		h = &fft->h[i * FIR_FFT_BINS];
+		shift = FIR_FFT_ACC_SHIFT + max_shift - fft->fdl_shift[slot];
+		for (k = 0; k < FIR_FFT_BINS; k++) {
+			/* Q1.31 x Q1.31 -> Q2.62 */
+			xr = x[k].real;
+			xi = x[k].imag;
+			acc[2 * k] += (xr * h[k].real >> shift) -
+				(xi * h[k].imag >> shift);
+			acc[2 * k + 1] += (xr * h[k].imag >> shift) +
+				(xi * h[k].real >> shift);
+		}
+
+		slot = slot ? slot - 1 : fft->partitions - 1;
+	}
+
+	return max_shift;
+}
+
+void fir_fft_block(struct fir_fft_state *fft)
+{
+	struct fir_fft_work *work = fft->work;
+	struct icomplex32 *data = work->data;
+	int64_t *acc = work->acc;
+	int64_t m = 0;
+	int64_t y;
+	int acc_shift = 0;
+	int shift;
+	int i;
+
+	/* Bypassed channel is only delayed by one block to keep the channels
+	 * aligned.
+	 */
+	if (!fft->partitions) {
+		for (i = 0; i < FIR_FFT_BLOCK_LEN; i++)
+			fft->out[i] = fft->in[FIR_FFT_BLOCK_LEN + i];
+
+		return;
+	}
+
+	/* Spectrum of previous and current input blocks */
+	for (i = 0; i < FIR_FFT_SIZE; i++) {
+		data[i].real = fft->in[i];
+		data[i].imag = 0;
+	}
+
+	for (i = 0; i < FIR_FFT_BLOCK_LEN; i++)
+		fft->in[i] = fft->in[FIR_FFT_BLOCK_LEN + i];
+
+	fft->newest++;
+	if (fft->newest == fft->partitions)
+		fft->newest = 0;
+
+	fft->fdl_shift[fft->newest] = fft_execute_32(&work->plan, data, false);
+	for (i = 0; i < FIR_FFT_BINS; i++)
+		fft->fdl[fft->newest * FIR_FFT_BINS + i] = data[i];
+
+	/* The value of the output is the IFFT result multiplied by two
+	 * to power of the sum of the exponents and shifts of the spectra,
+	 * divided by FFT size for IFFT and by 2^31 for Q2.62 to Q1.31.
+	 */
+	shift = fir_fft_accumulate(fft) + fft->h_shift + FIR_FFT_ACC_SHIFT -
+		FIR_FFT_SIZE_LOG2 - 31 - fft->out_shift;
+
+	/* Scale the sum to Q1.31 with one bit of headroom */
+	for (i = 0; i < 2 * FIR_FFT_BINS; i++)
+		m |= acc[i] ^ (acc[i] >> 63);
+
+	while (m >> acc_shift >= 1 << 30)
+		acc_shift++;
+
+	/* Conjugate symmetric spectrum for real output */
+	for (i = 0; i < FIR_FFT_BINS; i++) {
+		data[i].real = acc_shift ?
+			Q_SHIFT_RND(acc[2 * i], acc_shift, 0) : acc[2 * i];
+		data[i].imag = acc_shift ?
+			Q_SHIFT_RND(acc[2 * i + 1], acc_shift, 0) :
+			acc[2 * i + 1];
+	}
+
+	for (i = 1; i < FIR_FFT_BLOCK_LEN; i++) {
+		data[FIR_FFT_SIZE - i].real = data[i].real;
+		data[FIR_FFT_SIZE - i].imag = -data[i].imag;
+	}
+
+	shift += acc_shift + fft_execute_32(&work->plan, data, true);
+
+	/* The second half of the circular convolution is the output */
+	data += FIR_FFT_BLOCK_LEN;
+	if (shift < 0) {
+		for (i = 0; i < FIR_FFT_BLOCK_LEN; i++) {
+			y = data[i].real;
+			fft->out[i] = sat_int32(Q_SHIFT_RND(y, -shift, 0));
+		}
+	} else {
+		shift = MIN(shift, 32);
+		for (i = 0; i < FIR_FFT_BLOCK_LEN; i++) {
+			y = data[i].real;
+			fft->out[i] = sat_int32(y << shift);
+		}
+	}
+}
+
+#endif
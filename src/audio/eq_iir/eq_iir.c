@@ -39,9 +39,13 @@ DECLARE_SOF_RT_UUID("eq-iir", eq_iir_uuid, 0x5150c0e6, 0x27f9, 0x4ec8,
 
 DECLARE_TR_CTX(eq_iir_tr, SOF_UUID(eq_iir_uuid), LOG_LEVEL_INFO);
 
+/* Samples of all channels filtered at a time */
+#define EQ_IIR_BLOCK_SAMPLES	256
+
 /* IIR component private data */
 struct comp_data {
 	struct iir_state_df2t iir[PLATFORM_MAX_CHANNELS]; /**< filters state */
+	int32_t block[EQ_IIR_BLOCK_SAMPLES];	/**< Q1.31 samples block */
 	struct sof_eq_iir_config *config;	/**< pointer to setup blob */
 	struct sof_eq_iir_config *config_new;	/**< pointer to new setup */
 	enum sof_ipc_frame source_format;	/**< source frame format */
@@ -52,98 +56,168 @@ struct comp_data {
 	eq_iir_func eq_iir_func;		/**< processing function */
 };
 
-#if CONFIG_FORMAT_S16LE
 /*
  * EQ IIR algorithm code
  */
 
-static void eq_iir_s16_default(const struct comp_dev *dev,
-			       const struct audio_stream *source,
-			       struct audio_stream *sink,
-			       uint32_t frames)
+/* Input samples are converted to Q1.31 in a block, the channel filters are
+ * run for the whole block and the result is converted to output format.
+ */
+typedef void (*eq_iir_in_func)(int32_t *z, const void *x, int samples);
+typedef void (*eq_iir_out_func)(void *y, const int32_t *z, int samples);
+
+/* Converts samples from source to block, returns next read position */
+static char *eq_iir_read(const struct audio_stream *source, char *x,
+			 int size, eq_iir_in_func in, int32_t *z, int samples)
+{
+	int n;
+
+	while (samples) {
+		n = MIN(samples, audio_stream_bytes_without_wrap(source, x) /
+			size);
+		in(z, x, n);
+		z += n;
+		samples -= n;
+		x = audio_stream_wrap(source, x + n * size);
+	}
+
+	return x;
+}
+
+/* Converts samples from block to sink, returns next write position */
+static char *eq_iir_write(const struct audio_stream *sink, char *y,
+			  int size, eq_iir_out_func out, const int32_t *z,
+			  int samples)
+{
+	int n;
+
+	while (samples) {
+		n = MIN(samples, audio_stream_bytes_without_wrap(sink, y) /
+			size);
+		out(y, z, n);
+		z += n;
+		samples -= n;
+		y = audio_stream_wrap(sink, y + n * size);
+	}
+
+	return y;
+}
 
+static void eq_iir_run(const struct comp_dev *dev,
+		       const struct audio_stream *source,
+		       struct audio_stream *sink, uint32_t frames,
+		       eq_iir_in_func in, eq_iir_out_func out)
 {
 	struct comp_data *cd = comp_get_drvdata(dev);
-	struct iir_state_df2t *filter;
-	int16_t *x;
-	int16_t *y;
-	int32_t z;
-	int ch;
-	int i;
-	int idx;
 	int nch = source->channels;
-
-	for (ch = 0; ch < nch; ch++) {
-		filter = &cd->iir[ch];
-		idx = ch;
-		for (i = 0; i < frames; i++) {
-			x = audio_stream_read_frag_s16(source, idx);
-			y = audio_stream_write_frag_s16(sink, idx);
-			z = iir_df2t(filter, *x << 16);
-			*y = sat_int16(Q_SHIFT_RND(z, 31, 15));
-			idx += nch;
-		}
+	int block_frames = EQ_IIR_BLOCK_SAMPLES / nch;
+	int src_size = audio_stream_sample_bytes(source);
+	int snk_size = audio_stream_sample_bytes(sink);
+	char *x = source->r_ptr;
+	char *y = sink->w_ptr;
+	int samples;
+	int n;
+
+	while (frames) {
+		n = MIN(frames, block_frames);
+		samples = n * nch;
+		x = eq_iir_read(source, x, src_size, in, cd->block, samples);
+		iir_df2t_block_interleaved(cd->iir, nch, cd->block, n);
+		y = eq_iir_write(sink, y, snk_size, out, cd->block, samples);
+		frames -= n;
 	}
 }
+
+#if CONFIG_FORMAT_S16LE
+static void eq_iir_in_s16(int32_t *z, const void *x, int samples)
+{
+	const int16_t *x16 = x;
+	int i;
+
+	for (i = 0; i < samples; i++)
+		z[i] = x16[i] << 16;
+}
+
+static void eq_iir_out_s16(void *y, const int32_t *z, int samples)
+{
+	int16_t *y16 = y;
+	int i;
+
+	for (i = 0; i < samples; i++)
+		y16[i] = sat_int16(Q_SHIFT_RND(z[i], 31, 15));
+}
 #endif /* CONFIG_FORMAT_S16LE */
 
 #if CONFIG_FORMAT_S24LE
-static void eq_iir_s24_default(const struct comp_dev *dev,
-			       const struct audio_stream *source,
-			       struct audio_stream *sink,
-			       uint32_t frames)
+static void eq_iir_in_s24(int32_t *z, const void *x, int samples)
+{
+	const int32_t *x32 = x;
+	int i;
+
+	for (i = 0; i < samples; i++)
+		z[i] = x32[i] << 8;
+}
 
+static void eq_iir_out_s24(void *y, const int32_t *z, int samples)
 {
-	struct comp_data *cd = comp_get_drvdata(dev);
-	struct iir_state_df2t *filter;
-	int32_t *x;
-	int32_t *y;
-	int32_t z;
-	int idx;
-	int ch;
+	int32_t *y32 = y;
 	int i;
-	int nch = source->channels;
 
-	for (ch = 0; ch < nch; ch++) {
-		filter = &cd->iir[ch];
-		idx = ch;
-		for (i = 0; i < frames; i++) {
-			x = audio_stream_read_frag_s32(source, idx);
-			y = audio_stream_write_frag_s32(sink, idx);
-			z = iir_df2t(filter, *x << 8);
-			*y = sat_int24(Q_SHIFT_RND(z, 31, 23));
-			idx += nch;
-		}
-	}
+	for (i = 0; i < samples; i++)
+		y32[i] = sat_int24(Q_SHIFT_RND(z[i], 31, 23));
 }
 #endif /* CONFIG_FORMAT_S24LE */
 
 #if CONFIG_FORMAT_S32LE
-static void eq_iir_s32_default(const struct comp_dev *dev,
+static void eq_iir_in_s32(int32_t *z, const void *x, int samples)
+{
+	int ret;
+
+	ret = memcpy_s(z, samples * sizeof(int32_t), x,
+		       samples * sizeof(int32_t));
+	assert(!ret);
+}
+
+static void eq_iir_out_s32(void *y, const int32_t *z, int samples)
+{
+	int ret;
+
+	ret = memcpy_s(y, samples * sizeof(int32_t), z,
+		       samples * sizeof(int32_t));
+	assert(!ret);
+}
+#endif /* CONFIG_FORMAT_S32LE */
+
+#if CONFIG_FORMAT_S16LE
+static void eq_iir_s16_default(const struct comp_dev *dev,
 			       const struct audio_stream *source,
 			       struct audio_stream *sink,
 			       uint32_t frames)
+{
+	eq_iir_run(dev, source, sink, frames, eq_iir_in_s16,
+		   eq_iir_out_s16);
+}
+#endif /* CONFIG_FORMAT_S16LE */
 
+#if CONFIG_FORMAT_S24LE
+static void eq_iir_s24_default(const struct comp_dev *dev,
+			       const struct audio_stream *source,
+			       struct audio_stream *sink,
+			       uint32_t frames)
 {
-	struct comp_data *cd = comp_get_drvdata(dev);
-	struct iir_state_df2t *filter;
-	int32_t *x;
-	int32_t *y;
-	int idx;
-	int ch;
-	int i;
-	int nch = source->channels;
+	eq_iir_run(dev, source, sink, frames, eq_iir_in_s24,
+		   eq_iir_out_s24);
+}
+#endif /* CONFIG_FORMAT_S24LE */
 
-	for (ch = 0; ch < nch; ch++) {
-		filter = &cd->iir[ch];
-		idx = ch;
-		for (i = 0; i < frames; i++) {
-			x = audio_stream_read_frag_s32(source, idx);
-			y = audio_stream_write_frag_s32(sink, idx);
-			*y = iir_df2t(filter, *x);
-			idx += nch;
-		}
-	}
+#if CONFIG_FORMAT_S32LE
+static void eq_iir_s32_default(const struct comp_dev *dev,
+			       const struct audio_stream *source,
+			       struct audio_stream *sink,
+			       uint32_t frames)
+{
+	eq_iir_run(dev, source, sink, frames, eq_iir_in_s32,
+		   eq_iir_out_s32);
 }
 #endif /* CONFIG_FORMAT_S32LE */
 
@@ -152,29 +226,9 @@ static void eq_iir_s32_16_default(const struct comp_dev *dev,
 				  const struct audio_stream *source,
 				  struct audio_stream *sink,
 				  uint32_t frames)
-
 {
-	struct comp_data *cd = comp_get_drvdata(dev);
-	struct iir_state_df2t *filter;
-	int32_t *x;
-	int16_t *y;
-	int32_t z;
-	int idx;
-	int ch;
-	int i;
-	int nch = source->channels;
-
-	for (ch = 0; ch < nch; ch++) {
-		filter = &cd->iir[ch];
-		idx = ch;
-		for (i = 0; i < frames; i++) {
-			x = audio_stream_read_frag_s32(source, idx);
-			y = audio_stream_write_frag_s16(sink, idx);
-			z = iir_df2t(filter, *x);
-			*y = sat_int16(Q_SHIFT_RND(z, 31, 15));
-			idx += nch;
-		}
-	}
+	eq_iir_run(dev, source, sink, frames, eq_iir_in_s32,
+		   eq_iir_out_s16);
 }
 #endif /* CONFIG_FORMAT_S32LE && CONFIG_FORMAT_S16LE */
 
@@ -183,29 +237,9 @@ static void eq_iir_s32_24_default(const struct comp_dev *dev,
 				  const struct audio_stream *source,
 				  struct audio_stream *sink,
 				  uint32_t frames)
-
 {
-	struct comp_data *cd = comp_get_drvdata(dev);
-	struct iir_state_df2t *filter;
-	int32_t *x;
-	int32_t *y;
-	int32_t z;
-	int idx;
-	int ch;
-	int i;
-	int nch = source->channels;
-
-	for (ch = 0; ch < nch; ch++) {
-		filter = &cd->iir[ch];
-		idx = ch;
-		for (i = 0; i < frames; i++) {
-			x = audio_stream_read_frag_s32(source, idx);
-			y = audio_stream_write_frag_s32(sink, idx);
-			z = iir_df2t(filter, *x);
-			*y = sat_int24(Q_SHIFT_RND(z, 31, 23));
-			idx += nch;
-		}
-	}
+	eq_iir_run(dev, source, sink, frames, eq_iir_in_s32,
+		   eq_iir_out_s24);
 }
 #endif /* CONFIG_FORMAT_S32LE && CONFIG_FORMAT_S24LE */
 
@@ -10,6 +10,7 @@
 #include <sof/audio/format.h>
 #include <user/eq.h>
 #include <errno.h>
+#include <stdbool.h>
 #include <stddef.h>
 #include <stdint.h>
 
@@ -104,5 +105,190 @@ int32_t iir_df2t(struct iir_state_df2t *iir, int32_t x)
 	return out;
 }
 
+/* Block processing of series DF2T IIR. The biquads are computed one at a
+ * time for the whole block with the coefficients and delays kept in local
+ * variables. The arithmetic is the same as in iir_df2t() so the output is
+ * bit-exact with the sample by sample version.
+ */
+
+static inline void iir_df2t_biquad_block(int32_t *coef, int64_t *delay,
+					 int32_t *x, int stride, int samples)
+{
+	int64_t acc;
+	int64_t d0 = delay[0];
+	int64_t d1 = delay[1];
+	int32_t a2 = coef[0];
+	int32_t a1 = coef[1];
+	int32_t b2 = coef[2];
+	int32_t b1 = coef[3];
+	int32_t b0 = coef[4];
+	int32_t shift = coef[5];
+	int32_t gain = coef[6];
+	int32_t in;
+	int32_t tmp;
+	int i;
+
+	for (i = 0; i < samples; i++) {
+		in = *x;
+		acc = (int64_t)b0 * in + d0;
+		tmp = (int32_t)Q_SHIFT_RND(acc, 61, 31);
+		acc = d1;
+		acc += (int64_t)b1 * in;
+		acc += (int64_t)a1 * tmp;
+		d0 = acc;
+		acc = (int64_t)b2 * in;
+		acc += (int64_t)a2 * tmp;
+		d1 = acc;
+		acc = (int64_t)gain * tmp;
+		acc = Q_SHIFT_RND(acc, 45 + shift, 31);
+		*x = sat_int32(acc);
+		x += stride;
+	}
+
+	delay[0] = d0;
+	delay[1] = d1;
+}
+
+void iir_df2t_block(struct iir_state_df2t *iir, int32_t *x, int stride,
+		    int samples)
+{
+	int32_t *coef = iir->coef;
+	int64_t *delay = iir->delay;
+	int i;
+
+	/* Bypass is set with number of biquads set to zero. */
+	if (!iir->biquads)
+		return;
+
+	/* Parallel sections need the input sample for every branch, use the
+	 * sample by sample version for them.
+	 */
+	if (iir->biquads_in_series != iir->biquads) {
+		for (i = 0; i < samples; i++)
+			x[i * stride] = iir_df2t(iir, x[i * stride]);
+
+		return;
+	}
+
+	for (i = 0; i < iir->biquads; i++) {
+		iir_df2t_biquad_block(coef, delay, x, stride, samples);
+		coef += SOF_EQ_IIR_NBIQUAD_DF2T;
+		delay += IIR_DF2T_NUM_DELAYS;
+	}
+}
+
+/* One biquad for interleaved channels, the channels are the lanes of the
+ * inner loop. The lanes count is a compile time constant in the callers so
+ * the compiler can unroll and vectorize the lanes.
+ */
+static inline void iir_df2t_biquad_lanes(struct iir_state_df2t *iir,
+					 const int lanes, int biquad,
+					 int32_t *x, int frames)
+{
+	int64_t d0[IIR_DF2T_LANES_MAX];
+	int64_t d1[IIR_DF2T_LANES_MAX];
+	int32_t a2[IIR_DF2T_LANES_MAX];
+	int32_t a1[IIR_DF2T_LANES_MAX];
+	int32_t b2[IIR_DF2T_LANES_MAX];
+	int32_t b1[IIR_DF2T_LANES_MAX];
+	int32_t b0[IIR_DF2T_LANES_MAX];
+	int32_t shift[IIR_DF2T_LANES_MAX];
+	int32_t gain[IIR_DF2T_LANES_MAX];
+	int64_t acc;
+	int32_t *coef;
+	int64_t *delay;
+	int32_t in;
+	int32_t tmp;
+	int ch;
+	int i;
+
+	for (ch = 0; ch < lanes; ch++) {
+		coef = &iir[ch].coef[biquad * SOF_EQ_IIR_NBIQUAD_DF2T];
+		delay = &iir[ch].delay[biquad * IIR_DF2T_NUM_DELAYS];
+		a2[ch] = coef[0];
+		a1[ch] = coef[1];
+		b2[ch] = coef[2];
+		b1[ch] = coef[3];
+		b0[ch] = coef[4];
+		shift[ch] = coef[5];
+		gain[ch] = coef[6];
+		d0[ch] = delay[0];
+		d1[ch] = delay[1];
+	}
+
+	for (i = 0; i < frames; i++) {
+		for (ch = 0; ch < lanes; ch++) {
+			in = x[ch];
+			acc = (int64_t)b0[ch] * in + d0[ch];
+			tmp = (int32_t)Q_SHIFT_RND(acc, 61, 31);
+			acc = d1[ch];
+			acc += (int64_t)b1[ch] * in;
+			acc += (int64_t)a1[ch] * tmp;
+			d0[ch] = acc;
+			acc = (int64_t)b2[ch] * in;
+			acc += (int64_t)a2[ch] * tmp;
+			d1[ch] = acc;
+			acc = (int64_t)gain[ch] * tmp;
+			acc = Q_SHIFT_RND(acc, 45 + shift[ch], 31);
+			x[ch] = sat_int32(acc);
+		}
+		x += lanes;
+	}
+
+	for (ch = 0; ch < lanes; ch++) {
+		delay = &iir[ch].delay[biquad * IIR_DF2T_NUM_DELAYS];
+		delay[0] = d0[ch];
+		delay[1] = d1[ch];
+	}
+}
+
+/* Lanes can be used when all channels have the same number of biquads in
+ * series.
+ */
+static bool iir_df2t_lanes_ok(struct iir_state_df2t *iir, int channels)
+{
+	int ch;
+
+	if (channels != 2 && channels != 4 && channels != 8)
+		return false;
+
+	for (ch = 0; ch < channels; ch++) {
+		if (!iir[ch].biquads ||
+		    iir[ch].biquads != iir[0].biquads ||
+		    iir[ch].biquads_in_series != iir[ch].biquads)
+			return false;
+	}
+
+	return true;
+}
+
+void iir_df2t_block_interleaved(struct iir_state_df2t *iir, int channels,
+				int32_t *x, int frames)
+{
+	int ch;
+	int j;
+
+	if (!iir_df2t_lanes_ok(iir, channels)) {
+		for (ch = 0; ch < channels; ch++)
+			iir_df2t_block(&iir[ch], x + ch, channels, frames);
+
+		return;
+	}
+
+	for (j = 0; j < iir[0].biquads; j++) {
+		switch (channels) {
+		case 2:
+			iir_df2t_biquad_lanes(iir, 2, j, x, frames);
+			break;
+		case 4:
+			iir_df2t_biquad_lanes(iir, 4, j, x, frames);
+			break;
+		default:
+			iir_df2t_biquad_lanes(iir, 8, j, x, frames);
+			break;
+		}
+	}
+}
+
 #endif
 
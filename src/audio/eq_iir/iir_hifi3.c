@@ -131,4 +131,26 @@ int32_t iir_df2t(struct iir_state_df2t *iir, int32_t x)
 	return out;
 }
 
+/* Block processing with the sample by sample HiFi3 version */
+
+void iir_df2t_block(struct iir_state_df2t *iir, int32_t *x, int stride,
+		    int samples)
+{
+	int i;
+
+	for (i = 0; i < samples; i++) {
+		*x = iir_df2t(iir, *x);
+		x += stride;
+	}
+}
+
+void iir_df2t_block_interleaved(struct iir_state_df2t *iir, int channels,
+				int32_t *x, int frames)
+{
+	int ch;
+
+	for (ch = 0; ch < channels; ch++)
+		iir_df2t_block(&iir[ch], x + ch, channels, frames);
+}
+
 #endif
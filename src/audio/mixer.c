@@ -36,83 +36,267 @@ DECLARE_SOF_RT_UUID("mixer", mixer_uuid, 0xbc06c037, 0x12aa, 0x417c,
 
 DECLARE_TR_CTX(mixer_tr, SOF_UUID(mixer_uuid), LOG_LEVEL_INFO);
 
+/* number of samples mixed at a time with more than two sources */
+#define MIXER_ACC_SAMPLES	128
+
 /* mixer component private data */
 struct mixer_data {
 	void (*mix_func)(struct comp_dev *dev, struct audio_stream *sink,
 			 const struct audio_stream **sources, uint32_t count,
 			 uint32_t frames);
+
+	/* wide accumulator for sources, saturated once to sink */
+	union {
+		int32_t s16[MIXER_ACC_SAMPLES];	/* 16 bit samples */
+		int64_t s32[MIXER_ACC_SAMPLES];	/* 24 and 32 bit samples */
+	} acc;
 };
 
+/* number of samples from ptr to the end of stream buffer */
+static inline uint32_t
+mix_samples_without_wrap(const struct audio_stream *stream, void *ptr,
+			 uint32_t sample_bytes)
+{
+	return audio_stream_bytes_without_wrap(stream, ptr) / sample_bytes;
+}
+
 #if CONFIG_FORMAT_S16LE
+/* Accumulate samples of one 16 bit source, the first source sets acc */
+static void mix_acc_s16(int32_t *acc, const struct audio_stream *source,
+			uint32_t frag, uint32_t samples, bool first)
+{
+	int16_t *src = audio_stream_read_frag_s16(source, frag);
+	uint32_t n;
+	uint32_t i;
+
+	while (samples) {
+		n = MIN(samples,
+			mix_samples_without_wrap(source, src, sizeof(*src)));
+		if (first) {
+			for (i = 0; i < n; i++)
+				acc[i] = src[i];
+		} else {
+			for (i = 0; i < n; i++)
+				acc[i] += src[i];
+		}
+
+		acc += n;
+		samples -= n;
+		src = audio_stream_wrap(source, src + n);
+	}
+}
+
+/* Saturate accumulated samples to 16 bit sink */
+static void mix_store_s16(struct audio_stream *sink, uint32_t frag,
+			  const int32_t *acc, uint32_t samples)
+{
+	int16_t *dest = audio_stream_write_frag_s16(sink, frag);
+	uint32_t n;
+	uint32_t i;
+
+	while (samples) {
+		n = MIN(samples,
+			mix_samples_without_wrap(sink, dest, sizeof(*dest)));
+		for (i = 0; i < n; i++)
+			dest[i] = sat_int16(acc[i]);
+
+		acc += n;
+		samples -= n;
+		dest = audio_stream_wrap(sink, dest + n);
+	}
+}
+
+/* Mix two 16 bit PCM source streams to one sink stream */
+static void mix_2_s16(struct audio_stream *sink,
+		      const struct audio_stream **sources, uint32_t samples)
+{
+	int16_t *src0 = audio_stream_read_frag_s16(sources[0], 0);
+	int16_t *src1 = audio_stream_read_frag_s16(sources[1], 0);
+	int16_t *dest = audio_stream_write_frag_s16(sink, 0);
+	uint32_t n;
+	uint32_t i;
+
+	while (samples) {
+		n = mix_samples_without_wrap(sink, dest, sizeof(*dest));
+		n = MIN(n, mix_samples_without_wrap(sources[0], src0,
+						    sizeof(*src0)));
+		n = MIN(n, mix_samples_without_wrap(sources[1], src1,
+						    sizeof(*src1)));
+		n = MIN(n, samples);
+		for (i = 0; i < n; i++)
+			dest[i] = sat_int16((int32_t)src0[i] + src1[i]);
+
+		samples -= n;
+		src0 = audio_stream_wrap(sources[0], src0 + n);
+		src1 = audio_stream_wrap(sources[1], src1 + n);
+		dest = audio_stream_wrap(sink, dest + n);
+	}
+}
+
 /* Mix n 16 bit PCM source streams to one sink stream */
 static void mix_n_s16(struct comp_dev *dev, struct audio_stream *sink,
 		      const struct audio_stream **sources, uint32_t num_sources,
 		      uint32_t frames)
 {
-	int16_t *src;
-	int16_t *dest;
-	int32_t val;
-	int i;
-	int j;
-	int channel;
+	struct mixer_data *md = comp_get_drvdata(dev);
+	uint32_t samples = frames * sink->channels;
 	uint32_t frag = 0;
+	uint32_t n;
+	int j;
 
-	for (i = 0; i < frames; i++) {
-		for (channel = 0; channel < sink->channels; channel++) {
-			val = 0;
-
-			for (j = 0; j < num_sources; j++) {
-				src = audio_stream_read_frag_s16(sources[j],
-								 frag);
-				val += *src;
-			}
-
-			dest = audio_stream_write_frag_s16(sink, frag);
+	switch (num_sources) {
+	case 1:
+		audio_stream_copy(sources[0], 0, sink, 0,
+				  samples * sizeof(int16_t));
+		return;
+	case 2:
+		mix_2_s16(sink, sources, samples);
+		return;
+	}
 
-			/* Saturate to 16 bits */
-			*dest = sat_int16(val);
+	/* sum all sources to 32 bits and saturate once */
+	while (frag < samples) {
+		n = MIN(samples - frag, MIXER_ACC_SAMPLES);
+		mix_acc_s16(md->acc.s16, sources[0], frag, n, true);
+		for (j = 1; j < num_sources; j++)
+			mix_acc_s16(md->acc.s16, sources[j], frag, n, false);
 
-			frag++;
-		}
+		mix_store_s16(sink, frag, md->acc.s16, n);
+		frag += n;
 	}
 }
 #endif /* CONFIG_FORMAT_S16LE */
 
 #if CONFIG_FORMAT_S24LE || CONFIG_FORMAT_S32LE
+/* Accumulate samples of one 32 bit source, the first source sets acc */
+static void mix_acc_s32(int64_t *acc, const struct audio_stream *source,
+			uint32_t frag, uint32_t samples, bool first)
+{
+	int32_t *src = audio_stream_read_frag_s32(source, frag);
+	uint32_t n;
+	uint32_t i;
+
+	while (samples) {
+		n = MIN(samples,
+			mix_samples_without_wrap(source, src, sizeof(*src)));
+		if (first) {
+			for (i = 0; i < n; i++)
+				acc[i] = src[i];
+		} else {
+			for (i = 0; i < n; i++)
+				acc[i] += src[i];
+		}
+
+		acc += n;
+		samples -= n;
+		src = audio_stream_wrap(source, src + n);
+	}
+}
+
+/* Saturate accumulated samples to 32 bit sink */
+static void mix_store_s32(struct audio_stream *sink, uint32_t frag,
+			  const int64_t *acc, uint32_t samples)
+{
+	int32_t *dest = audio_stream_write_frag_s32(sink, frag);
+	uint32_t n;
+	uint32_t i;
+
+	while (samples) {
+		n = MIN(samples,
+			mix_samples_without_wrap(sink, dest, sizeof(*dest)));
+		for (i = 0; i < n; i++)
+			dest[i] = sat_int32(acc[i]);
+
+		acc += n;
+		samples -= n;
+		dest = audio_stream_wrap(sink, dest + n);
+	}
+}
+
+/* Mix two 32 bit PCM source streams to one sink stream */
+static void mix_2_s32(struct audio_stream *sink,
+		      const struct audio_stream **sources, uint32_t samples)
+{
+	int32_t *src0 = audio_stream_read_frag_s32(sources[0], 0);
+	int32_t *src1 = audio_stream_read_frag_s32(sources[1], 0);
+	int32_t *dest = audio_stream_write_frag_s32(sink, 0);
+	uint32_t n;
+	uint32_t i;
+
+	while (samples) {
+		n = mix_samples_without_wrap(sink, dest, sizeof(*dest));
+		n = MIN(n, mix_samples_without_wrap(sources[0], src0,
+						    sizeof(*src0)));
+		n = MIN(n, mix_samples_without_wrap(sources[1], src1,
+						    sizeof(*src1)));
+		n = MIN(n, samples);
+		for (i = 0; i < n; i++)
+			dest[i] = sat_int32((int64_t)src0[i] + src1[i]);
+
+		samples -= n;
+		src0 = audio_stream_wrap(sources[0], src0 + n);
+		src1 = audio_stream_wrap(sources[1], src1 + n);
+		dest = audio_stream_wrap(sink, dest + n);
+	}
+}
+
 /* Mix n 32 bit PCM source streams to one sink stream */
 static void mix_n_s32(struct comp_dev *dev, struct audio_stream *sink,
 		      const struct audio_stream **sources, uint32_t num_sources,
 		      uint32_t frames)
 {
-	int32_t *src;
-	int32_t *dest;
-	int64_t val;
-	int i;
-	int j;
-	int channel;
+	struct mixer_data *md = comp_get_drvdata(dev);
+	uint32_t samples = frames * sink->channels;
 	uint32_t frag = 0;
+	uint32_t n;
+	int j;
 
-	for (i = 0; i < frames; i++) {
-		for (channel = 0; channel < sink->channels; channel++) {
-			val = 0;
-
-			for (j = 0; j < num_sources; j++) {
-				src = audio_stream_read_frag_s32(sources[j],
-								 frag);
-				val += *src;
-			}
-
-			dest = audio_stream_write_frag_s32(sink, frag);
+	switch (num_sources) {
+	case 1:
+		audio_stream_copy(sources[0], 0, sink, 0,
+				  samples * sizeof(int32_t));
+		return;
+	case 2:
+		mix_2_s32(sink, sources, samples);
+		return;
+	}
 
-			/* Saturate to 32 bits */
-			*dest = sat_int32(val);
+	/* sum all sources to 64 bits and saturate once */
+	while (frag < samples) {
+		n = MIN(samples - frag, MIXER_ACC_SAMPLES);
+		mix_acc_s32(md->acc.s32, sources[0], frag, n, true);
+		for (j = 1; j < num_sources; j++)
+			mix_acc_s32(md->acc.s32, sources[j], frag, n, false);
 
-			frag++;
-		}
+		mix_store_s32(sink, frag, md->acc.s32, n);
+		frag += n;
 	}
 }
 #endif /* CONFIG_FORMAT_S24LE || CONFIG_FORMAT_S32LE */
 
+/* check if source has only zero samples, stops at first non-zero sample */
+static bool mixer_source_is_silent(const struct audio_stream *source,
+				   uint32_t bytes)
+{
+	uint16_t *src = source->r_ptr;
+	uint32_t samples = bytes / sizeof(*src);
+	uint32_t n;
+	uint32_t i;
+
+	while (samples) {
+		n = MIN(samples,
+			mix_samples_without_wrap(source, src, sizeof(*src)));
+		for (i = 0; i < n; i++)
+			if (src[i])
+				return false;
+
+		samples -= n;
+		src = audio_stream_wrap(source, src + n);
+	}
+
+	return true;
+}
+
 static struct comp_dev *mixer_new(const struct comp_driver *drv,
 				  struct sof_ipc_comp *comp)
 {
@@ -274,10 +458,12 @@ static int mixer_copy(struct comp_dev *dev)
 	struct comp_buffer *sink;
 	struct comp_buffer *sources[PLATFORM_MAX_STREAMS];
 	const struct audio_stream *sources_stream[PLATFORM_MAX_STREAMS];
+	const struct audio_stream *mix_streams[PLATFORM_MAX_STREAMS];
 	struct comp_buffer *source;
 	struct list_item *blist;
 	int32_t i = 0;
 	int32_t num_mix_sources = 0;
+	int32_t num_mix_streams = 0;
 	uint32_t frames = INT32_MAX;
 	uint32_t source_bytes;
 	uint32_t sink_bytes;
@@ -332,10 +518,24 @@ static int mixer_copy(struct comp_dev *dev)
 	comp_dbg(dev, "mixer_copy(), source_bytes = 0x%x, sink_bytes = 0x%x",
 		 source_bytes, sink_bytes);
 
-	/* mix streams */
+	/* mix streams, silent sources are consumed but not mixed */
 	for (i = num_mix_sources - 1; i >= 0; i--)
 		buffer_invalidate(sources[i], source_bytes);
-	md->mix_func(dev, &sink->stream, sources_stream, num_mix_sources,
+
+	if (num_mix_sources > 1) {
+		for (i = 0; i < num_mix_sources; i++) {
+			if (!mixer_source_is_silent(sources_stream[i],
+						    source_bytes))
+				mix_streams[num_mix_streams++] =
+					sources_stream[i];
+		}
+	}
+
+	/* with all sources silent any of them gives the output */
+	if (!num_mix_streams)
+		mix_streams[num_mix_streams++] = sources_stream[0];
+
+	md->mix_func(dev, &sink->stream, mix_streams, num_mix_streams,
 		     frames);
 	buffer_writeback(sink, sink_bytes);
 
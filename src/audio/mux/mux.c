@@ -11,6 +11,7 @@
 
 #include <sof/audio/component.h>
 #include <sof/audio/mux.h>
+#include <sof/bit.h>
 #include <sof/common.h>
 #include <sof/drivers/ipc.h>
 #include <sof/lib/alloc.h>
@@ -44,6 +45,61 @@ DECLARE_SOF_RT_UUID("demux", demux_uuid, 0xc4b26868, 0x1430, 0x470e,
 
 DECLARE_TR_CTX(demux_tr, SOF_UUID(demux_uuid), LOG_LEVEL_INFO);
 
+/* Appends taps of the input channels set in routing bitmask */
+static struct mux_tap *mux_add_taps(struct mux_tap *tap, uint8_t stream,
+				    uint8_t mask)
+{
+	uint8_t in_ch;
+
+	for (in_ch = 0; in_ch < PLATFORM_MAX_CHANNELS; in_ch++) {
+		if (mask & BIT(in_ch)) {
+			tap->stream = stream;
+			tap->channel = in_ch;
+			tap++;
+		}
+	}
+
+	return tap;
+}
+
+/* Compiles routing bitmasks into taps of each output channel. Mux has a
+ * single sink stream that sums channels of all the source streams, demux
+ * routes channels of its single source to each sink stream.
+ */
+static void mux_prepare_look_up_table(struct comp_dev *dev,
+				      struct comp_data *cd)
+{
+	struct mux_stream_data *streams = cd->config.streams;
+	struct mux_look_up *lookup;
+	struct mux_tap *tap = cd->taps;
+	uint8_t mask;
+	uint8_t out_ch;
+	uint8_t i;
+	uint8_t j;
+
+	if (dev->comp.type == SOF_COMP_MUX) {
+		lookup = &cd->lookup[0];
+		for (out_ch = 0; out_ch < PLATFORM_MAX_CHANNELS; out_ch++) {
+			lookup->taps[out_ch] = tap;
+			for (j = 0; j < MUX_MAX_STREAMS; j++) {
+				mask = streams[j].mask[out_ch];
+				tap = mux_add_taps(tap, j, mask);
+			}
+			lookup->num_taps[out_ch] = tap - lookup->taps[out_ch];
+		}
+		return;
+	}
+
+	for (i = 0; i < MUX_MAX_STREAMS; i++) {
+		lookup = &cd->lookup[i];
+		for (out_ch = 0; out_ch < PLATFORM_MAX_CHANNELS; out_ch++) {
+			lookup->taps[out_ch] = tap;
+			tap = mux_add_taps(tap, 0, streams[i].mask[out_ch]);
+			lookup->num_taps[out_ch] = tap - lookup->taps[out_ch];
+		}
+	}
+}
+
 static int mux_set_values(struct comp_dev *dev, struct comp_data *cd,
 			  struct sof_mux_config *cfg)
 {
@@ -75,6 +131,8 @@ static int mux_set_values(struct comp_dev *dev, struct comp_data *cd,
 			cd->config.streams[i].mask[j] = cfg->streams[i].mask[j];
 	}
 
+	mux_prepare_look_up_table(dev, cd);
+
 	if (dev->state > COMP_STATE_INIT) {
 		if (dev->comp.type == SOF_COMP_MUX)
 			cd->mux = mux_get_processing_function(dev);
@@ -345,7 +403,7 @@ static int demux_copy(struct comp_dev *dev)
 
 		buffer_invalidate(source, source_bytes);
 		cd->demux(&sinks[i]->stream, &source->stream, frames,
-			  &cd->config.streams[i]);
+			  &cd->lookup[i]);
 		buffer_writeback(sinks[i], sinks_bytes[i]);
 	}
 
@@ -440,8 +498,7 @@ static int mux_copy(struct comp_dev *dev)
 	sink_bytes = frames * audio_stream_frame_bytes(&sink->stream);
 
 	/* produce output */
-	cd->mux(&sink->stream, &sources_stream[0], frames,
-		&cd->config.streams[0]);
+	cd->mux(&sink->stream, &sources_stream[0], frames, &cd->lookup[0]);
 	buffer_writeback(sink, sink_bytes);
 
 	/* update components */
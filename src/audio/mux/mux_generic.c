@@ -18,333 +18,443 @@
 #include <stddef.h>
 #include <stdint.h>
 
+/*
+ * \brief Collects taps of output channel from the connected sources.
+ * \param[in] sources Array of source buffers.
+ * \param[in] lookup Routing of the output stream.
+ * \param[in] out_ch Output channel.
+ * \param[out] taps Taps with an input channel present in source.
+ * \return Number of taps.
+ */
+static uint8_t mux_active_taps(const struct audio_stream **sources,
+			       const struct mux_look_up *lookup,
+			       uint8_t out_ch, struct mux_tap *taps)
+{
+	const struct mux_tap *tap = lookup->taps[out_ch];
+	const struct audio_stream *source;
+	uint8_t num_taps = 0;
+	uint8_t i;
+
+	for (i = 0; i < lookup->num_taps[out_ch]; i++) {
+		source = sources[tap[i].stream];
+		if (source && tap[i].channel < source->channels)
+			taps[num_taps++] = tap[i];
+	}
+
+	return num_taps;
+}
+
+/*
+ * \brief Returns position of same channel in next frame.
+ * \param[in] stream Buffer.
+ * \param[in] ptr Sample position.
+ * \param[in] sample_bytes Size of sample.
+ */
+static inline void *mux_next_frame(const struct audio_stream *stream,
+				   void *ptr, size_t sample_bytes)
+{
+	return audio_stream_wrap(stream, (char *)ptr +
+				 stream->channels * sample_bytes);
+}
+
 #if CONFIG_FORMAT_S16LE
 /*
- * \brief Fetch 16b samples from source buffer and perform routing operations
- *	  based on mask provided.
- * \param[in,out] source Source buffer.
- * \param[in] offset Offset in source buffer.
- * \param[in] mask Routing bitmask for calculating output sample.
+ * \brief Fetch 16b samples from source buffers and sum the taps of an
+ *	  output channel.
+ * \param[in] sources Array of source buffers.
+ * \param[in] taps Input channels to sum.
+ * \param[in] num_taps Number of taps.
+ * \param[in] frame Frame index in source buffers.
  */
-UT_STATIC inline int32_t calc_sample_s16le(const struct audio_stream *source,
-					   uint32_t offset, uint8_t mask)
+UT_STATIC inline int32_t calc_sample_s16le(const struct audio_stream **sources,
+					   const struct mux_tap *taps,
+					   uint8_t num_taps, uint32_t frame)
 {
+	const struct audio_stream *source;
 	int32_t sample = 0;
 	int16_t *src;
-	int8_t in_ch;
-
-	if (mask == 0)
-		return 0;
+	uint8_t i;
 
-	for (in_ch = 0; in_ch < source->channels; in_ch++) {
-		if (mask & BIT(in_ch)) {
-			src = audio_stream_read_frag_s16(source,
-							 offset + in_ch);
-			sample += *src;
-		}
+	for (i = 0; i < num_taps; i++) {
+		source = sources[taps[i].stream];
+		src = audio_stream_read_frag_s16(source,
+						 frame * source->channels +
+						 taps[i].channel);
+		sample += *src;
 	}
 
 	return sample;
 }
 
-/* \brief Demuxing 16 bit streams.
- *
- * Source stream is routed to sink with regard to routing bitmasks from
- * mux_stream_data structure. Each bitmask describes composition of single
- * output channel.
- *
+/*
+ * \brief Produces an output channel as sum of its taps.
  * \param[in,out] sink Destination buffer.
- * \param[in,out] source Source buffer.
+ * \param[in,out] dst Position of first output sample.
+ * \param[in] sources Array of source buffers.
+ * \param[in] taps Input channels to sum.
+ * \param[in] num_taps Number of taps.
  * \param[in] frames Number of frames to process.
- * \param[in] data Parameters describing channel count and routing.
  */
-static void demux_s16le(struct audio_stream *sink,
-			const struct audio_stream *source, uint32_t frames,
-			struct mux_stream_data *data)
+static void mux_channel_s16le(struct audio_stream *sink, int16_t *dst,
+			      const struct audio_stream **sources,
+			      const struct mux_tap *taps, uint8_t num_taps,
+			      uint32_t frames)
 {
-	int32_t sample;
-	int16_t *dst;
-	uint32_t dst_idx;
-	uint8_t i;
-	uint8_t out_ch;
-
-	for (i = 0; i < frames; i++) {
-		for (out_ch = 0; out_ch < sink->channels; out_ch++) {
-			sample = calc_sample_s16le(source,
-						   i * source->channels,
-						   data->mask[out_ch]);
-
-			/* saturate to 16 bits */
-			dst_idx = i * sink->channels + out_ch;
-			dst = audio_stream_write_frag_s16(sink, dst_idx);
-			*dst = sat_int16(sample);
+	const struct audio_stream *a;
+	const struct audio_stream *b;
+	int16_t *src_a;
+	int16_t *src_b;
+	uint32_t i;
+
+	switch (num_taps) {
+	case 0:
+		for (i = 0; i < frames; i++) {
+			*dst = 0;
+			dst = mux_next_frame(sink, dst, sizeof(*dst));
 		}
+		break;
+	case 1:
+		a = sources[taps[0].stream];
+		src_a = audio_stream_read_frag_s16(a, taps[0].channel);
+		for (i = 0; i < frames; i++) {
+			*dst = *src_a;
+			src_a = mux_next_frame(a, src_a, sizeof(*src_a));
+			dst = mux_next_frame(sink, dst, sizeof(*dst));
+		}
+		break;
+	case 2:
+		a = sources[taps[0].stream];
+		b = sources[taps[1].stream];
+		src_a = audio_stream_read_frag_s16(a, taps[0].channel);
+		src_b = audio_stream_read_frag_s16(b, taps[1].channel);
+		for (i = 0; i < frames; i++) {
+			*dst = sat_int16((int32_t)*src_a + *src_b);
+			src_a = mux_next_frame(a, src_a, sizeof(*src_a));
+			src_b = mux_next_frame(b, src_b, sizeof(*src_b));
+			dst = mux_next_frame(sink, dst, sizeof(*dst));
+		}
+		break;
+	default:
+		for (i = 0; i < frames; i++) {
+			*dst = sat_int16(calc_sample_s16le(sources, taps,
+							   num_taps, i));
+			dst = mux_next_frame(sink, dst, sizeof(*dst));
+		}
+		break;
 	}
 }
 
 /* \brief Muxing 16 bit streams.
  *
- * Source streams are routed to sink with regard to routing bitmasks from
- * mux_stream_data structures array. Each source stream has bitmask for each
- * of it's channels describing to which channels of output stream it
- * contributes.
+ * Source streams are routed to sink with regard to routing look up table
+ * compiled from the bitmasks. Each output channel is processed as a copy
+ * of a single input channel, a sum of two input channels or a sum of the
+ * taps in general case.
  *
  * \param[in,out] sink Destination buffer.
  * \param[in,out] sources Array of source buffers.
  * \param[in] frames Number of frames to process.
- * \param[in] data Array of parameters describing channel count and routing for
- *		   each stream.
+ * \param[in] lookup Routing of the sink stream.
  */
 static void mux_s16le(struct audio_stream *sink,
 		      const struct audio_stream **sources, uint32_t frames,
-		      struct mux_stream_data *data)
+		      const struct mux_look_up *lookup)
 {
-	const struct audio_stream *source;
-	uint8_t i;
-	uint8_t j;
-	uint8_t out_ch;
+	struct mux_tap taps[MUX_MAX_STREAMS * PLATFORM_MAX_CHANNELS];
 	int16_t *dst;
-	uint32_t dst_idx;
-	int32_t sample;
-
-	for (i = 0; i < frames; i++) {
-		for (out_ch = 0; out_ch < sink->channels; out_ch++) {
-			sample = 0;
-
-			for (j = 0; j < MUX_MAX_STREAMS; j++) {
-				source = sources[j];
-				if (!source)
-					continue;
-
-				sample += calc_sample_s16le(source,
-						i * source->channels,
-						data[j].mask[out_ch]);
-			}
-			dst_idx = i * sink->channels + out_ch;
-			dst = audio_stream_write_frag_s16(sink, dst_idx);
-			*dst = sat_int16(sample);
-		}
+	uint8_t num_taps;
+	uint8_t out_ch;
+
+	for (out_ch = 0; out_ch < sink->channels; out_ch++) {
+		num_taps = mux_active_taps(sources, lookup, out_ch, taps);
+		dst = audio_stream_write_frag_s16(sink, out_ch);
+		mux_channel_s16le(sink, dst, sources, taps, num_taps, frames);
 	}
 }
+
+/* \brief Demuxing 16 bit streams.
+ *
+ * Source stream is routed to sink with regard to routing look up table
+ * compiled from the bitmasks of the sink stream.
+ *
+ * \param[in,out] sink Destination buffer.
+ * \param[in,out] source Source buffer.
+ * \param[in] frames Number of frames to process.
+ * \param[in] lookup Routing of the sink stream.
+ */
+static void demux_s16le(struct audio_stream *sink,
+			const struct audio_stream *source, uint32_t frames,
+			const struct mux_look_up *lookup)
+{
+	mux_s16le(sink, &source, frames, lookup);
+}
 #endif /* CONFIG_FORMAT_S16LE */
 
 #if CONFIG_FORMAT_S24LE
 /*
- * \brief Fetch 24b samples from source buffer and perform routing operations
- *	  based on mask provided.
- * \param[in,out] source Source buffer.
- * \param[in] offset Offset in source buffer.
- * \param[in] mask Routing bitmask for calculating output sample.
+ * \brief Fetch 24b samples from source buffers and sum the taps of an
+ *	  output channel.
+ * \param[in] sources Array of source buffers.
+ * \param[in] taps Input channels to sum.
+ * \param[in] num_taps Number of taps.
+ * \param[in] frame Frame index in source buffers.
  */
-UT_STATIC inline int32_t calc_sample_s24le(const struct audio_stream *source,
-					   uint32_t offset, uint8_t mask)
+UT_STATIC inline int32_t calc_sample_s24le(const struct audio_stream **sources,
+					   const struct mux_tap *taps,
+					   uint8_t num_taps, uint32_t frame)
 {
+	const struct audio_stream *source;
 	int32_t sample = 0;
 	int32_t *src;
-	int8_t in_ch;
-
-	if (mask == 0)
-		return 0;
+	uint8_t i;
 
-	for (in_ch = 0; in_ch < source->channels; in_ch++) {
-		if (mask & BIT(in_ch)) {
-			src = audio_stream_read_frag_s32(source,
-							 offset + in_ch);
-			sample += sign_extend_s24(*src);
-		}
+	for (i = 0; i < num_taps; i++) {
+		source = sources[taps[i].stream];
+		src = audio_stream_read_frag_s32(source,
+						 frame * source->channels +
+						 taps[i].channel);
+		sample += sign_extend_s24(*src);
 	}
 
 	return sample;
 }
 
-/* \brief Demuxing 24 bit streams.
- *
- * Source stream is routed to sink with regard to routing bitmasks from
- * mux_stream_data structure. Each bitmask describes composition of single
- * output channel.
- *
+/*
+ * \brief Produces an output channel as sum of its taps.
  * \param[in,out] sink Destination buffer.
- * \param[in,out] source Source buffer.
+ * \param[in,out] dst Position of first output sample.
+ * \param[in] sources Array of source buffers.
+ * \param[in] taps Input channels to sum.
+ * \param[in] num_taps Number of taps.
  * \param[in] frames Number of frames to process.
- * \param[in] data Parameters describing channel count and routing.
  */
-static void demux_s24le(struct audio_stream *sink,
-			const struct audio_stream *source, uint32_t frames,
-			struct mux_stream_data *data)
+static void mux_channel_s24le(struct audio_stream *sink, int32_t *dst,
+			      const struct audio_stream **sources,
+			      const struct mux_tap *taps, uint8_t num_taps,
+			      uint32_t frames)
 {
-	int32_t sample;
-	int32_t *dst;
-	uint32_t dst_idx;
-	uint8_t i;
-	uint8_t out_ch;
-
-	for (i = 0; i < frames; i++) {
-		for (out_ch = 0; out_ch < sink->channels; out_ch++) {
-			sample = calc_sample_s24le(source,
-						   i * source->channels,
-						   data->mask[out_ch]);
-
-			/* saturate to 24 bits */
-			dst_idx = i * sink->channels + out_ch;
-			dst = audio_stream_write_frag_s32(sink, dst_idx);
-			*dst = sat_int24(sample);
+	const struct audio_stream *a;
+	const struct audio_stream *b;
+	int32_t *src_a;
+	int32_t *src_b;
+	uint32_t i;
+
+	switch (num_taps) {
+	case 0:
+		for (i = 0; i < frames; i++) {
+			*dst = 0;
+			dst = mux_next_frame(sink, dst, sizeof(*dst));
+		}
+		break;
+	case 1:
+		a = sources[taps[0].stream];
+		src_a = audio_stream_read_frag_s32(a, taps[0].channel);
+		for (i = 0; i < frames; i++) {
+			*dst = sign_extend_s24(*src_a);
+			src_a = mux_next_frame(a, src_a, sizeof(*src_a));
+			dst = mux_next_frame(sink, dst, sizeof(*dst));
+		}
+		break;
+	case 2:
+		a = sources[taps[0].stream];
+		b = sources[taps[1].stream];
+		src_a = audio_stream_read_frag_s32(a, taps[0].channel);
+		src_b = audio_stream_read_frag_s32(b, taps[1].channel);
+		for (i = 0; i < frames; i++) {
+			*dst = sat_int24(sign_extend_s24(*src_a) +
+					 sign_extend_s24(*src_b));
+			src_a = mux_next_frame(a, src_a, sizeof(*src_a));
+			src_b = mux_next_frame(b, src_b, sizeof(*src_b));
+			dst = mux_next_frame(sink, dst, sizeof(*dst));
 		}
+		break;
+	default:
+		for (i = 0; i < frames; i++) {
+			*dst = sat_int24(calc_sample_s24le(sources, taps,
+							   num_taps, i));
+			dst = mux_next_frame(sink, dst, sizeof(*dst));
+		}
+		break;
 	}
 }
 
 /* \brief Muxing 24 bit streams.
  *
- * Source streams are routed to sink with regard to routing bitmasks from
- * mux_stream_data structures array. Each source stream has bitmask for each
- * of it's channels describing to which channels of output stream it
- * contributes.
+ * Source streams are routed to sink with regard to routing look up table
+ * compiled from the bitmasks. Each output channel is processed as a copy
+ * of a single input channel, a sum of two input channels or a sum of the
+ * taps in general case.
  *
  * \param[in,out] sink Destination buffer.
  * \param[in,out] sources Array of source buffers.
  * \param[in] frames Number of frames to process.
- * \param[in] data Array of parameters describing channel count and routing for
- *		   each stream.
+ * \param[in] lookup Routing of the sink stream.
  */
 static void mux_s24le(struct audio_stream *sink,
 		      const struct audio_stream **sources, uint32_t frames,
-		      struct mux_stream_data *data)
+		      const struct mux_look_up *lookup)
 {
-	const struct audio_stream *source;
-	uint8_t i;
-	uint8_t j;
-	uint8_t out_ch;
+	struct mux_tap taps[MUX_MAX_STREAMS * PLATFORM_MAX_CHANNELS];
 	int32_t *dst;
-	uint32_t dst_idx;
-	int32_t sample;
-
-	for (i = 0; i < frames; i++) {
-		for (out_ch = 0; out_ch < sink->channels; out_ch++) {
-			sample = 0;
-			for (j = 0; j < MUX_MAX_STREAMS; j++) {
-				source = sources[j];
-				if (!source)
-					continue;
-
-				sample += calc_sample_s24le(source,
-						i * source->channels,
-						data[j].mask[out_ch]);
-			}
-			dst_idx = i * sink->channels + out_ch;
-			dst = audio_stream_write_frag_s32(sink, dst_idx);
-			*dst = sat_int24(sample);
-		}
+	uint8_t num_taps;
+	uint8_t out_ch;
+
+	for (out_ch = 0; out_ch < sink->channels; out_ch++) {
+		num_taps = mux_active_taps(sources, lookup, out_ch, taps);
+		dst = audio_stream_write_frag_s32(sink, out_ch);
+		mux_channel_s24le(sink, dst, sources, taps, num_taps, frames);
 	}
 }
+
+/* \brief Demuxing 24 bit streams.
+ *
+ * Source stream is routed to sink with regard to routing look up table
+ * compiled from the bitmasks of the sink stream.
+ *
+ * \param[in,out] sink Destination buffer.
+ * \param[in,out] source Source buffer.
+ * \param[in] frames Number of frames to process.
+ * \param[in] lookup Routing of the sink stream.
+ */
+static void demux_s24le(struct audio_stream *sink,
+			const struct audio_stream *source, uint32_t frames,
+			const struct mux_look_up *lookup)
+{
+	mux_s24le(sink, &source, frames, lookup);
+}
 #endif /* CONFIG_FORMAT_S24LE */
 
 #if CONFIG_FORMAT_S32LE
 /*
- * \brief Fetch 32b samples from source buffer and perform routing operations
- *	  based on mask provided.
- * \param[in,out] source Source buffer.
- * \param[in] offset Offset in source buffer.
- * \param[in] mask Routing bitmask for calculating output sample.
+ * \brief Fetch 32b samples from source buffers and sum the taps of an
+ *	  output channel.
+ * \param[in] sources Array of source buffers.
+ * \param[in] taps Input channels to sum.
+ * \param[in] num_taps Number of taps.
+ * \param[in] frame Frame index in source buffers.
  */
-UT_STATIC inline int64_t calc_sample_s32le(const struct audio_stream *source,
-					   uint32_t offset, uint8_t mask)
+UT_STATIC inline int64_t calc_sample_s32le(const struct audio_stream **sources,
+					   const struct mux_tap *taps,
+					   uint8_t num_taps, uint32_t frame)
 {
+	const struct audio_stream *source;
 	int64_t sample = 0;
 	int32_t *src;
-	int8_t in_ch;
-
-	if (mask == 0)
-		return 0;
+	uint8_t i;
 
-	for (in_ch = 0; in_ch < source->channels; in_ch++) {
-		if (mask & BIT(in_ch)) {
-			src = audio_stream_read_frag_s32(source,
-							 offset + in_ch);
-			sample += *src;
-		}
+	for (i = 0; i < num_taps; i++) {
+		source = sources[taps[i].stream];
+		src = audio_stream_read_frag_s32(source,
+						 frame * source->channels +
+						 taps[i].channel);
+		sample += *src;
 	}
 
 	return sample;
 }
 
-/* \brief Demuxing 32 bit streams.
- *
- * Source stream is routed to sink with regard to routing bitmasks from
- * mux_stream_data structure. Each bitmask describes composition of single
- * output channel.
- *
+/*
+ * \brief Produces an output channel as sum of its taps.
  * \param[in,out] sink Destination buffer.
- * \param[in,out] source Source buffer.
+ * \param[in,out] dst Position of first output sample.
+ * \param[in] sources Array of source buffers.
+ * \param[in] taps Input channels to sum.
+ * \param[in] num_taps Number of taps.
  * \param[in] frames Number of frames to process.
- * \param[in] data Parameters describing channel count and routing.
  */
-static void demux_s32le(struct audio_stream *sink,
-			const struct audio_stream *source, uint32_t frames,
-			struct mux_stream_data *data)
+static void mux_channel_s32le(struct audio_stream *sink, int32_t *dst,
+			      const struct audio_stream **sources,
+			      const struct mux_tap *taps, uint8_t num_taps,
+			      uint32_t frames)
 {
-	int64_t sample;
-	int32_t *dst;
-	uint32_t dst_idx;
-	uint8_t i;
-	uint8_t out_ch;
-
-	for (i = 0; i < frames; i++) {
-		for (out_ch = 0; out_ch < sink->channels; out_ch++) {
-			sample = calc_sample_s32le(source,
-						   i * source->channels,
-						   data->mask[out_ch]);
-
-			/* saturate to 32 bits */
-			dst_idx = i * sink->channels + out_ch;
-			dst = audio_stream_write_frag_s32(sink, dst_idx);
-			*dst = sat_int32(sample);
+	const struct audio_stream *a;
+	const struct audio_stream *b;
+	int32_t *src_a;
+	int32_t *src_b;
+	uint32_t i;
+
+	switch (num_taps) {
+	case 0:
+		for (i = 0; i < frames; i++) {
+			*dst = 0;
+			dst = mux_next_frame(sink, dst, sizeof(*dst));
 		}
+		break;
+	case 1:
+		a = sources[taps[0].stream];
+		src_a = audio_stream_read_frag_s32(a, taps[0].channel);
+		for (i = 0; i < frames; i++) {
+			*dst = *src_a;
+			src_a = mux_next_frame(a, src_a, sizeof(*src_a));
+			dst = mux_next_frame(sink, dst, sizeof(*dst));
+		}
+		break;
+	case 2:
+		a = sources[taps[0].stream];
+		b = sources[taps[1].stream];
+		src_a = audio_stream_read_frag_s32(a, taps[0].channel);
+		src_b = audio_stream_read_frag_s32(b, taps[1].channel);
+		for (i = 0; i < frames; i++) {
+			*dst = sat_int32((int64_t)*src_a + *src_b);
+			src_a = mux_next_frame(a, src_a, sizeof(*src_a));
+			src_b = mux_next_frame(b, src_b, sizeof(*src_b));
+			dst = mux_next_frame(sink, dst, sizeof(*dst));
+		}
+		break;
+	default:
+		for (i = 0; i < frames; i++) {
+			*dst = sat_int32(calc_sample_s32le(sources, taps,
+							   num_taps, i));
+			dst = mux_next_frame(sink, dst, sizeof(*dst));
+		}
+		break;
 	}
 }
 
 /* \brief Muxing 32 bit streams.
  *
- * Source streams are routed to sink with regard to routing bitmasks from
- * mux_stream_data structures array. Each source stream has bitmask for each
- * of it's channels describing to which channels of output stream it
- * contributes.
+ * Source streams are routed to sink with regard to routing look up table
+ * compiled from the bitmasks. Each output channel is processed as a copy
+ * of a single input channel, a sum of two input channels or a sum of the
+ * taps in general case.
  *
  * \param[in,out] sink Destination buffer.
  * \param[in,out] sources Array of source buffers.
  * \param[in] frames Number of frames to process.
- * \param[in] data Array of parameters describing channel count and routing for
- *		   each stream.
+ * \param[in] lookup Routing of the sink stream.
  */
 static void mux_s32le(struct audio_stream *sink,
 		      const struct audio_stream **sources, uint32_t frames,
-		      struct mux_stream_data *data)
+		      const struct mux_look_up *lookup)
 {
-	const struct audio_stream *source;
-	uint8_t i;
-	uint8_t j;
-	uint8_t out_ch;
+	struct mux_tap taps[MUX_MAX_STREAMS * PLATFORM_MAX_CHANNELS];
 	int32_t *dst;
-	uint32_t dst_idx;
-	int64_t sample;
-
-	for (i = 0; i < frames; i++) {
-		for (out_ch = 0; out_ch < sink->channels; out_ch++) {
-			sample = 0;
-			for (j = 0; j < MUX_MAX_STREAMS; j++) {
-				source = sources[j];
-				if (!source)
-					continue;
-
-				sample += calc_sample_s32le(source,
-						i * source->channels,
-						data[j].mask[out_ch]);
-			}
-			dst_idx = i * sink->channels + out_ch;
-			dst = audio_stream_write_frag_s32(sink, dst_idx);
-			*dst = sat_int32(sample);
-		}
+	uint8_t num_taps;
+	uint8_t out_ch;
+
+	for (out_ch = 0; out_ch < sink->channels; out_ch++) {
+		num_taps = mux_active_taps(sources, lookup, out_ch, taps);
+		dst = audio_stream_write_frag_s32(sink, out_ch);
+		mux_channel_s32le(sink, dst, sources, taps, num_taps, frames);
 	}
 }
 
+/* \brief Demuxing 32 bit streams.
+ *
+ * Source stream is routed to sink with regard to routing look up table
+ * compiled from the bitmasks of the sink stream.
+ *
+ * \param[in,out] sink Destination buffer.
+ * \param[in,out] source Source buffer.
+ * \param[in] frames Number of frames to process.
+ * \param[in] lookup Routing of the sink stream.
+ */
+static void demux_s32le(struct audio_stream *sink,
+			const struct audio_stream *source, uint32_t frames,
+			const struct mux_look_up *lookup)
+{
+	mux_s32le(sink, &source, frames, lookup);
+}
 #endif /* CONFIG_FORMAT_S32LE */
 
 const struct comp_func_map mux_func_map[] = {
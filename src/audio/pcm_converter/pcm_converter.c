@@ -11,39 +11,156 @@
  */
 
 #include <sof/audio/audio_stream.h>
+#include <sof/audio/format.h>
 #include <sof/audio/pcm_converter.h>
+#include <sof/common.h>
 #include <sof/debug/panic.h>
+#include <sof/lib/alloc.h>
+#include <ipc/topology.h>
+#include <errno.h>
 
 void pcm_convert_as_linear(const struct audio_stream *source, uint32_t ioffset,
 			   struct audio_stream *sink, uint32_t ooffset,
 			   uint32_t samples, pcm_converter_lin_func converter)
 {
-	const int s_size_in = audio_stream_sample_bytes(source);
-	const int s_size_out = audio_stream_sample_bytes(sink);
-	char *r_ptr = audio_stream_get_frag(source, source->r_ptr, ioffset,
-					    s_size_in);
-	char *w_ptr = audio_stream_get_frag(sink, sink->w_ptr, ooffset,
-					    s_size_in);
-	int i = 0;
-	int chunk;
-	int N1, N2;
+	struct audio_stream_span span;
+	uint32_t chunk;
 
 	assert(audio_stream_get_avail_samples(source) >= samples + ioffset);
 	assert(audio_stream_get_free_samples(sink) >= samples + ooffset);
 
-	while (i < samples) {
-		/* calculate chunk size */
-		N1 = audio_stream_bytes_without_wrap(source, r_ptr);
-		N2 = audio_stream_bytes_without_wrap(sink, w_ptr);
-		chunk = MIN(N1, N2) * s_size_out;
-		chunk = MIN(chunk, samples - i);
+	audio_stream_span_init(&span, source, ioffset,
+			       audio_stream_sample_bytes(source), sink, ooffset,
+			       audio_stream_sample_bytes(sink), samples);
 
-		/* run conversion on linear memory region */
-		converter(r_ptr, w_ptr, chunk);
+	/* run conversion on linear memory regions */
+	while ((chunk = audio_stream_span_next(&span)))
+		converter(span.src, span.snk, chunk);
+}
+
+int pcm_adapter_init(struct pcm_adapter *adapter, enum sof_ipc_frame source,
+		     enum sof_ipc_frame process, enum sof_ipc_frame sink,
+		     uint32_t channels)
+{
+	size_t block;
+	int blocks;
+
+	pcm_adapter_free(adapter);
+
+	if (!channels)
+		return -EINVAL;
+
+	/* even number of frames, at least one pair with many channels */
+	adapter->frames = MAX((PCM_ADAPTER_SAMPLES / channels) & ~1u, 2u);
+
+	adapter->process_fmt = process;
+	adapter->convert_in = NULL;
+	adapter->convert_out = NULL;
+
+	if (source != process) {
+		adapter->convert_in = pcm_get_conversion_function(source,
+								  process);
+		if (!adapter->convert_in)
+			return -EINVAL;
+	}
+
+	if (process != sink) {
+		adapter->convert_out = pcm_get_conversion_function(process,
+								   sink);
+		if (!adapter->convert_out)
+			return -EINVAL;
+	}
+
+	blocks = !!adapter->convert_in + !!adapter->convert_out;
+	if (!blocks)
+		return 0;
+
+	/* blocks are sized for 32 bit samples */
+	block = adapter->frames * channels * sizeof(int32_t);
+
+	adapter->in = rballoc(0, SOF_MEM_CAPS_RAM, blocks * block);
+	if (!adapter->in)
+		return -ENOMEM;
+
+	adapter->out = adapter->convert_in ?
+		       (char *)adapter->in + block : adapter->in;
+
+	return 0;
+}
+
+void pcm_adapter_free(struct pcm_adapter *adapter)
+{
+	rfree(adapter->in);
+	adapter->in = NULL;
+	adapter->out = NULL;
+}
+
+/* linear block in processing format for the adapter */
+static void pcm_adapter_block(struct audio_stream *block, void *addr,
+			      const struct audio_stream *stream,
+			      enum sof_ipc_frame frame_fmt, uint32_t frames)
+{
+	*block = *stream;
+	block->frame_fmt = frame_fmt;
+	audio_stream_init(block, addr,
+			  frames * audio_stream_frame_bytes(block));
+}
+
+/* copy of a stream starting frames later */
+static void pcm_adapter_skip(struct audio_stream *copy,
+			     const struct audio_stream *stream,
+			     uint32_t frames)
+{
+	uint32_t bytes = frames * audio_stream_frame_bytes(stream);
+
+	*copy = *stream;
+	copy->r_ptr = audio_stream_wrap(stream, (char *)stream->r_ptr + bytes);
+	copy->w_ptr = audio_stream_wrap(stream, (char *)stream->w_ptr + bytes);
+	copy->avail -= MIN(copy->avail, bytes);
+	copy->free -= MIN(copy->free, bytes);
+}
+
+void pcm_adapter_process(struct pcm_adapter *adapter,
+			 const struct audio_stream *source,
+			 struct audio_stream *sink, uint32_t frames,
+			 pcm_adapter_func func, void *ctx)
+{
+	struct audio_stream in;
+	struct audio_stream out;
+	uint32_t nch = source->channels;
+	uint32_t done;
+	uint32_t n;
+
+	if (!adapter->convert_in && !adapter->convert_out) {
+		func(ctx, source, sink, frames);
+		return;
+	}
+
+	for (done = 0; done < frames; done += n) {
+		n = MIN(frames - done, adapter->frames);
+
+		if (adapter->convert_in) {
+			pcm_adapter_block(&in, adapter->in, source,
+					  adapter->process_fmt, n);
+			adapter->convert_in(source, done * nch, &in, 0,
+					    n * nch);
+			audio_stream_produce(&in, in.size);
+		} else {
+			pcm_adapter_skip(&in, source, done);
+		}
+
+		if (adapter->convert_out)
+			pcm_adapter_block(&out, adapter->out, sink,
+					  adapter->process_fmt, n);
+		else
+			pcm_adapter_skip(&out, sink, done);
+
+		func(ctx, &in, &out, n);
 
-		/* move pointers */
-		r_ptr = audio_stream_wrap(source, r_ptr + chunk * s_size_in);
-		w_ptr = audio_stream_wrap(sink, w_ptr + chunk * s_size_out);
-		i += chunk;
+		if (adapter->convert_out) {
+			audio_stream_produce(&out, out.size);
+			adapter->convert_out(&out, 0, sink, done * nch,
+					     n * nch);
+		}
 	}
 }
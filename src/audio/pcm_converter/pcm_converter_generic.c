@@ -30,16 +30,20 @@ static void pcm_convert_s16_to_s24(const struct audio_stream *source,
 				   uint32_t ioffset, struct audio_stream *sink,
 				   uint32_t ooffset, uint32_t samples)
 {
-	uint32_t buff_frag = 0;
+	struct audio_stream_span span;
 	int16_t *src;
 	int32_t *dst;
+	uint32_t n;
 	uint32_t i;
 
-	for (i = 0; i < samples; i++) {
-		src = audio_stream_read_frag_s16(source, buff_frag + ioffset);
-		dst = audio_stream_write_frag_s32(sink, buff_frag + ooffset);
-		*dst = *src << 8;
-		buff_frag++;
+	audio_stream_span_init(&span, source, ioffset, sizeof(*src), sink,
+			       ooffset, sizeof(*dst), samples);
+
+	while ((n = audio_stream_span_next(&span))) {
+		src = span.src;
+		dst = span.snk;
+		for (i = 0; i < n; i++)
+			dst[i] = src[i] << 8;
 	}
 }
 
@@ -47,16 +51,21 @@ static void pcm_convert_s24_to_s16(const struct audio_stream *source,
 				   uint32_t ioffset, struct audio_stream *sink,
 				   uint32_t ooffset, uint32_t samples)
 {
-	uint32_t buff_frag = 0;
+	struct audio_stream_span span;
 	int32_t *src;
 	int16_t *dst;
+	uint32_t n;
 	uint32_t i;
 
-	for (i = 0; i < samples; i++) {
-		src = audio_stream_read_frag_s32(source, buff_frag + ioffset);
-		dst = audio_stream_write_frag_s16(sink, buff_frag + ooffset);
-		*dst = sat_int16(Q_SHIFT_RND(sign_extend_s24(*src), 23, 15));
-		buff_frag++;
+	audio_stream_span_init(&span, source, ioffset, sizeof(*src), sink,
+			       ooffset, sizeof(*dst), samples);
+
+	while ((n = audio_stream_span_next(&span))) {
+		src = span.src;
+		dst = span.snk;
+		for (i = 0; i < n; i++)
+			dst[i] = sat_int16(Q_SHIFT_RND(sign_extend_s24(src[i]),
+						       23, 15));
 	}
 }
 
@@ -68,16 +77,20 @@ static void pcm_convert_s16_to_s32(const struct audio_stream *source,
 				   uint32_t ioffset, struct audio_stream *sink,
 				   uint32_t ooffset, uint32_t samples)
 {
-	uint32_t buff_frag = 0;
+	struct audio_stream_span span;
 	int16_t *src;
 	int32_t *dst;
+	uint32_t n;
 	uint32_t i;
 
-	for (i = 0; i < samples; i++) {
-		src = audio_stream_read_frag_s16(source, buff_frag + ioffset);
-		dst = audio_stream_write_frag_s32(sink, buff_frag + ooffset);
-		*dst = *src << 16;
-		buff_frag++;
+	audio_stream_span_init(&span, source, ioffset, sizeof(*src), sink,
+			       ooffset, sizeof(*dst), samples);
+
+	while ((n = audio_stream_span_next(&span))) {
+		src = span.src;
+		dst = span.snk;
+		for (i = 0; i < n; i++)
+			dst[i] = src[i] << 16;
 	}
 }
 
@@ -85,16 +98,20 @@ static void pcm_convert_s32_to_s16(const struct audio_stream *source,
 				   uint32_t ioffset, struct audio_stream *sink,
 				   uint32_t ooffset, uint32_t samples)
 {
-	uint32_t buff_frag = 0;
+	struct audio_stream_span span;
 	int32_t *src;
 	int16_t *dst;
+	uint32_t n;
 	uint32_t i;
 
-	for (i = 0; i < samples; i++) {
-		src = audio_stream_read_frag_s32(source, buff_frag + ioffset);
-		dst = audio_stream_write_frag_s16(sink, buff_frag + ooffset);
-		*dst = sat_int16(Q_SHIFT_RND(*src, 31, 15));
-		buff_frag++;
+	audio_stream_span_init(&span, source, ioffset, sizeof(*src), sink,
+			       ooffset, sizeof(*dst), samples);
+
+	while ((n = audio_stream_span_next(&span))) {
+		src = span.src;
+		dst = span.snk;
+		for (i = 0; i < n; i++)
+			dst[i] = sat_int16(Q_SHIFT_RND(src[i], 31, 15));
 	}
 }
 
@@ -106,16 +123,20 @@ static void pcm_convert_s24_to_s32(const struct audio_stream *source,
 				   uint32_t ioffset, struct audio_stream *sink,
 				   uint32_t ooffset, uint32_t samples)
 {
-	uint32_t buff_frag = 0;
+	struct audio_stream_span span;
 	int32_t *src;
 	int32_t *dst;
+	uint32_t n;
 	uint32_t i;
 
-	for (i = 0; i < samples; i++) {
-		src = audio_stream_read_frag_s32(source, buff_frag + ioffset);
-		dst = audio_stream_write_frag_s32(sink, buff_frag + ooffset);
-		*dst = *src << 8;
-		buff_frag++;
+	audio_stream_span_init(&span, source, ioffset, sizeof(*src), sink,
+			       ooffset, sizeof(*dst), samples);
+
+	while ((n = audio_stream_span_next(&span))) {
+		src = span.src;
+		dst = span.snk;
+		for (i = 0; i < n; i++)
+			dst[i] = src[i] << 8;
 	}
 }
 
@@ -123,16 +144,20 @@ static void pcm_convert_s32_to_s24(const struct audio_stream *source,
 				   uint32_t ioffset, struct audio_stream *sink,
 				   uint32_t ooffset, uint32_t samples)
 {
-	uint32_t buff_frag = 0;
+	struct audio_stream_span span;
 	int32_t *src;
 	int32_t *dst;
+	uint32_t n;
 	uint32_t i;
 
-	for (i = 0; i < samples; i++) {
-		src = audio_stream_read_frag_s32(source, buff_frag + ioffset);
-		dst = audio_stream_write_frag_s32(sink, buff_frag + ooffset);
-		*dst = sat_int24(Q_SHIFT_RND(*src, 31, 23));
-		buff_frag++;
+	audio_stream_span_init(&span, source, ioffset, sizeof(*src), sink,
+			       ooffset, sizeof(*dst), samples);
+
+	while ((n = audio_stream_span_next(&span))) {
+		src = span.src;
+		dst = span.snk;
+		for (i = 0; i < n; i++)
+			dst[i] = sat_int24(Q_SHIFT_RND(src[i], 31, 23));
 	}
 }
 
@@ -201,9 +226,12 @@ static int32_t _pcm_convert_f_to_i(int32_t src, int32_t pow)
 	mantissa = BIT(23) | (MASK(22, 0) & src); /* mantisa + 1.0 [Q9.22] */
 	/* calculate power */
 	dst = _pcm_shift(mantissa, exponent - 23);
-	/* add 0.5 to round correctly but assert it doesn't lead to overflow */
-	if (exponent - 22 < 9 || (src & BIT(31)) == BIT(31))
+	/* add 0.5 to round correctly when there are fractional bits */
+	if (exponent < 23)
 		dst += _pcm_shift(mantissa, exponent - 22) & 1;
+	/* saturated negative value, INT32_MAX can't be negated to it */
+	else if (exponent >= 31 && (src & BIT(31)) == BIT(31))
+		return INT32_MIN;
 	/* copy sign to dst */
 	dst = (dst ^ (src >> 31)) + (int)((unsigned int)src >> 31);
 
@@ -377,6 +405,203 @@ static void pcm_convert_f_to_s32(const struct audio_stream *source,
 }
 #endif /* CONFIG_FORMAT_FLOAT && CONFIG_FORMAT_S32LE */
 
+#if CONFIG_FORMAT_CONVERT_FLOAT_NATIVE
+/*
+ * Conversions using the native float type, for targets with a float unit.
+ * Scaling by a power of two is exact and the rounding follows the integer
+ * versions above bit exactly: float to fixed rounds half away from zero and
+ * saturates, fixed to float truncates the mantissa. The loops have no
+ * branches so the compiler can vectorize them.
+ */
+
+/**
+ * \brief convert float number to fixed point using float unit
+ * \param src float number to convert
+ * \param scale 2**pow, pow is number of fractional bits in fixed point value
+ * \return src * scale rounded and saturated to int32_t
+ */
+static inline int32_t pcm_convert_f_to_i_native(float src, float scale)
+{
+	union {
+		float f;
+		int32_t i;
+	} in = { .f = src };
+	double x;
+
+	/* NaN and infinity can't be compared reliably when the compiler
+	 * assumes finite math, replace them with the largest finite value
+	 * of the same sign using integer operations. It saturates by sign
+	 * like the integer version does.
+	 */
+	in.i = (in.i & MASK(30, 23)) == MASK(30, 23) ?
+	       (in.i & BIT(31)) | (MASK(30, 0) & ~BIT(23)) : in.i;
+
+	/* double holds the float mantissa with the rounding offset exactly */
+	x = (double)in.f * scale;
+	x += in.f < 0 ? -0.5 : 0.5;
+
+	/* saturate before truncation */
+	x = x < INT32_MAX ? x : INT32_MAX;
+	x = x > INT32_MIN ? x : INT32_MIN;
+
+	return (int32_t)x;
+}
+
+/**
+ * \brief convert fixed number to float using float unit
+ * \param src integer number to convert
+ * \param scale 2**-pow, pow is number of fractional bits in fixed point value
+ * \return src * scale with mantissa truncated towards zero
+ */
+static inline float pcm_convert_i_to_f_native(int32_t src, float scale)
+{
+	union {
+		float f;
+		int32_t i;
+	} dst;
+	double err;
+
+	/* rounding is possible only for more than 24 significant bits,
+	 * step back towards zero when it increased the magnitude
+	 */
+	dst.f = (float)src;
+	err = (double)dst.f - src;
+	dst.i -= ((src < 0) & (err < 0)) | ((src > 0) & (err > 0));
+
+	return dst.f * scale;
+}
+
+#if CONFIG_FORMAT_S16LE
+static void pcm_convert_s16_to_f_native_lin(const void *psrc, void *pdst,
+					    uint32_t samples)
+{
+	const int16_t *src = psrc;
+	float *dst = pdst;
+	int i;
+
+	/* s16 has no more than 24 significant bits, conversion is exact */
+	for (i = 0; i < samples; i++)
+		dst[i] = (float)src[i] * (1.0f / (1 << 15));
+}
+
+static void pcm_convert_f_to_s16_native_lin(const void *psrc, void *pdst,
+					    uint32_t samples)
+{
+	const float *src = psrc;
+	int16_t *dst = pdst;
+	int i;
+
+	for (i = 0; i < samples; i++)
+		dst[i] = sat_int16(pcm_convert_f_to_i_native(src[i],
+							     1 << 15));
+}
+
+static void pcm_convert_s16_to_f_native(const struct audio_stream *source,
+					uint32_t ioffset,
+					struct audio_stream *sink,
+					uint32_t ooffset, uint32_t samples)
+{
+	pcm_convert_as_linear(source, ioffset, sink, ooffset, samples,
+			      pcm_convert_s16_to_f_native_lin);
+}
+
+static void pcm_convert_f_to_s16_native(const struct audio_stream *source,
+					uint32_t ioffset,
+					struct audio_stream *sink,
+					uint32_t ooffset, uint32_t samples)
+{
+	pcm_convert_as_linear(source, ioffset, sink, ooffset, samples,
+			      pcm_convert_f_to_s16_native_lin);
+}
+#endif /* CONFIG_FORMAT_S16LE */
+
+#if CONFIG_FORMAT_S24LE
+static void pcm_convert_s24_to_f_native_lin(const void *psrc, void *pdst,
+					    uint32_t samples)
+{
+	const int32_t *src = psrc;
+	float *dst = pdst;
+	int i;
+
+	/* s24 has no more than 24 significant bits, conversion is exact */
+	for (i = 0; i < samples; i++)
+		dst[i] = (float)sign_extend_s24(src[i]) * (1.0f / (1 << 23));
+}
+
+static void pcm_convert_f_to_s24_native_lin(const void *psrc, void *pdst,
+					    uint32_t samples)
+{
+	const float *src = psrc;
+	int32_t *dst = pdst;
+	int i;
+
+	for (i = 0; i < samples; i++)
+		dst[i] = sat_int24(pcm_convert_f_to_i_native(src[i],
+							     1 << 23));
+}
+
+static void pcm_convert_s24_to_f_native(const struct audio_stream *source,
+					uint32_t ioffset,
+					struct audio_stream *sink,
+					uint32_t ooffset, uint32_t samples)
+{
+	pcm_convert_as_linear(source, ioffset, sink, ooffset, samples,
+			      pcm_convert_s24_to_f_native_lin);
+}
+
+static void pcm_convert_f_to_s24_native(const struct audio_stream *source,
+					uint32_t ioffset,
+					struct audio_stream *sink,
+					uint32_t ooffset, uint32_t samples)
+{
+	pcm_convert_as_linear(source, ioffset, sink, ooffset, samples,
+			      pcm_convert_f_to_s24_native_lin);
+}
+#endif /* CONFIG_FORMAT_S24LE */
+
+#if CONFIG_FORMAT_S32LE
+static void pcm_convert_s32_to_f_native_lin(const void *psrc, void *pdst,
+					    uint32_t samples)
+{
+	const int32_t *src = psrc;
+	float *dst = pdst;
+	int i;
+
+	for (i = 0; i < samples; i++)
+		dst[i] = pcm_convert_i_to_f_native(src[i], 1.0f / (1u << 31));
+}
+
+static void pcm_convert_f_to_s32_native_lin(const void *psrc, void *pdst,
+					    uint32_t samples)
+{
+	const float *src = psrc;
+	int32_t *dst = pdst;
+	int i;
+
+	for (i = 0; i < samples; i++)
+		dst[i] = pcm_convert_f_to_i_native(src[i], 1u << 31);
+}
+
+static void pcm_convert_s32_to_f_native(const struct audio_stream *source,
+					uint32_t ioffset,
+					struct audio_stream *sink,
+					uint32_t ooffset, uint32_t samples)
+{
+	pcm_convert_as_linear(source, ioffset, sink, ooffset, samples,
+			      pcm_convert_s32_to_f_native_lin);
+}
+
+static void pcm_convert_f_to_s32_native(const struct audio_stream *source,
+					uint32_t ioffset,
+					struct audio_stream *sink,
+					uint32_t ooffset, uint32_t samples)
+{
+	pcm_convert_as_linear(source, ioffset, sink, ooffset, samples,
+			      pcm_convert_f_to_s32_native_lin);
+}
+#endif /* CONFIG_FORMAT_S32LE */
+#endif /* CONFIG_FORMAT_CONVERT_FLOAT_NATIVE */
+
 const struct pcm_func_map pcm_func_map[] = {
 #if CONFIG_FORMAT_S16LE
 	{ SOF_IPC_FRAME_S16_LE, SOF_IPC_FRAME_S16_LE, audio_stream_copy_s16 },
@@ -402,6 +627,24 @@ const struct pcm_func_map pcm_func_map[] = {
 #if CONFIG_FORMAT_FLOAT
 	{ SOF_IPC_FRAME_FLOAT, SOF_IPC_FRAME_FLOAT, audio_stream_copy_s32 },
 #endif /* CONFIG_FORMAT_FLOAT */
+#if CONFIG_FORMAT_CONVERT_FLOAT_NATIVE && CONFIG_FORMAT_S16LE
+	{ SOF_IPC_FRAME_S16_LE, SOF_IPC_FRAME_FLOAT,
+	  pcm_convert_s16_to_f_native },
+	{ SOF_IPC_FRAME_FLOAT, SOF_IPC_FRAME_S16_LE,
+	  pcm_convert_f_to_s16_native },
+#endif /* CONFIG_FORMAT_CONVERT_FLOAT_NATIVE && CONFIG_FORMAT_S16LE */
+#if CONFIG_FORMAT_CONVERT_FLOAT_NATIVE && CONFIG_FORMAT_S24LE
+	{ SOF_IPC_FRAME_S24_4LE, SOF_IPC_FRAME_FLOAT,
+	  pcm_convert_s24_to_f_native },
+	{ SOF_IPC_FRAME_FLOAT, SOF_IPC_FRAME_S24_4LE,
+	  pcm_convert_f_to_s24_native },
+#endif /* CONFIG_FORMAT_CONVERT_FLOAT_NATIVE && CONFIG_FORMAT_S24LE */
+#if CONFIG_FORMAT_CONVERT_FLOAT_NATIVE && CONFIG_FORMAT_S32LE
+	{ SOF_IPC_FRAME_S32_LE, SOF_IPC_FRAME_FLOAT,
+	  pcm_convert_s32_to_f_native },
+	{ SOF_IPC_FRAME_FLOAT, SOF_IPC_FRAME_S32_LE,
+	  pcm_convert_f_to_s32_native },
+#endif /* CONFIG_FORMAT_CONVERT_FLOAT_NATIVE && CONFIG_FORMAT_S32LE */
 #if CONFIG_FORMAT_FLOAT && CONFIG_FORMAT_S16LE
 	{ SOF_IPC_FRAME_S16_LE, SOF_IPC_FRAME_FLOAT, pcm_convert_s16_to_f },
 	{ SOF_IPC_FRAME_FLOAT, SOF_IPC_FRAME_S16_LE, pcm_convert_f_to_s16 },
@@ -18,110 +18,123 @@
 #include <stddef.h>
 #include <stdint.h>
 
-#if CONFIG_FORMAT_S16LE
+#if SEL_GENERIC
+void sel_gather_s16(int16_t *dst, const int16_t *src, int stride,
+		    int samples)
+{
+	int i;
+
+	for (i = 0; i < samples; i++) {
+		*dst++ = *src;
+		src += stride;
+	}
+}
+
+void sel_gather_s32(int32_t *dst, const int32_t *src, int stride,
+		    int samples)
+{
+	int i;
+
+	for (i = 0; i < samples; i++) {
+		*dst++ = *src;
+		src += stride;
+	}
+}
+#endif /* SEL_GENERIC */
+
 /**
- * \brief Channel selection for 16 bit, 1 channel data format.
- * \param[in,out] dev Selector base component device.
- * \param[in,out] sink Destination buffer.
- * \param[in,out] source Source buffer.
- * \param[in] frames Number of frames to process.
+ * \brief Returns number of samples at stride until the buffer wraps.
+ * \param[in] stream Buffer.
+ * \param[in] ptr Position of the first sample.
+ * \param[in] bytes Distance of samples in bytes.
  */
-static void sel_s16le_1ch(struct comp_dev *dev, struct audio_stream *sink,
-			  const struct audio_stream *source, uint32_t frames)
+static inline uint32_t
+sel_samples_without_wrap(const struct audio_stream *stream, const void *ptr,
+			 uint32_t bytes)
 {
-	struct comp_data *cd = comp_get_drvdata(dev);
-	int16_t *src;
-	int16_t *dest;
-	uint32_t i;
-	uint32_t j = 0;
-	uint32_t nch = cd->config.in_channels_count;
-
-	for (i = cd->config.sel_channel; i < frames * nch; i += nch) {
-		src = audio_stream_read_frag_s16(source, i);
-		dest = audio_stream_write_frag_s16(sink, j++);
-		*dest = *src;
-	}
+	return (audio_stream_bytes_without_wrap(stream, ptr) + bytes - 1) /
+		bytes;
 }
 
 /**
- * \brief Channel selection for 16 bit, at least 2 channels data format.
+ * \brief Channel selection in passthrough mode, all channels are copied.
  * \param[in,out] dev Selector base component device.
  * \param[in,out] sink Destination buffer.
  * \param[in,out] source Source buffer.
  * \param[in] frames Number of frames to process.
  */
-static void sel_s16le_nch(struct comp_dev *dev, struct audio_stream *sink,
-			  const struct audio_stream *source, uint32_t frames)
+static void sel_passthrough(struct comp_dev *dev, struct audio_stream *sink,
+			    const struct audio_stream *source,
+			    uint32_t frames)
 {
-	struct comp_data *cd = comp_get_drvdata(dev);
-	int16_t *src;
-	int16_t *dest;
-	uint32_t i;
-	uint32_t j = 0;
-	uint32_t channel;
-
-	for (i = 0; i < frames; i++) {
-		for (channel = 0; channel < cd->config.in_channels_count;
-		     channel++) {
-			src = audio_stream_read_frag_s16(source, j);
-			dest = audio_stream_write_frag_s16(sink, j);
-			*dest = *src;
-			j++;
-		}
-	}
+	audio_stream_copy(source, 0, sink, 0,
+			  frames * audio_stream_frame_bytes(source));
 }
-#endif /* CONFIG_FORMAT_S16LE */
 
-#if CONFIG_FORMAT_S24LE || CONFIG_FORMAT_S32LE
+#if CONFIG_FORMAT_S16LE
 /**
- * \brief Channel selection for 32 bit, 1 channel data format.
+ * \brief Channel selection for 16 bit, 1 channel data format.
  * \param[in,out] dev Selector base component device.
  * \param[in,out] sink Destination buffer.
  * \param[in,out] source Source buffer.
  * \param[in] frames Number of frames to process.
  */
-static void sel_s32le_1ch(struct comp_dev *dev, struct audio_stream *sink,
+static void sel_s16le_1ch(struct comp_dev *dev, struct audio_stream *sink,
 			  const struct audio_stream *source, uint32_t frames)
 {
 	struct comp_data *cd = comp_get_drvdata(dev);
-	int32_t *src;
-	int32_t *dest;
-	uint32_t i;
-	uint32_t j = 0;
-	uint32_t nch = cd->config.in_channels_count;
-
-	for (i = cd->config.sel_channel; i < frames * nch; i += nch) {
-		src = audio_stream_read_frag_s32(source, i);
-		dest = audio_stream_write_frag_s32(sink, j++);
-		*dest = *src;
+	int16_t *src = audio_stream_read_frag_s16(source,
+						  cd->config.sel_channel);
+	int16_t *dest = sink->w_ptr;
+	uint32_t nch = source->channels;
+	uint32_t n_src;
+	uint32_t n_snk;
+	uint32_t n;
+
+	while (frames) {
+		/* gather linear parts of source and sink */
+		n_src = sel_samples_without_wrap(source, src,
+						 nch * sizeof(int16_t));
+		n_snk = sel_samples_without_wrap(sink, dest, sizeof(int16_t));
+		n = MIN(frames, MIN(n_src, n_snk));
+		sel_gather_s16(dest, src, nch, n);
+		src = audio_stream_wrap(source, src + n * nch);
+		dest = audio_stream_wrap(sink, dest + n);
+		frames -= n;
 	}
 }
+#endif /* CONFIG_FORMAT_S16LE */
 
+#if CONFIG_FORMAT_S24LE || CONFIG_FORMAT_S32LE
 /**
- * \brief Channel selection for 32 bit, at least 2 channels data format.
+ * \brief Channel selection for 32 bit, 1 channel data format.
  * \param[in,out] dev Selector base component device.
  * \param[in,out] sink Destination buffer.
  * \param[in,out] source Source buffer.
  * \param[in] frames Number of frames to process.
  */
-static void sel_s32le_nch(struct comp_dev *dev, struct audio_stream *sink,
+static void sel_s32le_1ch(struct comp_dev *dev, struct audio_stream *sink,
 			  const struct audio_stream *source, uint32_t frames)
 {
 	struct comp_data *cd = comp_get_drvdata(dev);
-	int32_t *src;
-	int32_t *dest;
-	uint32_t i;
-	uint32_t j = 0;
-	uint32_t channel;
-
-	for (i = 0; i < frames; i++) {
-		for (channel = 0; channel < cd->config.in_channels_count;
-		     channel++) {
-			src = audio_stream_read_frag_s32(source, j);
-			dest = audio_stream_write_frag_s32(sink, j);
-			*dest = *src;
-			j++;
-		}
+	int32_t *src = audio_stream_read_frag_s32(source,
+						  cd->config.sel_channel);
+	int32_t *dest = sink->w_ptr;
+	uint32_t nch = source->channels;
+	uint32_t n_src;
+	uint32_t n_snk;
+	uint32_t n;
+
+	while (frames) {
+		/* gather linear parts of source and sink */
+		n_src = sel_samples_without_wrap(source, src,
+						 nch * sizeof(int32_t));
+		n_snk = sel_samples_without_wrap(sink, dest, sizeof(int32_t));
+		n = MIN(frames, MIN(n_src, n_snk));
+		sel_gather_s32(dest, src, nch, n);
+		src = audio_stream_wrap(source, src + n * nch);
+		dest = audio_stream_wrap(sink, dest + n);
+		frames -= n;
 	}
 }
 #endif /* CONFIG_FORMAT_S24LE || CONFIG_FORMAT_S32LE */
@@ -129,18 +142,18 @@ static void sel_s32le_nch(struct comp_dev *dev, struct audio_stream *sink,
 const struct comp_func_map func_table[] = {
 #if CONFIG_FORMAT_S16LE
 	{SOF_IPC_FRAME_S16_LE, 1, sel_s16le_1ch},
-	{SOF_IPC_FRAME_S16_LE, 2, sel_s16le_nch},
-	{SOF_IPC_FRAME_S16_LE, 4, sel_s16le_nch},
+	{SOF_IPC_FRAME_S16_LE, 2, sel_passthrough},
+	{SOF_IPC_FRAME_S16_LE, 4, sel_passthrough},
 #endif /* CONFIG_FORMAT_S16LE */
 #if CONFIG_FORMAT_S24LE
 	{SOF_IPC_FRAME_S24_4LE, 1, sel_s32le_1ch},
-	{SOF_IPC_FRAME_S24_4LE, 2, sel_s32le_nch},
-	{SOF_IPC_FRAME_S24_4LE, 4, sel_s32le_nch},
+	{SOF_IPC_FRAME_S24_4LE, 2, sel_passthrough},
+	{SOF_IPC_FRAME_S24_4LE, 4, sel_passthrough},
 #endif /* CONFIG_FORMAT_S24LE */
 #if CONFIG_FORMAT_S32LE
 	{SOF_IPC_FRAME_S32_LE, 1, sel_s32le_1ch},
-	{SOF_IPC_FRAME_S32_LE, 2, sel_s32le_nch},
-	{SOF_IPC_FRAME_S32_LE, 4, sel_s32le_nch},
+	{SOF_IPC_FRAME_S32_LE, 2, sel_passthrough},
+	{SOF_IPC_FRAME_S32_LE, 4, sel_passthrough},
 #endif /* CONFIG_FORMAT_S32LE */
 };
 
@@ -0,0 +1,47 @@
+// SPDX-License-Identifier: BSD-3-Clause
+//
+// Copyright(c) 2020 Intel Corporation. All rights reserved.
+
+/**
+ * \file audio/selector_hifi3.c
+ * \brief Audio channel selector / extractor - HiFi3 processing functions
+ */
+
+#include <sof/audio/selector.h>
+#include <stdint.h>
+
+#if SEL_HIFI3
+
+#include <xtensa/tie/xt_hifi3.h>
+
+void sel_gather_s16(int16_t *dst, const int16_t *src, int stride,
+		    int samples)
+{
+	ae_int16x4 sample;
+	ae_int16 *in = (ae_int16 *)src;
+	ae_int16 *out = (ae_int16 *)dst;
+	int inc = stride * sizeof(ae_int16);
+	int i;
+
+	for (i = 0; i < samples; i++) {
+		AE_L16_XP(sample, in, inc);
+		AE_S16_0_IP(sample, out, sizeof(ae_int16));
+	}
+}
+
+void sel_gather_s32(int32_t *dst, const int32_t *src, int stride,
+		    int samples)
+{
+	ae_int32x2 sample;
+	ae_int32 *in = (ae_int32 *)src;
+	ae_int32 *out = (ae_int32 *)dst;
+	int inc = stride * sizeof(ae_int32);
+	int i;
+
+	for (i = 0; i < samples; i++) {
+		AE_L32_XP(sample, in, inc);
+		AE_S32_L_IP(sample, out, sizeof(ae_int32));
+	}
+}
+
+#endif /* SEL_HIFI3 */
@@ -12,6 +12,7 @@
 #include <sof/audio/pipeline.h>
 #include <sof/audio/src/src.h>
 #include <sof/audio/src/src_config.h>
+#include <sof/audio/src/src_design.h>
 #include <sof/debug/panic.h>
 #include <sof/drivers/ipc.h>
 #include <sof/lib/alloc.h>
@@ -45,8 +46,15 @@
 #endif
 
 /* The FIR maximum lengths are per channel so need to multiply them */
+#if CONFIG_COMP_SRC_DESIGN
+#define MAX_FIR_DELAY_SIZE_XNCH (PLATFORM_MAX_CHANNELS * \
+	MAX(MAX_FIR_DELAY_SIZE, SRC_DESIGN_MAX_FIR_DELAY_SIZE))
+#define MAX_OUT_DELAY_SIZE_XNCH (PLATFORM_MAX_CHANNELS * \
+	MAX(MAX_OUT_DELAY_SIZE, SRC_DESIGN_MAX_OUT_DELAY_SIZE))
+#else
 #define MAX_FIR_DELAY_SIZE_XNCH (PLATFORM_MAX_CHANNELS * MAX_FIR_DELAY_SIZE)
 #define MAX_OUT_DELAY_SIZE_XNCH (PLATFORM_MAX_CHANNELS * MAX_OUT_DELAY_SIZE)
+#endif
 
 static const struct comp_driver comp_src;
 
@@ -111,6 +119,10 @@ int src_buffer_lengths(struct src_param *a, int fs_in, int fs_out, int nch,
 {
 	struct src_stage *stage1;
 	struct src_stage *stage2;
+#if CONFIG_COMP_SRC_DESIGN
+	struct src_design *design;
+#endif
+	int fifo_length;
 	int r1;
 
 	if (nch > PLATFORM_MAX_CHANNELS) {
@@ -123,16 +135,48 @@ int src_buffer_lengths(struct src_param *a, int fs_in, int fs_out, int nch,
 	a->nch = nch;
 	a->idx_in = src_find_fs(src_in_fs, NUM_IN_FS, fs_in);
 	a->idx_out = src_find_fs(src_out_fs, NUM_OUT_FS, fs_out);
+	a->stage1 = NULL;
+	a->stage2 = NULL;
 
-	/* Check that both in and out rates are supported */
-	if (a->idx_in < 0 || a->idx_out < 0) {
-		comp_cl_err(&comp_src, "src_buffer_lengths(): rates not supported, fs_in: %u, fs_out: %u",
-			    fs_in, fs_out);
-		return -EINVAL;
+#if CONFIG_COMP_SRC_DESIGN
+	/* Design the filters for rates or combinations that are missing
+	 * from the coefficients table. The designs are cached so the new
+	 * reference is taken before the previous one is released.
+	 */
+	design = NULL;
+	if (a->idx_in < 0 || a->idx_out < 0 ||
+	    src_table1[a->idx_out][a->idx_in]->filter_length < 1) {
+		if (src_design_get(&design, fs_in, fs_out,
+				   SRC_DESIGN_QUALITY_DEFAULT) < 0) {
+			comp_cl_err(&comp_src, "src_buffer_lengths(): design failed, fs_in: %u, fs_out: %u",
+				    fs_in, fs_out);
+			src_design_put(a->design);
+			a->design = NULL;
+			return -EINVAL;
+		}
+
+		a->stage1 = &design->stage1;
+		a->stage2 = &design->stage2;
 	}
 
-	stage1 = src_table1[a->idx_out][a->idx_in];
-	stage2 = src_table2[a->idx_out][a->idx_in];
+	src_design_put(a->design);
+	a->design = design;
+#endif
+
+	if (!a->stage1) {
+		/* Check that both in and out rates are supported */
+		if (a->idx_in < 0 || a->idx_out < 0) {
+			comp_cl_err(&comp_src, "src_buffer_lengths(): rates not supported, fs_in: %u, fs_out: %u",
+				    fs_in, fs_out);
+			return -EINVAL;
+		}
+
+		a->stage1 = src_table1[a->idx_out][a->idx_in];
+		a->stage2 = src_table2[a->idx_out][a->idx_in];
+	}
+
+	stage1 = a->stage1;
+	stage2 = a->stage2;
 
 	/* Check from stage1 parameter for a deleted in/out rate combination.*/
 	if (stage1->filter_length < 1) {
@@ -152,6 +196,7 @@ int src_buffer_lengths(struct src_param *a, int fs_in, int fs_out, int nch,
 	a->blk_in = 0;
 	a->blk_out = 0;
 
+	a->fused = 0;
 	if (stage2->filter_length == 1) {
 		a->fir_s2 = 0;
 		a->out_s2 = 0;
@@ -172,6 +217,16 @@ int src_buffer_lengths(struct src_param *a, int fs_in, int fs_out, int nch,
 		 * there is no equation known for minimum size.
 		 */
 		a->sbuf_length = 2 * nch * stage1->blk_out * r1;
+
+		/* The stages can be alternated with a FIFO for two blocks
+		 * of both stages. Use it when smaller than the two periods
+		 * buffer to keep the intermediate data in cache.
+		 */
+		fifo_length = 2 * nch * (stage1->blk_out + stage2->blk_in);
+		if (fifo_length < a->sbuf_length) {
+			a->sbuf_length = fifo_length;
+			a->fused = 1;
+		}
 	}
 
 	a->src_multich = a->fir_s1 + a->fir_s2 + a->out_s1 + a->out_s2;
@@ -264,29 +319,25 @@ void src_polyphase_reset(struct polyphase_src *src)
 int src_polyphase_init(struct polyphase_src *src, struct src_param *p,
 		       int32_t *delay_lines_start)
 {
-	struct src_stage *stage1;
-	struct src_stage *stage2;
 	int n_stages;
 	int ret;
 
-	if (p->idx_in < 0 || p->idx_out < 0)
+	if (!p->stage1 || !p->stage2)
 		return -EINVAL;
 
 	/* Get setup for 2 stage conversion */
-	stage1 = src_table1[p->idx_out][p->idx_in];
-	stage2 = src_table2[p->idx_out][p->idx_in];
-	ret = init_stages(stage1, stage2, src, p, 2, delay_lines_start);
+	ret = init_stages(p->stage1, p->stage2, src, p, 2, delay_lines_start);
 	if (ret < 0)
 		return -EINVAL;
 
 	/* Get number of stages used for optimize opportunity. 2nd
 	 * stage length is one if conversion needs only one stage.
-	 * If input and output rate is the same return 0 to
-	 * use a simple copy function instead of 1 stage FIR with one
-	 * tap.
+	 * If input and output rate is the same both stages are one
+	 * tap pass-through, return 0 to use a simple copy function
+	 * instead of 1 stage FIR with one tap.
 	 */
 	n_stages = (src->stage2->filter_length == 1) ? 1 : 2;
-	if (p->idx_in == p->idx_out)
+	if (src->stage1->filter_length == 1 && n_stages == 1)
 		n_stages = 0;
 
 	/* If filter length for first stage is zero this is a deleted
@@ -400,6 +451,80 @@ static void src_2s(struct comp_dev *dev, const struct audio_stream *source,
 	}
 }
 
+/* 2 stage SRC with the stages alternated via a small FIFO. Stage 2 drains
+ * the FIFO and stage 1 refills it until the source or sink limits for
+ * this copy are met.
+ */
+static void src_2s_fused(struct comp_dev *dev,
+			 const struct audio_stream *source,
+			 struct audio_stream *sink, int *n_read, int *n_written)
+{
+	struct src_stage_prm s1;
+	struct src_stage_prm s2;
+	struct comp_data *cd = comp_get_drvdata(dev);
+	void *sbuf_addr = cd->delay_lines;
+	void *sbuf_end_addr = &cd->delay_lines[cd->param.sbuf_length];
+	size_t sbuf_size = cd->param.sbuf_length * sizeof(int32_t);
+	int nch = source->channels;
+	int s1_blk_out = cd->src.stage1->blk_out * nch;
+	int s2_blk_in = cd->src.stage2->blk_in * nch;
+	int s1_times = cd->param.stage1_times;
+	int s2_times = cd->param.stage2_times;
+
+	*n_read = 0;
+	*n_written = 0;
+	s1.x_end_addr = source->end_addr;
+	s1.x_size = source->size;
+	s1.y_addr = sbuf_addr;
+	s1.y_end_addr = sbuf_end_addr;
+	s1.y_size = sbuf_size;
+	s1.state = &cd->src.state1;
+	s1.stage = cd->src.stage1;
+	s1.x_rptr = source->r_ptr;
+	s1.y_wptr = cd->sbuf_w_ptr;
+	s1.nch = nch;
+	s1.shift = cd->data_shift;
+
+	s2.x_end_addr = sbuf_end_addr;
+	s2.x_size = sbuf_size;
+	s2.y_addr = sink->addr;
+	s2.y_end_addr = sink->end_addr;
+	s2.y_size = sink->size;
+	s2.state = &cd->src.state2;
+	s2.stage = cd->src.stage2;
+	s2.x_rptr = cd->sbuf_r_ptr;
+	s2.y_wptr = sink->w_ptr;
+	s2.nch = nch;
+	s2.shift = cd->data_shift;
+
+	for (;;) {
+		s2.times = MIN(s2_times, cd->sbuf_avail / s2_blk_in);
+		if (s2.times) {
+			cd->polyphase_func(&s2);
+			cd->sbuf_avail -= s2.times * s2_blk_in;
+			s2_times -= s2.times;
+			*n_written += s2.times * cd->src.stage2->blk_out;
+		}
+
+		/* Stage 1 consumes the same source blocks as in src_2s().
+		 * When the sink is full it still fills the FIFO so the
+		 * leftover is processed in the next copy.
+		 */
+		s1.times = MIN(s1_times, (cd->param.sbuf_length -
+					  cd->sbuf_avail) / s1_blk_out);
+		if (!s1.times)
+			break;
+
+		cd->polyphase_func(&s1);
+		cd->sbuf_avail += s1.times * s1_blk_out;
+		s1_times -= s1.times;
+		*n_read += s1.times * cd->src.stage1->blk_in;
+	}
+
+	cd->sbuf_w_ptr = s1.y_wptr;
+	cd->sbuf_r_ptr = s2.x_rptr;
+}
+
 /* 1 stage SRC for simple conversions */
 static void src_1s(struct comp_dev *dev, const struct audio_stream *source,
 		   struct audio_stream *sink, int *n_read, int *n_written)
@@ -512,6 +637,10 @@ static void src_free(struct comp_dev *dev)
 	if (cd->delay_lines)
 		rfree(cd->delay_lines);
 
+#if CONFIG_COMP_SRC_DESIGN
+	src_design_put(cd->param.design);
+#endif
+
 	rfree(cd);
 	rfree(dev);
 }
@@ -650,7 +779,10 @@ static int src_params(struct comp_dev *dev,
 		cd->src_func = src_1s; /* Simpler 1 stage SRC */
 		break;
 	case 2:
-		cd->src_func = src_2s; /* Default 2 stage SRC */
+		/* Default 2 stage SRC with period sized stage buffer or
+		 * the stages alternated via a small FIFO.
+		 */
+		cd->src_func = cd->param.fused ? src_2s_fused : src_2s;
 		break;
 	default:
 		/* This is possibly due to missing coefficients for
@@ -934,6 +1066,9 @@ static SHARED_DATA struct comp_driver_info comp_src_info = {
 
 static void sys_comp_src_init(void)
 {
+#if CONFIG_COMP_SRC_DESIGN
+	src_design_init();
+#endif
 	comp_register(platform_shared_get(&comp_src_info,
 					  sizeof(comp_src_info)));
 }
@@ -0,0 +1,624 @@
+// SPDX-License-Identifier: BSD-3-Clause
+//
+// Copyright(c) 2020 Intel Corporation. All rights reserved.
+
+/* Runtime design of polyphase SRC filters. The design follows the
+ * tools/tune/src scripts with fixed-point math: the conversion ratio is
+ * factorized to two stages, each stage gets a Kaiser windowed sinc low-pass
+ * filter with order from Kaiser's estimate and the coefficients are scaled
+ * with the same maximum shift rule as the exported tables.
+ */
+
+#include <sof/audio/format.h>
+#include <sof/audio/src/src.h>
+#include <sof/audio/src/src_config.h>
+#include <sof/audio/src/src_design.h>
+#include <sof/lib/alloc.h>
+#include <sof/lib/memory.h>
+#include <sof/math/numbers.h>
+#include <sof/math/trig.h>
+#include <sof/spinlock.h>
+#include <sof/string.h>
+#include <ipc/topology.h>
+#include <errno.h>
+#include <stddef.h>
+#include <stdint.h>
+
+/* Kaiser window beta for 70 dB stop-band attenuation is
+ * 0.1102 * (70 - 8.7) = 6.7553, the Bessel series uses (beta / 2)^2.
+ */
+#define SRC_DESIGN_BETA2_DIV4_Q20	11962558
+
+/* Kaiser order estimate (70 - 7.95) / (2.285 * 2 * pi) = 4.3219 */
+#define SRC_DESIGN_KAISER_K_Q16		283241
+
+/* Gain -1 dB for one stage and -0.5 dB per stage for two stages */
+#define SRC_DESIGN_GAIN_1S_Q31		1913946816
+#define SRC_DESIGN_GAIN_2S_Q31		2027355295
+
+/* Max coefficient 32767/32768 in Q8.24 */
+#define SRC_DESIGN_COEF_MAX_Q24		((1 << 24) - (1 << 9))
+
+/* Filter length is multiple of subfilters count times this */
+#define SRC_DESIGN_LENGTH_MULT		4
+
+/* Passband 20 kHz at 44.1 kHz and 24 kHz above 80 kHz rates */
+#define SRC_DESIGN_PB_LIMIT_FS		80000
+#define SRC_DESIGN_PB_HIGH_FS		24000
+
+#if SRC_SHORT
+typedef int16_t src_coef_t;
+static const int16_t src_design_one = 16384;
+#else
+typedef int32_t src_coef_t;
+static const int32_t src_design_one = 1073741824;
+#endif
+
+/* Design parameters of one stage */
+struct src_design_prm {
+	int fs1;
+	int fs2;
+	int l;
+	int m;
+	int idm;
+	int odm;
+	int length;
+	int f2_pb;	/* Twice the passband edge frequency */
+	int gain;	/* Q1.31 */
+};
+
+/* Factorizations that are preferred over the generic rule */
+static const struct {
+	int l;
+	int m;
+	int l1;
+	int m1;
+} src_design_fixed_lm[] = {
+	{ 147, 640, 7, 8 },	/* 192 to 44.1 kHz */
+	{ 147, 320, 7, 8 },	/* 96 to 44.1 kHz */
+	{ 147, 160, 7, 8 },	/* 48 to 44.1 kHz */
+	{ 160, 147, 8, 7 },	/* 44.1 to 48 kHz */
+	{ 320, 147, 8, 7 },	/* 44.1 to 96 kHz */
+	{ 4, 3, 4, 3 },		/* 24 to 32 kHz, single stage */
+	{ 3, 4, 3, 4 },		/* 32 to 24 kHz, single stage */
+};
+
+/* Designs shared by the SRC instances, looked up by conversion */
+struct src_design_cache {
+	spinlock_t lock;	/* protects the entries and references */
+	uint32_t time;
+	struct src_design *design[SRC_DESIGN_CACHE_SIZE];
+};
+
+static SHARED_DATA struct src_design_cache src_design_cache;
+
+/* Returns a factor of c that is nearest to square root of c */
+static int src_design_factor(int c)
+{
+	int x = 1;
+	int a1 = 0;
+	int a2 = 1;
+	int t;
+
+	while ((x + 1) * (x + 1) <= c)
+		x++;
+
+	/* Round the square root */
+	if (c - x * x > x)
+		x++;
+
+	for (t = x; t <= 2 * x; t++) {
+		if (c % t == 0) {
+			a1 = t;
+			break;
+		}
+	}
+
+	for (t = x; t >= x / 2 && t > 0; t--) {
+		if (c % t == 0) {
+			a2 = t;
+			break;
+		}
+	}
+
+	return a1 && a1 - x < x - a2 ? a1 : a2;
+}
+
+/* Splits the conversion to two stages with the intermediate rate
+ * nearest to the lower of input and output rates.
+ */
+static int src_design_factor_lm(int fs1, int fs2, int *l1, int *m1,
+				int *l2, int *m2)
+{
+	int k = gcd(fs1, fs2);
+	int l = fs2 / k;
+	int m = fs1 / k;
+	int fs_min = fs1 > fs2 ? fs2 : fs1;
+	int l0[4];
+	int m0[4];
+	int fs3;
+	int best = -1;
+	int delta = 0;
+	int i;
+
+	l0[0] = src_design_factor(l);
+	m0[0] = src_design_factor(m);
+	for (i = 0; i < ARRAY_SIZE(src_design_fixed_lm); i++) {
+		if (src_design_fixed_lm[i].l == l &&
+		    src_design_fixed_lm[i].m == m) {
+			l0[0] = src_design_fixed_lm[i].l1;
+			m0[0] = src_design_fixed_lm[i].m1;
+		}
+	}
+
+	/* The four possible first stages and their second stages */
+	l0[1] = l0[0];
+	m0[1] = m / m0[0];
+	l0[2] = l / l0[0];
+	m0[2] = m0[0];
+	l0[3] = l0[2];
+	m0[3] = m0[1];
+
+	/* Don't let intermediate rate go below the lower rate and
+	 * pick the one nearest to it.
+	 */
+	for (i = 0; i < 4; i++) {
+		fs3 = fs1 / m0[i] * l0[i];
+		if (fs3 >= fs_min && (best < 0 || fs3 - fs_min < delta)) {
+			best = i;
+			delta = fs3 - fs_min;
+		}
+	}
+
+	if (best < 0)
+		return -EINVAL;
+
+	*l1 = l0[best];
+	*m1 = m0[best];
+	*l2 = l / *l1;
+	*m2 = m / *m1;
+	if (*l1 == 1 && *m1 == 1) {
+		*l1 = *l2;
+		*m1 = *m2;
+		*l2 = 1;
+		*m2 = 1;
+	}
+
+	return 0;
+}
+
+/* Finds l0 and m0 for -l0 * L + m0 * M == 1 with the smallest sum */
+static void src_design_find_l0m0(struct src_design_prm *p)
+{
+	int lt;
+
+	p->idm = 0;
+	p->odm = 0;
+	if (p->m == 1) {
+		p->odm = 1;
+		return;
+	}
+
+	if (p->l == 1) {
+		p->idm = 1;
+		return;
+	}
+
+	for (lt = 1; lt <= 4 * p->l; lt++) {
+		if ((1 + lt * p->l) % p->m == 0 &&
+		    (!p->idm || lt + (1 + lt * p->l) / p->m <
+		     p->idm + p->odm)) {
+			p->idm = lt;
+			p->odm = (1 + lt * p->l) / p->m;
+		}
+	}
+}
+
+/* Computes the stage dimensions from Kaiser filter order estimate */
+static int src_design_stage_prm(struct src_design_prm *p, int fs1, int fs2,
+				int f2_pb, int gain)
+{
+	int fs_min = fs1 > fs2 ? fs2 : fs1;
+	int mult;
+	int64_t num;
+	int64_t den;
+	int n;
+
+	p->fs1 = fs1;
+	p->fs2 = fs2;
+	p->l = fs2 / gcd(fs1, fs2);
+	p->m = fs1 / gcd(fs1, fs2);
+	p->f2_pb = f2_pb;
+	p->gain = gain;
+	if (p->l == 1 && p->m == 1) {
+		p->length = 1;
+		return 0;
+	}
+
+	if (p->l > SRC_DESIGN_MAX_LM || p->m > SRC_DESIGN_MAX_LM ||
+	    f2_pb >= fs_min)
+		return -EINVAL;
+
+	src_design_find_l0m0(p);
+	if (!p->odm && !p->idm)
+		return -EINVAL;
+
+	/* Order for transition band from passband edge to Nyquist
+	 * frequency of the lower rate at L times input rate.
+	 */
+	num = (int64_t)SRC_DESIGN_KAISER_K_Q16 * 2 * p->l * fs1;
+	den = (int64_t)(fs_min - f2_pb) << 16;
+	n = (num + den - 1) / den;
+
+	/* Length is rounded up to multiple of subfilters times four */
+	mult = p->l * SRC_DESIGN_LENGTH_MULT;
+	p->length = (n + 1 + mult - 1) / mult * mult;
+
+	if (p->length / p->l + (p->l - 1) * p->idm + p->m >
+	    SRC_DESIGN_MAX_FIR_DELAY_SIZE ||
+	    1 + (p->l - 1) * p->odm > SRC_DESIGN_MAX_OUT_DELAY_SIZE)
+		return -EINVAL;
+
+	return 0;
+}
+
+/* Modified Bessel function of first kind I0(2 * sqrt(y)) for Q12.20 y,
+ * the result is Q32.32.
+ */
+static int64_t src_design_bessel_i0(int32_t y)
+{
+	int64_t sum = (int64_t)1 << 32;
+	int64_t t = sum;
+	int k = 1;
+
+	while (t > 0) {
+		t = ((t * y) >> 20) / (k * k);
+		sum += t;
+		k++;
+	}
+
+	return sum;
+}
+
+/* Kaiser window value for sample position t2 / 2 from filter center with
+ * window length n, returns Q1.31.
+ */
+static int32_t src_design_kaiser(int t2, int n, int64_t i0_beta)
+{
+	int64_t d2 = (int64_t)(n - 1) * (n - 1);
+	int64_t x;
+	int32_t y;
+
+	/* (beta / 2)^2 * (1 - (t2 / (n - 1))^2) */
+	x = ((d2 - (int64_t)t2 * t2) << 30) / d2;
+	y = (x * SRC_DESIGN_BETA2_DIV4_Q20) >> 30;
+	return (src_design_bessel_i0(y) << 23) / (i0_beta >> 8);
+}
+
+/* Low-pass impulse response sin(2 * pi * fc * t) / (pi * t) with cutoff
+ * fc = f2_cut / (4 * fs) at t = t2 / 2, returns Q1.31.
+ */
+static int32_t src_design_sinc(int t2, int f2_cut, int fs)
+{
+	int64_t period = (int64_t)8 * fs;
+	int64_t p;
+	int32_t s;
+
+	if (!t2)
+		return ((int64_t)f2_cut << 30) / fs;
+
+	/* Reduce phase to one period for exact sine argument */
+	p = ((int64_t)f2_cut * t2) % period;
+	if (p < 0)
+		p += period;
+
+	s = sin_fixed(p * PI_MUL2_Q4_28 / period);
+	return (int64_t)s * (1 << 29) / ((int64_t)PI_Q4_28 * t2);
+}
+
+/* Quantizes Q8.24 coefficient with shift to Q1.15 or Q1.31 */
+static src_coef_t src_design_quant(int64_t c, int shift)
+{
+#if SRC_SHORT
+	int s = 9 - shift;
+#else
+	int s = -7 - shift;
+#endif
+
+	if (s <= 0)
+		return c * (1 << -s);
+
+	return (c + ((int64_t)1 << (s - 1))) >> s;
+}
+
+/* Sets the constant stage parameters, length one is a pass-through stage */
+static int src_design_init_stage(struct src_stage *stage,
+				 const struct src_design_prm *p,
+				 const void *coefs, int shift)
+{
+	struct src_stage one = { 0, 0, 1, 1, 1, 1, 1, 0, -1,
+				 &src_design_one };
+	struct src_stage s = { p->idm, p->odm, p->l, p->length / p->l,
+			       p->length, p->m, p->l, 0, shift, coefs };
+
+	if (p->length == 1)
+		return memcpy_s(stage, sizeof(*stage), &one, sizeof(one));
+
+	return memcpy_s(stage, sizeof(*stage), &s, sizeof(s));
+}
+
+/* Designs the filter for stage and stores polyphase ordered coefficients */
+static int src_design_stage(struct src_stage *stage, src_coef_t *coefs,
+			    int32_t *h, const struct src_design_prm *p)
+{
+	const int n = p->length;
+	const int fs3 = p->l * p->fs1;
+	const int f2_cut = p->f2_pb + (p->fs1 > p->fs2 ? p->fs2 : p->fs1);
+	const int subfilter_length = n / p->l;
+	int64_t i0_beta;
+	int64_t sum = 0;
+	int64_t c;
+	int64_t c_max = 0;
+	int shift = 0;
+	int i;
+	int j;
+
+	if (n == 1)
+		return src_design_init_stage(stage, p, NULL, 0);
+
+	/* Windowed sinc, the center is between samples for even length */
+	i0_beta = src_design_bessel_i0(SRC_DESIGN_BETA2_DIV4_Q20);
+	for (i = 0; i < n; i++) {
+		j = 2 * i - n + 1;
+		h[i] = q_mults_32x32(src_design_sinc(j, f2_cut, fs3),
+				     src_design_kaiser(j, n, i0_beta),
+				     Q_SHIFT_BITS_64(31, 31, 31));
+		sum += h[i];
+	}
+
+	if (sum <= 0)
+		return -EINVAL;
+
+	/* Scale DC gain to L times stage gain as Q8.24 */
+	for (i = 0; i < n; i++) {
+		c = (((int64_t)h[i] * p->gain) >> 31) * p->l;
+		c = c * (1 << 24) / sum;
+		h[i] = c;
+		c_max = MAX(c_max, c < 0 ? -c : c);
+	}
+
+	/* Maximum shift that keeps max coefficient under 32767/32768 */
+	while (c_max >= SRC_DESIGN_COEF_MAX_Q24) {
+		c_max >>= 1;
+		shift--;
+	}
+
+	while (c_max << 1 < SRC_DESIGN_COEF_MAX_Q24) {
+		c_max <<= 1;
+		shift++;
+	}
+
+	/* Subfilter i is h[i], h[i + L], h[i + 2L], ... */
+	for (i = 0; i < p->l; i++) {
+		for (j = 0; j < subfilter_length; j++)
+			coefs[i * subfilter_length + j] =
+				src_design_quant(h[i + j * p->l], shift);
+	}
+
+	return src_design_init_stage(stage, p, coefs, shift);
+}
+
+static void src_design_free(struct src_design *d)
+{
+	if (!d)
+		return;
+
+	rfree(d->coefs);
+	rfree(d);
+}
+
+static struct src_design *src_design_new(int fs_in, int fs_out, int quality)
+{
+	struct src_design_prm p1;
+	struct src_design_prm p2;
+	struct src_design *d;
+	int32_t *h;
+	int fs_min = fs_in > fs_out ? fs_out : fs_in;
+	int f2_pb;
+	int gain;
+	int fs3;
+	int l1;
+	int m1;
+	int l2;
+	int m2;
+	int ret;
+
+	if (fs_in <= 0 || fs_out <= 0 || quality <= 0 ||
+	    src_design_factor_lm(fs_in, fs_out, &l1, &m1, &l2, &m2) < 0)
+		return NULL;
+
+	/* Passband 20 kHz at 44.1 kHz scaled with quality, must be
+	 * within 0.10 - 0.49 of the lower rate.
+	 */
+	if (fs_min > SRC_DESIGN_PB_LIMIT_FS)
+		f2_pb = 2 * SRC_DESIGN_PB_HIGH_FS;
+	else
+		f2_pb = (int64_t)fs_min * quality * 4 / 441;
+
+	if ((int64_t)f2_pb * 100 < 20 * fs_min ||
+	    (int64_t)f2_pb * 100 > 98 * fs_min)
+		return NULL;
+
+	/* Both stages keep the passband of the final conversion and
+	 * split the gain.
+	 */
+	fs3 = fs_in / m1 * l1;
+	gain = l2 == 1 && m2 == 1 ? SRC_DESIGN_GAIN_1S_Q31 :
+		SRC_DESIGN_GAIN_2S_Q31;
+	if (src_design_stage_prm(&p1, fs_in, fs3, f2_pb, gain) < 0 ||
+	    src_design_stage_prm(&p2, fs3, fs_out, f2_pb, gain) < 0)
+		return NULL;
+
+	d = rzalloc(SOF_MEM_ZONE_RUNTIME, SOF_MEM_FLAG_SHARED, SOF_MEM_CAPS_RAM,
+		    sizeof(*d));
+	if (!d)
+		return NULL;
+
+	d->coefs = rballoc(SOF_MEM_FLAG_SHARED, SOF_MEM_CAPS_RAM,
+			   (p1.length + p2.length) * sizeof(src_coef_t));
+	h = rballoc(0, SOF_MEM_CAPS_RAM,
+		    MAX(p1.length, p2.length) * sizeof(int32_t));
+	if (!d->coefs || !h) {
+		rfree(h);
+		src_design_free(d);
+		return NULL;
+	}
+
+	ret = src_design_stage(&d->stage1, d->coefs, h, &p1);
+	if (!ret)
+		ret = src_design_stage(&d->stage2,
+				       (src_coef_t *)d->coefs + p1.length,
+				       h, &p2);
+
+	rfree(h);
+	if (ret < 0) {
+		src_design_free(d);
+		return NULL;
+	}
+
+	d->fs_in = fs_in;
+	d->fs_out = fs_out;
+	d->quality = quality;
+	return d;
+}
+
+/* Takes a reference to a cached design of the conversion, the cache
+ * lock must be held.
+ */
+static struct src_design *src_design_find(struct src_design_cache *cache,
+					  int fs_in, int fs_out, int quality)
+{
+	struct src_design *d;
+	int i;
+
+	cache->time++;
+	for (i = 0; i < SRC_DESIGN_CACHE_SIZE; i++) {
+		d = cache->design[i];
+		if (d && d->fs_in == fs_in && d->fs_out == fs_out &&
+		    d->quality == quality) {
+			d->refs++;
+			d->age = cache->time;
+			return d;
+		}
+	}
+
+	return NULL;
+}
+
+/* Returns a free slot or the least recently used unused design, the
+ * cache lock must be held.
+ */
+static int src_design_slot(struct src_design_cache *cache)
+{
+	struct src_design *d;
+	int slot = -1;
+	int i;
+
+	for (i = 0; i < SRC_DESIGN_CACHE_SIZE; i++) {
+		d = cache->design[i];
+		if (!d)
+			return i;
+
+		if (!d->refs && (slot < 0 ||
+				 cache->time - d->age >
+				 cache->time - cache->design[slot]->age))
+			slot = i;
+	}
+
+	return slot;
+}
+
+int src_design_get(struct src_design **design, int fs_in, int fs_out,
+		   int quality)
+{
+	struct src_design_cache *cache =
+		platform_shared_get(&src_design_cache,
+				    sizeof(src_design_cache));
+	struct src_design *evicted = NULL;
+	struct src_design *d;
+	struct src_design *new;
+	int slot;
+	int ret = 0;
+
+	*design = NULL;
+
+	spin_lock(&cache->lock);
+	d = src_design_find(cache, fs_in, fs_out, quality);
+	platform_shared_commit(cache, sizeof(*cache));
+	spin_unlock(&cache->lock);
+
+	if (d) {
+		*design = d;
+		return 0;
+	}
+
+	/* The design takes long so it is done without holding the lock */
+	new = src_design_new(fs_in, fs_out, quality);
+	if (!new)
+		return -EINVAL;
+
+	new->refs = 1;
+
+	spin_lock(&cache->lock);
+
+	/* Another user may have added the same conversion meanwhile */
+	d = src_design_find(cache, fs_in, fs_out, quality);
+	if (!d) {
+		slot = src_design_slot(cache);
+		if (slot < 0) {
+			ret = -EBUSY;
+		} else {
+			evicted = cache->design[slot];
+			new->age = cache->time;
+			cache->design[slot] = new;
+			d = new;
+			new = NULL;
+		}
+	}
+
+	platform_shared_commit(cache, sizeof(*cache));
+	spin_unlock(&cache->lock);
+
+	src_design_free(evicted);
+	src_design_free(new);
+	*design = d;
+	return ret;
+}
+
+void src_design_init(void)
+{
+	struct src_design_cache *cache =
+		platform_shared_get(&src_design_cache,
+				    sizeof(src_design_cache));
+
+	spinlock_init(&cache->lock);
+	platform_shared_commit(cache, sizeof(*cache));
+}
+
+void src_design_put(struct src_design *design)
+{
+	struct src_design_cache *cache;
+
+	if (!design)
+		return;
+
+	cache = platform_shared_get(&src_design_cache,
+				    sizeof(src_design_cache));
+
+	spin_lock(&cache->lock);
+	if (design->refs > 0)
+		design->refs--;
+
+	platform_shared_commit(cache, sizeof(*cache));
+	spin_unlock(&cache->lock);
+}
@@ -17,6 +17,7 @@
 #include <sof/lib/memory.h>
 #include <sof/lib/uuid.h>
 #include <sof/list.h>
+#include <sof/math/numbers.h>
 #include <sof/math/trig.h>
 #include <sof/platform.h>
 #include <sof/string.h>
@@ -42,6 +43,11 @@
 #define TONE_FREQUENCY_DEFAULT TONE_FREQ(997.0)
 #define TONE_NUM_FS            13       /* Table size for 8-192 kHz range */
 
+/* The recursive oscillator is re-synchronized to the phase accumulator
+ * every 1 ms to bound the amplitude and phase drift from rounding.
+ */
+#define TONE_RESYNC_BLOCKS     8        /* In 125 us blocks */
+
 static const struct comp_driver comp_tone;
 
 /* 04e3f894-2c5c-4f2e-8dc1-694eeaab53fa */
@@ -75,6 +81,11 @@ struct tone_state {
 	int32_t ramp_step; /* Amplitude ramp step Q1.31 */
 	int32_t w; /* Angle radians Q4.28 */
 	int32_t w_step; /* Angle step Q4.28 */
+	int32_t osc_sin; /* Oscillator sine state Q1.31 */
+	int32_t osc_cos; /* Oscillator cosine state Q1.31 */
+	int32_t rot_sin; /* Sine of angle step Q1.31 */
+	int32_t rot_cos; /* Cosine of angle step Q1.31 */
+	uint32_t osc_blocks; /* Blocks until oscillator re-sync, 0 to force */
 	uint32_t block_count;
 	uint32_t repeat_count;
 	uint32_t repeats; /* Number of repeats for tone (sweep steps) */
@@ -94,7 +105,8 @@ struct comp_data {
 			  uint32_t frames);
 };
 
-static int32_t tonegen(struct tone_state *sg);
+static int32_t *tonegen(struct tone_state *sg, struct audio_stream *sink,
+			int32_t *dest, int stride, uint32_t samples);
 static void tonegen_control(struct tone_state *sg);
 static void tonegen_update_f(struct tone_state *sg, int32_t f);
 
@@ -102,61 +114,211 @@ static void tonegen_update_f(struct tone_state *sg, int32_t f);
  * Tone generator algorithm code
  */
 
-static inline void tone_circ_inc_wrap(int32_t **ptr, int32_t *end, size_t size)
-{
-	if (*ptr >= end)
-		*ptr = (int32_t *)((size_t)*ptr - size);
-}
-
 static void tone_s32_default(struct comp_dev *dev, struct audio_stream *sink,
 			     uint32_t frames)
 {
 	struct comp_data *cd = comp_get_drvdata(dev);
-	int32_t *dest = (int32_t *)sink->w_ptr;
-	int i;
-	int n;
-	int n_wrap_dest;
-	int n_min;
+	struct tone_state *sg;
+	int32_t *dest;
+	uint32_t samples;
+	uint32_t n;
 	int nch = cd->channels;
-
-	n = frames * nch;
-	while (n > 0) {
-		n_wrap_dest = (int32_t *)sink->end_addr - dest;
-		n_min = (n < n_wrap_dest) ? n : n_wrap_dest;
-		/* Process until wrap or completed n */
-		while (n_min > 0) {
-			n -= nch;
-			n_min -= nch;
-			for (i = 0; i < nch; i++) {
-				tonegen_control(&cd->sg[i]);
-				*dest = tonegen(&cd->sg[i]);
-				dest++;
+	int ch;
+
+	for (ch = 0; ch < nch; ch++) {
+		sg = &cd->sg[ch];
+		dest = audio_stream_write_frag_s32(sink, ch);
+		n = frames;
+
+		/* Generate up to the next 125 us block boundary and then
+		 * update the tone controls for the next block.
+		 */
+		while (n > 0) {
+			if (sg->sample_count + 1 >= sg->samples_in_block) {
+				tonegen_control(sg);
+				samples = MIN(n,
+					      MAX(sg->samples_in_block, 1));
+				sg->sample_count = samples - 1;
+			} else {
+				samples = MIN(n, sg->samples_in_block -
+					      sg->sample_count - 1);
+				sg->sample_count += samples;
 			}
+
+			dest = tonegen(sg, sink, dest, nch, samples);
+			n -= samples;
 		}
-		tone_circ_inc_wrap(&dest, sink->end_addr, sink->size);
 	}
 }
 
-static int32_t tonegen(struct tone_state *sg)
+/* Taylor series coefficients 1/n! for sine and cosine, Q1.31 */
+static const int32_t tone_sin_coef[] = {
+	Q_CONVERT_FLOAT(1.0 / 39916800, 31),
+	Q_CONVERT_FLOAT(1.0 / 362880, 31),
+	Q_CONVERT_FLOAT(1.0 / 5040, 31),
+	Q_CONVERT_FLOAT(1.0 / 120, 31),
+	Q_CONVERT_FLOAT(1.0 / 6, 31),
+};
+
+static const int32_t tone_cos_coef[] = {
+	Q_CONVERT_FLOAT(1.0 / 479001600, 31),
+	Q_CONVERT_FLOAT(1.0 / 3628800, 31),
+	Q_CONVERT_FLOAT(1.0 / 40320, 31),
+	Q_CONVERT_FLOAT(1.0 / 720, 31),
+	Q_CONVERT_FLOAT(1.0 / 24, 31),
+	Q_CONVERT_FLOAT(1.0 / 2, 31),
+};
+
+static inline int32_t tone_mult_q31(int32_t x, int32_t y)
+{
+	return q_multsr_32x32(x, y, Q_SHIFT_BITS_64(31, 31, 31));
+}
+
+/*
+ * Sine and cosine of angle w in Q4.28 radians as Q1.31. The angle is folded
+ * to 0 - pi/4 where the Taylor series is evaluated. The result is more
+ * accurate than sin_fixed() as needed for the oscillator coefficients, the
+ * error of a coefficient accumulates for every sample until the re-sync.
+ */
+static void tonegen_sincos(int32_t w, int32_t *sine, int32_t *cosine)
+{
+	int32_t x;
+	int32_t x2;
+	int32_t s;
+	int32_t c;
+	int32_t t;
+	int64_t p;
+	bool neg_s = false;
+	bool neg_c = false;
+	bool swap = false;
+	int i;
+
+	w %= PI_MUL2_Q4_28;
+	if (w < 0)
+		w += PI_MUL2_Q4_28;
+
+	if (w > PI_Q4_28) {
+		w -= PI_Q4_28;
+		neg_s = true;
+		neg_c = true;
+	}
+
+	if (w > PI_DIV2_Q4_28) {
+		w = PI_Q4_28 - w;
+		neg_c = !neg_c;
+	}
+
+	if (w > PI_DIV2_Q4_28 / 2) {
+		w = PI_DIV2_Q4_28 - w;
+		swap = true;
+	}
+
+	/* Q4.28 -> Q1.31, the folded angle is less than one */
+	x = w << 3;
+	x2 = tone_mult_q31(x, x);
+
+	/* sin(x) = x - x^3 * (1/3! - x^2 * (1/5! - x^2 * (...))) */
+	p = tone_sin_coef[0];
+	for (i = 1; i < ARRAY_SIZE(tone_sin_coef); i++)
+		p = tone_sin_coef[i] - tone_mult_q31(p, x2);
+
+	s = x - tone_mult_q31(tone_mult_q31(x, x2), p);
+
+	/* 1 - cos(x) = x^2 * (1/2! - x^2 * (1/4! - x^2 * (...))) */
+	p = tone_cos_coef[0];
+	for (i = 1; i < ARRAY_SIZE(tone_cos_coef); i++)
+		p = tone_cos_coef[i] - tone_mult_q31(p, x2);
+
+	c = sat_int32(((int64_t)1 << 31) - tone_mult_q31(x2, p));
+
+	if (swap) {
+		t = s;
+		s = c;
+		c = t;
+	}
+
+	*sine = neg_s ? -s : s;
+	*cosine = neg_c ? -c : c;
+}
+
+/* Reset the oscillator state and rotation from the accumulated angle */
+static void tonegen_resync(struct tone_state *sg)
+{
+	tonegen_sincos(sg->w, &sg->osc_sin, &sg->osc_cos);
+	tonegen_sincos(sg->w_step, &sg->rot_sin, &sg->rot_cos);
+	sg->osc_blocks = TONE_RESYNC_BLOCKS;
+}
+
+/*
+ * Generates samples with constant amplitude and frequency. The sine is
+ * computed with a coupled form recursive oscillator that rotates the
+ * (cos, sin) state vector by the angle step for every sample:
+ *
+ *	sin(w + dw) = sin(w) * cos(dw) + cos(w) * sin(dw)
+ *	cos(w + dw) = cos(w) * cos(dw) - sin(w) * sin(dw)
+ *
+ * The rotation is not exactly unitary in Q1.31 so the state is periodically
+ * re-synchronized from the phase accumulator that is advanced per block.
+ * The error to an ideal sine stays below -115 dB of the full scale, which is
+ * the accuracy of the sin_fixed() table lookup used previously.
+ */
+static int32_t *tonegen(struct tone_state *sg, struct audio_stream *sink,
+			int32_t *dest, int stride, uint32_t samples)
 {
-	int64_t sine;
 	int64_t w;
+	int64_t s;
+	int64_t c;
+	int32_t osc_sin;
+	int32_t osc_cos;
+	int32_t rot_sin;
+	int32_t rot_cos;
+	int32_t a;
+	uint32_t n;
+	uint32_t i;
+
+	/* Angle for the first sample, then advance by the generated samples */
+	if (!sg->osc_blocks)
+		tonegen_resync(sg);
+
+	w = (int64_t)sg->w + (int64_t)samples * sg->w_step;
+	sg->w = (w < PI_MUL2_Q4_28) ? (int32_t)w : (int32_t)(w % PI_MUL2_Q4_28);
+
+	osc_sin = sg->osc_sin;
+	osc_cos = sg->osc_cos;
+	rot_sin = sg->rot_sin;
+	rot_cos = sg->rot_cos;
+	a = sg->mute ? 0 : sg->a; /* Amplitude Q1.31 */
+
+	while (samples > 0) {
+		/* Process until wrap or completed samples */
+		n = samples;
+		if (dest + (n - 1) * stride >= (int32_t *)sink->end_addr)
+			n = ((int32_t *)sink->end_addr - dest + stride - 1) /
+			    stride;
+
+		for (i = 0; i < n; i++) {
+			/* Q1.31 no saturation need */
+			*dest = q_mults_32x32(osc_sin, a,
+					      Q_SHIFT_BITS_64(31, 31, 31));
+			dest += stride;
+
+			/* Next point, Q1.31 x Q1.31 -> Q2.62 */
+			s = (int64_t)osc_sin * rot_cos +
+			    (int64_t)osc_cos * rot_sin;
+			c = (int64_t)osc_cos * rot_cos -
+			    (int64_t)osc_sin * rot_sin;
+			osc_sin = sat_int32(Q_SHIFT_RND(s, 62, 31));
+			osc_cos = sat_int32(Q_SHIFT_RND(c, 62, 31));
+		}
 
-	/* sg->w is angle in Q4.28 radians format, sin() returns Q1.31 */
-	/* sg->a is amplitude as Q1.31 */
-	sine =
-		q_mults_32x32(sin_fixed(sg->w), sg->a,
-			      Q_SHIFT_BITS_64(31, 31, 31));
+		dest = audio_stream_wrap(sink, dest);
+		samples -= n;
+	}
 
-	/* Next point */
-	w = (int64_t)sg->w + sg->w_step;
-	sg->w = (w > PI_MUL2_Q4_28)
-		? (int32_t)(w - PI_MUL2_Q4_28) : (int32_t)w;
+	sg->osc_sin = osc_sin;
+	sg->osc_cos = osc_cos;
 
-	if (sg->mute)
-		return 0;
-	else
-		return (int32_t)sine; /* Q1.31 no saturation need */
+	return dest;
 }
 
 static void tonegen_control(struct tone_state *sg)
@@ -164,19 +326,20 @@ static void tonegen_control(struct tone_state *sg)
 	int64_t a;
 	int64_t p;
 
-	/* Count samples, 125 us blocks */
-	sg->sample_count++;
-	if (sg->sample_count < sg->samples_in_block)
-		return;
-
 	sg->sample_count = 0;
 	if (sg->block_count < INT32_MAX)
 		sg->block_count++;
 
+	if (sg->osc_blocks)
+		sg->osc_blocks--;
+
 	/* Fade-in ramp during tone */
 	if (sg->block_count < sg->tone_length) {
-		if (sg->a == 0)
-			sg->w = 0; /* Reset phase to have less clicky ramp */
+		if (sg->a == 0) {
+			/* Reset phase to have less clicky ramp */
+			sg->w = 0;
+			sg->osc_blocks = 0;
+		}
 
 		if (sg->a > sg->a_target) {
 			a = (int64_t)sg->a - sg->ramp_step;
@@ -306,6 +469,7 @@ static void tonegen_update_f(struct tone_state *sg, int32_t f)
 	w_tmp = q_multsr_32x32(sg->f, sg->c, Q_SHIFT_BITS_64(16, 31, 28));
 	w_tmp = (w_tmp > PI_Q4_28) ? PI_Q4_28 : w_tmp; /* Limit to pi Q4.28 */
 	sg->w_step = (int32_t)w_tmp;
+	sg->osc_blocks = 0; /* Re-sync oscillator to the new angle step */
 }
 
 static void tonegen_reset(struct tone_state *sg)
@@ -317,6 +481,7 @@ static void tonegen_reset(struct tone_state *sg)
 	sg->f = TONE_FREQUENCY_DEFAULT;
 	sg->w = 0;
 	sg->w_step = 0;
+	sg->osc_blocks = 0;
 
 	sg->block_count = 0;
 	sg->repeat_count = 0;
@@ -209,6 +209,50 @@ static void vol_sync_host(struct comp_dev *dev, unsigned int num_channels)
 	}
 }
 
+/**
+ * \brief Prepares per frame ramp gains and increments for processing.
+ * \param[in,out] dev Volume base component device.
+ *
+ * The interpolated gain is restarted from the current volume if the
+ * volume has been changed outside of the ramp. The per frame increment
+ * is the ramp update step divided by the update interval frames. It is
+ * rounded away from zero, a step smaller than the interval frames in
+ * fractional LSBs would otherwise stop the ramp.
+ */
+UT_STATIC void volume_ramp_frames_init(struct comp_dev *dev)
+{
+	struct comp_data *cd = comp_get_drvdata(dev);
+	int32_t frames = MAX(cd->vol_ramp_frames, 1);
+	int64_t inc;
+	int i;
+
+	for (i = 0; i < cd->channels; i++) {
+		if (cd->ramp_gain[i] >> VOL_RAMP_FRAC_BITS != cd->volume[i])
+			cd->ramp_gain[i] = cd->volume[i] << VOL_RAMP_FRAC_BITS;
+
+		inc = (int64_t)cd->ramp_increment[i] << VOL_RAMP_FRAC_BITS;
+		if (inc > 0)
+			inc = (inc + frames - 1) / frames;
+		else
+			inc = (inc - frames + 1) / frames;
+
+		cd->ramp_frame_inc[i] = sat_int32(inc);
+	}
+}
+
+/**
+ * \brief Updates volume from per frame ramp gains after processing.
+ * \param[in,out] dev Volume base component device.
+ */
+UT_STATIC void volume_ramp_frames_update(struct comp_dev *dev)
+{
+	struct comp_data *cd = comp_get_drvdata(dev);
+	int i;
+
+	for (i = 0; i < cd->channels; i++)
+		cd->volume[i] = cd->ramp_gain[i] >> VOL_RAMP_FRAC_BITS;
+}
+
 /**
  * \brief Ramps volume changes over time.
  * \param[in,out] dev Volume base component device.
@@ -235,6 +279,23 @@ static void volume_ramp(struct comp_dev *dev)
 	 */
 	cd->vol_ramp_active = true;
 
+	/* With per frame ramp the processing has updated the volume, only
+	 * check if all active channels have reached the target.
+	 */
+	if (cd->scale_vol_ramp) {
+		cd->ramp_finished = true;
+		for (i = 0; i < cd->channels; i++) {
+			if (cd->volume[i] == cd->tvolume[i])
+				cd->ramp_increment[i] = 0;
+			else
+				cd->ramp_finished = false;
+		}
+
+		cd->vol_ramp_active = !cd->ramp_finished;
+		vol_sync_host(dev, cd->channels);
+		return;
+	}
+
 	/* inc/dec each volume if it's not at target for active channels */
 	for (i = 0; i < cd->channels; i++) {
 		/* skip if target reached */
@@ -382,6 +443,7 @@ static void volume_free(struct comp_dev *dev)
 
 	comp_dbg(dev, "volume_free()");
 
+	pcm_adapter_free(&cd->adapter);
 	rfree(cd);
 	rfree(dev);
 }
@@ -663,6 +725,70 @@ static int volume_cmd(struct comp_dev *dev, int cmd, void *data,
 	}
 }
 
+/**
+ * \brief Verifies the stream parameters of the buffers.
+ * \param[in,out] dev Volume base component device.
+ * \param[in] params Audio (PCM) stream parameters.
+ * \return Error code.
+ */
+static int volume_verify_params(struct comp_dev *dev,
+				struct sof_ipc_stream_params *params)
+{
+	struct comp_buffer *sourceb;
+	struct comp_buffer *sinkb;
+	enum sof_ipc_frame process_fmt;
+	uint32_t buffer_flag;
+	int ret;
+
+	comp_dbg(dev, "volume_verify_params()");
+
+	sourceb = list_first_item(&dev->bsource_list, struct comp_buffer,
+				  sink_list);
+	sinkb = list_first_item(&dev->bsink_list, struct comp_buffer,
+				source_list);
+
+	/* keep different source and sink frame_fmt's if the format adapter
+	 * can convert them, otherwise both are set to pcm frame_fmt
+	 */
+	process_fmt = vol_process_format(sourceb->stream.frame_fmt,
+					 sinkb->stream.frame_fmt);
+	buffer_flag = vol_find_func_map(process_fmt) &&
+		      pcm_adapter_supported(sourceb->stream.frame_fmt,
+					    process_fmt,
+					    sinkb->stream.frame_fmt) ?
+		      BUFF_PARAMS_FRAME_FMT : 0;
+
+	ret = comp_verify_params(dev, buffer_flag, params);
+	if (ret < 0) {
+		comp_err(dev, "volume_verify_params(): comp_verify_params() failed.");
+		return ret;
+	}
+
+	return 0;
+}
+
+/**
+ * \brief Sets volume component audio stream parameters.
+ * \param[in,out] dev Volume base component device.
+ * \param[in] params Audio (PCM) stream parameters.
+ * \return Error code.
+ */
+static int volume_params(struct comp_dev *dev,
+			 struct sof_ipc_stream_params *params)
+{
+	int err;
+
+	comp_dbg(dev, "volume_params()");
+
+	err = volume_verify_params(dev, params);
+	if (err < 0) {
+		comp_err(dev, "volume_params(): pcm params verification failed");
+		return -EINVAL;
+	}
+
+	return 0;
+}
+
 /**
  * \brief Sets volume component state.
  * \param[in,out] dev Volume base component device.
@@ -676,6 +802,25 @@ static int volume_trigger(struct comp_dev *dev, int cmd)
 	return comp_set_state(dev, cmd);
 }
 
+/* processing functions called through the format adapter */
+static void volume_run(void *ctx, const struct audio_stream *source,
+		       struct audio_stream *sink, uint32_t frames)
+{
+	struct comp_dev *dev = ctx;
+	struct comp_data *cd = comp_get_drvdata(dev);
+
+	cd->scale_vol(dev, sink, source, frames);
+}
+
+static void volume_run_ramp(void *ctx, const struct audio_stream *source,
+			    struct audio_stream *sink, uint32_t frames)
+{
+	struct comp_dev *dev = ctx;
+	struct comp_data *cd = comp_get_drvdata(dev);
+
+	cd->scale_vol_ramp(dev, sink, source, frames);
+}
+
 /**
  * \brief Copies and processes stream data.
  * \param[in,out] dev Volume base component device.
@@ -708,8 +853,11 @@ static int volume_copy(struct comp_dev *dev)
 		 c.source_bytes, c.sink_bytes);
 
 	while (c.frames) {
-		if (cd->ramp_finished || cd->vol_ramp_frames > c.frames) {
-			/* without ramping process all at once */
+		if (cd->ramp_finished || cd->vol_ramp_frames > c.frames ||
+		    cd->scale_vol_ramp) {
+			/* without ramping or with per frame ramp process all
+			 * at once
+			 */
 			frames = c.frames;
 		} else if (pga->ramp == SOF_VOLUME_LINEAR_ZC) {
 			/* with ZC ramping look for next ZC offset */
@@ -725,7 +873,17 @@ static int volume_copy(struct comp_dev *dev)
 
 		/* copy and scale volume */
 		buffer_invalidate(source, source_bytes);
-		cd->scale_vol(dev, &sink->stream, &source->stream, frames);
+		if (!cd->ramp_finished && cd->scale_vol_ramp) {
+			volume_ramp_frames_init(dev);
+			pcm_adapter_process(&cd->adapter, &source->stream,
+					    &sink->stream, frames,
+					    volume_run_ramp, dev);
+			volume_ramp_frames_update(dev);
+		} else {
+			pcm_adapter_process(&cd->adapter, &source->stream,
+					    &sink->stream, frames, volume_run,
+					    dev);
+		}
 		buffer_writeback(sink, sink_bytes);
 
 		/* calculate new free and available */
@@ -747,15 +905,16 @@ static int volume_copy(struct comp_dev *dev)
  */
 static vol_zc_func vol_get_zc_function(struct comp_dev *dev)
 {
-	struct comp_buffer *sinkb;
+	struct comp_buffer *sourceb;
 	int i;
 
-	sinkb = list_first_item(&dev->bsink_list, struct comp_buffer,
-				source_list);
+	/* zero crossings are searched from the source buffer */
+	sourceb = list_first_item(&dev->bsource_list, struct comp_buffer,
+				  sink_list);
 
 	/* map the zc function to frame format */
 	for (i = 0; i < ARRAY_SIZE(zc_func_map); i++) {
-		if (sinkb->stream.frame_fmt != zc_func_map[i].frame_fmt)
+		if (sourceb->stream.frame_fmt != zc_func_map[i].frame_fmt)
 			continue;
 
 		return zc_func_map[i].func;
@@ -774,7 +933,10 @@ static vol_zc_func vol_get_zc_function(struct comp_dev *dev)
  */
 static int volume_prepare(struct comp_dev *dev)
 {
+	struct sof_ipc_comp_volume *pga =
+		COMP_GET_IPC(dev, sof_ipc_comp_volume);
 	struct comp_data *cd = comp_get_drvdata(dev);
+	struct comp_buffer *sourceb;
 	struct comp_buffer *sinkb;
 	struct sof_ipc_comp_config *config = dev_comp_config(dev);
 	uint32_t sink_period_bytes;
@@ -790,7 +952,9 @@ static int volume_prepare(struct comp_dev *dev)
 	if (ret == COMP_STATUS_STATE_ALREADY_SET)
 		return PPL_STATUS_PATH_STOP;
 
-	/* volume component will only ever have 1 sink buffer */
+	/* volume component will only ever have 1 source and 1 sink buffer */
+	sourceb = list_first_item(&dev->bsource_list,
+				  struct comp_buffer, sink_list);
 	sinkb = list_first_item(&dev->bsink_list,
 				struct comp_buffer, source_list);
 
@@ -812,6 +976,14 @@ static int volume_prepare(struct comp_dev *dev)
 		goto err;
 	}
 
+	/* Linear ramp is interpolated per frame if the format supports it,
+	 * zero crossings ramp keeps gain updates at zero crossings.
+	 */
+	if (pga->ramp == SOF_VOLUME_LINEAR)
+		cd->scale_vol_ramp = vol_get_ramp_function(dev);
+	else
+		cd->scale_vol_ramp = NULL;
+
 	cd->zc_get = vol_get_zc_function(dev);
 	if (!cd->zc_get) {
 		comp_err(dev, "volume_prepare(): invalid cd->zc_get");
@@ -819,6 +991,15 @@ static int volume_prepare(struct comp_dev *dev)
 		goto err;
 	}
 
+	ret = pcm_adapter_init(&cd->adapter, sourceb->stream.frame_fmt,
+			       vol_get_process_format(dev),
+			       sinkb->stream.frame_fmt,
+			       sourceb->stream.channels);
+	if (ret < 0) {
+		comp_err(dev, "volume_prepare(): format adapter init failed");
+		goto err;
+	}
+
 	vol_sync_host(dev, PLATFORM_MAX_CHANNELS);
 
 	/* Set current volume to min to ensure ramp starts from minimum
@@ -851,8 +1032,12 @@ err:
  */
 static int volume_reset(struct comp_dev *dev)
 {
+	struct comp_data *cd = comp_get_drvdata(dev);
+
 	comp_dbg(dev, "volume_reset()");
 
+	pcm_adapter_free(&cd->adapter);
+
 	comp_set_state(dev, COMP_TRIGGER_RESET);
 	return 0;
 }
@@ -865,6 +1050,7 @@ static const struct comp_driver comp_volume = {
 	.ops	= {
 		.create		= volume_new,
 		.free		= volume_free,
+		.params		= volume_params,
 		.cmd		= volume_cmd,
 		.trigger	= volume_trigger,
 		.copy		= volume_copy,
@@ -26,6 +26,162 @@
 #include <stddef.h>
 #include <stdint.h>
 
+/**
+ * \brief Volume processing function for a linear block of samples.
+ * \param[out] dst Destination samples.
+ * \param[in] src Source samples.
+ * \param[in] gain Gains for each sample in Q8.16.
+ * \param[in] samples Number of samples to process.
+ */
+typedef void (*vol_block_func)(void *dst, const void *src,
+			       const int32_t *gain, uint32_t samples);
+
+/**
+ * \brief Expands current channel volumes to samples interleave order.
+ * \param[in,out] cd Volume component private data.
+ * \param[in] channels Number of channels.
+ * \return Length of gain pattern, multiple of channels.
+ */
+static uint32_t vol_gain_pattern(struct comp_data *cd, uint32_t channels)
+{
+	uint32_t len = VOL_GAIN_PATTERN_MAX - VOL_GAIN_PATTERN_MAX % channels;
+	uint32_t channel;
+	uint32_t i;
+
+	for (i = 0; i < len; i += channels)
+		for (channel = 0; channel < channels; channel++)
+			cd->gain_pattern[i + channel] = cd->volume[channel];
+
+	return len;
+}
+
+/**
+ * \brief Applies volume from source buffer to sink buffer.
+ * \param[in,out] dev Volume base component device.
+ * \param[in,out] sink Destination buffer.
+ * \param[in] source Source buffer.
+ * \param[in] frames Number of frames to process.
+ * \param[in] sample_bytes Size of source and sink samples.
+ * \param[in] block Processing function for linear blocks.
+ *
+ * The buffers are processed in linear spans between buffer wraps. The
+ * spans are split further at the end of the gain pattern, so the block
+ * function sees plain arrays of samples and gains and can be vectorized
+ * by the compiler.
+ */
+static void vol_process(struct comp_dev *dev, struct audio_stream *sink,
+			const struct audio_stream *source, uint32_t frames,
+			uint32_t sample_bytes, vol_block_func block)
+{
+	struct comp_data *cd = comp_get_drvdata(dev);
+	struct audio_stream_span span;
+	uint32_t len = vol_gain_pattern(cd, sink->channels);
+	uint32_t phase = 0;
+	uint32_t chunk;
+	uint32_t n;
+	char *src;
+	char *dst;
+
+	audio_stream_span_init(&span, source, 0, sample_bytes, sink, 0,
+			       sample_bytes, frames * sink->channels);
+
+	while ((n = audio_stream_span_next(&span))) {
+		src = span.src;
+		dst = span.snk;
+		while (n) {
+			chunk = MIN(n, len - phase);
+			block(dst, src, cd->gain_pattern + phase, chunk);
+			src += chunk * sample_bytes;
+			dst += chunk * sample_bytes;
+			n -= chunk;
+			phase += chunk;
+			if (phase == len)
+				phase = 0;
+		}
+	}
+}
+
+/**
+ * \brief Advances per frame interpolated ramp gains by one frame.
+ * \param[in,out] cd Volume component private data.
+ * \param[in] channels Number of channels.
+ *
+ * The gains stop at the target volume. The current gains for the next
+ * frame are written to the start of the gain pattern.
+ */
+static void vol_ramp_step(struct comp_data *cd, uint32_t channels)
+{
+	int32_t target;
+	int32_t inc;
+	uint32_t channel;
+
+	for (channel = 0; channel < channels; channel++) {
+		target = cd->tvolume[channel] << VOL_RAMP_FRAC_BITS;
+		inc = cd->ramp_frame_inc[channel];
+		if ((inc > 0 && target - cd->ramp_gain[channel] > inc) ||
+		    (inc < 0 && target - cd->ramp_gain[channel] < inc))
+			cd->ramp_gain[channel] += inc;
+		else
+			cd->ramp_gain[channel] = target;
+
+		cd->gain_pattern[channel] = cd->ramp_gain[channel] >>
+					    VOL_RAMP_FRAC_BITS;
+	}
+}
+
+/**
+ * \brief Applies volume ramp from source buffer to sink buffer.
+ * \param[in,out] dev Volume base component device.
+ * \param[in,out] sink Destination buffer.
+ * \param[in] source Source buffer.
+ * \param[in] frames Number of frames to process.
+ * \param[in] sample_bytes Size of source and sink samples.
+ * \param[in] block Processing function for linear blocks.
+ *
+ * The gain of each channel is advanced by ramp_frame_inc after every
+ * frame. The gains are in Q8.24 in ramp_gain and the processing uses
+ * them truncated to Q8.16 like the constant gain processing.
+ */
+static void vol_ramp_process(struct comp_dev *dev, struct audio_stream *sink,
+			     const struct audio_stream *source,
+			     uint32_t frames, uint32_t sample_bytes,
+			     vol_block_func block)
+{
+	struct comp_data *cd = comp_get_drvdata(dev);
+	struct audio_stream_span span;
+	uint32_t channels = sink->channels;
+	uint32_t channel;
+	uint32_t phase = 0;
+	uint32_t chunk;
+	uint32_t n;
+	char *src;
+	char *dst;
+
+	for (channel = 0; channel < channels; channel++)
+		cd->gain_pattern[channel] = cd->ramp_gain[channel] >>
+					    VOL_RAMP_FRAC_BITS;
+
+	audio_stream_span_init(&span, source, 0, sample_bytes, sink, 0,
+			       sample_bytes, frames * channels);
+
+	while ((n = audio_stream_span_next(&span))) {
+		src = span.src;
+		dst = span.snk;
+		while (n) {
+			chunk = MIN(n, channels - phase);
+			block(dst, src, cd->gain_pattern + phase, chunk);
+			src += chunk * sample_bytes;
+			dst += chunk * sample_bytes;
+			n -= chunk;
+			phase += chunk;
+			if (phase == channels) {
+				vol_ramp_step(cd, channels);
+				phase = 0;
+			}
+		}
+	}
+}
+
 #if CONFIG_FORMAT_S24LE
 /**
  * \brief Volume s24 to s24 multiply function
@@ -41,6 +197,18 @@ static inline int32_t vol_mult_s24_to_s24(int32_t x, int32_t vol)
 				     Q_SHIFT_BITS_64(23, 16, 23));
 }
 
+static void vol_block_s24(void *dst, const void *src, const int32_t *gain,
+			  uint32_t samples)
+{
+	const int32_t *x = src;
+	int32_t *y = dst;
+	uint32_t i;
+
+	/* Samples are Q1.23 --> Q1.23 and volume is Q8.16 */
+	for (i = 0; i < samples; i++)
+		y[i] = vol_mult_s24_to_s24(x[i], gain[i]);
+}
+
 /**
  * \brief Volume processing from 24/32 bit to 24/32 bit.
  * \param[in,out] dev Volume base component device.
@@ -54,28 +222,41 @@ static inline int32_t vol_mult_s24_to_s24(int32_t x, int32_t vol)
 static void vol_s24_to_s24(struct comp_dev *dev, struct audio_stream *sink,
 			   const struct audio_stream *source, uint32_t frames)
 {
-	struct comp_data *cd = comp_get_drvdata(dev);
-	int32_t *src;
-	int32_t *dest;
-	int32_t i;
-	uint32_t channel;
-	uint32_t buff_frag = 0;
-
-	/* Samples are Q1.23 --> Q1.23 and volume is Q8.16 */
-	for (i = 0; i < frames; i++) {
-		for (channel = 0; channel < sink->channels; channel++) {
-			src = audio_stream_read_frag_s32(source, buff_frag);
-			dest = audio_stream_write_frag_s32(sink, buff_frag);
-
-			*dest = vol_mult_s24_to_s24(*src, cd->volume[channel]);
+	vol_process(dev, sink, source, frames, sizeof(int32_t),
+		    vol_block_s24);
+}
 
-			buff_frag++;
-		}
-	}
+/**
+ * \brief Volume processing with ramp from 24/32 bit to 24/32 bit.
+ * \param[in,out] dev Volume base component device.
+ * \param[in,out] sink Destination buffer.
+ * \param[in,out] source Source buffer.
+ * \param[in] frames Number of frames to process.
+ */
+static void vol_s24_to_s24_ramp(struct comp_dev *dev,
+				struct audio_stream *sink,
+				const struct audio_stream *source,
+				uint32_t frames)
+{
+	vol_ramp_process(dev, sink, source, frames, sizeof(int32_t),
+			 vol_block_s24);
 }
 #endif /* CONFIG_FORMAT_S24LE */
 
 #if CONFIG_FORMAT_S32LE
+static void vol_block_s32(void *dst, const void *src, const int32_t *gain,
+			  uint32_t samples)
+{
+	const int32_t *x = src;
+	int32_t *y = dst;
+	uint32_t i;
+
+	/* Samples are Q1.31 --> Q1.31 and volume is Q8.16 */
+	for (i = 0; i < samples; i++)
+		y[i] = q_multsr_sat_32x32(x[i], gain[i],
+					  Q_SHIFT_BITS_64(31, 16, 31));
+}
+
 /**
  * \brief Volume processing from 32 bit to 32 bit.
  * \param[in,out] dev Volume base component device.
@@ -89,30 +270,49 @@ static void vol_s24_to_s24(struct comp_dev *dev, struct audio_stream *sink,
 static void vol_s32_to_s32(struct comp_dev *dev, struct audio_stream *sink,
 			   const struct audio_stream *source, uint32_t frames)
 {
-	struct comp_data *cd = comp_get_drvdata(dev);
-	int32_t *src;
-	int32_t *dest;
-	int32_t i;
-	uint32_t channel;
-	uint32_t buff_frag = 0;
+	vol_process(dev, sink, source, frames, sizeof(int32_t),
+		    vol_block_s32);
+}
 
-	/* Samples are Q1.31 --> Q1.31 and volume is Q8.16 */
-	for (i = 0; i < frames; i++) {
-		for (channel = 0; channel < sink->channels; channel++) {
-			src = audio_stream_read_frag_s32(source, buff_frag);
-			dest = audio_stream_write_frag_s32(sink, buff_frag);
+/**
+ * \brief Volume processing with ramp from 32 bit to 32 bit.
+ * \param[in,out] dev Volume base component device.
+ * \param[in,out] sink Destination buffer.
+ * \param[in,out] source Source buffer.
+ * \param[in] frames Number of frames to process.
+ */
+static void vol_s32_to_s32_ramp(struct comp_dev *dev,
+				struct audio_stream *sink,
+				const struct audio_stream *source,
+				uint32_t frames)
+{
+	vol_ramp_process(dev, sink, source, frames, sizeof(int32_t),
+			 vol_block_s32);
+}
+#endif /* CONFIG_FORMAT_S32LE */
 
-			*dest = q_multsr_sat_32x32
-				(*src, cd->volume[channel],
-				 Q_SHIFT_BITS_64(31, 16, 31));
+#if CONFIG_FORMAT_S16LE
+static void vol_block_s16(void *dst, const void *src, const int32_t *gain,
+			  uint32_t samples)
+{
+	const int16_t *x = src;
+	int16_t *y = dst;
+	int32_t sample;
+	uint32_t i;
 
-			buff_frag++;
-		}
+	/* Samples are Q1.15 --> Q1.15 and volume is Q8.16. The gain is
+	 * split to integer and fractional parts so that the product
+	 * fits 32 bits, the result is the same as with 64 bit
+	 * q_multsr_sat_32x32_16() but vectorizes to 32 bit lanes.
+	 */
+	for (i = 0; i < samples; i++) {
+		sample = x[i];
+		y[i] = sat_int16(sample * (gain[i] >> VOL_QXY_Y) +
+				 ((((sample * (gain[i] & 0xffff)) >>
+				    (VOL_QXY_Y - 1)) + 1) >> 1));
 	}
 }
-#endif /* CONFIG_FORMAT_S32LE */
 
-#if CONFIG_FORMAT_S16LE
 /**
  * \brief Volume processing from 16 bit to 16 bit.
  * \param[in,out] dev Volume base component device.
@@ -126,38 +326,36 @@ static void vol_s32_to_s32(struct comp_dev *dev, struct audio_stream *sink,
 static void vol_s16_to_s16(struct comp_dev *dev, struct audio_stream *sink,
 			   const struct audio_stream *source, uint32_t frames)
 {
-	struct comp_data *cd = comp_get_drvdata(dev);
-	int16_t *src;
-	int16_t *dest;
-	int32_t i;
-	uint32_t channel;
-	uint32_t buff_frag = 0;
-
-	/* Samples are Q1.15 --> Q1.15 and volume is Q8.16 */
-	for (i = 0; i < frames; i++) {
-		for (channel = 0; channel < sink->channels; channel++) {
-			src = audio_stream_read_frag_s16(source, buff_frag);
-			dest = audio_stream_write_frag_s16(sink, buff_frag);
-
-			*dest = q_multsr_sat_32x32_16
-				(*src, cd->volume[channel],
-				 Q_SHIFT_BITS_32(15, 16, 15));
+	vol_process(dev, sink, source, frames, sizeof(int16_t),
+		    vol_block_s16);
+}
 
-			buff_frag++;
-		}
-	}
+/**
+ * \brief Volume processing with ramp from 16 bit to 16 bit.
+ * \param[in,out] dev Volume base component device.
+ * \param[in,out] sink Destination buffer.
+ * \param[in,out] source Source buffer.
+ * \param[in] frames Number of frames to process.
+ */
+static void vol_s16_to_s16_ramp(struct comp_dev *dev,
+				struct audio_stream *sink,
+				const struct audio_stream *source,
+				uint32_t frames)
+{
+	vol_ramp_process(dev, sink, source, frames, sizeof(int16_t),
+			 vol_block_s16);
 }
 #endif /* CONFIG_FORMAT_S16LE */
 
 const struct comp_func_map func_map[] = {
 #if CONFIG_FORMAT_S16LE
-	{ SOF_IPC_FRAME_S16_LE, vol_s16_to_s16 },
+	{ SOF_IPC_FRAME_S16_LE, vol_s16_to_s16, vol_s16_to_s16_ramp },
 #endif /* CONFIG_FORMAT_S16LE */
 #if CONFIG_FORMAT_S24LE
-	{ SOF_IPC_FRAME_S24_4LE, vol_s24_to_s24 },
+	{ SOF_IPC_FRAME_S24_4LE, vol_s24_to_s24, vol_s24_to_s24_ramp },
 #endif /* CONFIG_FORMAT_S24LE */
 #if CONFIG_FORMAT_S32LE
-	{ SOF_IPC_FRAME_S32_LE, vol_s32_to_s32 },
+	{ SOF_IPC_FRAME_S32_LE, vol_s32_to_s32, vol_s32_to_s32_ramp },
 #endif /* CONFIG_FORMAT_S32LE */
 };
 
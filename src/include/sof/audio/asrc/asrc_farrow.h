@@ -46,6 +46,14 @@
 #include <stddef.h>
 #include <stdint.h>
 
+/*
+ * Maximum number of output frames produced in one block between two
+ * input frames. Upsampling produces up to 1 / fs_ratio outputs for
+ * every input, the impulse responses for the block are computed
+ * before filtering each channel for all of them.
+ */
+#define ASRC_MAX_BLOCK_FRAMES	4
+
 /*
  * @brief Define whether the input and output buffers shall be
  * interleaved or not.
@@ -175,6 +183,15 @@ struct asrc_farrow {
 					  /*!< coefficients */
 	int32_t *impulse_response; /*!< Pointer to the impulse response */
 				   /*!< for generating one output sample */
+	int32_t *ir_scratch;	/*!< Impulse responses of a block computed */
+				/*!< on the fly */
+	int32_t *ir_cache;	/*!< Impulse responses of the output frames */
+				/*!< of a fixed mode control cycle */
+	int ir_cache_size;	/*!< Size of the cache in bytes */
+	int ir_cache_length;	/*!< Number of impulse responses fitting */
+				/*!< to the cache */
+	int ir_cache_count;	/*!< Number of impulse responses computed */
+				/*!< to the cache */
 
 	/* PROGRAM + general */
 	bool is_initialised;	/*!< Flag is set to true after */
@@ -575,6 +592,35 @@ enum asrc_error_code asrc_update_fs_ratio(struct comp_dev *dev,
 					  int primary_num_frames,
 					  int secondary_num_frames);
 
+/*
+ * @brief Sets memory for caching the impulse responses
+ *
+ * In fixed control mode the time value is reset at start of every
+ * control cycle, so the impulse response of an output frame depends
+ * only on its index in the cycle. The responses of the first cycle are
+ * stored to the cache and reused by the following cycles with the same
+ * number of frames. Output frames beyond the cache size and feedback
+ * control mode compute the impulse response on the fly. Call after
+ * asrc_initialise(), the memory must be 8 bytes aligned.
+ *
+ * @param[in] src_obj   Pointer to the ias_src_farrow instance.
+ * @param[in] ir_cache  Memory for the impulse responses, NULL to disable.
+ * @param[in] size      Size of the memory in bytes, see
+ *                      asrc_get_ir_cache_size().
+ */
+enum asrc_error_code asrc_set_ir_cache(struct comp_dev *dev,
+				       struct asrc_farrow *src_obj,
+				       int32_t *ir_cache, int size);
+
+/*
+ * @brief Get the cache size for impulse responses
+ *
+ * @param[in] src_obj     Pointer to the ias_src_farrow instance.
+ * @param[in] num_frames  Number of output frames in a control cycle.
+ * @return Size of the cache in bytes.
+ */
+int asrc_get_ir_cache_size(struct asrc_farrow *src_obj, int num_frames);
+
 /*
  * @brief Changes the input and output sampling rate.
  *
@@ -617,32 +663,36 @@ enum asrc_error_code asrc_set_output_format(struct comp_dev *dev,
 					    enum asrc_io_format output_format);
 
 /*
- * Write value of 16 bit input buffers to the channels of the ring buffer
+ * Write num_frames frames of 16 bit input buffers to the channels of the
+ * ring buffer
  */
 void asrc_write_to_ring_buffer16(struct asrc_farrow *src_obj,
 				 int16_t **input_buffers,
-				 int index_input_frame);
+				 int index_input_frame, int num_frames);
 
 /*
- * Write value of 32 bit input buffers to the channels of the ring buffer
+ * Write num_frames frames of 32 bit input buffers to the channels of the
+ * ring buffer
  */
 void asrc_write_to_ring_buffer32(struct asrc_farrow *src_obj,
 				 int32_t **input_buffers,
-				 int index_input_frame);
+				 int index_input_frame, int num_frames);
 
 /*
- * Filter the 32 bit ring buffer values with impulse_response
+ * Filter the 16 bit ring buffer values with num_frames consecutive
+ * impulse responses starting from impulse_response
  */
 void asrc_fir_filter16(struct asrc_farrow *src_obj,
 		       int16_t **output_buffers,
-		       int index_output_frame);
+		       int index_output_frame, int num_frames);
 
 /*
- * Filter the 32 bit ring buffer values with impulse_response
+ * Filter the 32 bit ring buffer values with num_frames consecutive
+ * impulse responses starting from impulse_response
  */
 void asrc_fir_filter32(struct asrc_farrow *src_obj,
 		       int32_t **output_buffers,
-		       int index_output_frame);
+		       int index_output_frame, int num_frames);
 
 /*
  * Calculates the impulse response. This impulse response is then
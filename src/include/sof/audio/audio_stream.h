@@ -526,6 +526,85 @@ audio_stream_bytes_without_wrap(const struct audio_stream *source,
 	return to_end;
 }
 
+/**
+ * Contiguous segments of a source and a sink stream for processing of samples
+ * without buffer wrap checks. Each call of audio_stream_span_next() returns
+ * the number of samples up to the next wrap of either buffer, so a transfer
+ * is split into at most three spans.
+ */
+struct audio_stream_span {
+	const struct audio_stream *source;
+	const struct audio_stream *sink;
+	void *src;		/**< source span start, valid after next() */
+	void *snk;		/**< sink span start, valid after next() */
+	char *r_pos;		/**< source position of next span */
+	char *w_pos;		/**< sink position of next span */
+	uint32_t src_size;	/**< source sample size in bytes */
+	uint32_t snk_size;	/**< sink sample size in bytes */
+	uint32_t samples;	/**< samples left */
+};
+
+/**
+ * Initializes span iterator for transfer of samples from source to sink.
+ * @param span Span iterator.
+ * @param source Source buffer, read pointer is not modified.
+ * @param ioffset Offset (in samples) in source buffer to start reading from.
+ * @param src_size Source sample size in bytes.
+ * @param sink Sink buffer, write pointer is not modified.
+ * @param ooffset Offset (in samples) in sink buffer to start writing to.
+ * @param snk_size Sink sample size in bytes.
+ * @param samples Number of samples to transfer.
+ */
+static inline void audio_stream_span_init(struct audio_stream_span *span,
+					  const struct audio_stream *source,
+					  uint32_t ioffset, uint32_t src_size,
+					  const struct audio_stream *sink,
+					  uint32_t ooffset, uint32_t snk_size,
+					  uint32_t samples)
+{
+	span->source = source;
+	span->sink = sink;
+	span->r_pos = audio_stream_get_frag(source, source->r_ptr, ioffset,
+					    src_size);
+	span->w_pos = audio_stream_get_frag(sink, sink->w_ptr, ooffset,
+					    snk_size);
+	span->src_size = src_size;
+	span->snk_size = snk_size;
+	span->samples = samples;
+}
+
+/**
+ * Gets next pair of linear source and sink regions.
+ * @param span Span iterator, src and snk are set to the region starts.
+ * @return Number of samples in the regions, 0 when transfer is complete.
+ */
+static inline uint32_t audio_stream_span_next(struct audio_stream_span *span)
+{
+	uint32_t n_src;
+	uint32_t n_snk;
+	uint32_t n;
+
+	if (!span->samples)
+		return 0;
+
+	n_src = audio_stream_bytes_without_wrap(span->source, span->r_pos) /
+		span->src_size;
+	n_snk = audio_stream_bytes_without_wrap(span->sink, span->w_pos) /
+		span->snk_size;
+	n = MIN(span->samples, MIN(n_src, n_snk));
+	assert(n);
+
+	span->src = span->r_pos;
+	span->snk = span->w_pos;
+	span->r_pos = audio_stream_wrap(span->source,
+					span->r_pos + n * span->src_size);
+	span->w_pos = audio_stream_wrap(span->sink,
+					span->w_pos + n * span->snk_size);
+	span->samples -= n;
+
+	return n;
+}
+
 /**
  * Copies data from source buffer to sink buffer.
  * @param source Source buffer.
@@ -540,29 +619,16 @@ static inline void audio_stream_copy(const struct audio_stream *source,
 				     struct audio_stream *sink,
 				     uint32_t ooffset_bytes, uint32_t bytes)
 {
-	void *src = audio_stream_wrap(source,
-				      (char *)source->r_ptr + ioffset_bytes);
-	void *snk = audio_stream_wrap(sink,
-				      (char *)sink->w_ptr + ooffset_bytes);
-	uint32_t bytes_src;
-	uint32_t bytes_snk;
-	uint32_t bytes_copied;
+	struct audio_stream_span span;
+	uint32_t n;
 	int ret;
 
-	while (bytes) {
-		bytes_src = audio_stream_bytes_without_wrap(source, src);
-		bytes_snk = audio_stream_bytes_without_wrap(sink, snk);
-		bytes_copied = MIN(bytes, MIN(bytes_src, bytes_snk));
+	audio_stream_span_init(&span, source, ioffset_bytes, 1, sink,
+			       ooffset_bytes, 1, bytes);
 
-		ret = memcpy_s(snk, bytes_snk, src, bytes_copied);
+	while ((n = audio_stream_span_next(&span))) {
+		ret = memcpy_s(span.snk, n, span.src, n);
 		assert(!ret);
-
-		bytes -= bytes_copied;
-		src = (char *)src + bytes_copied;
-		snk = (char *)snk + bytes_copied;
-
-		src = audio_stream_wrap(source, src);
-		snk = audio_stream_wrap(sink, snk);
 	}
 }
 
@@ -9,12 +9,29 @@
 #define __SOF_AUDIO_DCBLOCK_DCBLOCK_H__
 
 #include <stdint.h>
+#include <sof/audio/pcm_converter.h>
 #include <sof/platform.h>
 #include <ipc/stream.h>
 
 struct audio_stream;
 struct comp_dev;
 
+/* Select optimized code variant when xt-xcc compiler is used on HiFi3 */
+#if defined __XCC__
+#include <xtensa/config/core-isa.h>
+#if XCHAL_HAVE_HIFI3 == 1
+#define DCBLOCK_HIFI3	1
+#define DCBLOCK_GENERIC	0
+#else
+#define DCBLOCK_HIFI3	0
+#define DCBLOCK_GENERIC	1
+#endif
+#else
+/* GCC */
+#define DCBLOCK_HIFI3	0
+#define DCBLOCK_GENERIC	1
+#endif
+
 struct dcblock_state {
 	int32_t x_prev; /**< state variable referring to x[n-1] */
 	int32_t y_prev; /**< state variable referring to y[n-1] */
@@ -40,6 +57,7 @@ struct comp_data {
 	enum sof_ipc_frame source_format;
 	enum sof_ipc_frame sink_format;
 	dcblock_func dcblock_func; /**< processing function */
+	struct pcm_adapter adapter; /**< source and sink format adapter */
 };
 
 /** \brief DC Blocking Filter processing functions map item. */
@@ -72,4 +90,17 @@ static inline dcblock_func dcblock_find_func(enum sof_ipc_frame src_fmt)
 	return NULL;
 }
 
+/**
+ * \brief Retrieves the frame format for processing, the source format is
+ *	  preferred to keep its precision. Other formats are handled by the
+ *	  format adapter.
+ * \param src_fmt the frames' format of the source buffer
+ * \param sink_fmt the frames' format of the sink buffer
+ */
+static inline enum sof_ipc_frame
+dcblock_process_format(enum sof_ipc_frame src_fmt, enum sof_ipc_frame sink_fmt)
+{
+	return dcblock_find_func(src_fmt) ? src_fmt : sink_fmt;
+}
+
 #endif /* __SOF_AUDIO_DCBLOCK_DCBLOCK_H__ */
@@ -14,19 +14,34 @@
 
 #if FIR_GENERIC
 
+#include <sof/audio/eq_fir/fir_fft.h>
 #include <sof/audio/format.h>
+#include <sof/math/numbers.h>
+#include <stdbool.h>
 #include <stdint.h>
 
+struct audio_stream;
 struct comp_buffer;
 struct sof_eq_fir_coef_data;
 
+/* Max. number of sequential samples processed per call, the delay line
+ * needs that minus one entries more than taps.
+ */
+#define FIR_32X16_SAMPLES_MAX	4
+
+/* Max. number of channels filtered together with shared coefficients */
+#define FIR_LANES_MAX		8
+
 struct fir_state_32x16 {
 	int rwi; /* Circular read and write index */
 	int taps; /* Number of FIR taps */
-	int length; /* Number of FIR taps */
+	int length; /* Number of FIR taps plus input length */
 	int out_shift; /* Amount of right shifts at output */
 	int16_t *coef; /* Pointer to FIR coefficients */
 	int32_t *delay; /* Pointer to FIR delay line */
+#if FIR_FFT
+	struct fir_fft_state *fft; /* FFT convolution state or NULL */
+#endif
 };
 
 void fir_reset(struct fir_state_32x16 *fir);
@@ -39,29 +54,72 @@ int fir_init_coef(struct fir_state_32x16 *fir,
 void fir_init_delay(struct fir_state_32x16 *fir, int32_t **data);
 
 #if CONFIG_FORMAT_S16LE
-void eq_fir_s16(struct fir_state_32x16 *fir, const struct audio_stream *source,
-		struct audio_stream *sink, int frames, int nch);
+void eq_fir_4x_s16(struct fir_state_32x16 *fir,
+		   const struct audio_stream *source,
+		   struct audio_stream *sink, int frames, int nch);
+#endif /* CONFIG_FORMAT_S16LE */
+
+#if CONFIG_FORMAT_S24LE
+void eq_fir_4x_s24(struct fir_state_32x16 *fir,
+		   const struct audio_stream *source,
+		   struct audio_stream *sink, int frames, int nch);
+#endif /* CONFIG_FORMAT_S24LE */
+
+#if CONFIG_FORMAT_S32LE
+void eq_fir_4x_s32(struct fir_state_32x16 *fir,
+		   const struct audio_stream *source,
+		   struct audio_stream *sink, int frames, int nch);
+#endif /* CONFIG_FORMAT_S32LE */
+
+#if FIR_LANES
+bool fir_lanes_ok(struct fir_state_32x16 *fir, int nch);
+
+void fir_init_delay_lanes(struct fir_state_32x16 *fir, int nch,
+			  int32_t **data);
+
+#if CONFIG_FORMAT_S16LE
+void eq_fir_lanes_s16(struct fir_state_32x16 *fir,
+		      const struct audio_stream *source,
+		      struct audio_stream *sink, int frames, int nch);
 #endif /* CONFIG_FORMAT_S16LE */
 
 #if CONFIG_FORMAT_S24LE
-void eq_fir_s24(struct fir_state_32x16 *fir, const struct audio_stream *source,
-		struct audio_stream *sink, int frames, int nch);
+void eq_fir_lanes_s24(struct fir_state_32x16 *fir,
+		      const struct audio_stream *source,
+		      struct audio_stream *sink, int frames, int nch);
 #endif /* CONFIG_FORMAT_S24LE */
 
 #if CONFIG_FORMAT_S32LE
-void eq_fir_s32(struct fir_state_32x16 *fir, const struct audio_stream *source,
-		struct audio_stream *sink, int frames, int nch);
+void eq_fir_lanes_s32(struct fir_state_32x16 *fir,
+		      const struct audio_stream *source,
+		      struct audio_stream *sink, int frames, int nch);
 #endif /* CONFIG_FORMAT_S32LE */
+#endif /* FIR_LANES */
 
 /* The next functions are inlined to optmize execution speed */
 
+/* Write sample to delay and advance the circular write index */
+static inline void fir_32x16_write(struct fir_state_32x16 *fir, int32_t x)
+{
+	fir->delay[fir->rwi] = x;
+	if (++fir->rwi == fir->length)
+		fir->rwi = 0;
+}
+
+/* Returns the delay line index of the sample written n samples ago */
+static inline int fir_32x16_index(struct fir_state_32x16 *fir, int n)
+{
+	int i = fir->rwi - n;
+
+	return i < 0 ? i + fir->length : i;
+}
+
 static inline int32_t fir_32x16(struct fir_state_32x16 *fir, int32_t x)
 {
 	int64_t y = 0;
-	int32_t *data = &fir->delay[fir->rwi];
+	int32_t *data;
 	int16_t *coef = &fir->coef[0];
 	int n1;
-	int n2;
 	int n;
 
 	/* Bypass is set with length set to zero. */
@@ -69,39 +127,26 @@ static inline int32_t fir_32x16(struct fir_state_32x16 *fir, int32_t x)
 		return x;
 
 	/* Write sample to delay */
-	*data = x;
+	fir_32x16_write(fir, x);
 
-	/* Advance write pointer and calculate into n1 max. number of taps
-	 * to process before circular wrap.
+	/* Calculate into n1 max. number of taps to process before circular
+	 * wrap.
 	 */
-	n1 = ++fir->rwi;
-	if (fir->rwi == fir->length)
-		fir->rwi = 0;
-
-	/* Check if no need to un-wrap FIR data. */
-	if (n1 > fir->length) {
-		/* Data is Q1.31, coef is Q1.15, product is Q2.46 */
-		for (n = 0; n < fir->length; n++) {
-			y += (int64_t)(*coef) * (*data);
-			coef++;
-			data--;
-		}
-
-		/* Q2.46 -> Q2.31, saturate to Q1.31 */
-		return sat_int32(y >> (15 + fir->out_shift));
-	}
+	n = fir_32x16_index(fir, 1);
+	data = &fir->delay[n];
+	n1 = MIN(fir->taps, n + 1);
 
 	/* Part 1, loop n1 times */
 	for (n = 0; n < n1; n++) {
+		/* Data is Q1.31, coef is Q1.15, product is Q2.46 */
 		y += (int64_t)(*coef) * (*data);
 		coef++;
 		data--;
 	}
 
-	/* Part 2, un-wrap data, continue n2 times */
-	n2 = fir->length - n1;
+	/* Part 2, un-wrap data, continue for the rest of taps */
 	data = &fir->delay[fir->length - 1];
-	for (n = 0; n < n2; n++) {
+	for (; n < fir->taps; n++) {
 		y += (int64_t)(*coef) * (*data);
 		coef++;
 		data--;
@@ -111,5 +156,294 @@ static inline int32_t fir_32x16(struct fir_state_32x16 *fir, int32_t x)
 	return sat_int32(y >> (15 + fir->out_shift));
 }
 
+/* Computes two sequential output samples per pass over the delay line.
+ * Every coefficient is loaded once and applied to two sequential samples
+ * that are shifted in registers so that also the data is loaded once.
+ */
+static inline void fir_32x16_2x(struct fir_state_32x16 *fir, int32_t x0,
+				int32_t x1, int32_t *y0, int32_t *y1)
+{
+	int64_t a0 = 0;
+	int64_t a1 = 0;
+	int32_t *data;
+	int16_t *coef = &fir->coef[0];
+	int32_t d0;
+	int32_t d1 = x1;
+	int32_t c;
+	int n1;
+	int n;
+
+	/* Bypass is set with length set to zero. */
+	if (!fir->length) {
+		*y0 = x0;
+		*y1 = x1;
+		return;
+	}
+
+	fir_32x16_write(fir, x0);
+	fir_32x16_write(fir, x1);
+
+	/* Start from x0, the newer sample x1 is already in d1 */
+	n = fir_32x16_index(fir, 2);
+	data = &fir->delay[n];
+	n1 = MIN(fir->taps, n + 1);
+	for (n = 0; n < n1; n++) {
+		c = *coef++;
+		d0 = *data--;
+		a1 += (int64_t)c * d1;
+		a0 += (int64_t)c * d0;
+		d1 = d0;
+	}
+
+	data = &fir->delay[fir->length - 1];
+	for (; n < fir->taps; n++) {
+		c = *coef++;
+		d0 = *data--;
+		a1 += (int64_t)c * d1;
+		a0 += (int64_t)c * d0;
+		d1 = d0;
+	}
+
+	*y0 = sat_int32(a0 >> (15 + fir->out_shift));
+	*y1 = sat_int32(a1 >> (15 + fir->out_shift));
+}
+
+/* The same as fir_32x16_2x() for four sequential samples */
+static inline void fir_32x16_4x(struct fir_state_32x16 *fir, int32_t x0,
+				int32_t x1, int32_t x2, int32_t x3,
+				int32_t *y0, int32_t *y1, int32_t *y2,
+				int32_t *y3)
+{
+	int64_t a0 = 0;
+	int64_t a1 = 0;
+	int64_t a2 = 0;
+	int64_t a3 = 0;
+	int32_t *data;
+	int16_t *coef = &fir->coef[0];
+	int32_t d0;
+	int32_t d1 = x1;
+	int32_t d2 = x2;
+	int32_t d3 = x3;
+	int32_t c;
+	int n1;
+	int n;
+
+	/* Bypass is set with length set to zero. */
+	if (!fir->length) {
+		*y0 = x0;
+		*y1 = x1;
+		*y2 = x2;
+		*y3 = x3;
+		return;
+	}
+
+	fir_32x16_write(fir, x0);
+	fir_32x16_write(fir, x1);
+	fir_32x16_write(fir, x2);
+	fir_32x16_write(fir, x3);
+
+	n = fir_32x16_index(fir, 4);
+	data = &fir->delay[n];
+	n1 = MIN(fir->taps, n + 1);
+	for (n = 0; n < n1; n++) {
+		c = *coef++;
+		d0 = *data--;
+		a3 += (int64_t)c * d3;
+		a2 += (int64_t)c * d2;
+		a1 += (int64_t)c * d1;
+		a0 += (int64_t)c * d0;
+		d3 = d2;
+		d2 = d1;
+		d1 = d0;
+	}
+
+	data = &fir->delay[fir->length - 1];
+	for (; n < fir->taps; n++) {
+		c = *coef++;
+		d0 = *data--;
+		a3 += (int64_t)c * d3;
+		a2 += (int64_t)c * d2;
+		a1 += (int64_t)c * d1;
+		a0 += (int64_t)c * d0;
+		d3 = d2;
+		d2 = d1;
+		d1 = d0;
+	}
+
+	*y0 = sat_int32(a0 >> (15 + fir->out_shift));
+	*y1 = sat_int32(a1 >> (15 + fir->out_shift));
+	*y2 = sat_int32(a2 >> (15 + fir->out_shift));
+	*y3 = sat_int32(a3 >> (15 + fir->out_shift));
+}
+
+#if FIR_LANES
+/* Filters one frame of interleaved channels that share the coefficients
+ * of fir, the channels are the lanes of the inner loop. The delay line of
+ * fir is interleaved with lanes channels. The lanes count is a compile
+ * time constant in the callers so the compiler can unroll the lanes.
+ */
+static inline void fir_32x16_lanes(struct fir_state_32x16 *fir,
+				   const int lanes, const int32_t *x,
+				   int32_t *y)
+{
+	int64_t a[FIR_LANES_MAX];
+	int32_t *data = &fir->delay[fir->rwi * lanes];
+	int16_t *coef = &fir->coef[0];
+	int32_t c;
+	int n1;
+	int n;
+	int i;
+
+	/* Write frame to delay */
+	for (i = 0; i < lanes; i++) {
+		data[i] = x[i];
+		a[i] = 0;
+	}
+
+	n1 = MIN(fir->taps, fir->rwi + 1);
+	if (++fir->rwi == fir->length)
+		fir->rwi = 0;
+
+	/* Part 1, loop n1 times */
+	for (n = 0; n < n1; n++) {
+		c = *coef++;
+		for (i = 0; i < lanes; i++)
+			a[i] += (int64_t)c * data[i];
+
+		data -= lanes;
+	}
+
+	/* Part 2, un-wrap data, continue for the rest of taps */
+	data = &fir->delay[(fir->length - 1) * lanes];
+	for (; n < fir->taps; n++) {
+		c = *coef++;
+		for (i = 0; i < lanes; i++)
+			a[i] += (int64_t)c * data[i];
+
+		data -= lanes;
+	}
+
+	for (i = 0; i < lanes; i++)
+		y[i] = sat_int32(a[i] >> (15 + fir->out_shift));
+}
+
+/* The same as fir_32x16_lanes() for two sequential frames. The data of the
+ * newer frame is shifted in registers as in fir_32x16_2x().
+ */
+static inline void fir_32x16_lanes_2x(struct fir_state_32x16 *fir,
+				      const int lanes, const int32_t *x,
+				      int32_t *y)
+{
+	int64_t a0[FIR_LANES_MAX];
+	int64_t a1[FIR_LANES_MAX];
+	int32_t d1[FIR_LANES_MAX];
+	int32_t *data;
+	int16_t *coef = &fir->coef[0];
+	int32_t d0;
+	int32_t c;
+	int rwi = fir->rwi;
+	int n1;
+	int n;
+	int i;
+
+	/* Write frames to delay */
+	data = &fir->delay[fir->rwi * lanes];
+	for (i = 0; i < lanes; i++)
+		data[i] = x[i];
+
+	if (++fir->rwi == fir->length)
+		fir->rwi = 0;
+
+	data = &fir->delay[fir->rwi * lanes];
+	for (i = 0; i < lanes; i++) {
+		data[i] = x[lanes + i];
+		d1[i] = x[lanes + i];
+		a0[i] = 0;
+		a1[i] = 0;
+	}
+
+	if (++fir->rwi == fir->length)
+		fir->rwi = 0;
+
+	/* Start from the older frame */
+	data = &fir->delay[rwi * lanes];
+	n1 = MIN(fir->taps, rwi + 1);
+	for (n = 0; n < n1; n++) {
+		c = *coef++;
+		for (i = 0; i < lanes; i++) {
+			d0 = data[i];
+			a1[i] += (int64_t)c * d1[i];
+			a0[i] += (int64_t)c * d0;
+			d1[i] = d0;
+		}
+
+		data -= lanes;
+	}
+
+	data = &fir->delay[(fir->length - 1) * lanes];
+	for (; n < fir->taps; n++) {
+		c = *coef++;
+		for (i = 0; i < lanes; i++) {
+			d0 = data[i];
+			a1[i] += (int64_t)c * d1[i];
+			a0[i] += (int64_t)c * d0;
+			d1[i] = d0;
+		}
+
+		data -= lanes;
+	}
+
+	for (i = 0; i < lanes; i++) {
+		y[i] = sat_int32(a0[i] >> (15 + fir->out_shift));
+		y[lanes + i] = sat_int32(a1[i] >> (15 + fir->out_shift));
+	}
+}
+#endif /* FIR_LANES */
+
+/* Filters with FFT convolution when it is set up for the channel and with
+ * the time-domain fir_32x16() otherwise.
+ */
+static inline int32_t fir_filter(struct fir_state_32x16 *fir, int32_t x)
+{
+#if FIR_FFT
+	if (fir->fft)
+		return fir_fft_32(fir->fft, x);
+#endif
+
+	return fir_32x16(fir, x);
+}
+
+static inline void fir_filter_2x(struct fir_state_32x16 *fir, int32_t x0,
+				 int32_t x1, int32_t *y0, int32_t *y1)
+{
+#if FIR_FFT
+	if (fir->fft) {
+		*y0 = fir_fft_32(fir->fft, x0);
+		*y1 = fir_fft_32(fir->fft, x1);
+		return;
+	}
+#endif
+
+	fir_32x16_2x(fir, x0, x1, y0, y1);
+}
+
+static inline void fir_filter_4x(struct fir_state_32x16 *fir, int32_t x0,
+				 int32_t x1, int32_t x2, int32_t x3,
+				 int32_t *y0, int32_t *y1, int32_t *y2,
+				 int32_t *y3)
+{
+#if FIR_FFT
+	if (fir->fft) {
+		*y0 = fir_fft_32(fir->fft, x0);
+		*y1 = fir_fft_32(fir->fft, x1);
+		*y2 = fir_fft_32(fir->fft, x2);
+		*y3 = fir_fft_32(fir->fft, x3);
+		return;
+	}
+#endif
+
+	fir_32x16_4x(fir, x0, x1, x2, x3, y0, y1, y2, y3);
+}
+
 #endif
 #endif /* __SOF_AUDIO_EQ_FIR_FIR_H__ */
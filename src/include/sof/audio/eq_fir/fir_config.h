@@ -10,6 +10,9 @@
 #ifndef __SOF_AUDIO_EQ_FIR_FIR_CONFIG_H__
 #define __SOF_AUDIO_EQ_FIR_FIR_CONFIG_H__
 
+#include <config.h>
+#include <user/eq.h>
+
 /* Prevent xtensa gcc built firmware to be configured for longer
  * filter that it can process. This length limitation (# of taps) is for one
  * channel, for stereo the channel specific limit is this divided by two,
@@ -58,4 +61,35 @@
 #endif
 #endif
 
+/* The generic C version can run the filters with FFT based overlap-save
+ * convolution when it is selected with CONFIG_COMP_FIR_FFT. The unit tests
+ * build it always to check it against the time-domain version.
+ */
+#if FIR_GENERIC && (CONFIG_COMP_FIR_FFT || defined(UNIT_TEST))
+#define FIR_FFT		1
+#else
+#define FIR_FFT		0
+#endif
+
+/* The library build accepts responses longer than the IPC ABI limit since
+ * the long responses run with FFT convolution. The blob size limit allows
+ * one response of max. length for each of eight channels.
+ */
+#if FIR_FFT && (CONFIG_LIBRARY || defined(UNIT_TEST))
+#define FIR_MAX_LENGTH		4096
+#define FIR_MAX_SIZE		65536
+#else
+#define FIR_MAX_LENGTH		SOF_EQ_FIR_MAX_LENGTH
+#define FIR_MAX_SIZE		SOF_EQ_FIR_MAX_SIZE
+#endif
+
+/* The generic C version filters 2, 4, or 8 channels with the same
+ * response together with interleaved delay lines.
+ */
+#if FIR_GENERIC
+#define FIR_LANES		1
+#else
+#define FIR_LANES		0
+#endif
+
 #endif /* __SOF_AUDIO_EQ_FIR_FIR_CONFIG_H__ */
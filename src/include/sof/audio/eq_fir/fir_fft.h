@@ -0,0 +1,82 @@
+/* SPDX-License-Identifier: BSD-3-Clause
+ *
+ * Copyright(c) 2020 Intel Corporation. All rights reserved.
+ */
+
+#ifndef __SOF_AUDIO_EQ_FIR_FIR_FFT_H__
+#define __SOF_AUDIO_EQ_FIR_FIR_FFT_H__
+
+#include <sof/audio/eq_fir/fir_config.h>
+
+#if FIR_FFT
+
+#include <sof/math/fft.h>
+#include <stdint.h>
+
+struct fir_state_32x16;
+
+/* Uniformly partitioned overlap-save convolution. The filter is split to
+ * partitions of FIR_FFT_BLOCK_LEN taps and the input is processed in
+ * blocks of the same length with FFT of twice the length. The output is
+ * delayed by one block.
+ */
+#define FIR_FFT_BLOCK_LEN	64
+#define FIR_FFT_SIZE		(2 * FIR_FFT_BLOCK_LEN)
+#define FIR_FFT_SIZE_LOG2	7
+#define FIR_FFT_BINS		(FIR_FFT_BLOCK_LEN + 1) /* Up to Nyquist */
+
+/* Shortest response run with FFT convolution, below this the time-domain
+ * fir_32x16_4x() is faster. Measured with x86-64 GCC -O2 and -O3 the
+ * cost per sample is equal at about 300 taps.
+ */
+#define FIR_FFT_MIN_TAPS	384
+
+/* Right shift of the spectra products to allow sum of many partitions */
+#define FIR_FFT_ACC_SHIFT	8
+
+/* FFT plan and scratch shared by all channels */
+struct fir_fft_work {
+	struct fft_plan plan;
+	struct icomplex32 twiddle[FIR_FFT_SIZE / 2];
+	struct icomplex32 data[FIR_FFT_SIZE];
+	int64_t acc[2 * FIR_FFT_BINS]; /* Sum of spectra products */
+};
+
+struct fir_fft_state {
+	struct fir_fft_work *work;
+	int partitions; /* Number of partitions, zero for delay only */
+	int out_shift; /* Amount of right shifts at output */
+	int h_shift; /* Exponent of coefficients spectra */
+	int pos; /* Position in input and output blocks */
+	int newest; /* Newest spectrum in input spectra */
+	struct icomplex32 *h; /* Coefficients spectra of partitions */
+	struct icomplex32 *fdl; /* Input spectra of previous blocks */
+	int32_t *fdl_shift; /* Exponents of input spectra */
+	int32_t *in; /* Previous and current input blocks */
+	int32_t *out; /* Output block */
+};
+
+int fir_fft_delay_size(struct fir_state_32x16 *fir);
+
+void fir_fft_init_work(struct fir_fft_work *work);
+
+void fir_fft_init(struct fir_fft_state *fft, struct fir_state_32x16 *fir,
+		  struct fir_fft_work *work, int32_t **data);
+
+void fir_fft_block(struct fir_fft_state *fft);
+
+static inline int32_t fir_fft_32(struct fir_fft_state *fft, int32_t x)
+{
+	int32_t y = fft->out[fft->pos];
+
+	fft->in[FIR_FFT_BLOCK_LEN + fft->pos] = x;
+	if (++fft->pos == FIR_FFT_BLOCK_LEN) {
+		fir_fft_block(fft);
+		fft->pos = 0;
+	}
+
+	return y;
+}
+
+#endif
+#endif /* __SOF_AUDIO_EQ_FIR_FIR_FFT_H__ */
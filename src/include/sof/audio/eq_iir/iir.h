@@ -52,6 +52,9 @@ struct sof_eq_iir_header_df2t;
 
 #define IIR_DF2T_NUM_DELAYS 2
 
+/* Max. number of interleaved channels filtered in parallel lanes */
+#define IIR_DF2T_LANES_MAX 8
+
 struct iir_state_df2t {
 	unsigned int biquads; /* Number of IIR 2nd order sections total */
 	unsigned int biquads_in_series; /* Number of IIR 2nd order sections
@@ -63,6 +66,19 @@ struct iir_state_df2t {
 
 int32_t iir_df2t(struct iir_state_df2t *iir, int32_t x);
 
+/* Filters in place samples of one channel, stride is the distance of
+ * consecutive samples in x.
+ */
+void iir_df2t_block(struct iir_state_df2t *iir, int32_t *x, int stride,
+		    int samples);
+
+/* Filters in place interleaved frames, iir[] has a filter for every
+ * channel. Two, four and eight channels are filtered in parallel lanes
+ * when all the filters have the same number of biquads in series.
+ */
+void iir_df2t_block_interleaved(struct iir_state_df2t *iir, int channels,
+				int32_t *x, int frames);
+
 int iir_init_coef_df2t(struct iir_state_df2t *iir,
 		       struct sof_eq_iir_header_df2t *config);
 
@@ -43,12 +43,33 @@ struct mux_stream_data {
 	uint8_t reserved[(20 - PLATFORM_MAX_CHANNELS - 1) % 4]; // padding to ensure proper alignment of following instances
 };
 
+/** \brief Max number of input channels routed to output streams. */
+#define MUX_MAX_TAPS (MUX_MAX_STREAMS * PLATFORM_MAX_CHANNELS * \
+		      PLATFORM_MAX_CHANNELS)
+
+/** \brief Input channel contributing to an output channel. */
+struct mux_tap {
+	uint8_t stream;		/**< index of source stream */
+	uint8_t channel;	/**< channel in source stream */
+};
+
+/**
+ * \brief Routing of an output stream compiled from the bitmasks.
+ *
+ * Each output channel is the sum of its taps, so processing doesn't need
+ * to scan the bitmasks of all streams for every sample.
+ */
+struct mux_look_up {
+	uint8_t num_taps[PLATFORM_MAX_CHANNELS];
+	struct mux_tap *taps[PLATFORM_MAX_CHANNELS];
+};
+
 typedef void(*demux_func)(struct audio_stream *sink,
 			  const struct audio_stream *source, uint32_t frames,
-			  struct mux_stream_data *data);
+			  const struct mux_look_up *lookup);
 typedef void(*mux_func)(struct audio_stream *sink,
 			const struct audio_stream **sources, uint32_t frames,
-			struct mux_stream_data *data);
+			const struct mux_look_up *lookup);
 
 struct sof_mux_config {
 	uint16_t frame_format_deprecated;	/* deprecated in ABI 3.15 */
@@ -66,6 +87,10 @@ struct comp_data {
 		demux_func demux;
 	};
 
+	/* routing for sink stream of mux or each sink stream of demux */
+	struct mux_look_up lookup[MUX_MAX_STREAMS];
+	struct mux_tap taps[MUX_MAX_TAPS];
+
 	struct sof_mux_config config;
 };
 
@@ -84,16 +109,19 @@ demux_func demux_get_processing_function(struct comp_dev *dev);
 void sys_comp_mux_init(void);
 
 #if CONFIG_FORMAT_S16LE
-int32_t calc_sample_s16le(const struct audio_stream *source,
-			  uint32_t offset, uint8_t mask);
+int32_t calc_sample_s16le(const struct audio_stream **sources,
+			  const struct mux_tap *taps, uint8_t num_taps,
+			  uint32_t frame);
 #endif /* CONFIG_FORMAT_S16LE */
 #if CONFIG_FORMAT_S24LE
-int32_t calc_sample_s24le(const struct audio_stream *source,
-			  uint32_t offset, uint8_t mask);
+int32_t calc_sample_s24le(const struct audio_stream **sources,
+			  const struct mux_tap *taps, uint8_t num_taps,
+			  uint32_t frame);
 #endif /* CONFIG_FORMAT_S24LE */
 #if CONFIG_FORMAT_S32LE
-int64_t calc_sample_s32le(const struct audio_stream *source,
-			  uint32_t offset, uint8_t mask);
+int64_t calc_sample_s32le(const struct audio_stream **sources,
+			  const struct mux_tap *taps, uint8_t num_taps,
+			  uint32_t frame);
 #endif /* CONFIG_FORMAT_S32LE */
 #endif /* UNIT_TEST */
 
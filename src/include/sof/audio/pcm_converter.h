@@ -16,6 +16,7 @@
 
 #include <ipc/stream.h>
 #include <config.h>
+#include <stdbool.h>
 #include <stddef.h>
 #include <stdint.h>
 
@@ -66,10 +67,13 @@ struct pcm_func_map {
 extern const struct pcm_func_map pcm_func_map[];
 
 /** \brief Number of conversion functions. */
-extern const uint32_t pcm_func_count;
+extern const size_t pcm_func_count;
 
 /**
  * \brief Retrieves PCM conversion function.
+ *
+ * The map may have more than one function for a pair of formats, the first
+ * one is preferred.
  * \param[in] in Source frame format.
  * \param[in] out Sink frame format.
  */
@@ -105,4 +109,88 @@ void pcm_convert_as_linear(const struct audio_stream *source, uint32_t ioffset,
 			   struct audio_stream *sink, uint32_t ooffset,
 			   uint32_t samples, pcm_converter_lin_func converter);
 
+/**
+ * \brief Samples converted at a time by the format adapter. The blocks are
+ *	  an even number of frames, at least two, for processing functions
+ *	  that handle frames in pairs.
+ */
+#define PCM_ADAPTER_SAMPLES	256
+
+/**
+ * \brief Component processing function run by the format adapter
+ * \param ctx private context of the component
+ * \param source stream in processing format
+ * \param sink stream in processing format
+ * \param frames number of frames to process
+ */
+typedef void (*pcm_adapter_func)(void *ctx, const struct audio_stream *source,
+				 struct audio_stream *sink, uint32_t frames);
+
+/**
+ * \brief Format adapter, lets a component processing function read and
+ *	  write streams in formats other than its processing format.
+ *
+ * Source samples are converted to the processing format and processed
+ * samples to the sink format in small blocks kept in cache, instead of
+ * passing through an extra buffer and converter component.
+ */
+struct pcm_adapter {
+	pcm_converter_func convert_in;	/**< source to processing format */
+	pcm_converter_func convert_out;	/**< processing to sink format */
+	enum sof_ipc_frame process_fmt;	/**< processing frame format */
+	uint32_t frames;	/**< frames in a block */
+	void *in;	/**< converted source block */
+	void *out;	/**< processed block to convert */
+};
+
+/**
+ * \brief Checks if the format adapter supports the formats.
+ * \param[in] source Source frame format.
+ * \param[in] process Processing frame format.
+ * \param[in] sink Sink frame format.
+ */
+static inline bool pcm_adapter_supported(enum sof_ipc_frame source,
+					 enum sof_ipc_frame process,
+					 enum sof_ipc_frame sink)
+{
+	return (source == process ||
+		pcm_get_conversion_function(source, process)) &&
+	       (process == sink ||
+		pcm_get_conversion_function(process, sink));
+}
+
+/**
+ * \brief Sets up the format adapter, allocates blocks for conversions
+ * \param adapter format adapter
+ * \param source source frame format
+ * \param process processing frame format
+ * \param sink sink frame format
+ * \param channels number of channels in the streams
+ * \return error code
+ */
+int pcm_adapter_init(struct pcm_adapter *adapter, enum sof_ipc_frame source,
+		     enum sof_ipc_frame process, enum sof_ipc_frame sink,
+		     uint32_t channels);
+
+/**
+ * \brief Frees the format adapter blocks
+ * \param adapter format adapter
+ */
+void pcm_adapter_free(struct pcm_adapter *adapter);
+
+/**
+ * \brief Runs processing function between streams through format adapter,
+ *	  read and write pointers are not modified
+ * \param adapter format adapter
+ * \param source buffer with samples to process
+ * \param sink output buffer
+ * \param frames number of frames to process
+ * \param func processing function
+ * \param ctx processing function context
+ */
+void pcm_adapter_process(struct pcm_adapter *adapter,
+			 const struct audio_stream *source,
+			 struct audio_stream *sink, uint32_t frames,
+			 pcm_adapter_func func, void *ctx);
+
 #endif /* __SOF_AUDIO_PCM_CONVERTER_H__ */
@@ -23,6 +23,22 @@
 struct comp_buffer;
 struct comp_dev;
 
+/* Select optimized code variant when xt-xcc compiler is used on HiFi3 */
+#if defined __XCC__
+#include <xtensa/config/core-isa.h>
+#if XCHAL_HAVE_HIFI3 == 1
+#define SEL_HIFI3	1
+#define SEL_GENERIC	0
+#else
+#define SEL_HIFI3	0
+#define SEL_GENERIC	1
+#endif
+#else
+/* GCC */
+#define SEL_HIFI3	0
+#define SEL_GENERIC	1
+#endif
+
 /** \brief Supported channel count on input. */
 #define SEL_SOURCE_2CH 2
 #define SEL_SOURCE_4CH 4
@@ -54,8 +70,19 @@ struct comp_func_map {
 };
 
 /** \brief Map of formats with dedicated processing functions. */
-extern const struct comp_func_map func_map[];
+extern const struct comp_func_map func_table[];
 
+/**
+ * \brief Copies every stride:th sample, used for channel extraction.
+ * \param[out] dst Destination, linear.
+ * \param[in] src Source, linear for (samples - 1) * stride + 1 samples.
+ * \param[in] stride Distance of source samples.
+ * \param[in] samples Number of samples to copy.
+ */
+void sel_gather_s16(int16_t *dst, const int16_t *src, int stride,
+		    int samples);
+void sel_gather_s32(int32_t *dst, const int32_t *src, int stride,
+		    int samples);
 
 /**
  * \brief Retrieves selector processing function.
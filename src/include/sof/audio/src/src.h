@@ -11,6 +11,9 @@
 #include <stddef.h>
 #include <stdint.h>
 
+struct src_design;
+struct src_stage;
+
 struct src_param {
 	int fir_s1;
 	int fir_s2;
@@ -26,6 +29,10 @@ struct src_param {
 	int idx_in;
 	int idx_out;
 	int nch;
+	int fused; /* Stage 2 runs interleaved with stage 1 via small FIFO */
+	struct src_stage *stage1;
+	struct src_stage *stage2;
+	struct src_design *design; /* Set when stages are designed at runtime */
 };
 
 struct src_stage {
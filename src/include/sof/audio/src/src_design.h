@@ -0,0 +1,66 @@
+/* SPDX-License-Identifier: BSD-3-Clause
+ *
+ * Copyright(c) 2020 Intel Corporation. All rights reserved.
+ */
+
+#ifndef __SOF_AUDIO_SRC_SRC_DESIGN_H__
+#define __SOF_AUDIO_SRC_SRC_DESIGN_H__
+
+#include <sof/audio/src/src.h>
+#include <stdint.h>
+
+/* Runtime design of the two polyphase stages for conversions that are
+ * missing from the compiled-in coefficient tables. The filters follow
+ * the rules of the tools/tune/src design scripts: Kaiser windowed sinc
+ * with 70 dB stop-band, stop-band starting at Nyquist frequency of the
+ * lower rate and a passband of 20 kHz at 44.1 kHz scaled with quality.
+ */
+
+/* Passband width in percent of the default 20 kHz at 44.1 kHz */
+#define SRC_DESIGN_QUALITY_DEFAULT	100
+
+/* Number of designed conversions kept for reuse */
+#define SRC_DESIGN_CACHE_SIZE		4
+
+/* Largest interpolation or decimation factor allowed for a stage */
+#define SRC_DESIGN_MAX_LM		32
+
+/* Per channel delay line limits for designed stages */
+#define SRC_DESIGN_MAX_FIR_DELAY_SIZE	1024
+#define SRC_DESIGN_MAX_OUT_DELAY_SIZE	1024
+
+struct src_design {
+	int fs_in;
+	int fs_out;
+	int quality;
+	int refs;		/* Number of users, entry can't be evicted */
+	uint32_t age;		/* Least recently used entry is evicted */
+	struct src_stage stage1;
+	struct src_stage stage2;
+	void *coefs;		/* Both stages coefficients */
+};
+
+/**
+ * \brief Initializes the design cache, called once at driver init.
+ */
+void src_design_init(void);
+
+/**
+ * \brief Returns designed stages for a conversion. The designs are cached
+ *	  and shared by all users of the same conversion.
+ * \param[out] design Cached design, a reference is held by caller.
+ * \param[in] fs_in Input sample rate in Hz.
+ * \param[in] fs_out Output sample rate in Hz.
+ * \param[in] quality Passband width in percent of the default.
+ * \return Error code, zero for success.
+ */
+int src_design_get(struct src_design **design, int fs_in, int fs_out,
+		   int quality);
+
+/**
+ * \brief Releases a reference to a design from src_design_get().
+ * \param[in] design Design to release, can be NULL.
+ */
+void src_design_put(struct src_design *design);
+
+#endif /* __SOF_AUDIO_SRC_SRC_DESIGN_H__ */
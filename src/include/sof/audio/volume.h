@@ -17,6 +17,7 @@
 #define __SOF_AUDIO_VOLUME_H__
 
 #include <sof/audio/component.h>
+#include <sof/audio/pcm_converter.h>
 #include <sof/bit.h>
 #include <sof/common.h>
 #include <sof/trace/trace.h>
@@ -69,12 +70,24 @@ struct sof_ipc_ctrl_value_chan;
  */
 #define VOL_MAX		((1 << (VOL_QXY_X + VOL_QXY_Y - 1)) - 1)
 
+/**
+ * \brief Additional fractional bits of per frame interpolated ramp gain.
+ * The interpolated gain is Q8.24, that fits int32_t with VOL_MAX.
+ */
+#define VOL_RAMP_FRAC_BITS	8
+
 /** \brief Volume 0dB value. */
 #define VOL_ZERO_DB	BIT(VOL_QXY_Y)
 
 /** \brief Volume minimum value. */
 #define VOL_MIN		0
 
+/**
+ * \brief Maximum length of gain vector expanded to channels interleave.
+ * The used length is the largest multiple of channels count that fits.
+ */
+#define VOL_GAIN_PATTERN_MAX	64
+
 /**
  * \brief volume processing function interface
  */
@@ -99,6 +112,12 @@ struct comp_data {
 	int32_t tvolume[SOF_IPC_MAX_CHANNELS];	/**< target volume */
 	int32_t mvolume[SOF_IPC_MAX_CHANNELS];	/**< mute volume */
 	int32_t ramp_increment[SOF_IPC_MAX_CHANNELS]; /**< for linear ramp */
+	int32_t ramp_gain[SOF_IPC_MAX_CHANNELS]; /**< interpolated, Q8.24 */
+	int32_t ramp_frame_inc[SOF_IPC_MAX_CHANNELS]; /**< per frame, Q8.24 */
+#ifdef CONFIG_GENERIC
+	/**< current volume repeated in samples interleave order */
+	int32_t gain_pattern[VOL_GAIN_PATTERN_MAX];
+#endif
 	int32_t vol_min;			/**< minimum volume */
 	int32_t vol_max;			/**< maximum volume */
 	int32_t	vol_ramp_range;			/**< max ramp transition */
@@ -109,13 +128,17 @@ struct comp_data {
 	bool vol_ramp_active;			/**< set if volume is ramped */
 	bool ramp_finished;			/**< control ramp launch */
 	vol_scale_func scale_vol;	/**< volume processing function */
+	/**< processing function with per frame ramp, NULL if not used */
+	vol_scale_func scale_vol_ramp;
 	vol_zc_func zc_get; /**< function getting nearest zero crossing frame */
+	struct pcm_adapter adapter; /**< source and sink format adapter */
 };
 
 /** \brief Volume processing functions map. */
 struct comp_func_map {
 	uint16_t frame_fmt;	/**< frame format */
 	vol_scale_func func;	/**< volume processing function */
+	vol_scale_func ramp_func; /**< processing with per frame gain ramp */
 };
 
 /** \brief Map of formats with dedicated processing functions. */
@@ -131,30 +154,85 @@ struct comp_zc_func_map {
 };
 
 /**
- * \brief Retrievies volume processing function.
+ * \brief Retrieves volume processing functions for a frame format.
+ * \param[in] frame_fmt Frame format.
+ * \return Processing functions map item or NULL if format is not supported.
+ */
+static inline const struct comp_func_map *
+vol_find_func_map(enum sof_ipc_frame frame_fmt)
+{
+	int i;
+
+	for (i = 0; i < func_count; i++) {
+		if (frame_fmt == func_map[i].frame_fmt)
+			return &func_map[i];
+	}
+
+	return NULL;
+}
+
+/**
+ * \brief Retrieves the frame format for processing, the source format is
+ *	  preferred to keep its precision. Other formats are handled by the
+ *	  format adapter.
+ * \param[in] src_fmt Frame format of the source buffer.
+ * \param[in] sink_fmt Frame format of the sink buffer.
+ */
+static inline enum sof_ipc_frame
+vol_process_format(enum sof_ipc_frame src_fmt, enum sof_ipc_frame sink_fmt)
+{
+	return vol_find_func_map(src_fmt) ? src_fmt : sink_fmt;
+}
+
+/**
+ * \brief Retrieves the frame format for processing of the component.
  * \param[in,out] dev Volume base component device.
  */
-static inline vol_scale_func vol_get_processing_function(struct comp_dev *dev)
+static inline enum sof_ipc_frame vol_get_process_format(struct comp_dev *dev)
 {
+	struct comp_buffer *sourceb;
 	struct comp_buffer *sinkb;
-	int i;
 
+	sourceb = list_first_item(&dev->bsource_list, struct comp_buffer,
+				  sink_list);
 	sinkb = list_first_item(&dev->bsink_list, struct comp_buffer,
 				source_list);
 
-	/* map the volume function for source and sink buffers */
-	for (i = 0; i < func_count; i++) {
-		if (sinkb->stream.frame_fmt != func_map[i].frame_fmt)
-			continue;
+	return vol_process_format(sourceb->stream.frame_fmt,
+				  sinkb->stream.frame_fmt);
+}
 
-		return func_map[i].func;
-	}
+/**
+ * \brief Retrievies volume processing function.
+ * \param[in,out] dev Volume base component device.
+ */
+static inline vol_scale_func vol_get_processing_function(struct comp_dev *dev)
+{
+	const struct comp_func_map *map;
 
-	return NULL;
+	map = vol_find_func_map(vol_get_process_format(dev));
+
+	return map ? map->func : NULL;
+}
+
+/**
+ * \brief Retrieves volume processing function with per frame gain ramp.
+ * \param[in,out] dev Volume base component device.
+ * \return Processing function or NULL if not available for the format.
+ */
+static inline vol_scale_func vol_get_ramp_function(struct comp_dev *dev)
+{
+	const struct comp_func_map *map;
+
+	map = vol_find_func_map(vol_get_process_format(dev));
+
+	return map ? map->ramp_func : NULL;
 }
 
 #ifdef UNIT_TEST
 void sys_comp_volume_init(void);
+void volume_ramp_frames_init(struct comp_dev *dev);
+void volume_ramp_frames_update(struct comp_dev *dev);
 #endif
 
 #endif /* __SOF_AUDIO_VOLUME_H__ */
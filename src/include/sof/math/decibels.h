@@ -11,6 +11,22 @@
 
 #include <stdint.h>
 
+/* Select optimized code variant when xt-xcc compiler is used on HiFi3 */
+#if defined __XCC__
+#include <xtensa/config/core-isa.h>
+#if XCHAL_HAVE_HIFI3 == 1
+#define DECIBELS_HIFI3		1
+#define DECIBELS_GENERIC	0
+#else
+#define DECIBELS_HIFI3		0
+#define DECIBELS_GENERIC	1
+#endif
+#else
+/* GCC */
+#define DECIBELS_HIFI3		0
+#define DECIBELS_GENERIC	1
+#endif
+
 #define EXP_FIXED_INPUT_QY 27
 #define EXP_FIXED_OUTPUT_QY 20
 #define DB2LIN_FIXED_INPUT_QY 24
@@ -19,4 +35,31 @@
 int32_t exp_fixed(int32_t x); /* Input is Q5.27, output is Q12.20 */
 int32_t db2lin_fixed(int32_t x); /* Input is Q8.24, output is Q12.20 */
 
+/* The array versions compute 2^t with t = x * log2(e) or t = db * log2(10) / 20
+ * as Q6.26. The input is clamped so that t stays within -17.0 .. +12.0, the
+ * output is zero below the range of the scalar functions and saturates above.
+ */
+#define LOG2E_Q2_30		1549082005	/* log2(e) */
+#define LOG2_10_DIV20_Q33	1426757253	/* log2(10) / 20 */
+#define EXP_V_MIN_Q5_27		-1543503872	/* -11.5 */
+#define EXP_V_MAX_Q5_27		1073741824	/* 8.0 */
+#define DB2LIN_V_MIN_Q8_24	-1677721600	/* -100.0 dB */
+#define DB2LIN_V_MAX_Q8_24	1207959552	/* 72.0 dB */
+
+/* Minimax polynomial 2^f = c0 + c1 * f + ... + c5 * f^5 for f in 0.0 .. 1.0,
+ * the coefficients are Q2.30
+ */
+#define EXP2_V_C0_Q2_30		1073741712	/* 0.9999998958 */
+#define EXP2_V_C1_Q2_30		744269106	/* 0.6931546203 */
+#define EXP2_V_C2_Q2_30		257849186	/* 0.2401407680 */
+#define EXP2_V_C3_Q2_30		59982749	/* 0.0558632884 */
+#define EXP2_V_C4_Q2_30		9605918		/* 0.0089462083 */
+#define EXP2_V_C5_Q2_30		2034859		/* 0.0018951098 */
+
+/* Array versions of the above, they compute 2^t with a polynomial and differ
+ * from the scalar functions by less than 0.1 dB in the supported range.
+ */
+void exp_fixed_v(const int32_t *x, int32_t *y, int n);
+void db2lin_fixed_v(const int32_t *db, int32_t *lin, int n);
+
 #endif /* __SOF_MATH_DECIBELS_H__ */
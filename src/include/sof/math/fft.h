@@ -0,0 +1,41 @@
+/* SPDX-License-Identifier: BSD-3-Clause
+ *
+ * Copyright(c) 2020 Intel Corporation. All rights reserved.
+ */
+
+#ifndef __SOF_MATH_FFT_H__
+#define __SOF_MATH_FFT_H__
+
+#include <stdbool.h>
+#include <stdint.h>
+
+#define FFT_SIZE_MIN	2
+#define FFT_SIZE_MAX	4096
+
+/* Complex number with Q1.31 real and imaginary parts */
+struct icomplex32 {
+	int32_t real;
+	int32_t imag;
+};
+
+struct fft_plan {
+	int size; /* FFT length, power of two */
+	int len; /* log2 of FFT length */
+	struct icomplex32 *twiddle; /* size / 2 factors exp(-j*2*pi*k/size) */
+};
+
+/* Returns size in bytes of twiddle factors for FFT length */
+int fft_twiddle_size(int size);
+
+void fft_plan_init(struct fft_plan *plan, int size,
+		   struct icomplex32 *twiddle);
+
+/* In-place radix-2 FFT or IFFT of size complex samples. The stages are
+ * scaled down by block floating point when needed to avoid overflow. The
+ * return value is the total number of right shifts done, i.e. the DFT
+ * (without 1/N for IFFT) of data is the result multiplied by 2^shift.
+ */
+int fft_execute_32(const struct fft_plan *plan, struct icomplex32 *data,
+		   bool ifft);
+
+#endif /* __SOF_MATH_FFT_H__ */
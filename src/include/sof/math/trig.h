@@ -12,10 +12,41 @@
 
 #include <stdint.h>
 
+/* Select optimized code variant when xt-xcc compiler is used on HiFi3 */
+#if defined __XCC__
+#include <xtensa/config/core-isa.h>
+#if XCHAL_HAVE_HIFI3 == 1
+#define TRIG_HIFI3	1
+#define TRIG_GENERIC	0
+#else
+#define TRIG_HIFI3	0
+#define TRIG_GENERIC	1
+#endif
+#else
+/* GCC */
+#define TRIG_HIFI3	0
+#define TRIG_GENERIC	1
+#endif
+
 #define PI_DIV2_Q4_28 421657428
 #define PI_Q4_28      843314857
 #define PI_MUL2_Q4_28     1686629713
+#define TWO_DIV_PI_Q1_31  1367130551
+
+/* Minimax polynomial sin(pi/2 * x) = x * (c1 + c3 * x^2 + ... + c9 * x^8)
+ * for x in -1.0 .. +1.0 as used by sin_fixed_v(), the coefficients are Q2.30
+ */
+#define SINE_V_C1_Q2_30	1686629681	/*  1.5707962973 */
+#define SINE_V_C3_Q2_30	-693597962	/* -0.6459634394 */
+#define SINE_V_C5_Q2_30	85565131	/*  0.0796887378 */
+#define SINE_V_C7_Q2_30	-5017110	/* -0.0046725479 */
+#define SINE_V_C9_Q2_30	162088		/*  0.0001509560 */
 
 int32_t sin_fixed(int32_t w); /* Input is Q4.28, output is Q1.31 */
 
+/* Array version of sin_fixed(), any Q4.28 angle is allowed. The result is
+ * computed with a polynomial and differs from sin_fixed() by few LSB.
+ */
+void sin_fixed_v(const int32_t *w, int32_t *sine, int n);
+
 #endif /* __SOF_MATH_TRIG_H__ */
@@ -78,7 +78,7 @@ struct tr_ctx;
 
 #if CONFIG_LIBRARY
 
-extern int test_bench_trace;
+extern __thread int test_bench_trace;
 char *get_trace_class(uint32_t trace_class);
 #define _log_message(atomic, level, comp_class, ctx, id_1, id_2,	\
 		     format, ...)					\
@@ -6,6 +6,7 @@
 
 #include <sof/audio/format.h>
 #include <sof/math/decibels.h>
+#include <sof/math/numbers.h>
 #include <stdint.h>
 
 #define ONE_Q20         Q_CONVERT_FLOAT(1.0, 20)	  /* Use Q12.20 */
@@ -115,3 +116,62 @@ int32_t exp_fixed(int32_t x)
 
 	return y;
 }
+
+#if DECIBELS_GENERIC
+
+static inline int32_t exp2_v_mult_q30(int32_t x, int32_t y)
+{
+	return q_multsr_32x32(x, y, Q_SHIFT_BITS_64(30, 30, 30));
+}
+
+/* Power of two for the array versions. The Q6.26 argument is split to
+ * integer n and fraction f. The 2^f is a polynomial and 2^n a shift. There
+ * are no branches, so the loops that use it can be vectorized.
+ *
+ * Input is Q6.26, -17.0 .. +12.0
+ * Output is Q12.20, saturated to 2048.0
+ */
+static inline int32_t exp2_v(int32_t t)
+{
+	int32_t n = t >> 26;
+	int32_t f = (t & ((1 << 26) - 1)) << 4; /* Q2.30 */
+	int32_t p;
+
+	p = exp2_v_mult_q30(EXP2_V_C5_Q2_30, f) + EXP2_V_C4_Q2_30;
+	p = exp2_v_mult_q30(p, f) + EXP2_V_C3_Q2_30;
+	p = exp2_v_mult_q30(p, f) + EXP2_V_C2_Q2_30;
+	p = exp2_v_mult_q30(p, f) + EXP2_V_C1_Q2_30;
+	p = exp2_v_mult_q30(p, f) + EXP2_V_C0_Q2_30;
+
+	/* Q2.30 x 2^(n + 17) -> Q12.20 x 2^n */
+	return sat_int32((((int64_t)p << (n + 17)) + (1 << 26)) >> 27);
+}
+
+void exp_fixed_v(const int32_t *x, int32_t *y, int n)
+{
+	int32_t t;
+	int i;
+
+	for (i = 0; i < n; i++) {
+		/* Q5.27 x Q2.30 -> Q6.26 */
+		t = MIN(MAX(x[i], EXP_V_MIN_Q5_27), EXP_V_MAX_Q5_27);
+		t = q_multsr_32x32(t, LOG2E_Q2_30, Q_SHIFT_BITS_64(27, 30, 26));
+		y[i] = exp2_v(t) & -(int32_t)(x[i] >= EXP_V_MIN_Q5_27);
+	}
+}
+
+void db2lin_fixed_v(const int32_t *db, int32_t *lin, int n)
+{
+	int32_t t;
+	int i;
+
+	for (i = 0; i < n; i++) {
+		/* Q8.24 x Q-2.33 -> Q6.26 */
+		t = MIN(MAX(db[i], DB2LIN_V_MIN_Q8_24), DB2LIN_V_MAX_Q8_24);
+		t = q_multsr_32x32(t, LOG2_10_DIV20_Q33,
+				   Q_SHIFT_BITS_64(24, 33, 26));
+		lin[i] = exp2_v(t) & -(int32_t)(db[i] >= DB2LIN_V_MIN_Q8_24);
+	}
+}
+
+#endif /* DECIBELS_GENERIC */
@@ -0,0 +1,126 @@
+// SPDX-License-Identifier: BSD-3-Clause
+//
+// Copyright(c) 2020 Intel Corporation. All rights reserved.
+
+#include <sof/math/decibels.h>
+#include <stdint.h>
+
+#if DECIBELS_HIFI3
+
+#include <xtensa/tie/xt_hifi3.h>
+
+/* Q2.30 x Q2.30 -> Q2.30 for both lanes */
+static inline ae_int32x2 exp2_v_mult_q30(ae_int32x2 x, ae_int32x2 y)
+{
+	ae_int64 h = AE_SLAI64S(AE_MUL32_HH(x, y), 2);
+	ae_int64 l = AE_SLAI64S(AE_MUL32_LL(x, y), 2);
+
+	return AE_ROUND32X2F64SASYM(h, l);
+}
+
+/* Power of two for two Q6.26 arguments as Q12.20, the same algorithm as
+ * the generic version in decibels.c. The shifts by 2^n differ per lane so
+ * they are done as multiplications.
+ */
+static inline ae_int32x2 exp2_v_hifi3(ae_int32x2 t)
+{
+	ae_int32x2 n = AE_SRAI32(t, 26);
+	ae_int32x2 f;
+	ae_int32x2 p;
+	ae_int32x2 scale;
+	ae_int64 h;
+	ae_int64 l;
+
+	/* Fraction as Q2.30 */
+	f = AE_SLAI32(AE_SUB32(t, AE_SLAI32(n, 26)), 4);
+
+	p = AE_ADD32S(exp2_v_mult_q30(AE_MOVDA32(EXP2_V_C5_Q2_30), f),
+		      AE_MOVDA32(EXP2_V_C4_Q2_30));
+	p = AE_ADD32S(exp2_v_mult_q30(p, f), AE_MOVDA32(EXP2_V_C3_Q2_30));
+	p = AE_ADD32S(exp2_v_mult_q30(p, f), AE_MOVDA32(EXP2_V_C2_Q2_30));
+	p = AE_ADD32S(exp2_v_mult_q30(p, f), AE_MOVDA32(EXP2_V_C1_Q2_30));
+	p = AE_ADD32S(exp2_v_mult_q30(p, f), AE_MOVDA32(EXP2_V_C0_Q2_30));
+
+	/* Q2.30 x 2^(n + 17) -> Q12.20 x 2^n, to Q1.63 and round to Q1.31 */
+	scale = AE_MOVDA32X2(1 << (AE_MOVAD32_H(n) + 17),
+			     1 << (AE_MOVAD32_L(n) + 17));
+	h = AE_SLAI64S(AE_MUL32_HH(p, scale), 5);
+	l = AE_SLAI64S(AE_MUL32_LL(p, scale), 5);
+	return AE_ROUND32X2F64SASYM(h, l);
+}
+
+/* Q5.27 x Q2.30 -> Q6.26, zero below the range as exp_fixed() */
+static inline ae_int32x2 exp_v_hifi3(ae_int32x2 x)
+{
+	ae_int32x2 t;
+	ae_int32x2 y;
+	xtbool2 low;
+
+	t = AE_MAX32(x, AE_MOVDA32(EXP_V_MIN_Q5_27));
+	t = AE_MIN32(t, AE_MOVDA32(EXP_V_MAX_Q5_27));
+	t = AE_MULFP32X2RAS(t, AE_MOVDA32(LOG2E_Q2_30));
+	y = exp2_v_hifi3(t);
+	low = AE_LT32(x, AE_MOVDA32(EXP_V_MIN_Q5_27));
+	AE_MOVT32X2(y, AE_ZERO32(), low);
+	return y;
+}
+
+/* Q8.24 x Q-2.33 -> Q6.26, zero below the range as db2lin_fixed() */
+static inline ae_int32x2 db2lin_v_hifi3(ae_int32x2 db)
+{
+	ae_int32x2 t;
+	ae_int32x2 y;
+	xtbool2 low;
+
+	t = AE_MAX32(db, AE_MOVDA32(DB2LIN_V_MIN_Q8_24));
+	t = AE_MIN32(t, AE_MOVDA32(DB2LIN_V_MAX_Q8_24));
+	t = AE_MULFP32X2RAS(t, AE_MOVDA32(LOG2_10_DIV20_Q33));
+	y = exp2_v_hifi3(t);
+	low = AE_LT32(db, AE_MOVDA32(DB2LIN_V_MIN_Q8_24));
+	AE_MOVT32X2(y, AE_ZERO32(), low);
+	return y;
+}
+
+void exp_fixed_v(const int32_t *x, int32_t *y, int n)
+{
+	const ae_int32x2 *in = (const ae_int32x2 *)x;
+	ae_int32x2 *out = (ae_int32x2 *)y;
+	ae_valign inu = AE_LA64_PP(in);
+	ae_valign outu = AE_ZALIGN64();
+	ae_int32x2 v;
+	int i;
+
+	for (i = 0; i < n - 1; i += 2) {
+		AE_LA32X2_IP(v, inu, in);
+		AE_SA32X2_IP(exp_v_hifi3(v), outu, out);
+	}
+
+	AE_SA64POS_FP(outu, out);
+
+	/* Last value of an odd count */
+	if (i < n)
+		y[i] = AE_MOVAD32_H(exp_v_hifi3(AE_MOVDA32(x[i])));
+}
+
+void db2lin_fixed_v(const int32_t *db, int32_t *lin, int n)
+{
+	const ae_int32x2 *in = (const ae_int32x2 *)db;
+	ae_int32x2 *out = (ae_int32x2 *)lin;
+	ae_valign inu = AE_LA64_PP(in);
+	ae_valign outu = AE_ZALIGN64();
+	ae_int32x2 v;
+	int i;
+
+	for (i = 0; i < n - 1; i += 2) {
+		AE_LA32X2_IP(v, inu, in);
+		AE_SA32X2_IP(db2lin_v_hifi3(v), outu, out);
+	}
+
+	AE_SA64POS_FP(outu, out);
+
+	/* Last value of an odd count */
+	if (i < n)
+		lin[i] = AE_MOVAD32_H(db2lin_v_hifi3(AE_MOVDA32(db[i])));
+}
+
+#endif /* DECIBELS_HIFI3 */
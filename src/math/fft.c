@@ -0,0 +1,156 @@
+// SPDX-License-Identifier: BSD-3-Clause
+//
+// Copyright(c) 2020 Intel Corporation. All rights reserved.
+
+#include <sof/audio/format.h>
+#include <sof/math/fft.h>
+#include <sof/math/trig.h>
+#include <errno.h>
+#include <stdbool.h>
+#include <stdint.h>
+
+int fft_twiddle_size(int size)
+{
+	if (size < FFT_SIZE_MIN || size > FFT_SIZE_MAX || (size & (size - 1)))
+		return -EINVAL;
+
+	return size / 2 * sizeof(struct icomplex32);
+}
+
+void fft_plan_init(struct fft_plan *plan, int size,
+		   struct icomplex32 *twiddle)
+{
+	int32_t w;
+	int k;
+
+	plan->size = size;
+	plan->len = 0;
+	while ((1 << plan->len) < size)
+		plan->len++;
+
+	/* exp(-j*w) = cos(w) - j*sin(w) where cos(w) = sin(w + pi/2), the
+	 * angle w = 2*pi*k/size is Q4.28.
+	 */
+	plan->twiddle = twiddle;
+	for (k = 0; k < size / 2; k++) {
+		w = (int32_t)(((int64_t)PI_MUL2_Q4_28 * k) / size);
+		twiddle[k].real = sin_fixed(w + PI_DIV2_Q4_28);
+		twiddle[k].imag = -sin_fixed(w);
+	}
+}
+
+static void fft_bit_reverse(struct icomplex32 *data, int size)
+{
+	struct icomplex32 tmp;
+	int i;
+	int j = 0;
+	int m;
+
+	for (i = 0; i < size - 1; i++) {
+		if (i < j) {
+			tmp = data[i];
+			data[i] = data[j];
+			data[j] = tmp;
+		}
+
+		/* Increment j in bit reversed order */
+		m = size >> 1;
+		while (j & m) {
+			j ^= m;
+			m >>= 1;
+		}
+		j |= m;
+	}
+}
+
+/* Returns right shifts needed before next stage. The radix-2 butterfly
+ * can grow the magnitude of real or imaginary part by 1 + sqrt(2) so
+ * values up to 2^29 are processed without scaling, up to 2^30 with one
+ * shift and larger with two shifts.
+ */
+static int fft_stage_shift(const struct icomplex32 *data, int size)
+{
+	int32_t m = 0;
+	int i;
+
+	/* Bitwise or of magnitudes has the same most significant bit as
+	 * the maximum magnitude.
+	 */
+	for (i = 0; i < size; i++) {
+		m |= data[i].real ^ (data[i].real >> 31);
+		m |= data[i].imag ^ (data[i].imag >> 31);
+	}
+
+	if (m >= 1 << 30)
+		return 2;
+
+	if (m >= 1 << 29)
+		return 1;
+
+	return 0;
+}
+
+int fft_execute_32(const struct fft_plan *plan, struct icomplex32 *data,
+		   bool ifft)
+{
+	struct icomplex32 *a;
+	struct icomplex32 *b;
+	struct icomplex32 w;
+	int64_t tr;
+	int64_t ti;
+	int64_t rnd;
+	int32_t ar;
+	int32_t ai;
+	int size = plan->size;
+	int total = 0;
+	int shift;
+	int half;
+	int step;
+	int i;
+	int j;
+	int k;
+
+	fft_bit_reverse(data, size);
+
+	for (i = 0; i < plan->len; i++) {
+		half = 1 << i;
+		step = size >> (i + 1); /* Twiddle index step */
+		shift = fft_stage_shift(data, size);
+		rnd = shift ? 1 << (shift - 1) : 0;
+		total += shift;
+
+		for (k = 0; k < size; k += 2 * half) {
+			for (j = 0; j < half; j++) {
+				a = &data[k + j];
+				b = &data[k + j + half];
+
+				/* The first twiddle factor is one */
+				if (!j) {
+					tr = b->real;
+					ti = b->imag;
+				} else {
+					w = plan->twiddle[j * step];
+					if (ifft)
+						w.imag = -w.imag;
+
+					/* Q1.31 x Q1.31 -> Q2.62 -> Q1.31 */
+					tr = (int64_t)b->real * w.real -
+						(int64_t)b->imag * w.imag;
+					ti = (int64_t)b->real * w.imag +
+						(int64_t)b->imag * w.real;
+					tr = Q_SHIFT_RND(tr, 62, 31);
+					ti = Q_SHIFT_RND(ti, 62, 31);
+				}
+
+				ar = a->real;
+				ai = a->imag;
+				a->real = (ar + tr + rnd) >> shift;
+				a->imag = (ai + ti + rnd) >> shift;
+				b->real = (ar - tr + rnd) >> shift;
+				b->imag = (ai - ti + rnd) >> shift;
+			}
+		}
+	}
+
+	return total;
+}
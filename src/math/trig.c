@@ -574,3 +574,49 @@ int32_t sin_fixed(int32_t w)
 
 	return (int32_t)sine;
 }
+
+#if TRIG_GENERIC
+
+static inline int32_t sin_v_mult_q30(int32_t x, int32_t y)
+{
+	return q_multsr_32x32(x, y, Q_SHIFT_BITS_64(30, 30, 30));
+}
+
+/* Compute sine for an array of angles. The angle is converted to quarter
+ * turns in Q2.30 that wraps at full turn and folded to -1 .. +1 quarter
+ * turns where the odd polynomial is evaluated. There are no branches or
+ * table lookups, so the loop can be vectorized.
+ */
+void sin_fixed_v(const int32_t *w, int32_t *sine, int n)
+{
+	uint32_t phase;
+	uint32_t sign;
+	int32_t x;
+	int32_t x2;
+	int32_t p;
+	int i;
+
+	for (i = 0; i < n; i++) {
+		/* Q4.28 x Q1.31 -> Q4.28 quarter turns, to Q2.30 with wrap */
+		phase = (uint32_t)q_multsr_32x32(w[i], TWO_DIV_PI_Q1_31,
+						 Q_SHIFT_BITS_64(28, 31, 28));
+		phase <<= 2;
+
+		/* Fold with sin(x) = sin(2 - x) to -1 .. +1 quarter turns */
+		phase += 1 << 30;
+		sign = -(phase >> 31);
+		x = (int32_t)(((phase ^ sign) - sign) - (1 << 30));
+
+		x2 = sin_v_mult_q30(x, x);
+		p = sin_v_mult_q30(SINE_V_C9_Q2_30, x2) + SINE_V_C7_Q2_30;
+		p = sin_v_mult_q30(p, x2) + SINE_V_C5_Q2_30;
+		p = sin_v_mult_q30(p, x2) + SINE_V_C3_Q2_30;
+		p = sin_v_mult_q30(p, x2) + SINE_V_C1_Q2_30;
+
+		/* Q2.30 x Q2.30 -> Q1.31 */
+		sine[i] = sat_int32(Q_MULTSR_32X32((int64_t)x, p,
+						   30, 30, 31));
+	}
+}
+
+#endif /* TRIG_GENERIC */
@@ -0,0 +1,74 @@
+// SPDX-License-Identifier: BSD-3-Clause
+//
+// Copyright(c) 2020 Intel Corporation. All rights reserved.
+
+#include <sof/math/trig.h>
+#include <stdint.h>
+
+#if TRIG_HIFI3
+
+#include <xtensa/tie/xt_hifi3.h>
+
+/* Q2.30 x Q2.30 -> Q2.30 for both lanes */
+static inline ae_int32x2 sin_v_mult_q30(ae_int32x2 x, ae_int32x2 y)
+{
+	ae_int64 h = AE_SLAI64S(AE_MUL32_HH(x, y), 2);
+	ae_int64 l = AE_SLAI64S(AE_MUL32_LL(x, y), 2);
+
+	return AE_ROUND32X2F64SASYM(h, l);
+}
+
+/* Sine of two Q4.28 angles as Q1.31, the same algorithm as the generic
+ * version in trig.c.
+ */
+static inline ae_int32x2 sin_v_hifi3(ae_int32x2 w)
+{
+	ae_int32x2 quarter = AE_MOVDA32(1 << 30);
+	ae_int32x2 x;
+	ae_int32x2 x2;
+	ae_int32x2 p;
+	ae_int64 h;
+	ae_int64 l;
+
+	/* Q4.28 x Q1.31 -> Q4.28 quarter turns, to Q2.30 with wrap */
+	x = AE_MULFP32X2RAS(w, AE_MOVDA32(TWO_DIV_PI_Q1_31));
+	x = AE_SLAI32(x, 2);
+
+	/* Fold with sin(x) = sin(2 - x) to -1 .. +1 quarter turns */
+	x = AE_SUB32(AE_ABS32S(AE_ADD32(x, quarter)), quarter);
+
+	x2 = sin_v_mult_q30(x, x);
+	p = AE_ADD32S(sin_v_mult_q30(AE_MOVDA32(SINE_V_C9_Q2_30), x2),
+		      AE_MOVDA32(SINE_V_C7_Q2_30));
+	p = AE_ADD32S(sin_v_mult_q30(p, x2), AE_MOVDA32(SINE_V_C5_Q2_30));
+	p = AE_ADD32S(sin_v_mult_q30(p, x2), AE_MOVDA32(SINE_V_C3_Q2_30));
+	p = AE_ADD32S(sin_v_mult_q30(p, x2), AE_MOVDA32(SINE_V_C1_Q2_30));
+
+	/* Q2.30 x Q2.30 -> Q4.60, to Q1.63 and round to Q1.31 */
+	h = AE_SLAI64S(AE_MUL32_HH(x, p), 3);
+	l = AE_SLAI64S(AE_MUL32_LL(x, p), 3);
+	return AE_ROUND32X2F64SASYM(h, l);
+}
+
+void sin_fixed_v(const int32_t *w, int32_t *sine, int n)
+{
+	const ae_int32x2 *in = (const ae_int32x2 *)w;
+	ae_int32x2 *out = (ae_int32x2 *)sine;
+	ae_valign inu = AE_LA64_PP(in);
+	ae_valign outu = AE_ZALIGN64();
+	ae_int32x2 x;
+	int i;
+
+	for (i = 0; i < n - 1; i += 2) {
+		AE_LA32X2_IP(x, inu, in);
+		AE_SA32X2_IP(sin_v_hifi3(x), outu, out);
+	}
+
+	AE_SA64POS_FP(outu, out);
+
+	/* Last angle of an odd count */
+	if (i < n)
+		sine[i] = AE_MOVAD32_H(sin_v_hifi3(AE_MOVDA32(w[i])));
+}
+
+#endif /* TRIG_HIFI3 */
@@ -0,0 +1,291 @@
+// SPDX-License-Identifier: BSD-3-Clause
+//
+// Copyright(c) 2020 Intel Corporation. All rights reserved.
+
+#include <sof/audio/asrc/asrc_farrow.h>
+#include <sof/audio/format.h>
+#include <sof/common.h>
+
+#include <stdarg.h>
+#include <stddef.h>
+#include <setjmp.h>
+#include <stdint.h>
+#include <stdlib.h>
+#include <string.h>
+#include <cmocka.h>
+
+#define TEST_CHANNELS	2
+#define TEST_CYCLES	12
+
+/* Time value of one input or output frame in Q5.27 as in asrc_farrow.c */
+#define TEST_TIME_VALUE_ONE	Q_CONVERT_FLOAT(1, 27)
+
+struct test_config {
+	int fs_prim;
+	int fs_sec;
+	int prim_frames;	/* Primary frames in a control cycle */
+	int sec_frames;		/* Secondary frames in a control cycle */
+	enum asrc_operation_mode mode;
+	int bits;
+};
+
+struct test_asrc {
+	struct asrc_farrow *asrc;
+	int32_t *in32;
+	int32_t *out32;
+	int32_t *ibuf[TEST_CHANNELS];
+	int32_t *obuf[TEST_CHANNELS];
+};
+
+static void test_write(struct test_asrc *t, int bits, int frame)
+{
+	if (bits == 16)
+		asrc_write_to_ring_buffer16(t->asrc, (int16_t **)t->ibuf,
+					    frame, 1);
+	else
+		asrc_write_to_ring_buffer32(t->asrc, t->ibuf, frame, 1);
+}
+
+static void test_filter(struct test_asrc *t, int bits, int frame)
+{
+	struct asrc_farrow *asrc = t->asrc;
+
+	asrc->impulse_response = asrc->ir_scratch;
+	(*asrc->calc_ir)(asrc);
+	if (bits == 16)
+		asrc_fir_filter16(asrc, (int16_t **)t->obuf, frame, 1);
+	else
+		asrc_fir_filter32(asrc, t->obuf, frame, 1);
+}
+
+/*
+ * Reference push mode state machine that decides per frame whether to
+ * consume an input or produce an output, returns the output frames
+ */
+static int test_ref_push(struct test_asrc *t, int bits, int in_frames)
+{
+	struct asrc_farrow *asrc = t->asrc;
+	int n_in = 0;
+	int n_out = 0;
+
+	while (n_in < in_frames) {
+		if (asrc->time_value < TEST_TIME_VALUE_ONE) {
+			test_filter(t, bits, n_out);
+			asrc->time_value += asrc->fs_ratio;
+			n_out++;
+		} else {
+			test_write(t, bits, n_in);
+			asrc->time_value -= TEST_TIME_VALUE_ONE;
+			n_in++;
+		}
+	}
+
+	return n_out;
+}
+
+/* Reference pull mode state machine, returns the consumed input frames */
+static int test_ref_pull(struct test_asrc *t, int bits, int in_frames,
+			 int out_frames)
+{
+	struct asrc_farrow *asrc = t->asrc;
+	int n_in = 0;
+	int n_out = 0;
+
+	while (n_out < out_frames) {
+		if (asrc->time_value_pull < TEST_TIME_VALUE_ONE) {
+			if (n_in != in_frames) {
+				test_write(t, bits, n_in);
+				n_in++;
+			}
+
+			asrc->time_value = (((int64_t)TEST_TIME_VALUE_ONE -
+					     asrc->time_value_pull) *
+					    asrc->fs_ratio_inv) >> 27;
+			asrc->time_value_pull += asrc->fs_ratio;
+		} else {
+			test_filter(t, bits, n_out);
+			asrc->time_value += asrc->fs_ratio_inv;
+			asrc->time_value_pull -= TEST_TIME_VALUE_ONE;
+			n_out++;
+		}
+	}
+
+	return n_in;
+}
+
+static void test_asrc_new(struct test_asrc *t, const struct test_config *cfg,
+			  int frames_max)
+{
+	int size;
+	int ret;
+	int ch;
+
+	ret = asrc_get_required_size(NULL, &size, TEST_CHANNELS, cfg->bits);
+	assert_int_equal(ret, ASRC_EC_OK);
+	t->asrc = calloc(1, size);
+	t->in32 = calloc(frames_max * TEST_CHANNELS, sizeof(int32_t));
+	t->out32 = calloc(frames_max * TEST_CHANNELS, sizeof(int32_t));
+	assert_non_null(t->asrc);
+	assert_non_null(t->in32);
+	assert_non_null(t->out32);
+
+	ret = asrc_initialise(NULL, t->asrc, TEST_CHANNELS, cfg->fs_prim,
+			      cfg->fs_sec, ASRC_IOF_INTERLEAVED,
+			      ASRC_IOF_INTERLEAVED, ASRC_BM_LINEAR, frames_max,
+			      cfg->bits, ASRC_CM_FIXED, cfg->mode);
+	assert_int_equal(ret, ASRC_EC_OK);
+
+	/* Interleaved channels, the pointers are to the first sample */
+	for (ch = 0; ch < TEST_CHANNELS; ch++) {
+		if (cfg->bits == 16) {
+			t->ibuf[ch] = (int32_t *)((int16_t *)t->in32 + ch);
+			t->obuf[ch] = (int32_t *)((int16_t *)t->out32 + ch);
+		} else {
+			t->ibuf[ch] = t->in32 + ch;
+			t->obuf[ch] = t->out32 + ch;
+		}
+	}
+}
+
+static void test_asrc_free(struct test_asrc *t)
+{
+	free(t->out32);
+	free(t->in32);
+	free(t->asrc);
+}
+
+static void test_block(void **state)
+{
+	const struct test_config *cfg = *state;
+	struct test_asrc blk;
+	struct test_asrc ref;
+	int sample_bytes = cfg->bits / 8;
+	int in_frames;
+	int out_frames;
+	int frames_max;
+	int n_ref;
+	int idx;
+	int n;
+	int ret;
+	int c;
+	int i;
+
+	if (cfg->mode == ASRC_OM_PUSH) {
+		in_frames = cfg->prim_frames;
+		out_frames = cfg->sec_frames;
+	} else {
+		in_frames = cfg->sec_frames;
+		out_frames = cfg->prim_frames;
+	}
+
+	frames_max = MAX(in_frames, out_frames) + 10;
+	test_asrc_new(&blk, cfg, frames_max);
+	test_asrc_new(&ref, cfg, frames_max);
+
+	srand(cfg->fs_prim + cfg->fs_sec + cfg->bits);
+	for (c = 0; c < TEST_CYCLES; c++) {
+		/* Same input to both */
+		for (i = 0; i < in_frames * TEST_CHANNELS; i++) {
+			if (cfg->bits == 16) {
+				((int16_t *)blk.in32)[i] = rand();
+				((int16_t *)ref.in32)[i] =
+					((int16_t *)blk.in32)[i];
+			} else {
+				blk.in32[i] = rand() * 2654435761u;
+				ref.in32[i] = blk.in32[i];
+			}
+		}
+
+		ret = asrc_update_fs_ratio(NULL, blk.asrc, cfg->prim_frames,
+					   cfg->sec_frames);
+		assert_int_equal(ret, ASRC_EC_OK);
+		ret = asrc_update_fs_ratio(NULL, ref.asrc, cfg->prim_frames,
+					   cfg->sec_frames);
+		assert_int_equal(ret, ASRC_EC_OK);
+
+		idx = 0;
+		if (cfg->mode == ASRC_OM_PUSH && cfg->bits == 16)
+			ret = asrc_process_push16(NULL, blk.asrc,
+						  (int16_t **)blk.ibuf,
+						  in_frames,
+						  (int16_t **)blk.obuf, &n,
+						  &idx, 0);
+		else if (cfg->mode == ASRC_OM_PUSH)
+			ret = asrc_process_push32(NULL, blk.asrc, blk.ibuf,
+						  in_frames, blk.obuf, &n,
+						  &idx, 0);
+		else if (cfg->bits == 16)
+			ret = asrc_process_pull16(NULL, blk.asrc,
+						  (int16_t **)blk.ibuf, &n,
+						  (int16_t **)blk.obuf,
+						  out_frames, in_frames, &idx);
+		else
+			ret = asrc_process_pull32(NULL, blk.asrc, blk.ibuf,
+						  &n, blk.obuf, out_frames,
+						  in_frames, &idx);
+
+		assert_int_equal(ret, ASRC_EC_OK);
+
+		if (cfg->mode == ASRC_OM_PUSH) {
+			n_ref = test_ref_push(&ref, cfg->bits, in_frames);
+			assert_int_equal(n_ref, out_frames);
+		} else {
+			n_ref = test_ref_pull(&ref, cfg->bits, in_frames,
+					      out_frames);
+			assert_int_equal(n_ref, in_frames);
+		}
+
+		assert_int_equal(n, n_ref);
+		assert_int_equal(blk.asrc->time_value, ref.asrc->time_value);
+		assert_memory_equal(blk.out32, ref.out32,
+				    out_frames * TEST_CHANNELS * sample_bytes);
+	}
+
+	test_asrc_free(&ref);
+	test_asrc_free(&blk);
+}
+
+static struct test_config configs[] = {
+	{ 8000, 48000, 8, 48, ASRC_OM_PUSH, 16 },
+	{ 8000, 48000, 8, 48, ASRC_OM_PUSH, 32 },
+	{ 16000, 48000, 16, 48, ASRC_OM_PUSH, 16 },
+	{ 16000, 48000, 16, 48, ASRC_OM_PUSH, 32 },
+	{ 44100, 48000, 441, 480, ASRC_OM_PUSH, 16 },
+	{ 44100, 48000, 441, 480, ASRC_OM_PUSH, 32 },
+	{ 48000, 8000, 48, 8, ASRC_OM_PULL, 16 },
+	{ 48000, 8000, 48, 8, ASRC_OM_PULL, 32 },
+	{ 48000, 16000, 48, 16, ASRC_OM_PULL, 16 },
+	{ 48000, 16000, 48, 16, ASRC_OM_PULL, 32 },
+	{ 48000, 44100, 480, 441, ASRC_OM_PULL, 16 },
+	{ 48000, 44100, 480, 441, ASRC_OM_PULL, 32 },
+#if CONFIG_ASRC_SUPPORT_CONVERSION_48000_TO_16000
+	{ 48000, 16000, 48, 16, ASRC_OM_PUSH, 16 },
+	{ 48000, 16000, 48, 16, ASRC_OM_PUSH, 32 },
+	{ 16000, 48000, 16, 48, ASRC_OM_PULL, 16 },
+	{ 16000, 48000, 16, 48, ASRC_OM_PULL, 32 },
+#endif
+#if CONFIG_ASRC_SUPPORT_CONVERSION_48000_TO_44100
+	{ 48000, 44100, 480, 441, ASRC_OM_PUSH, 16 },
+	{ 48000, 44100, 480, 441, ASRC_OM_PUSH, 32 },
+	{ 44100, 48000, 441, 480, ASRC_OM_PULL, 16 },
+	{ 44100, 48000, 441, 480, ASRC_OM_PULL, 32 },
+#endif
+};
+
+int main(void)
+{
+	struct CMUnitTest tests[ARRAY_SIZE(configs)];
+	int i;
+
+	for (i = 0; i < ARRAY_SIZE(configs); i++) {
+		tests[i].name = "test_block";
+		tests[i].test_func = test_block;
+		tests[i].setup_func = NULL;
+		tests[i].teardown_func = NULL;
+		tests[i].initial_state = &configs[i];
+	}
+
+	cmocka_set_message_output(CM_OUTPUT_TAP);
+
+	return cmocka_run_group_tests(tests, NULL, NULL);
+}
@@ -0,0 +1,259 @@
+// SPDX-License-Identifier: BSD-3-Clause
+//
+// Copyright(c) 2020 Intel Corporation. All rights reserved.
+
+/*
+ * ASRC component copy with fixed conversion ratio. The period of 1 ms is
+ * not an integer number of frames at 44.1 kHz, so the control cycle of
+ * 147 to 160 frames is processed over several copies. The output with
+ * the impulse responses cache must be bit exact with the output computed
+ * on the fly.
+ */
+
+#include <stdarg.h>
+#include <stddef.h>
+#include <setjmp.h>
+#include <stdint.h>
+#include <stdlib.h>
+#include <cmocka.h>
+
+/* the asrc driver is static */
+#include "asrc/asrc.c"
+
+#define TEST_CHANNELS		2
+#define TEST_SOURCE_RATE	44100
+#define TEST_SINK_RATE		48000
+#define TEST_PERIOD_FRAMES	48	/* 1 ms at sink */
+#define TEST_COPIES		100
+#define TEST_CYCLE_SOURCE	147
+#define TEST_CYCLE_SINK		160
+
+struct test_config {
+	enum asrc_operation_mode mode;
+	enum sof_ipc_frame frame_fmt;
+	int source_frames;	/* Source buffer size */
+	int sink_frames;	/* Sink buffer size */
+	const char *name;
+};
+
+static struct comp_buffer *test_buffer(enum sof_ipc_frame frame_fmt,
+				       uint32_t rate, uint32_t frames)
+{
+	struct sof_ipc_buffer desc = {
+		.size = frames * TEST_CHANNELS *
+			(frame_fmt == SOF_IPC_FRAME_S16_LE ?
+			 sizeof(int16_t) : sizeof(int32_t)),
+	};
+	struct comp_buffer *buf = buffer_new(&desc);
+
+	assert_non_null(buf);
+	buf->stream.channels = TEST_CHANNELS;
+	buf->stream.frame_fmt = frame_fmt;
+	buf->stream.rate = rate;
+	return buf;
+}
+
+static void test_write(struct audio_stream *stream, int i, int32_t val)
+{
+	if (stream->frame_fmt == SOF_IPC_FRAME_S16_LE)
+		*(int16_t *)audio_stream_write_frag_s16(stream, i) = val >> 16;
+	else
+		*(int32_t *)audio_stream_write_frag_s32(stream, i) = val;
+}
+
+static int32_t test_read(const struct audio_stream *stream, int i)
+{
+	if (stream->frame_fmt == SOF_IPC_FRAME_S16_LE)
+		return *(int16_t *)audio_stream_read_frag_s16(stream, i);
+
+	return *(int32_t *)audio_stream_read_frag_s32(stream, i);
+}
+
+/* Runs the copies with a 44.1 kHz source and a 48 kHz sink those are
+ * serviced every 1 ms, returns the number of output samples.
+ */
+static int test_run(const struct test_config *cfg, bool cache, int32_t *out,
+		    int max_out)
+{
+	struct sof_ipc_comp_asrc ipc = {
+		.comp = {
+			.type = SOF_COMP_ASRC,
+		},
+		.config = {
+			.hdr = {
+				.size = sizeof(struct sof_ipc_comp_config),
+			},
+			.periods_sink = 1,
+			.periods_source = 1,
+		},
+		.source_rate = TEST_SOURCE_RATE,
+		.sink_rate = TEST_SINK_RATE,
+		.asynchronous_mode = 0,
+		.operation_mode = cfg->mode,
+	};
+	struct sof_ipc_stream_params params = {
+		.rate = TEST_SOURCE_RATE,
+	};
+	struct comp_buffer *source;
+	struct comp_buffer *sink;
+	struct comp_data *cd;
+	struct comp_dev *dev;
+	uint32_t seed = 1;
+	int source_total = 0;
+	int consumed;
+	int produced;
+	int n_out = 0;
+	int frames;
+	int n;
+	int c;
+	int i;
+
+	dev = comp_asrc.ops.create(&comp_asrc, (struct sof_ipc_comp *)&ipc);
+	assert_non_null(dev);
+	list_init(&dev->bsource_list);
+	list_init(&dev->bsink_list);
+	dev->direction = SOF_IPC_STREAM_PLAYBACK;
+	dev->frames = TEST_PERIOD_FRAMES;
+
+	source = test_buffer(cfg->frame_fmt, TEST_SOURCE_RATE,
+			     cfg->source_frames);
+	sink = test_buffer(cfg->frame_fmt, TEST_SINK_RATE, cfg->sink_frames);
+	source->sink = dev;
+	sink->source = dev;
+	list_item_append(&source->sink_list, &dev->bsource_list);
+	list_item_append(&sink->source_list, &dev->bsink_list);
+
+	assert_int_equal(comp_asrc.ops.params(dev, &params), 0);
+	assert_int_equal(comp_asrc.ops.prepare(dev), 0);
+
+	cd = comp_get_drvdata(dev);
+	assert_int_equal(cd->control_mode, ASRC_CM_FIXED);
+	assert_int_equal(cd->cycle_source_frames, TEST_CYCLE_SOURCE);
+	assert_int_equal(cd->cycle_sink_frames, TEST_CYCLE_SINK);
+	assert_non_null(cd->ir_cache);
+	assert_true(cd->ir_cache_size <= CONFIG_COMP_ASRC_IR_CACHE_SIZE);
+
+	/* Without the cache all responses are computed on the fly */
+	if (!cache)
+		cd->asrc_obj->ir_cache_length = 0;
+
+	for (c = 0; c < TEST_COPIES; c++) {
+		/* 44 or 45 new source frames every 1 ms */
+		frames = (c + 1) * TEST_SOURCE_RATE / 1000 -
+			c * TEST_SOURCE_RATE / 1000;
+		n = audio_stream_get_free_frames(&source->stream);
+		frames = MIN(frames, n);
+		for (i = 0; i < frames * TEST_CHANNELS; i++) {
+			seed = seed * 1664525 + 1013904223;
+			test_write(&source->stream, i, seed);
+		}
+
+		audio_stream_produce(&source->stream, frames *
+				     audio_stream_frame_bytes(&source->stream));
+		source_total += frames;
+
+		assert_int_equal(comp_asrc.ops.copy(dev), 0);
+
+		/* The sink is drained by one period */
+		n = MIN(audio_stream_get_avail_samples(&sink->stream),
+			TEST_PERIOD_FRAMES * TEST_CHANNELS);
+		assert_true(n_out + n <= max_out);
+		for (i = 0; i < n; i++)
+			out[n_out++] = test_read(&sink->stream, i);
+
+		audio_stream_consume(&sink->stream, n *
+				     audio_stream_sample_bytes(&sink->stream));
+	}
+
+	/* The complete cycles converted 147 frames to 160 frames */
+	consumed = source_total -
+		audio_stream_get_avail_frames(&source->stream);
+	produced = (n_out + audio_stream_get_avail_samples(&sink->stream)) /
+		TEST_CHANNELS;
+	assert_true(consumed > 10 * TEST_CYCLE_SOURCE);
+	assert_int_equal(consumed - cd->cycle_source_pos,
+			 (produced - cd->cycle_sink_pos) * TEST_CYCLE_SOURCE /
+			 TEST_CYCLE_SINK);
+	assert_int_equal((consumed - cd->cycle_source_pos) %
+			 TEST_CYCLE_SOURCE, 0);
+	/* The budget can limit the cache to the first responses of the
+	 * cycle.
+	 */
+	if (cache) {
+		assert_true(cd->asrc_obj->ir_cache_count > 0);
+		assert_true(cd->asrc_obj->ir_cache_count <=
+			    MIN(cd->asrc_obj->ir_cache_length,
+				TEST_CYCLE_SINK));
+	}
+
+	comp_asrc.ops.reset(dev);
+	comp_asrc.ops.free(dev);
+	buffer_free(source);
+	buffer_free(sink);
+	return n_out;
+}
+
+static void test_asrc_copy_fixed(void **state)
+{
+	const struct test_config *cfg = *state;
+	int max_out = TEST_COPIES * TEST_PERIOD_FRAMES * TEST_CHANNELS;
+	int32_t *ref = calloc(max_out, sizeof(int32_t));
+	int32_t *out = calloc(max_out, sizeof(int32_t));
+	int n_ref;
+	int n;
+
+	assert_non_null(ref);
+	assert_non_null(out);
+
+	n_ref = test_run(cfg, false, ref, max_out);
+	n = test_run(cfg, true, out, max_out);
+
+	/* The sink is serviced every period after the start */
+	assert_true(n_ref > (TEST_COPIES - 5) * TEST_PERIOD_FRAMES *
+		    TEST_CHANNELS);
+	assert_int_equal(n, n_ref);
+	assert_memory_equal(out, ref, n * sizeof(int32_t));
+
+	free(out);
+	free(ref);
+}
+
+#define TEST_CONFIG(_mode, _fmt, _source_frames, _sink_frames) \
+	{ \
+		.mode = ASRC_OM_ ## _mode, \
+		.frame_fmt = SOF_IPC_FRAME_ ## _fmt, \
+		.source_frames = (_source_frames), \
+		.sink_frames = (_sink_frames), \
+		.name = ("test_asrc_copy_fixed_" #_mode "_" #_fmt "_" \
+			 #_source_frames "_" #_sink_frames), \
+	}
+
+/* Buffers of one and two periods */
+static struct test_config configs[] = {
+	TEST_CONFIG(PUSH, S16_LE, 45, 48),
+	TEST_CONFIG(PUSH, S32_LE, 45, 48),
+	TEST_CONFIG(PUSH, S16_LE, 90, 96),
+	TEST_CONFIG(PUSH, S32_LE, 90, 96),
+	TEST_CONFIG(PULL, S16_LE, 45, 48),
+	TEST_CONFIG(PULL, S32_LE, 45, 48),
+	TEST_CONFIG(PULL, S16_LE, 90, 96),
+	TEST_CONFIG(PULL, S32_LE, 90, 96),
+};
+
+int main(void)
+{
+	struct CMUnitTest tests[ARRAY_SIZE(configs)];
+	int i;
+
+	for (i = 0; i < ARRAY_SIZE(configs); i++) {
+		tests[i].name = configs[i].name;
+		tests[i].test_func = test_asrc_copy_fixed;
+		tests[i].setup_func = NULL;
+		tests[i].teardown_func = NULL;
+		tests[i].initial_state = &configs[i];
+	}
+
+	cmocka_set_message_output(CM_OUTPUT_TAP);
+
+	return cmocka_run_group_tests(tests, NULL, NULL);
+}
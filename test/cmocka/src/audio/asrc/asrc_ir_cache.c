@@ -0,0 +1,216 @@
+// SPDX-License-Identifier: BSD-3-Clause
+//
+// Copyright(c) 2020 Intel Corporation. All rights reserved.
+
+#include <sof/audio/asrc/asrc_farrow.h>
+#include <sof/common.h>
+
+#include <stdarg.h>
+#include <stddef.h>
+#include <setjmp.h>
+#include <stdint.h>
+#include <stdlib.h>
+#include <string.h>
+#include <cmocka.h>
+
+#define TEST_CHANNELS	2
+#define TEST_CYCLES	12
+
+/* Cache sizes as fraction of the output frames in a control cycle */
+#define TEST_CACHE_NONE		0
+#define TEST_CACHE_HALF		1
+#define TEST_CACHE_FULL		2
+
+struct test_config {
+	int fs_prim;
+	int fs_sec;
+	int prim_frames;	/* Primary frames in a control cycle */
+	int sec_frames;		/* Secondary frames in a control cycle */
+	enum asrc_operation_mode mode;
+	int bits;
+};
+
+/* Runs the fixed control cycles, returns the number of output samples */
+static int test_run(const struct test_config *cfg, int cache, int32_t *out)
+{
+	struct asrc_farrow *asrc;
+	int32_t *ir_cache = NULL;
+	int32_t *in32 = NULL;
+	int32_t *out32 = NULL;
+	int32_t *ibuf[TEST_CHANNELS];
+	int32_t *obuf[TEST_CHANNELS];
+	int in_frames;
+	int out_frames;
+	int frames_max;
+	int cache_size;
+	int n_out = 0;
+	int size;
+	int idx;
+	int n;
+	int ret;
+	int ch;
+	int c;
+	int i;
+
+	if (cfg->mode == ASRC_OM_PUSH) {
+		in_frames = cfg->prim_frames;
+		out_frames = cfg->sec_frames;
+	} else {
+		in_frames = cfg->sec_frames;
+		out_frames = cfg->prim_frames;
+	}
+
+	frames_max = MAX(in_frames, out_frames) + 10;
+	ret = asrc_get_required_size(NULL, &size, TEST_CHANNELS, cfg->bits);
+	assert_int_equal(ret, ASRC_EC_OK);
+	asrc = calloc(1, size);
+	in32 = calloc(frames_max * TEST_CHANNELS, sizeof(int32_t));
+	out32 = calloc(frames_max * TEST_CHANNELS, sizeof(int32_t));
+	assert_non_null(asrc);
+	assert_non_null(in32);
+	assert_non_null(out32);
+
+	ret = asrc_initialise(NULL, asrc, TEST_CHANNELS, cfg->fs_prim,
+			      cfg->fs_sec, ASRC_IOF_INTERLEAVED,
+			      ASRC_IOF_INTERLEAVED, ASRC_BM_LINEAR, frames_max,
+			      cfg->bits, ASRC_CM_FIXED, cfg->mode);
+	assert_int_equal(ret, ASRC_EC_OK);
+
+	if (cache != TEST_CACHE_NONE) {
+		cache_size = asrc_get_ir_cache_size(asrc, out_frames * cache /
+						    TEST_CACHE_FULL);
+		ir_cache = malloc(cache_size);
+		assert_non_null(ir_cache);
+		ret = asrc_set_ir_cache(NULL, asrc, ir_cache, cache_size);
+		assert_int_equal(ret, ASRC_EC_OK);
+	}
+
+	/* Interleaved channels, the pointers are to the first sample */
+	for (ch = 0; ch < TEST_CHANNELS; ch++) {
+		if (cfg->bits == 16) {
+			ibuf[ch] = (int32_t *)((int16_t *)in32 + ch);
+			obuf[ch] = (int32_t *)((int16_t *)out32 + ch);
+		} else {
+			ibuf[ch] = in32 + ch;
+			obuf[ch] = out32 + ch;
+		}
+	}
+
+	srand(cfg->fs_prim + cfg->fs_sec + cfg->bits);
+	for (c = 0; c < TEST_CYCLES; c++) {
+		for (i = 0; i < in_frames * TEST_CHANNELS; i++) {
+			if (cfg->bits == 16)
+				((int16_t *)in32)[i] = rand();
+			else
+				in32[i] = rand() * 2 - RAND_MAX;
+		}
+
+		ret = asrc_update_fs_ratio(NULL, asrc, cfg->prim_frames,
+					   cfg->sec_frames);
+		assert_int_equal(ret, ASRC_EC_OK);
+
+		idx = 0;
+		if (cfg->mode == ASRC_OM_PUSH && cfg->bits == 16)
+			ret = asrc_process_push16(NULL, asrc,
+						  (int16_t **)ibuf, in_frames,
+						  (int16_t **)obuf, &n, &idx,
+						  0);
+		else if (cfg->mode == ASRC_OM_PUSH)
+			ret = asrc_process_push32(NULL, asrc, ibuf, in_frames,
+						  obuf, &n, &idx, 0);
+		else if (cfg->bits == 16)
+			ret = asrc_process_pull16(NULL, asrc,
+						  (int16_t **)ibuf, &n,
+						  (int16_t **)obuf, out_frames,
+						  in_frames, &idx);
+		else
+			ret = asrc_process_pull32(NULL, asrc, ibuf, &n, obuf,
+						  out_frames, in_frames, &idx);
+
+		assert_int_equal(ret, ASRC_EC_OK);
+		if (cfg->mode == ASRC_OM_PUSH)
+			assert_int_equal(n, out_frames);
+		else
+			assert_int_equal(n, in_frames);
+
+		for (i = 0; i < out_frames * TEST_CHANNELS; i++)
+			out[n_out++] = cfg->bits == 16 ?
+				((int16_t *)out32)[i] : out32[i];
+	}
+
+	free(ir_cache);
+	free(out32);
+	free(in32);
+	free(asrc);
+	return n_out;
+}
+
+static void test_ir_cache(void **state)
+{
+	const struct test_config *cfg = *state;
+	int max_out = TEST_CYCLES * TEST_CHANNELS *
+		MAX(cfg->prim_frames, cfg->sec_frames);
+	int32_t *ref = calloc(max_out, sizeof(int32_t));
+	int32_t *out = calloc(max_out, sizeof(int32_t));
+	int n_ref;
+	int n;
+
+	assert_non_null(ref);
+	assert_non_null(out);
+
+	n_ref = test_run(cfg, TEST_CACHE_NONE, ref);
+
+	/* All responses from the cache after the first cycle */
+	n = test_run(cfg, TEST_CACHE_FULL, out);
+	assert_int_equal(n, n_ref);
+	assert_memory_equal(out, ref, n * sizeof(int32_t));
+
+	/* Frames beyond the cache size are computed on the fly */
+	n = test_run(cfg, TEST_CACHE_HALF, out);
+	assert_int_equal(n, n_ref);
+	assert_memory_equal(out, ref, n * sizeof(int32_t));
+
+	free(out);
+	free(ref);
+}
+
+static struct test_config configs[] = {
+	{ 16000, 48000, 16, 48, ASRC_OM_PUSH, 16 },
+	{ 16000, 48000, 16, 48, ASRC_OM_PUSH, 32 },
+	{ 48000, 16000, 48, 16, ASRC_OM_PULL, 16 },
+	{ 48000, 16000, 48, 16, ASRC_OM_PULL, 32 },
+	{ 44100, 48000, 441, 480, ASRC_OM_PUSH, 16 },
+	{ 44100, 48000, 441, 480, ASRC_OM_PUSH, 32 },
+	{ 48000, 44100, 480, 441, ASRC_OM_PULL, 16 },
+	{ 48000, 44100, 480, 441, ASRC_OM_PULL, 32 },
+#if CONFIG_ASRC_SUPPORT_CONVERSION_48000_TO_16000
+	{ 48000, 16000, 48, 16, ASRC_OM_PUSH, 16 },
+	{ 48000, 16000, 48, 16, ASRC_OM_PUSH, 32 },
+	{ 16000, 48000, 16, 48, ASRC_OM_PULL, 16 },
+	{ 16000, 48000, 16, 48, ASRC_OM_PULL, 32 },
+#endif
+#if CONFIG_ASRC_SUPPORT_CONVERSION_48000_TO_44100
+	{ 48000, 44100, 480, 441, ASRC_OM_PUSH, 16 },
+	{ 48000, 44100, 480, 441, ASRC_OM_PUSH, 32 },
+	{ 44100, 48000, 441, 480, ASRC_OM_PULL, 16 },
+	{ 44100, 48000, 441, 480, ASRC_OM_PULL, 32 },
+#endif
+};
+
+int main(void)
+{
+	struct CMUnitTest tests[ARRAY_SIZE(configs)];
+	int i;
+
+	for (i = 0; i < ARRAY_SIZE(configs); i++) {
+		tests[i].name = "test_ir_cache";
+		tests[i].test_func = test_ir_cache;
+		tests[i].setup_func = NULL;
+		tests[i].teardown_func = NULL;
+		tests[i].initial_state = &configs[i];
+	}
+
+	cmocka_set_message_output(CM_OUTPUT_TAP);
+
+	return cmocka_run_group_tests(tests, NULL, NULL);
+}
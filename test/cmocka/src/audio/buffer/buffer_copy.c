@@ -152,6 +152,128 @@ static void test_audio_buffer_copy_fit_no_space_constraint(void **state)
 	buffer_free(snk);
 }
 
+static void test_audio_buffer_span_source_wraps_first(void **state)
+{
+	struct audio_stream_span span;
+
+	(void)state;
+
+	struct sof_ipc_buffer test_buf_desc = {
+		.size = 256
+	};
+
+	struct comp_buffer *src = buffer_new(&test_buf_desc);
+	struct comp_buffer *snk = buffer_new(&test_buf_desc);
+
+	assert_non_null(src);
+	assert_non_null(snk);
+
+	/* source read at 200, sink write at 100 */
+	comp_update_buffer_produce(src, 200);
+	comp_update_buffer_consume(src, 200);
+	comp_update_buffer_produce(snk, 100);
+	comp_update_buffer_consume(snk, 100);
+
+	audio_stream_span_init(&span, &src->stream, 0, 1, &snk->stream, 0, 1,
+			       120);
+
+	assert_int_equal(audio_stream_span_next(&span), 56);
+	assert_ptr_equal(span.src, (char *)src->stream.addr + 200);
+	assert_ptr_equal(span.snk, (char *)snk->stream.addr + 100);
+
+	assert_int_equal(audio_stream_span_next(&span), 64);
+	assert_ptr_equal(span.src, src->stream.addr);
+	assert_ptr_equal(span.snk, (char *)snk->stream.addr + 156);
+
+	assert_int_equal(audio_stream_span_next(&span), 0);
+
+	buffer_free(src);
+	buffer_free(snk);
+}
+
+static void test_audio_buffer_span_both_wrap(void **state)
+{
+	struct audio_stream_span span;
+
+	(void)state;
+
+	struct sof_ipc_buffer test_buf_desc = {
+		.size = 256
+	};
+
+	struct comp_buffer *src = buffer_new(&test_buf_desc);
+	struct comp_buffer *snk = buffer_new(&test_buf_desc);
+
+	assert_non_null(src);
+	assert_non_null(snk);
+
+	/* 16-bit source read at sample 100, 32-bit sink write at sample 40 */
+	comp_update_buffer_produce(src, 200);
+	comp_update_buffer_consume(src, 200);
+	comp_update_buffer_produce(snk, 160);
+	comp_update_buffer_consume(snk, 160);
+
+	audio_stream_span_init(&span, &src->stream, 0, sizeof(int16_t),
+			       &snk->stream, 0, sizeof(int32_t), 60);
+
+	/* sink wraps after 24 samples, source after 28 */
+	assert_int_equal(audio_stream_span_next(&span), 24);
+	assert_int_equal(audio_stream_span_next(&span), 4);
+	assert_ptr_equal(span.src, (char *)src->stream.addr + 248);
+	assert_ptr_equal(span.snk, snk->stream.addr);
+	assert_int_equal(audio_stream_span_next(&span), 32);
+	assert_ptr_equal(span.src, src->stream.addr);
+	assert_ptr_equal(span.snk, (char *)snk->stream.addr + 16);
+	assert_int_equal(audio_stream_span_next(&span), 0);
+
+	buffer_free(src);
+	buffer_free(snk);
+}
+
+static void test_audio_buffer_copy_wrap(void **state)
+{
+	uint8_t *src_data;
+	uint8_t *snk_data;
+	int i;
+
+	(void)state;
+
+	struct sof_ipc_buffer test_buf_desc = {
+		.size = 256
+	};
+
+	struct comp_buffer *src = buffer_new(&test_buf_desc);
+	struct comp_buffer *snk = buffer_new(&test_buf_desc);
+
+	assert_non_null(src);
+	assert_non_null(snk);
+
+	src_data = src->stream.addr;
+	snk_data = snk->stream.addr;
+	for (i = 0; i < test_buf_desc.size; i++) {
+		src_data[i] = i;
+		snk_data[i] = 0;
+	}
+
+	comp_update_buffer_produce(src, 200);
+	comp_update_buffer_consume(src, 200);
+	comp_update_buffer_produce(snk, 100);
+	comp_update_buffer_consume(snk, 100);
+
+	/* copy 170 bytes starting 10 bytes after read and write pointers */
+	audio_stream_copy(&src->stream, 10, &snk->stream, 10, 170);
+
+	for (i = 0; i < 170; i++)
+		assert_int_equal(snk_data[(110 + i) % 256],
+				 (uint8_t)((210 + i) % 256));
+
+	assert_int_equal(snk_data[109], 0);
+	assert_int_equal(snk_data[24], 0);
+
+	buffer_free(src);
+	buffer_free(snk);
+}
+
 int main(void)
 {
 	const struct CMUnitTest tests[] = {
@@ -159,7 +281,10 @@ int main(void)
 		cmocka_unit_test(test_audio_buffer_copy_overrun),
 		cmocka_unit_test(test_audio_buffer_copy_success),
 		cmocka_unit_test(test_audio_buffer_copy_fit_space_constraint),
-		cmocka_unit_test(test_audio_buffer_copy_fit_no_space_constraint)
+		cmocka_unit_test(test_audio_buffer_copy_fit_no_space_constraint),
+		cmocka_unit_test(test_audio_buffer_span_source_wraps_first),
+		cmocka_unit_test(test_audio_buffer_span_both_wrap),
+		cmocka_unit_test(test_audio_buffer_copy_wrap)
 	};
 
 	cmocka_set_message_output(CM_OUTPUT_TAP);
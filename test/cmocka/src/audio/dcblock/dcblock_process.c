@@ -0,0 +1,275 @@
+// SPDX-License-Identifier: BSD-3-Clause
+//
+// Copyright(c) 2020 Intel Corporation. All rights reserved.
+
+#include <sof/audio/component.h>
+#include <sof/audio/dcblock/dcblock.h>
+#include <sof/audio/format.h>
+#include <sof/common.h>
+#include <ipc/stream.h>
+
+#include <stdarg.h>
+#include <stddef.h>
+#include <setjmp.h>
+#include <stdint.h>
+#include <stdlib.h>
+#include <string.h>
+#include <cmocka.h>
+
+#define TEST_BLOCKS	7
+#define TEST_FRAMES	48
+
+/* buffers hold a non integer number of blocks so that they wrap */
+#define TEST_BUFFER_FRAMES	(TEST_FRAMES * 2 + 13)
+
+/* R is about 0.98 in Q2.30, differs per channel */
+#define TEST_R(ch)	(1052266987 - (ch) * 1000000)
+
+/* per sample reference, same arithmetic as the component */
+static int32_t test_ref_dcblock(struct dcblock_state *state, int32_t R,
+				int32_t x)
+{
+	int64_t out = ((int64_t)x) - state->x_prev +
+		      Q_SHIFT_RND((int64_t)R * state->y_prev, 61, 31);
+
+	state->y_prev = sat_int32(out);
+	state->x_prev = x;
+
+	return state->y_prev;
+}
+
+static void test_ref_process(struct dcblock_state *state,
+			     const struct audio_stream *source,
+			     const struct audio_stream *sink, int frames)
+{
+	int32_t tmp;
+	int nch = source->channels;
+	int ch;
+	int i;
+
+	for (i = 0; i < frames * nch; i++) {
+		ch = i % nch;
+		switch (source->frame_fmt) {
+		case SOF_IPC_FRAME_S16_LE: {
+			int16_t *x = audio_stream_read_frag_s16(source, i);
+			int16_t *y = audio_stream_write_frag_s16(sink, i);
+
+			tmp = test_ref_dcblock(&state[ch], TEST_R(ch),
+					       *x << 16);
+			*y = sat_int16(Q_SHIFT_RND(tmp, 31, 15));
+			break;
+		}
+		case SOF_IPC_FRAME_S24_4LE: {
+			int32_t *x = audio_stream_read_frag_s32(source, i);
+			int32_t *y = audio_stream_write_frag_s32(sink, i);
+
+			tmp = test_ref_dcblock(&state[ch], TEST_R(ch),
+					       *x << 8);
+			*y = sat_int24(Q_SHIFT_RND(tmp, 31, 23));
+			break;
+		}
+		default: {
+			int32_t *x = audio_stream_read_frag_s32(source, i);
+			int32_t *y = audio_stream_write_frag_s32(sink, i);
+
+			*y = test_ref_dcblock(&state[ch], TEST_R(ch), *x);
+			break;
+		}
+		}
+	}
+}
+
+static struct audio_stream *test_buffer(enum sof_ipc_frame frame_fmt,
+					int nch, int offset)
+{
+	struct audio_stream *buffer;
+	int sample_bytes;
+	int size;
+
+	buffer = calloc(1, sizeof(*buffer));
+	assert_non_null(buffer);
+
+	buffer->frame_fmt = frame_fmt;
+	buffer->channels = nch;
+	size = TEST_BUFFER_FRAMES * audio_stream_frame_bytes(buffer);
+	buffer->addr = malloc(size);
+	assert_non_null(buffer->addr);
+	audio_stream_init(buffer, buffer->addr, size);
+
+	/* offset in samples so that the wrap can split a frame */
+	sample_bytes = audio_stream_sample_bytes(buffer);
+	audio_stream_produce(buffer, offset * sample_bytes);
+	audio_stream_consume(buffer, offset * sample_bytes);
+
+	return buffer;
+}
+
+static void test_free_buffer(struct audio_stream *buffer)
+{
+	free(buffer->addr);
+	free(buffer);
+}
+
+/* full scale input with DC offset, clips sometimes */
+static void test_fill_source(struct audio_stream *source, int frames,
+			     unsigned int *seed)
+{
+	int64_t dc;
+	int64_t v;
+	int nch = source->channels;
+	int i;
+
+	for (i = 0; i < frames * nch; i++) {
+		dc = (int64_t)(i % nch) * INT32_MAX / (nch + 1);
+		v = dc + (int32_t)(rand_r(seed) * 2654435761u);
+		switch (source->frame_fmt) {
+		case SOF_IPC_FRAME_S16_LE:
+			*(int16_t *)audio_stream_write_frag_s16(source, i) =
+				sat_int16(v >> 16);
+			break;
+		case SOF_IPC_FRAME_S24_4LE:
+			*(int32_t *)audio_stream_write_frag_s32(source, i) =
+				sat_int24(sat_int32(v) >> 8);
+			break;
+		default:
+			*(int32_t *)audio_stream_write_frag_s32(source, i) =
+				sat_int32(v);
+			break;
+		}
+	}
+}
+
+static int32_t test_sample(const struct audio_stream *buffer, int i)
+{
+	if (buffer->frame_fmt == SOF_IPC_FRAME_S16_LE)
+		return *(int16_t *)audio_stream_write_frag_s16(buffer, i);
+
+	return *(int32_t *)audio_stream_write_frag_s32(buffer, i);
+}
+
+static void test_dcblock(enum sof_ipc_frame frame_fmt, int nch)
+{
+	struct comp_dev *dev = calloc(1, sizeof(*dev));
+	struct comp_data *cd = calloc(1, sizeof(*cd));
+	struct dcblock_state ref[PLATFORM_MAX_CHANNELS];
+	struct audio_stream *source;
+	struct audio_stream *sink;
+	struct audio_stream *ref_sink;
+	dcblock_func func = dcblock_find_func(frame_fmt);
+	unsigned int seed = nch;
+	int frame_bytes;
+	int bytes;
+	int ch;
+	int i;
+
+	assert_non_null(dev);
+	assert_non_null(cd);
+	assert_non_null(func);
+	comp_set_drvdata(dev, cd);
+
+	for (ch = 0; ch < nch; ch++) {
+		cd->R_coeffs[ch] = TEST_R(ch);
+		cd->state[ch].x_prev = ch * 1000;
+		cd->state[ch].y_prev = -ch * 100000;
+		ref[ch] = cd->state[ch];
+	}
+
+	source = test_buffer(frame_fmt, nch, TEST_BUFFER_FRAMES * nch - 1);
+	sink = test_buffer(frame_fmt, nch, TEST_BUFFER_FRAMES * nch - 5);
+	ref_sink = test_buffer(frame_fmt, nch, TEST_BUFFER_FRAMES * nch - 5);
+	frame_bytes = audio_stream_frame_bytes(source);
+
+	/* blocks of different length continue from the previous state */
+	for (i = 0; i < TEST_BLOCKS; i++) {
+		int frames = TEST_FRAMES - i * 3;
+
+		bytes = frames * frame_bytes;
+		test_fill_source(source, frames, &seed);
+		func(dev, source, sink, frames);
+		test_ref_process(ref, source, ref_sink, frames);
+
+		audio_stream_produce(source, bytes);
+		audio_stream_consume(source, bytes);
+		for (ch = 0; ch < frames * nch; ch++)
+			assert_int_equal(test_sample(sink, ch),
+					 test_sample(ref_sink, ch));
+
+		audio_stream_produce(sink, bytes);
+		audio_stream_consume(sink, bytes);
+		audio_stream_produce(ref_sink, bytes);
+		audio_stream_consume(ref_sink, bytes);
+	}
+
+	for (ch = 0; ch < nch; ch++) {
+		assert_int_equal(cd->state[ch].x_prev, ref[ch].x_prev);
+		assert_int_equal(cd->state[ch].y_prev, ref[ch].y_prev);
+	}
+
+	test_free_buffer(source);
+	test_free_buffer(sink);
+	test_free_buffer(ref_sink);
+	free(cd);
+	free(dev);
+}
+
+#define TEST_DCBLOCK(fmt, nch) \
+static void test_dcblock_##fmt##_##nch(void **state) \
+{ \
+	(void)state; \
+	test_dcblock(SOF_IPC_FRAME_##fmt, nch); \
+}
+
+#if CONFIG_FORMAT_S16LE
+TEST_DCBLOCK(S16_LE, 1)
+TEST_DCBLOCK(S16_LE, 2)
+TEST_DCBLOCK(S16_LE, 3)
+TEST_DCBLOCK(S16_LE, 4)
+TEST_DCBLOCK(S16_LE, 8)
+#endif /* CONFIG_FORMAT_S16LE */
+
+#if CONFIG_FORMAT_S24LE
+TEST_DCBLOCK(S24_4LE, 1)
+TEST_DCBLOCK(S24_4LE, 2)
+TEST_DCBLOCK(S24_4LE, 3)
+TEST_DCBLOCK(S24_4LE, 4)
+TEST_DCBLOCK(S24_4LE, 8)
+#endif /* CONFIG_FORMAT_S24LE */
+
+#if CONFIG_FORMAT_S32LE
+TEST_DCBLOCK(S32_LE, 1)
+TEST_DCBLOCK(S32_LE, 2)
+TEST_DCBLOCK(S32_LE, 3)
+TEST_DCBLOCK(S32_LE, 4)
+TEST_DCBLOCK(S32_LE, 8)
+#endif /* CONFIG_FORMAT_S32LE */
+
+int main(void)
+{
+	const struct CMUnitTest tests[] = {
+#if CONFIG_FORMAT_S16LE
+		cmocka_unit_test(test_dcblock_S16_LE_1),
+		cmocka_unit_test(test_dcblock_S16_LE_2),
+		cmocka_unit_test(test_dcblock_S16_LE_3),
+		cmocka_unit_test(test_dcblock_S16_LE_4),
+		cmocka_unit_test(test_dcblock_S16_LE_8),
+#endif /* CONFIG_FORMAT_S16LE */
+#if CONFIG_FORMAT_S24LE
+		cmocka_unit_test(test_dcblock_S24_4LE_1),
+		cmocka_unit_test(test_dcblock_S24_4LE_2),
+		cmocka_unit_test(test_dcblock_S24_4LE_3),
+		cmocka_unit_test(test_dcblock_S24_4LE_4),
+		cmocka_unit_test(test_dcblock_S24_4LE_8),
+#endif /* CONFIG_FORMAT_S24LE */
+#if CONFIG_FORMAT_S32LE
+		cmocka_unit_test(test_dcblock_S32_LE_1),
+		cmocka_unit_test(test_dcblock_S32_LE_2),
+		cmocka_unit_test(test_dcblock_S32_LE_3),
+		cmocka_unit_test(test_dcblock_S32_LE_4),
+		cmocka_unit_test(test_dcblock_S32_LE_8),
+#endif /* CONFIG_FORMAT_S32LE */
+	};
+
+	cmocka_set_message_output(CM_OUTPUT_TAP);
+
+	return cmocka_run_group_tests(tests, NULL, NULL);
+}
@@ -0,0 +1,218 @@
+// SPDX-License-Identifier: BSD-3-Clause
+//
+// Copyright(c) 2020 Intel Corporation. All rights reserved.
+
+#include <sof/audio/eq_fir/fir_config.h>
+#include <sof/audio/eq_fir/fir.h>
+#include <sof/audio/format.h>
+#include <user/eq.h>
+
+#include <math.h>
+#include <stdarg.h>
+#include <stddef.h>
+#include <setjmp.h>
+#include <stdint.h>
+#include <stdlib.h>
+#include <string.h>
+#include <cmocka.h>
+
+#if FIR_GENERIC
+
+#define TEST_SAMPLES	1000
+#define TEST_DELAY_SIZE	(SOF_EQ_FIR_MAX_LENGTH + FIR_32X16_SAMPLES_MAX - 1)
+
+static int16_t test_blob[SOF_EQ_FIR_COEF_NHEADER + SOF_EQ_FIR_MAX_LENGTH];
+static int32_t delay[3][TEST_DELAY_SIZE];
+static int32_t input[TEST_SAMPLES];
+
+/* Direct convolution of the input scaled down by shift with the
+ * coefficients
+ */
+static int32_t test_fir_ref_shift(struct sof_eq_fir_coef_data *config,
+				  int n, int shift)
+{
+	int64_t y = 0;
+	int k;
+
+	for (k = 0; k < config->length && k <= n; k++)
+		y += (int64_t)config->coef[k] * (input[n - k] >> shift);
+
+	return sat_int32(y >> (15 + config->out_shift));
+}
+
+static int32_t test_fir_ref(struct sof_eq_fir_coef_data *config, int n)
+{
+	return test_fir_ref_shift(config, n, 0);
+}
+
+/* Runs single, two and four samples per call versions of the filter and
+ * checks that all are bit exact with direct convolution. The sample count
+ * is not a multiple of the delay line length so the passes start from
+ * all positions of the circular delay line.
+ */
+static void test_fir_32x16_response(int length, int out_shift)
+{
+	struct fir_state_32x16 fir[3];
+	struct sof_eq_fir_coef_data *config =
+		(struct sof_eq_fir_coef_data *)test_blob;
+	int32_t *data;
+	int32_t y[4];
+	int32_t ref;
+	int i;
+	int j;
+
+	config->length = length;
+	config->out_shift = out_shift;
+	for (i = 0; i < length; i++)
+		config->coef[i] = 32767 * sin(0.7 * i) * exp(-0.01 * i);
+
+	for (i = 0; i < TEST_SAMPLES; i++)
+		input[i] = rand() - RAND_MAX / 2;
+
+	assert_true(fir_delay_size(config) <= sizeof(delay[0]));
+	memset(delay, 0, sizeof(delay));
+	for (j = 0; j < 3; j++) {
+		data = delay[j];
+		fir_init_coef(&fir[j], config);
+		fir_init_delay(&fir[j], &data);
+	}
+
+	for (i = 0; i < TEST_SAMPLES; i += 4) {
+		for (j = 0; j < 4; j++) {
+			ref = test_fir_ref(config, i + j);
+			assert_int_equal(fir_32x16(&fir[0], input[i + j]), ref);
+		}
+
+		fir_32x16_2x(&fir[1], input[i], input[i + 1], &y[0], &y[1]);
+		fir_32x16_2x(&fir[1], input[i + 2], input[i + 3], &y[2],
+			     &y[3]);
+		for (j = 0; j < 4; j++)
+			assert_int_equal(y[j], test_fir_ref(config, i + j));
+
+		fir_32x16_4x(&fir[2], input[i], input[i + 1], input[i + 2],
+			     input[i + 3], &y[0], &y[1], &y[2], &y[3]);
+		for (j = 0; j < 4; j++)
+			assert_int_equal(y[j], test_fir_ref(config, i + j));
+	}
+}
+
+#if FIR_LANES
+static int32_t lanes_delay[FIR_LANES_MAX * TEST_DELAY_SIZE];
+
+/* Runs the shared coefficients versions for interleaved channels that
+ * are the input signal scaled down by channel index and checks that the
+ * output is bit exact with direct convolution.
+ */
+static void test_fir_32x16_lanes(int length, int nch)
+{
+	struct fir_state_32x16 fir[FIR_LANES_MAX];
+	struct sof_eq_fir_coef_data *config =
+		(struct sof_eq_fir_coef_data *)test_blob;
+	int32_t *data = lanes_delay;
+	int32_t x[2 * FIR_LANES_MAX];
+	int32_t y[2 * FIR_LANES_MAX];
+	int ch;
+	int i;
+	int j;
+
+	config->length = length;
+	config->out_shift = 1;
+	for (i = 0; i < length; i++)
+		config->coef[i] = 32767 * sin(0.3 * i) * exp(-0.02 * i);
+
+	for (i = 0; i < TEST_SAMPLES; i++)
+		input[i] = rand() - RAND_MAX / 2;
+
+	for (ch = 0; ch < nch; ch++)
+		fir_init_coef(&fir[ch], config);
+
+	assert_true(fir_lanes_ok(fir, nch));
+	memset(lanes_delay, 0, sizeof(lanes_delay));
+	fir_init_delay_lanes(fir, nch, &data);
+
+	for (i = 0; i < TEST_SAMPLES; i += 2) {
+		for (j = 0; j < 2; j++) {
+			for (ch = 0; ch < nch; ch++)
+				x[j * nch + ch] = input[i + j] >> ch;
+		}
+
+		switch (nch) {
+		case 2:
+			fir_32x16_lanes_2x(fir, 2, x, y);
+			break;
+		case 4:
+			fir_32x16_lanes_2x(fir, 4, x, y);
+			break;
+		default:
+			fir_32x16_lanes(fir, 8, x, y);
+			fir_32x16_lanes(fir, 8, x + 8, y + 8);
+			break;
+		}
+
+		for (j = 0; j < 2; j++) {
+			for (ch = 0; ch < nch; ch++)
+				assert_int_equal(y[j * nch + ch],
+						 test_fir_ref_shift(config,
+								    i + j, ch));
+		}
+	}
+}
+#endif /* FIR_LANES */
+
+static void test_audio_eq_fir_32x16_short(void **state)
+{
+	(void)state;
+
+	test_fir_32x16_response(1, 0);
+	test_fir_32x16_response(2, 0);
+	test_fir_32x16_response(3, 0);
+	test_fir_32x16_response(5, 0);
+}
+
+static void test_audio_eq_fir_32x16_long(void **state)
+{
+	(void)state;
+
+	test_fir_32x16_response(63, 0);
+	test_fir_32x16_response(SOF_EQ_FIR_MAX_LENGTH, 0);
+}
+
+static void test_audio_eq_fir_32x16_shift(void **state)
+{
+	(void)state;
+
+	test_fir_32x16_response(37, 2);
+	test_fir_32x16_response(37, -1);
+}
+
+#if FIR_LANES
+static void test_audio_eq_fir_32x16_lanes(void **state)
+{
+	(void)state;
+
+	test_fir_32x16_lanes(1, 2);
+	test_fir_32x16_lanes(7, 2);
+	test_fir_32x16_lanes(40, 4);
+	test_fir_32x16_lanes(SOF_EQ_FIR_MAX_LENGTH, 8);
+}
+#endif /* FIR_LANES */
+
+#endif /* FIR_GENERIC */
+
+int main(void)
+{
+	const struct CMUnitTest tests[] = {
+#if FIR_GENERIC
+		cmocka_unit_test(test_audio_eq_fir_32x16_short),
+		cmocka_unit_test(test_audio_eq_fir_32x16_long),
+		cmocka_unit_test(test_audio_eq_fir_32x16_shift),
+#endif
+#if FIR_LANES
+		cmocka_unit_test(test_audio_eq_fir_32x16_lanes),
+#endif
+	};
+
+	cmocka_set_message_output(CM_OUTPUT_TAP);
+
+	return cmocka_run_group_tests(tests, NULL, NULL);
+}
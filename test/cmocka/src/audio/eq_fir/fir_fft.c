@@ -0,0 +1,188 @@
+// SPDX-License-Identifier: BSD-3-Clause
+//
+// Copyright(c) 2020 Intel Corporation. All rights reserved.
+
+#include <sof/audio/eq_fir/fir_config.h>
+#include <sof/audio/eq_fir/fir.h>
+#include <sof/math/numbers.h>
+#include <user/eq.h>
+
+#include <errno.h>
+#include <math.h>
+#include <stdarg.h>
+#include <stddef.h>
+#include <setjmp.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <cmocka.h>
+
+#if FIR_FFT
+
+#define TEST_SAMPLES	4000
+
+/* Max. difference to time-domain output in Q1.31, less than one LSB of
+ * 24 bit data.
+ */
+#define TEST_TOLERANCE	256
+
+/* Longest response tested */
+#define TEST_MAX_LENGTH	1024
+
+static int16_t test_blob[SOF_EQ_FIR_COEF_NHEADER + TEST_MAX_LENGTH];
+static int64_t fft_data[16384];
+static int32_t delay[TEST_MAX_LENGTH + FIR_32X16_SAMPLES_MAX - 1];
+static int32_t input[TEST_SAMPLES];
+
+/* Runs FFT convolution and time-domain reference of the same response and
+ * checks that the outputs differ by less than the tolerance after the
+ * delay of one block.
+ */
+static void test_fir_fft_response(int length, int out_shift)
+{
+	struct fir_state_32x16 ref;
+	struct fir_state_32x16 fir;
+	struct fir_fft_state fft;
+	struct sof_eq_fir_coef_data *config =
+		(struct sof_eq_fir_coef_data *)test_blob;
+	struct fir_fft_work *work = (struct fir_fft_work *)fft_data;
+	int32_t *data = (int32_t *)(work + 1);
+	int32_t *ref_delay = delay;
+	int32_t out[FIR_FFT_BLOCK_LEN];
+	int32_t y;
+	int err = 0;
+	int i;
+
+	config->length = length;
+	config->out_shift = out_shift;
+	for (i = 0; i < length; i++)
+		config->coef[i] = 29000 * sin(0.3 * i) * exp(-0.02 * i);
+
+	for (i = 0; i < TEST_SAMPLES; i++)
+		input[i] = (rand() - RAND_MAX / 2) * 0.9;
+
+	fir_init_coef(&ref, config);
+	fir_init_delay(&ref, &ref_delay);
+	memset(delay, 0, sizeof(delay));
+
+	fir_init_coef(&fir, config);
+	assert_true(sizeof(*work) + fir_fft_delay_size(&fir) <=
+		    sizeof(fft_data));
+	memset(fft_data, 0, sizeof(fft_data));
+	fir_fft_init_work(work);
+	fir_fft_init(&fft, &fir, work, &data);
+	fir.fft = &fft;
+
+	for (i = 0; i < TEST_SAMPLES; i++) {
+		y = fir_filter(&fir, input[i]);
+		if (i >= FIR_FFT_BLOCK_LEN)
+			err = MAX(err, abs(y - out[i % FIR_FFT_BLOCK_LEN]));
+
+		out[i % FIR_FFT_BLOCK_LEN] = fir_32x16(&ref, input[i]);
+	}
+
+	if (err > TEST_TOLERANCE)
+		printf("%s: length %d, error %d\n", __func__, length, err);
+
+	assert_true(err <= TEST_TOLERANCE);
+}
+
+static void test_audio_eq_fir_fft_long(void **state)
+{
+	(void)state;
+
+	test_fir_fft_response(TEST_MAX_LENGTH, 0);
+}
+
+/* Shortest response that eq_fir runs with FFT convolution */
+static void test_audio_eq_fir_fft_min_taps(void **state)
+{
+	(void)state;
+
+	test_fir_fft_response(FIR_FFT_MIN_TAPS, 0);
+}
+
+static void test_audio_eq_fir_fft_abi_max(void **state)
+{
+	(void)state;
+
+	test_fir_fft_response(SOF_EQ_FIR_MAX_LENGTH, 0);
+}
+
+/* Responses longer than the IPC ABI limit are accepted up to
+ * FIR_MAX_LENGTH taps.
+ */
+static void test_audio_eq_fir_fft_max_length(void **state)
+{
+	struct sof_eq_fir_coef_data *config =
+		(struct sof_eq_fir_coef_data *)test_blob;
+
+	(void)state;
+
+	config->length = FIR_MAX_LENGTH;
+	assert_true(fir_delay_size(config) > 0);
+
+	config->length = FIR_MAX_LENGTH + 1;
+	assert_int_equal(fir_delay_size(config), -EINVAL);
+}
+
+static void test_audio_eq_fir_fft_shift(void **state)
+{
+	(void)state;
+
+	test_fir_fft_response(2 * FIR_FFT_BLOCK_LEN + 1, 2);
+}
+
+static void test_audio_eq_fir_fft_short(void **state)
+{
+	(void)state;
+
+	test_fir_fft_response(5, 0);
+}
+
+/* Bypassed channel is only delayed by one block */
+static void test_audio_eq_fir_fft_bypass(void **state)
+{
+	struct fir_state_32x16 fir;
+	struct fir_fft_state fft;
+	struct fir_fft_work *work = (struct fir_fft_work *)fft_data;
+	int32_t *data = (int32_t *)(work + 1);
+	int i;
+
+	(void)state;
+
+	fir_reset(&fir);
+	memset(fft_data, 0, sizeof(fft_data));
+	fir_fft_init_work(work);
+	fir_fft_init(&fft, &fir, work, &data);
+	fir.fft = &fft;
+
+	for (i = 0; i < TEST_SAMPLES; i++) {
+		input[i] = rand();
+		assert_int_equal(fir_filter(&fir, input[i]),
+				 i < FIR_FFT_BLOCK_LEN ?
+				 0 : input[i - FIR_FFT_BLOCK_LEN]);
+	}
+}
+
+#endif /* FIR_FFT */
+
+int main(void)
+{
+	const struct CMUnitTest tests[] = {
+#if FIR_FFT
+		cmocka_unit_test(test_audio_eq_fir_fft_long),
+		cmocka_unit_test(test_audio_eq_fir_fft_min_taps),
+		cmocka_unit_test(test_audio_eq_fir_fft_abi_max),
+		cmocka_unit_test(test_audio_eq_fir_fft_max_length),
+		cmocka_unit_test(test_audio_eq_fir_fft_shift),
+		cmocka_unit_test(test_audio_eq_fir_fft_short),
+		cmocka_unit_test(test_audio_eq_fir_fft_bypass),
+#endif
+	};
+
+	cmocka_set_message_output(CM_OUTPUT_TAP);
+
+	return cmocka_run_group_tests(tests, NULL, NULL);
+}
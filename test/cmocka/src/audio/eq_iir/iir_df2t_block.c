@@ -0,0 +1,277 @@
+// SPDX-License-Identifier: BSD-3-Clause
+//
+// Copyright(c) 2020 Intel Corporation. All rights reserved.
+
+#include <sof/audio/eq_iir/iir.h>
+#include <sof/audio/format.h>
+#include <sof/common.h>
+#include <sof/math/numbers.h>
+#include <sof/string.h>
+#include <user/eq.h>
+
+#include <math.h>
+#include <stdarg.h>
+#include <stddef.h>
+#include <setjmp.h>
+#include <stdint.h>
+#include <stdlib.h>
+#include <string.h>
+#include <cmocka.h>
+
+#define TEST_CHANNELS	8
+#define TEST_BIQUADS	4
+#define TEST_FRAMES	1000
+
+/* Biquad output gains 1.0 and 1.9 in Q2.14 */
+#define TEST_GAIN_ONE	16384
+#define TEST_GAIN_SAT	31130
+
+/* Block lengths the frames are processed with, they don't divide the
+ * frames count evenly.
+ */
+static const int test_blocks[] = { 1, 48, 7, 192, 13, 64 };
+
+static int32_t coef[TEST_CHANNELS][TEST_BIQUADS * SOF_EQ_IIR_NBIQUAD_DF2T];
+static int64_t delay[TEST_CHANNELS][TEST_BIQUADS * IIR_DF2T_NUM_DELAYS];
+static int64_t ref_delay[TEST_CHANNELS][TEST_BIQUADS * IIR_DF2T_NUM_DELAYS];
+static int32_t data[TEST_FRAMES * TEST_CHANNELS];
+static int32_t ref[TEST_FRAMES * TEST_CHANNELS];
+
+/* Peaking EQ biquad from the audio EQ cookbook in the coefficients order
+ * {a2, a1, b2, b1, b0, shift, gain} of iir_df2t(). The a coefficients are
+ * stored negated. A shift of one is compensated with a gain of two,
+ * otherwise the output gain is the Q2.14 gain.
+ */
+static void test_biquad(int32_t *c, double f, double q, double gain_db,
+			int shift, int32_t gain)
+{
+	double a = pow(10.0, gain_db / 40.0);
+	double w = 2.0 * M_PI * f;
+	double alpha = sin(w) / (2.0 * q);
+	double a0 = 1.0 + alpha / a;
+
+	c[0] = -(1.0 - alpha / a) / a0 * (1 << 30);
+	c[1] = 2.0 * cos(w) / a0 * (1 << 30);
+	c[2] = (1.0 - alpha * a) / a0 * (1 << 30);
+	c[3] = -2.0 * cos(w) / a0 * (1 << 30);
+	c[4] = (1.0 + alpha * a) / a0 * (1 << 30);
+	c[5] = shift;
+	c[6] = shift ? INT16_MAX : gain;
+}
+
+/* Sets up the filter of a channel and an identical copy for the per sample
+ * reference. The responses differ per channel and per biquad.
+ */
+static void test_setup(struct iir_state_df2t *iir, struct iir_state_df2t *r,
+		       int ch, int biquads, int in_series, double gain_db,
+		       int32_t gain)
+{
+	int i;
+
+	iir->biquads = biquads;
+	iir->biquads_in_series = in_series;
+	iir->coef = coef[ch];
+	iir->delay = delay[ch];
+	for (i = 0; i < biquads; i++)
+		test_biquad(&coef[ch][i * SOF_EQ_IIR_NBIQUAD_DF2T],
+			    0.01 + 0.03 * i + 0.005 * ch, 0.7 + 0.5 * i,
+			    gain_db - 3.0 * i, i & 1, gain);
+
+	memset(delay[ch], 0, sizeof(delay[ch]));
+	memset(ref_delay[ch], 0, sizeof(ref_delay[ch]));
+	*r = *iir;
+	r->delay = ref_delay[ch];
+}
+
+/* Noise with a sine, amplitude is a fraction of the full scale */
+static void test_input(int channels, double amplitude)
+{
+	int i;
+
+	srand(1);
+	for (i = 0; i < TEST_FRAMES * channels; i++)
+		data[i] = amplitude * (0.5 * sin(0.05 * i) +
+				       0.5 * (2.0 * rand() / RAND_MAX - 1.0)) *
+			  INT32_MAX;
+
+	memcpy_s(ref, sizeof(ref), data,
+		 sizeof(data[0]) * TEST_FRAMES * channels);
+}
+
+/* Filters the input in blocks of varying length and checks the output and
+ * the delays against iir_df2t() run sample by sample.
+ */
+static void test_compare(struct iir_state_df2t *iir,
+			 struct iir_state_df2t *r, int channels)
+{
+	int32_t *x = data;
+	int frames = TEST_FRAMES;
+	int n;
+	int ch;
+	int i;
+
+	for (i = 0; frames > 0; i++) {
+		n = MIN(test_blocks[i % ARRAY_SIZE(test_blocks)], frames);
+		iir_df2t_block_interleaved(iir, channels, x, n);
+		x += n * channels;
+		frames -= n;
+	}
+
+	for (i = 0; i < TEST_FRAMES * channels; i++) {
+		ch = i % channels;
+		ref[i] = iir_df2t(&r[ch], ref[i]);
+	}
+
+	assert_memory_equal(data, ref,
+			    sizeof(data[0]) * TEST_FRAMES * channels);
+
+	for (ch = 0; ch < channels; ch++)
+		assert_memory_equal(delay[ch], ref_delay[ch],
+				    sizeof(delay[ch]));
+}
+
+static void test_series(int channels, double amplitude, double gain_db,
+			int32_t gain)
+{
+	struct iir_state_df2t iir[TEST_CHANNELS];
+	struct iir_state_df2t r[TEST_CHANNELS];
+	int ch;
+
+	for (ch = 0; ch < channels; ch++)
+		test_setup(&iir[ch], &r[ch], ch, 3, 3, gain_db, gain);
+
+	test_input(channels, amplitude);
+	test_compare(iir, r, channels);
+}
+
+static void test_iir_df2t_1ch(void **state)
+{
+	(void)state;
+
+	test_series(1, 0.5, 6.0, TEST_GAIN_ONE);
+}
+
+static void test_iir_df2t_2ch(void **state)
+{
+	(void)state;
+
+	test_series(2, 0.5, 6.0, TEST_GAIN_ONE);
+}
+
+static void test_iir_df2t_4ch(void **state)
+{
+	(void)state;
+
+	test_series(4, 0.5, 6.0, TEST_GAIN_ONE);
+}
+
+static void test_iir_df2t_8ch(void **state)
+{
+	(void)state;
+
+	test_series(8, 0.5, 6.0, TEST_GAIN_ONE);
+}
+
+/* Three channels have no lanes version */
+static void test_iir_df2t_3ch(void **state)
+{
+	(void)state;
+
+	test_series(3, 0.5, 6.0, TEST_GAIN_ONE);
+}
+
+/* Two sections of two biquads in parallel */
+static void test_iir_df2t_parallel(void **state)
+{
+	struct iir_state_df2t iir[TEST_CHANNELS];
+	struct iir_state_df2t r[TEST_CHANNELS];
+	int ch;
+
+	(void)state;
+
+	for (ch = 0; ch < 2; ch++)
+		test_setup(&iir[ch], &r[ch], ch, 4, 2, 6.0, TEST_GAIN_ONE);
+
+	test_input(2, 0.5);
+	test_compare(iir, r, 2);
+}
+
+/* Different number of biquads per channel */
+static void test_iir_df2t_mismatch(void **state)
+{
+	struct iir_state_df2t iir[TEST_CHANNELS];
+	struct iir_state_df2t r[TEST_CHANNELS];
+	int ch;
+
+	(void)state;
+
+	for (ch = 0; ch < 4; ch++)
+		test_setup(&iir[ch], &r[ch], ch, 1 + ch % 3, 1 + ch % 3, 6.0,
+			   TEST_GAIN_ONE);
+
+	test_input(4, 0.5);
+	test_compare(iir, r, 4);
+}
+
+/* All channels in bypass and one channel in bypass */
+static void test_iir_df2t_bypass(void **state)
+{
+	struct iir_state_df2t iir[TEST_CHANNELS];
+	struct iir_state_df2t r[TEST_CHANNELS];
+	int32_t x0;
+	int ch;
+
+	(void)state;
+
+	for (ch = 0; ch < 2; ch++)
+		test_setup(&iir[ch], &r[ch], ch, 0, 0, 6.0, TEST_GAIN_ONE);
+
+	test_input(2, 0.5);
+	x0 = data[TEST_FRAMES];
+	test_compare(iir, r, 2);
+	assert_int_equal(data[TEST_FRAMES], x0);
+
+	for (ch = 0; ch < 4; ch++)
+		test_setup(&iir[ch], &r[ch], ch, ch == 2 ? 0 : 2,
+			   ch == 2 ? 0 : 2, 6.0, TEST_GAIN_ONE);
+
+	test_input(4, 0.5);
+	test_compare(iir, r, 4);
+}
+
+/* Near full scale input with boost saturates the biquad outputs */
+static void test_iir_df2t_saturation(void **state)
+{
+	int saturated = 0;
+	int i;
+
+	(void)state;
+
+	test_series(2, 0.9, 6.0, TEST_GAIN_SAT);
+	for (i = 0; i < 2 * TEST_FRAMES; i++)
+		saturated += data[i] == INT32_MAX || data[i] == INT32_MIN;
+
+	assert_true(saturated > 0);
+
+	test_series(8, 0.9, 6.0, TEST_GAIN_SAT);
+	test_series(3, 0.9, 6.0, TEST_GAIN_SAT);
+}
+
+int main(void)
+{
+	const struct CMUnitTest tests[] = {
+		cmocka_unit_test(test_iir_df2t_1ch),
+		cmocka_unit_test(test_iir_df2t_2ch),
+		cmocka_unit_test(test_iir_df2t_4ch),
+		cmocka_unit_test(test_iir_df2t_8ch),
+		cmocka_unit_test(test_iir_df2t_3ch),
+		cmocka_unit_test(test_iir_df2t_parallel),
+		cmocka_unit_test(test_iir_df2t_mismatch),
+		cmocka_unit_test(test_iir_df2t_bypass),
+		cmocka_unit_test(test_iir_df2t_saturation),
+	};
+
+	cmocka_set_message_output(CM_OUTPUT_TAP);
+
+	return cmocka_run_group_tests(tests, NULL, NULL);
+}
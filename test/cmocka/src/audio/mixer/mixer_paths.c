@@ -0,0 +1,265 @@
+// SPDX-License-Identifier: BSD-3-Clause
+//
+// Copyright(c) 2020 Intel Corporation. All rights reserved.
+
+/*
+ * Mixer copy with one source, two sources, silent sources and the wide
+ * accumulator of more sources. Each output sample must equal the generic
+ * mix, the sum of all sources saturated once.
+ */
+
+#include <stdarg.h>
+#include <stddef.h>
+#include <setjmp.h>
+#include <stdint.h>
+#include <malloc.h>
+#include <cmocka.h>
+
+/* the mixer driver is static */
+#include "mixer.c"
+
+#define MIX_TEST_MAX_SOURCES	8
+
+/* frames per copy, the accumulator runs over several blocks */
+#define MIX_TEST_FRAMES		173
+
+enum mix_test_data {
+	MIX_TEST_RANDOM,	/* full scale random samples */
+	MIX_TEST_POS,		/* near the positive limit */
+	MIX_TEST_NEG,		/* near the negative limit */
+	MIX_TEST_LAST,		/* zero except for the last sample */
+};
+
+struct mix_test_case {
+	enum sof_ipc_frame frame_fmt;
+	int num_sources;
+	int channels;
+	enum mix_test_data data;
+	uint32_t silent;	/* mask of sources with only zero samples */
+	const char *name;
+};
+
+#define TEST_CASE(_fmt, _num_sources, _channels, _data, _silent) \
+	{ \
+		.frame_fmt = SOF_IPC_FRAME_ ## _fmt, \
+		.num_sources = (_num_sources), \
+		.channels = (_channels), \
+		.data = MIX_TEST_ ## _data, \
+		.silent = (_silent), \
+		.name = ("test_mixer_paths_" #_fmt "_" \
+			 #_num_sources "_srcs_" #_channels "ch_" \
+			 #_data "_silent_" #_silent), \
+	}
+
+static struct mix_test_case mix_test_cases[] = {
+#if CONFIG_FORMAT_S16LE
+	TEST_CASE(S16_LE, 1, 2, RANDOM, 0x0),
+	TEST_CASE(S16_LE, 2, 1, RANDOM, 0x0),
+	TEST_CASE(S16_LE, 2, 2, POS, 0x0),
+	TEST_CASE(S16_LE, 2, 3, NEG, 0x0),
+	TEST_CASE(S16_LE, 3, 2, RANDOM, 0x0),
+	TEST_CASE(S16_LE, 4, 3, POS, 0x0),
+	TEST_CASE(S16_LE, 8, 1, NEG, 0x0),
+	TEST_CASE(S16_LE, 8, 2, RANDOM, 0x0),
+	TEST_CASE(S16_LE, 2, 2, RANDOM, 0x1),
+	TEST_CASE(S16_LE, 3, 2, POS, 0x2),
+	TEST_CASE(S16_LE, 4, 3, RANDOM, 0x5),
+	TEST_CASE(S16_LE, 3, 1, RANDOM, 0x7),
+	TEST_CASE(S16_LE, 3, 2, LAST, 0x1),
+#endif /* CONFIG_FORMAT_S16LE */
+#if CONFIG_FORMAT_S32LE
+	TEST_CASE(S32_LE, 1, 2, RANDOM, 0x0),
+	TEST_CASE(S32_LE, 2, 1, RANDOM, 0x0),
+	TEST_CASE(S32_LE, 2, 2, POS, 0x0),
+	TEST_CASE(S32_LE, 2, 3, NEG, 0x0),
+	TEST_CASE(S32_LE, 3, 2, RANDOM, 0x0),
+	TEST_CASE(S32_LE, 4, 3, POS, 0x0),
+	TEST_CASE(S32_LE, 8, 1, NEG, 0x0),
+	TEST_CASE(S32_LE, 8, 2, RANDOM, 0x0),
+	TEST_CASE(S32_LE, 2, 2, RANDOM, 0x1),
+	TEST_CASE(S32_LE, 3, 2, POS, 0x2),
+	TEST_CASE(S32_LE, 4, 3, RANDOM, 0x5),
+	TEST_CASE(S32_LE, 3, 1, RANDOM, 0x7),
+	TEST_CASE(S32_LE, 3, 2, LAST, 0x1),
+#endif /* CONFIG_FORMAT_S32LE */
+};
+
+static struct sof_ipc_comp_mixer mixer_ipc = {
+	.comp = {
+		.type = SOF_COMP_MIXER,
+	},
+	.config = {
+		.hdr = {
+			.size = sizeof(struct sof_ipc_comp_config)
+		}
+	}
+};
+
+/* mixer source components, only the state is used */
+static struct comp_dev mix_test_source_dev[MIX_TEST_MAX_SOURCES];
+
+static uint32_t mix_test_seed;
+
+static int32_t mix_test_sample(const struct mix_test_case *tc, int i, int n)
+{
+	bool s16 = tc->frame_fmt == SOF_IPC_FRAME_S16_LE;
+
+	mix_test_seed = mix_test_seed * 1664525 + 1013904223;
+
+	switch (tc->data) {
+	case MIX_TEST_POS:
+		return (s16 ? INT16_MAX : INT32_MAX) - (mix_test_seed >> 24);
+	case MIX_TEST_NEG:
+		return (s16 ? INT16_MIN : INT32_MIN) + (mix_test_seed >> 24);
+	case MIX_TEST_LAST:
+		return i == n - 1 ? 1 : 0;
+	default:
+		return s16 ? (int16_t)(mix_test_seed >> 16) :
+			(int32_t)mix_test_seed;
+	}
+}
+
+/* set up stream to wrap after tail frames, the stream is empty */
+static void mix_test_stream(struct comp_buffer *buf,
+			    const struct mix_test_case *tc, uint32_t tail)
+{
+	uint32_t bytes;
+
+	buf->stream.channels = tc->channels;
+	buf->stream.frame_fmt = tc->frame_fmt;
+
+	bytes = tail * audio_stream_frame_bytes(&buf->stream);
+	bytes = buf->stream.size - bytes;
+	audio_stream_produce(&buf->stream, bytes);
+	audio_stream_consume(&buf->stream, bytes);
+}
+
+static void mix_test_write(struct audio_stream *stream, int i, int32_t val)
+{
+	if (stream->frame_fmt == SOF_IPC_FRAME_S16_LE)
+		*(int16_t *)audio_stream_write_frag_s16(stream, i) = val;
+	else
+		*(int32_t *)audio_stream_write_frag_s32(stream, i) = val;
+}
+
+static int32_t mix_test_read(const struct audio_stream *stream, int i)
+{
+	if (stream->frame_fmt == SOF_IPC_FRAME_S16_LE)
+		return *(int16_t *)audio_stream_read_frag_s16(stream, i);
+
+	return *(int32_t *)audio_stream_read_frag_s32(stream, i);
+}
+
+static struct comp_buffer *mix_test_buffer(const struct mix_test_case *tc,
+					   uint32_t frames)
+{
+	struct sof_ipc_buffer desc = {
+		.size = frames * tc->channels *
+			(tc->frame_fmt == SOF_IPC_FRAME_S16_LE ?
+			 sizeof(int16_t) : sizeof(int32_t)),
+	};
+	struct comp_buffer *buf = buffer_new(&desc);
+
+	assert_non_null(buf);
+	return buf;
+}
+
+static void test_mixer_paths(void **state)
+{
+	struct mix_test_case *tc = *state;
+	struct comp_buffer *sources[MIX_TEST_MAX_SOURCES];
+	struct comp_buffer *sink;
+	struct comp_dev *dev;
+	const int n = MIX_TEST_FRAMES * tc->channels;
+	int32_t *ref;
+	uint32_t bytes;
+	int64_t sum;
+	int i;
+	int j;
+
+	ref = calloc(tc->num_sources * n, sizeof(*ref));
+	assert_non_null(ref);
+	mix_test_seed = tc->num_sources * 8 + tc->channels;
+
+	dev = comp_mixer.ops.create(&comp_mixer,
+				    (struct sof_ipc_comp *)&mixer_ipc);
+	assert_non_null(dev);
+	list_init(&dev->bsource_list);
+	list_init(&dev->bsink_list);
+
+	/* sink wraps in the middle of the period */
+	sink = mix_test_buffer(tc, MIX_TEST_FRAMES + 5);
+	mix_test_stream(sink, tc, 61);
+	sink->source = dev;
+	list_item_prepend(&sink->source_list, &dev->bsink_list);
+	bytes = n * audio_stream_sample_bytes(&sink->stream);
+
+	/* sources of different sizes wrap at different frames */
+	for (j = 0; j < tc->num_sources; j++) {
+		sources[j] = mix_test_buffer(tc,
+					     MIX_TEST_FRAMES + 11 * (j + 1));
+		mix_test_stream(sources[j], tc,
+				(7 + 29 * j) % MIX_TEST_FRAMES);
+		mix_test_source_dev[j].state = COMP_STATE_ACTIVE;
+		sources[j]->source = &mix_test_source_dev[j];
+		sources[j]->sink = dev;
+		list_item_append(&sources[j]->sink_list, &dev->bsource_list);
+
+		for (i = 0; i < n; i++) {
+			if (!(tc->silent & BIT(j)))
+				ref[j * n + i] = mix_test_sample(tc, i, n);
+
+			mix_test_write(&sources[j]->stream, i, ref[j * n + i]);
+		}
+
+		audio_stream_produce(&sources[j]->stream, bytes);
+	}
+
+	assert_int_equal(comp_mixer.ops.prepare(dev), 1);
+	dev->state = COMP_STATE_ACTIVE;
+	assert_int_equal(comp_mixer.ops.copy(dev), 0);
+
+	/* all sources are consumed, also the silent ones */
+	for (j = 0; j < tc->num_sources; j++)
+		assert_int_equal(sources[j]->stream.avail, 0);
+
+	assert_int_equal(audio_stream_get_avail_samples(&sink->stream), n);
+
+	for (i = 0; i < n; i++) {
+		sum = 0;
+		for (j = 0; j < tc->num_sources; j++)
+			sum += ref[j * n + i];
+
+		if (tc->frame_fmt == SOF_IPC_FRAME_S16_LE)
+			sum = sat_int16(sum);
+		else
+			sum = sat_int32(sum);
+
+		assert_int_equal(mix_test_read(&sink->stream, i), sum);
+	}
+
+	for (j = 0; j < tc->num_sources; j++)
+		buffer_free(sources[j]);
+
+	buffer_free(sink);
+	comp_mixer.ops.free(dev);
+	free(ref);
+}
+
+int main(void)
+{
+	struct CMUnitTest tests[ARRAY_SIZE(mix_test_cases)];
+	int i;
+
+	for (i = 0; i < ARRAY_SIZE(tests); i++) {
+		tests[i].test_func = test_mixer_paths;
+		tests[i].initial_state = &mix_test_cases[i];
+		tests[i].setup_func = NULL;
+		tests[i].teardown_func = NULL;
+		tests[i].name = mix_test_cases[i].name;
+	}
+
+	cmocka_set_message_output(CM_OUTPUT_TAP);
+
+	return cmocka_run_group_tests(tests, NULL, NULL);
+}
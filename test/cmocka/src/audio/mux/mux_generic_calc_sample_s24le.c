@@ -21,6 +21,8 @@ struct test_data {
 	uint8_t mask;
 	int32_t *input;
 	struct comp_buffer *buffer;
+	struct mux_tap taps[PLATFORM_MAX_CHANNELS];
+	uint8_t num_taps;
 	int32_t expected_result;
 };
 
@@ -38,7 +40,7 @@ static int32_t input_samples[][PLATFORM_MAX_CHANNELS] = {
 #define TEST_CASE(channels, mask, input_index) \
 	{ ("test_calc_sample_s24le_ch_" #channels "_mask_" #mask \
 	   "_input_" #input_index), channels, mask, \
-	 input_samples[input_index], NULL, 0 }
+	 input_samples[input_index], NULL, { { 0 } }, 0, 0 }
 
 static struct test_data test_cases[] = {
 	TEST_CASE(1, 0x0, 0),
@@ -76,9 +78,8 @@ static void test_calc_sample(void **state)
 {
 	struct test_data *td = *((struct test_data **)state);
 
-	int32_t ret =  calc_sample_s24le(&td->buffer->stream,
-					 0,
-					 td->mask);
+	const struct audio_stream *sources[] = { &td->buffer->stream };
+	int32_t ret = calc_sample_s24le(sources, td->taps, td->num_taps, 0);
 
 	assert_int_equal(ret, td->expected_result);
 }
@@ -93,11 +94,14 @@ static int setup(void **state)
 	td->buffer->stream.channels = td->channels;
 
 	td->expected_result = 0;
+	td->num_taps = 0;
 
 	for (ch = 0; ch < td->channels; ++ch) {
 		/* 8 MSB should be ignored */
-		if (td->mask & BIT(ch))
+		if (td->mask & BIT(ch)) {
+			td->taps[td->num_taps++].channel = ch;
 			td->expected_result += (td->input[ch] & 0x00ffffff);
+		}
 	}
 
 	return 0;
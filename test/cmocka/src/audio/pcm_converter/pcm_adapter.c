@@ -0,0 +1,207 @@
+// SPDX-License-Identifier: BSD-3-Clause
+//
+// Copyright(c) 2020 Intel Corporation. All rights reserved.
+
+#include <sof/audio/pcm_converter.h>
+#include <sof/audio/format.h>
+#include <sof/common.h>
+#include <sof/audio/buffer.h>
+#include <ipc/stream.h>
+
+#include <errno.h>
+#include <stdarg.h>
+#include <stddef.h>
+#include <setjmp.h>
+#include <stdint.h>
+#include <stdlib.h>
+#include <string.h>
+#include <cmocka.h>
+
+#define TEST_CHANNELS	3
+#define TEST_FRAMES	200
+
+/* format without conversion functions */
+#define TEST_INVALID_FMT	((enum sof_ipc_frame)(SOF_IPC_FRAME_FLOAT + 1))
+
+/* buffers hold more than the processed frames so that they wrap */
+#define TEST_BUFFER_FRAMES	(TEST_FRAMES + 37)
+
+/* processing function copying the source, counts processed frames */
+static void test_copy(void *ctx, const struct audio_stream *source,
+		      struct audio_stream *sink, uint32_t frames)
+{
+	uint32_t *processed = ctx;
+
+	/* blocks are pairs of frames, also with many channels */
+	assert_int_equal(source->frame_fmt, sink->frame_fmt);
+	assert_int_not_equal(frames, 0);
+	assert_int_equal(frames % 2, 0);
+	audio_stream_copy(source, 0, sink, 0,
+			  frames * audio_stream_frame_bytes(source));
+	*processed += frames;
+}
+
+static struct audio_stream *test_buffer(enum sof_ipc_frame frame_fmt,
+					int channels)
+{
+	struct audio_stream *buffer;
+	int size;
+
+	buffer = calloc(1, sizeof(*buffer));
+	assert_non_null(buffer);
+
+	buffer->frame_fmt = frame_fmt;
+	buffer->channels = channels;
+	size = TEST_BUFFER_FRAMES * audio_stream_frame_bytes(buffer);
+	buffer->addr = malloc(size);
+	assert_non_null(buffer->addr);
+	audio_stream_init(buffer, buffer->addr, size);
+
+	/* move pointers close to the end */
+	audio_stream_produce(buffer, (TEST_BUFFER_FRAMES - 11) *
+			     audio_stream_frame_bytes(buffer));
+	audio_stream_consume(buffer, (TEST_BUFFER_FRAMES - 11) *
+			     audio_stream_frame_bytes(buffer));
+
+	return buffer;
+}
+
+static void test_free_buffer(struct audio_stream *buffer)
+{
+	free(buffer->addr);
+	free(buffer);
+}
+
+/* result through the adapter must match the direct conversion */
+static void test_adapter(enum sof_ipc_frame source_fmt,
+			 enum sof_ipc_frame process_fmt,
+			 enum sof_ipc_frame sink_fmt, int channels)
+{
+	struct pcm_adapter adapter = { 0 };
+	struct audio_stream *source = test_buffer(source_fmt, channels);
+	struct audio_stream *sink = test_buffer(sink_fmt, channels);
+	struct audio_stream *ref = test_buffer(sink_fmt, channels);
+	pcm_converter_func convert;
+	int16_t *x16;
+	int16_t *y16;
+	int32_t *x32;
+	int32_t *y32;
+	uint32_t processed = 0;
+	uint32_t samples = TEST_FRAMES * channels;
+	uint32_t i;
+
+	for (i = 0; i < samples; i++) {
+		if (source_fmt == SOF_IPC_FRAME_S16_LE) {
+			x16 = audio_stream_write_frag_s16(source, i);
+			*x16 = i * 97;
+		} else {
+			x32 = audio_stream_write_frag_s32(source, i);
+			*x32 = sign_extend_s24(i * 5003);
+		}
+	}
+	audio_stream_produce(source, samples *
+			     audio_stream_sample_bytes(source));
+
+	assert_true(pcm_adapter_supported(source_fmt, process_fmt, sink_fmt));
+	assert_int_equal(pcm_adapter_init(&adapter, source_fmt, process_fmt,
+					  sink_fmt, channels), 0);
+	pcm_adapter_process(&adapter, source, sink, TEST_FRAMES, test_copy,
+			    &processed);
+	pcm_adapter_free(&adapter);
+	assert_int_equal(processed, TEST_FRAMES);
+
+	convert = pcm_get_conversion_function(source_fmt, sink_fmt);
+	assert_non_null(convert);
+	convert(source, 0, ref, 0, samples);
+
+	for (i = 0; i < samples; i++) {
+		if (sink_fmt == SOF_IPC_FRAME_S16_LE) {
+			x16 = audio_stream_read_frag_s16(sink, i);
+			y16 = audio_stream_read_frag_s16(ref, i);
+			assert_int_equal(*x16, *y16);
+		} else {
+			x32 = audio_stream_read_frag_s32(sink, i);
+			y32 = audio_stream_read_frag_s32(ref, i);
+			assert_int_equal(*x32, *y32);
+		}
+	}
+
+	test_free_buffer(source);
+	test_free_buffer(sink);
+	test_free_buffer(ref);
+}
+
+#if CONFIG_FORMAT_S16LE && CONFIG_FORMAT_S24LE
+static void test_pcm_adapter_convert_source(void **state)
+{
+	(void)state;
+
+	test_adapter(SOF_IPC_FRAME_S16_LE, SOF_IPC_FRAME_S24_4LE,
+		     SOF_IPC_FRAME_S24_4LE, TEST_CHANNELS);
+}
+
+static void test_pcm_adapter_convert_sink(void **state)
+{
+	(void)state;
+
+	test_adapter(SOF_IPC_FRAME_S24_4LE, SOF_IPC_FRAME_S24_4LE,
+		     SOF_IPC_FRAME_S16_LE, TEST_CHANNELS);
+}
+
+/* more channels than samples in a block */
+static void test_pcm_adapter_many_channels(void **state)
+{
+	(void)state;
+
+	test_adapter(SOF_IPC_FRAME_S16_LE, SOF_IPC_FRAME_S24_4LE,
+		     SOF_IPC_FRAME_S16_LE, PCM_ADAPTER_SAMPLES + 1);
+}
+#endif /* CONFIG_FORMAT_S16LE && CONFIG_FORMAT_S24LE */
+
+#if CONFIG_FORMAT_S16LE && CONFIG_FORMAT_S24LE && CONFIG_FORMAT_S32LE
+static void test_pcm_adapter_convert_both(void **state)
+{
+	(void)state;
+
+	test_adapter(SOF_IPC_FRAME_S16_LE, SOF_IPC_FRAME_S32_LE,
+		     SOF_IPC_FRAME_S24_4LE, TEST_CHANNELS);
+}
+#endif /* CONFIG_FORMAT_S16LE && CONFIG_FORMAT_S24LE && CONFIG_FORMAT_S32LE */
+
+static void test_pcm_adapter_unsupported(void **state)
+{
+	struct pcm_adapter adapter = { 0 };
+
+	(void)state;
+
+	assert_false(pcm_adapter_supported(SOF_IPC_FRAME_S16_LE,
+					   SOF_IPC_FRAME_S16_LE,
+					   TEST_INVALID_FMT));
+	assert_int_equal(pcm_adapter_init(&adapter, TEST_INVALID_FMT,
+					  SOF_IPC_FRAME_S16_LE,
+					  SOF_IPC_FRAME_S16_LE, TEST_CHANNELS),
+			 -EINVAL);
+	assert_int_equal(pcm_adapter_init(&adapter, SOF_IPC_FRAME_S16_LE,
+					  SOF_IPC_FRAME_S24_4LE,
+					  SOF_IPC_FRAME_S16_LE, 0), -EINVAL);
+	pcm_adapter_free(&adapter);
+}
+
+int main(void)
+{
+	const struct CMUnitTest tests[] = {
+#if CONFIG_FORMAT_S16LE && CONFIG_FORMAT_S24LE
+		cmocka_unit_test(test_pcm_adapter_convert_source),
+		cmocka_unit_test(test_pcm_adapter_convert_sink),
+		cmocka_unit_test(test_pcm_adapter_many_channels),
+#endif /* CONFIG_FORMAT_S16LE && CONFIG_FORMAT_S24LE */
+#if CONFIG_FORMAT_S16LE && CONFIG_FORMAT_S24LE && CONFIG_FORMAT_S32LE
+		cmocka_unit_test(test_pcm_adapter_convert_both),
+#endif /* CONFIG_FORMAT_S16LE && CONFIG_FORMAT_S24LE && CONFIG_FORMAT_S32LE */
+		cmocka_unit_test(test_pcm_adapter_unsupported),
+	};
+
+	cmocka_set_message_output(CM_OUTPUT_TAP);
+
+	return cmocka_run_group_tests(tests, NULL, NULL);
+}
@@ -16,6 +16,7 @@
 #include <stddef.h>
 #include <setjmp.h>
 #include <math.h>
+#include <float.h>
 #include <malloc.h>
 #include <stdint.h>
 #include <cmocka.h>
@@ -94,6 +95,28 @@ static void free_test_buffer(struct audio_stream *buf)
 	free(buf);
 }
 
+/* all variants of a conversion in the map must be bit exact */
+static void _test_pcm_convert_variants(const struct audio_stream *source,
+				       const struct audio_stream *sink,
+				       pcm_converter_func fun, int samples)
+{
+	struct audio_stream *other;
+	const int bytes = samples * get_sample_bytes(sink->frame_fmt);
+	int i;
+
+	for (i = 0; i < pcm_func_count; i++) {
+		if (pcm_func_map[i].source != source->frame_fmt ||
+		    pcm_func_map[i].sink != sink->frame_fmt ||
+		    pcm_func_map[i].func == fun)
+			continue;
+
+		other = create_test_buffer(sink->frame_fmt, bytes);
+		pcm_func_map[i].func(source, 0, other, 0, samples);
+		assert_memory_equal(other->w_ptr, sink->w_ptr, bytes);
+		free_test_buffer(other);
+	}
+}
+
 static struct audio_stream *_test_pcm_convert(enum sof_ipc_frame frm_in,
 					      enum sof_ipc_frame frm_out,
 					      int samples, const void *data)
@@ -125,6 +148,8 @@ static struct audio_stream *_test_pcm_convert(enum sof_ipc_frame frm_in,
 	/* assert last value in sink is untouched */
 	assert_int_equal(((uint8_t *)sink->w_ptr)[outbytes - 1], fillval);
 
+	_test_pcm_convert_variants(source, sink, fun, samples);
+
 	/* free source and return sink */
 	free_test_buffer(source);
 	return sink;
@@ -222,6 +247,46 @@ static void test_pcm_convert_f_to_s16(void **state)
 	/* free memory */
 	free_test_buffer(sink);
 }
+
+static void test_pcm_convert_f_to_s16_edge(void **state)
+{
+	/* not scaled, 1.0 is the full scale */
+	static const float source_buf[] = {
+		0.5f, -0.5f, 0.99996948f, -0.99996948f,
+		0.99998474f, -0.99998474f, 1.0f, -1.0f,
+		2147483648.0f, -2147483648.0f, FLT_MAX, -FLT_MAX,
+		INFINITY, -INFINITY, NAN, -NAN,
+	};
+	/* NaN saturates by its sign like the other values out of range */
+	static const int16_t expected_buf[] = {
+		1 << 14, -(1 << 14), INT16_MAX, -INT16_MAX,
+		INT16_MAX, INT16_MIN, INT16_MAX, INT16_MIN,
+		INT16_MAX, INT16_MIN, INT16_MAX, INT16_MIN,
+		INT16_MAX, INT16_MIN, INT16_MAX, INT16_MIN,
+	};
+
+	struct audio_stream *sink;
+	int i, N = ARRAY_SIZE(source_buf);
+	int16_t *read_val;
+
+	assert_int_equal(ARRAY_SIZE(source_buf), ARRAY_SIZE(expected_buf));
+
+	/* run test */
+	sink = _test_pcm_convert(SOF_IPC_FRAME_FLOAT, SOF_IPC_FRAME_S16_LE,
+				 N, source_buf);
+
+	/* check results */
+	for (i = 0; i < N; ++i) {
+		read_val = audio_stream_read_frag(sink, i, sizeof(*read_val));
+		print_message("%2d/%02d ", i + 1, N);
+		pcm_float_print_values(*read_val, (int32_t *)&source_buf[i],
+				       (float)expected_buf[i], __func__);
+		assert_int_equal(*read_val, expected_buf[i]);
+	}
+
+	/* free memory */
+	free_test_buffer(sink);
+}
 #endif /* CONFIG_FORMAT_FLOAT && CONFIG_FORMAT_S16LE */
 
 #if CONFIG_FORMAT_FLOAT && CONFIG_FORMAT_S24LE
@@ -538,6 +603,84 @@ static void test_pcm_convert_f_to_s32_big_pos(void **state)
 	/* free memory */
 	free_test_buffer(sink);
 }
+
+static void test_pcm_convert_f_to_s32_round(void **state)
+{
+	typedef float Tin;
+	typedef int32_t Tout;
+	static Tin source_buf[] = {
+		0.5f, -0.5f, 1.5f, -1.5f, 2.5f, -2.5f,
+		0.49999997f, -0.49999997f, 1e-20f, -1e-20f,
+	};
+	/* halves are rounded away from zero */
+	static const Tout expected_buf[] = {
+		1, -1, 2, -2, 3, -3,
+		0, 0, 0, 0,
+	};
+
+	struct audio_stream *sink;
+	int i, N = ARRAY_SIZE(source_buf);
+	Tout *read_val;
+
+	assert_int_equal(ARRAY_SIZE(source_buf), ARRAY_SIZE(expected_buf));
+	scale_array(ratio32, source_buf, N);
+
+	/* run test */
+	sink = _test_pcm_convert(SOF_IPC_FRAME_FLOAT, SOF_IPC_FRAME_S32_LE,
+				 N, source_buf);
+
+	/* check results */
+	for (i = 0; i < N; ++i) {
+		read_val = audio_stream_read_frag(sink, i, sizeof(Tout));
+		print_message("%2d/%02d ", i + 1, N);
+		pcm_float_print_values(*read_val, (int32_t *)&source_buf[i],
+				       (float)expected_buf[i], __func__);
+		assert_int_equal(*read_val, expected_buf[i]);
+	}
+
+	/* free memory */
+	free_test_buffer(sink);
+}
+
+static void test_pcm_convert_f_to_s32_edge(void **state)
+{
+	/* not scaled, 1.0 is the full scale */
+	static const float source_buf[] = {
+		0.5f, -0.5f, 0.75f, -0.75f,
+		0.99999994f, -0.99999994f, 1.0f, -1.0f,
+		2147483648.0f, -2147483648.0f, FLT_MAX, -FLT_MAX,
+		INFINITY, -INFINITY, NAN, -NAN,
+	};
+	/* NaN saturates by its sign like the other values out of range */
+	static const int32_t expected_buf[] = {
+		1 << 30, -(1 << 30), 3 << 29, -(3 << 29),
+		INT32_MAX - 127, -INT32_MAX + 127, INT32_MAX, INT32_MIN,
+		INT32_MAX, INT32_MIN, INT32_MAX, INT32_MIN,
+		INT32_MAX, INT32_MIN, INT32_MAX, INT32_MIN,
+	};
+
+	struct audio_stream *sink;
+	int i, N = ARRAY_SIZE(source_buf);
+	int32_t *read_val;
+
+	assert_int_equal(ARRAY_SIZE(source_buf), ARRAY_SIZE(expected_buf));
+
+	/* run test */
+	sink = _test_pcm_convert(SOF_IPC_FRAME_FLOAT, SOF_IPC_FRAME_S32_LE,
+				 N, source_buf);
+
+	/* check results */
+	for (i = 0; i < N; ++i) {
+		read_val = audio_stream_read_frag(sink, i, sizeof(*read_val));
+		print_message("%2d/%02d ", i + 1, N);
+		pcm_float_print_values(*read_val, (int32_t *)&source_buf[i],
+				       (float)expected_buf[i], __func__);
+		assert_int_equal(*read_val, expected_buf[i]);
+	}
+
+	/* free memory */
+	free_test_buffer(sink);
+}
 #endif /* CONFIG_FORMAT_FLOAT && CONFIG_FORMAT_S32LE */
 
 int main(void)
@@ -546,6 +689,7 @@ int main(void)
 #if CONFIG_FORMAT_FLOAT && CONFIG_FORMAT_S16LE
 		cmocka_unit_test(test_pcm_convert_s16_to_f),
 		cmocka_unit_test(test_pcm_convert_f_to_s16),
+		cmocka_unit_test(test_pcm_convert_f_to_s16_edge),
 #endif /* CONFIG_FORMAT_FLOAT && CONFIG_FORMAT_S16LE */
 #if CONFIG_FORMAT_FLOAT && CONFIG_FORMAT_S24LE
 		cmocka_unit_test(test_pcm_convert_s24_to_f),
@@ -557,13 +701,15 @@ int main(void)
 		cmocka_unit_test(test_pcm_convert_f_to_s32),
 		cmocka_unit_test(test_pcm_convert_f_to_s32_big_neg),
 		cmocka_unit_test(test_pcm_convert_f_to_s32_big_pos),
+		cmocka_unit_test(test_pcm_convert_f_to_s32_round),
+		cmocka_unit_test(test_pcm_convert_f_to_s32_edge),
 #endif /* CONFIG_FORMAT_FLOAT && CONFIG_FORMAT_S32LE */
 	};
 
 	cmocka_set_message_output(CM_OUTPUT_TAP);
 
 	/* log number of converting functions for current configuration */
-	print_message("%s start tests, count(pcm_func_map)=%d\n",
+	print_message("%s start tests, count(pcm_func_map)=%zu\n",
 		      __FILE__, pcm_func_count);
 
 	return cmocka_run_group_tests(tests, NULL, NULL);
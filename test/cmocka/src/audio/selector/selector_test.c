@@ -12,6 +12,8 @@
 #include <sof/audio/component.h>
 #include <sof/audio/selector.h>
 
+/* source channels when the configuration leaves the count to the stream */
+#define SEL_STREAM_CHANNELS 2
 
 struct sel_test_state {
 	struct comp_dev *dev;
@@ -31,6 +33,7 @@ struct sel_test_parameters {
 	uint32_t sink_format;
 	void (*verify)(struct comp_dev *dev, struct audio_stream *sink,
 		       struct audio_stream *source);
+	uint32_t wrap_frames;	/**< moves buffer pointers to wrap the data */
 };
 
 static int setup(void **state)
@@ -73,12 +76,24 @@ static int setup(void **state)
 	/* allocate new source buffer */
 	sel_state->source = test_malloc(sizeof(*sel_state->source));
 	sel_state->source->frame_fmt = parameters->source_format;
-	sel_state->source->channels = parameters->in_channels;
+	sel_state->source->channels = parameters->in_channels ?
+				      parameters->in_channels :
+				      SEL_STREAM_CHANNELS;
 	size = parameters->frames * audio_stream_frame_bytes(sel_state->source);
 	pbuff = test_calloc(parameters->buffer_size_ms, size);
 	audio_stream_init(sel_state->source, pbuff,
 			  parameters->buffer_size_ms * size);
 
+	/* start source and sink at different positions before the wrap */
+	size = parameters->wrap_frames *
+	       audio_stream_frame_bytes(sel_state->source);
+	audio_stream_produce(sel_state->source, size);
+	audio_stream_consume(sel_state->source, size);
+	size = parameters->wrap_frames / 2 *
+	       audio_stream_frame_bytes(sel_state->sink);
+	audio_stream_produce(sel_state->sink, size);
+	audio_stream_consume(sel_state->sink, size);
+
 	/* assigns verification function */
 	sel_state->verify = parameters->verify;
 
@@ -108,12 +123,14 @@ static int teardown(void **state)
 #if CONFIG_FORMAT_S16LE
 static void fill_source_s16(struct sel_test_state *sel_state)
 {
-	int16_t *src = (int16_t *)sel_state->source->r_ptr;
+	struct audio_stream *source = sel_state->source;
+	int16_t *src;
 	int i;
 
-	for (i = 0; i < sel_state->source->size / sizeof(int16_t); i++)
-		src[i] = i;
-
+	for (i = 0; i < source->size / sizeof(int16_t); i++) {
+		src = audio_stream_write_frag_s16(source, i);
+		*src = i;
+	}
 }
 
 static void verify_s16le_Xch_to_1ch(struct comp_dev *dev,
@@ -121,23 +138,16 @@ static void verify_s16le_Xch_to_1ch(struct comp_dev *dev,
 				    struct audio_stream *source)
 {
 	struct comp_data *cd = comp_get_drvdata(dev);
-	const uint16_t *src = (uint16_t *)source->r_ptr;
-	const uint16_t *dst = (uint16_t *)sink->w_ptr;
-	uint32_t in_channels = cd->config.in_channels_count;
-	uint32_t channel;
+	uint32_t in_channels = source->channels;
 	uint32_t i;
-	uint32_t j = 0;
-	uint16_t source_in;
-	uint16_t destination;
-
-	for (i = 0; i < source->size / sizeof(uint16_t); i += in_channels) {
-		for (channel = 0; channel < in_channels; channel++) {
-			if (channel == cd->config.sel_channel) {
-				source_in = src[i + cd->config.sel_channel];
-				destination = dst[j++];
-				assert_int_equal(source_in, destination);
-			}
-		}
+	int16_t *source_in;
+	int16_t *destination;
+
+	for (i = 0; i < dev->frames; i++) {
+		source_in = audio_stream_read_frag_s16(source, i * in_channels +
+						       cd->config.sel_channel);
+		destination = audio_stream_read_frag_s16(sink, i);
+		assert_int_equal(*source_in, *destination);
 	}
 }
 
@@ -184,11 +194,14 @@ static void verify_s16le_4ch_to_4ch(struct comp_dev *dev,
 #if CONFIG_FORMAT_S24LE || CONFIG_FORMAT_S32LE
 static void fill_source_s32(struct sel_test_state *sel_state)
 {
-	int32_t *src = (int32_t *)sel_state->source->r_ptr;
+	struct audio_stream *source = sel_state->source;
+	int32_t *src;
 	int i;
 
-	for (i = 0; i < sel_state->source->size / sizeof(int32_t); i++)
-		src[i] = i << 16;
+	for (i = 0; i < source->size / sizeof(int32_t); i++) {
+		src = audio_stream_write_frag_s32(source, i);
+		*src = i << 16;
+	}
 }
 
 static void verify_s32le_Xch_to_1ch(struct comp_dev *dev,
@@ -196,23 +209,16 @@ static void verify_s32le_Xch_to_1ch(struct comp_dev *dev,
 				    struct audio_stream *source)
 {
 	struct comp_data *cd = comp_get_drvdata(dev);
-	const uint32_t *src = (uint32_t *)source->r_ptr;
-	const uint32_t *dst = (uint32_t *)sink->w_ptr;
-	uint32_t in_channels = cd->config.in_channels_count;
-	uint32_t channel;
+	uint32_t in_channels = source->channels;
 	uint32_t i;
-	uint32_t j = 0;
-	uint16_t source_in;
-	uint16_t destination;
-
-	for (i = 0; i < source->size / sizeof(uint32_t); i += in_channels) {
-		for (channel = 0; channel < in_channels; channel++) {
-			if (channel == cd->config.sel_channel) {
-				source_in = src[i + cd->config.sel_channel];
-				destination = dst[j++];
-				assert_int_equal(source_in, destination);
-			}
-		}
+	int32_t *source_in;
+	int32_t *destination;
+
+	for (i = 0; i < dev->frames; i++) {
+		source_in = audio_stream_read_frag_s32(source, i * in_channels +
+						       cd->config.sel_channel);
+		destination = audio_stream_read_frag_s32(sink, i);
+		assert_int_equal(*source_in, *destination);
 	}
 }
 
@@ -292,6 +298,14 @@ static struct sel_test_parameters parameters[] = {
 	{ 4, 4, 0, 48, 1, SOF_IPC_FRAME_S16_LE, SOF_IPC_FRAME_S16_LE, verify_s16le_4ch_to_4ch },
 	{ 2, 1, 0, 48, 1, SOF_IPC_FRAME_S16_LE, SOF_IPC_FRAME_S16_LE, verify_s16le_Xch_to_1ch },
 	{ 4, 1, 0, 48, 1, SOF_IPC_FRAME_S16_LE, SOF_IPC_FRAME_S16_LE, verify_s16le_Xch_to_1ch },
+	/* source and sink wrap in the middle of the data */
+	{ 2, 1, 1, 48, 1, SOF_IPC_FRAME_S16_LE, SOF_IPC_FRAME_S16_LE,
+	  verify_s16le_Xch_to_1ch, 29 },
+	{ 4, 1, 3, 48, 1, SOF_IPC_FRAME_S16_LE, SOF_IPC_FRAME_S16_LE,
+	  verify_s16le_Xch_to_1ch, 45 },
+	/* input channels count from the stream */
+	{ 0, 1, 1, 48, 1, SOF_IPC_FRAME_S16_LE, SOF_IPC_FRAME_S16_LE,
+	  verify_s16le_Xch_to_1ch },
 #endif /* CONFIG_FORMAT_S16LE */
 #if CONFIG_FORMAT_S24LE || CONFIG_FORMAT_S32LE
 	{ 2, 1, 0, 16, 1, SOF_IPC_FRAME_S24_4LE, SOF_IPC_FRAME_S24_4LE, verify_s32le_Xch_to_1ch },
@@ -302,6 +316,12 @@ static struct sel_test_parameters parameters[] = {
 	{ 4, 4, 0, 48, 1, SOF_IPC_FRAME_S24_4LE, SOF_IPC_FRAME_S24_4LE, verify_s32le_4ch_to_4ch },
 	{ 2, 1, 0, 48, 1, SOF_IPC_FRAME_S24_4LE, SOF_IPC_FRAME_S24_4LE, verify_s32le_Xch_to_1ch },
 	{ 4, 1, 0, 48, 1, SOF_IPC_FRAME_S24_4LE, SOF_IPC_FRAME_S24_4LE, verify_s32le_Xch_to_1ch },
+	{ 2, 1, 1, 48, 1, SOF_IPC_FRAME_S32_LE, SOF_IPC_FRAME_S32_LE,
+	  verify_s32le_Xch_to_1ch, 29 },
+	{ 4, 1, 3, 48, 1, SOF_IPC_FRAME_S32_LE, SOF_IPC_FRAME_S32_LE,
+	  verify_s32le_Xch_to_1ch, 45 },
+	{ 0, 1, 1, 48, 1, SOF_IPC_FRAME_S32_LE, SOF_IPC_FRAME_S32_LE,
+	  verify_s32le_Xch_to_1ch },
 #endif /* CONFIG_FORMAT_S24LE || CONFIG_FORMAT_S32LE */
 };
 
@@ -0,0 +1,258 @@
+// SPDX-License-Identifier: BSD-3-Clause
+//
+// Copyright(c) 2020 Intel Corporation. All rights reserved.
+
+#include <sof/audio/src/src.h>
+#include <sof/audio/src/src_config.h>
+#include <sof/audio/src/src_design.h>
+
+#include <errno.h>
+#include <math.h>
+#include <stdarg.h>
+#include <stddef.h>
+#include <setjmp.h>
+#include <stdint.h>
+#include <stdlib.h>
+#include <cmocka.h>
+
+#if SRC_SHORT
+#define TEST_COEF_Q	15
+#else
+#define TEST_COEF_Q	31
+#endif
+
+/* Stop-band attenuation and passband gain tolerances in dB */
+#define TEST_STOPBAND_DB	-69.0
+#define TEST_GAIN_TOL_DB	0.05
+
+static double test_coef(struct src_stage *stage, int n)
+{
+	int subfilter = n % stage->num_of_subfilters;
+	int tap = n / stage->num_of_subfilters;
+	int i = subfilter * stage->subfilter_length + tap;
+#if SRC_SHORT
+	double c = ((const int16_t *)stage->coefs)[i];
+#else
+	double c = ((const int32_t *)stage->coefs)[i];
+#endif
+
+	return c / ldexp(1.0, TEST_COEF_Q + stage->shift);
+}
+
+/* Magnitude in dB of the stage filter at frequency f normalized to the
+ * interpolated rate, the gain of L is removed.
+ */
+static double test_response_db(struct src_stage *stage, double f)
+{
+	double re = 0;
+	double im = 0;
+	int n;
+
+	for (n = 0; n < stage->filter_length; n++) {
+		re += test_coef(stage, n) * cos(2 * M_PI * f * n);
+		im -= test_coef(stage, n) * sin(2 * M_PI * f * n);
+	}
+
+	return 20 * log10(sqrt(re * re + im * im) / stage->num_of_subfilters);
+}
+
+/* Checks stage dimensions, stop-band from Nyquist frequency of the lower
+ * rate and the gain at 0 Hz.
+ */
+static void test_stage(struct src_stage *stage, int fs1, int fs2,
+		       double gain_db)
+{
+	int fs3 = fs1 * stage->num_of_subfilters;
+	double f_sb = 0.5 * (fs1 < fs2 ? fs1 : fs2) / fs3;
+	double f;
+
+	if (stage->filter_length == 1) {
+		assert_int_equal(fs1, fs2);
+		return;
+	}
+
+	assert_int_equal(fs1 * stage->blk_out, fs2 * stage->blk_in);
+	assert_int_equal(stage->num_of_subfilters, stage->blk_out);
+	assert_int_equal(stage->subfilter_length % 4, 0);
+	assert_int_equal(stage->filter_length,
+			 stage->subfilter_length * stage->num_of_subfilters);
+	if (stage->blk_in > 1 && stage->blk_out > 1)
+		assert_int_equal(-stage->idm * stage->blk_out +
+				 stage->odm * stage->blk_in, 1);
+
+	assert_true(fabs(test_response_db(stage, 0) - gain_db) <
+		    TEST_GAIN_TOL_DB);
+
+	for (f = f_sb; f < 0.5; f += 0.1 * f_sb)
+		assert_true(test_response_db(stage, f) < TEST_STOPBAND_DB);
+}
+
+static void test_conversion(int fs_in, int fs_out)
+{
+	struct src_design *design;
+	int fs3;
+
+	assert_int_equal(src_design_get(&design, fs_in, fs_out,
+					SRC_DESIGN_QUALITY_DEFAULT), 0);
+	assert_non_null(design);
+
+	fs3 = fs_in / design->stage1.blk_in * design->stage1.blk_out;
+	if (design->stage2.filter_length == 1) {
+		assert_int_equal(fs3, fs_out);
+		test_stage(&design->stage1, fs_in, fs3, -1.0);
+	} else {
+		test_stage(&design->stage1, fs_in, fs3, -0.5);
+		test_stage(&design->stage2, fs3, fs_out, -0.5);
+	}
+
+	src_design_put(design);
+}
+
+static void test_src_design_48000_37800(void **state)
+{
+	(void)state;
+
+	test_conversion(48000, 37800);
+}
+
+static void test_src_design_37800_48000(void **state)
+{
+	(void)state;
+
+	test_conversion(37800, 48000);
+}
+
+static void test_src_design_44100_32000(void **state)
+{
+	(void)state;
+
+	test_conversion(44100, 32000);
+}
+
+static void test_src_design_192000_96000(void **state)
+{
+	(void)state;
+
+	test_conversion(192000, 96000);
+}
+
+static void test_src_design_16000_12000(void **state)
+{
+	(void)state;
+
+	test_conversion(16000, 12000);
+}
+
+static void test_src_design_same_rate(void **state)
+{
+	(void)state;
+
+	test_conversion(96000, 96000);
+}
+
+/* Factors over the stage limit can't be designed */
+static void test_src_design_invalid(void **state)
+{
+	struct src_design *design;
+
+	(void)state;
+
+	assert_int_equal(src_design_get(&design, 48000, 47999,
+					SRC_DESIGN_QUALITY_DEFAULT), -EINVAL);
+	assert_null(design);
+}
+
+/* Two users of the same conversion share one design, it stays cached
+ * after the last user releases it.
+ */
+static void test_src_design_shared(void **state)
+{
+	struct src_design *design1;
+	struct src_design *design2;
+	struct src_design *again;
+
+	(void)state;
+
+	assert_int_equal(src_design_get(&design1, 48000, 37800,
+					SRC_DESIGN_QUALITY_DEFAULT), 0);
+	assert_int_equal(src_design_get(&design2, 48000, 37800,
+					SRC_DESIGN_QUALITY_DEFAULT), 0);
+	assert_non_null(design1);
+	assert_ptr_equal(design1, design2);
+	assert_int_equal(design1->refs, 2);
+
+	src_design_put(design1);
+	src_design_put(design2);
+	assert_int_equal(design2->refs, 0);
+
+	assert_int_equal(src_design_get(&again, 48000, 37800,
+					SRC_DESIGN_QUALITY_DEFAULT), 0);
+	assert_ptr_equal(again, design1);
+	src_design_put(again);
+
+	/* A different quality is a different design */
+	assert_int_equal(src_design_get(&again, 48000, 37800,
+					SRC_DESIGN_QUALITY_DEFAULT - 10), 0);
+	assert_ptr_not_equal(again, design1);
+	src_design_put(again);
+}
+
+/* In use designs are not evicted, the least recently used is */
+static void test_src_design_cache(void **state)
+{
+	struct src_design *design[SRC_DESIGN_CACHE_SIZE + 1];
+	struct src_design *again;
+	int i;
+
+	(void)state;
+
+	for (i = 0; i < SRC_DESIGN_CACHE_SIZE; i++)
+		assert_int_equal(src_design_get(&design[i], 48000,
+						12600 + 6300 * i,
+						SRC_DESIGN_QUALITY_DEFAULT), 0);
+
+	assert_int_equal(src_design_get(&again, 48000, 12600,
+					SRC_DESIGN_QUALITY_DEFAULT), 0);
+	assert_ptr_equal(again, design[0]);
+	src_design_put(again);
+
+	assert_int_equal(src_design_get(&design[i], 48000, 44800,
+					SRC_DESIGN_QUALITY_DEFAULT), -EBUSY);
+	assert_null(design[i]);
+
+	/* Release one, the least recently used free entry gets replaced */
+	src_design_put(design[1]);
+	assert_int_equal(src_design_get(&design[i], 48000, 44800,
+					SRC_DESIGN_QUALITY_DEFAULT), 0);
+
+	for (i = 0; i <= SRC_DESIGN_CACHE_SIZE; i++) {
+		if (i != 1)
+			src_design_put(design[i]);
+	}
+}
+
+static int test_group_setup(void **state)
+{
+	src_design_init();
+
+	return 0;
+}
+
+int main(void)
+{
+	const struct CMUnitTest tests[] = {
+		cmocka_unit_test(test_src_design_48000_37800),
+		cmocka_unit_test(test_src_design_37800_48000),
+		cmocka_unit_test(test_src_design_44100_32000),
+		cmocka_unit_test(test_src_design_192000_96000),
+		cmocka_unit_test(test_src_design_16000_12000),
+		cmocka_unit_test(test_src_design_same_rate),
+		cmocka_unit_test(test_src_design_invalid),
+		cmocka_unit_test(test_src_design_shared),
+		cmocka_unit_test(test_src_design_cache),
+	};
+
+	cmocka_set_message_output(CM_OUTPUT_TAP);
+
+	return cmocka_run_group_tests(tests, test_group_setup, NULL);
+}
@@ -0,0 +1,226 @@
+// SPDX-License-Identifier: BSD-3-Clause
+//
+// Copyright(c) 2020 Intel Corporation. All rights reserved.
+
+#include <stdarg.h>
+#include <stddef.h>
+#include <setjmp.h>
+#include <stdint.h>
+#include <stdlib.h>
+#include <string.h>
+#include <math.h>
+#include <cmocka.h>
+
+/* The two stage copy functions are static, test them in place. The module
+ * init is not used without DECLARE_MODULE() in unit tests.
+ */
+#pragma GCC diagnostic push
+#pragma GCC diagnostic ignored "-Wunused-function"
+#include "src/src.c"
+#pragma GCC diagnostic pop
+
+#define TEST_CHANNELS	2
+#define TEST_COPIES	400
+
+/* The buffers hold a non integer number of periods so that they wrap */
+#define TEST_BUFFER_FRAMES(period)	((period) * 3 + 7)
+
+struct test_config {
+	int fs_in;
+	int fs_out;
+	int sink_frames;	/* Sink period, not a multiple of the blocks */
+};
+
+struct test_src {
+	struct comp_dev dev;
+	struct comp_data cd;
+	struct comp_buffer source;
+	struct comp_buffer sink;
+};
+
+static void test_stream_init(struct comp_buffer *buf, int frames)
+{
+	size_t size = frames * TEST_CHANNELS * sizeof(int32_t);
+
+	memset(buf, 0, sizeof(*buf));
+	audio_stream_init(&buf->stream, calloc(1, size), size);
+	buf->stream.channels = TEST_CHANNELS;
+	buf->stream.frame_fmt = SOF_IPC_FRAME_S32_LE;
+}
+
+/* Sets up the component data as src_params() and src_prepare() do. With
+ * fused cleared the stage buffer gets the two periods length of src_2s().
+ */
+static void test_src_setup(struct test_src *t, const struct test_config *cfg,
+			   int fused)
+{
+	struct comp_dev *dev = &t->dev;
+	struct comp_data *cd = &t->cd;
+	struct src_param *p = &cd->param;
+	int source_frames;
+	int r1;
+
+	memset(t, 0, sizeof(*t));
+	comp_set_drvdata(dev, cd);
+
+	source_frames = cfg->sink_frames * cfg->fs_in / cfg->fs_out;
+	cd->source_rate = cfg->fs_in;
+	cd->sink_rate = cfg->fs_out;
+	cd->source_frames = source_frames;
+	cd->sink_frames = cfg->sink_frames;
+	cd->sample_container_bytes = sizeof(int32_t);
+	cd->data_shift = 0;
+	cd->polyphase_func = src_polyphase_stage_cir;
+
+	assert_int_equal(src_buffer_lengths(p, cfg->fs_in, cfg->fs_out,
+					    TEST_CHANNELS, source_frames), 0);
+	assert_int_equal(p->fused, 1);
+	if (!fused) {
+		r1 = source_frames / p->stage1->blk_in + 1;
+		p->sbuf_length = 2 * TEST_CHANNELS * p->stage1->blk_out * r1;
+		p->total = p->sbuf_length + p->src_multich;
+		p->fused = 0;
+	}
+
+	cd->delay_lines = calloc(p->total, sizeof(int32_t));
+	assert_int_equal(src_polyphase_init(&cd->src, p, cd->delay_lines +
+					    p->sbuf_length), 2);
+	cd->sbuf_r_ptr = cd->delay_lines;
+	cd->sbuf_w_ptr = cd->delay_lines;
+	cd->sbuf_avail = 0;
+	cd->src_func = fused ? src_2s_fused : src_2s;
+
+	test_stream_init(&t->source, TEST_BUFFER_FRAMES(source_frames + 1));
+	test_stream_init(&t->sink, TEST_BUFFER_FRAMES(cfg->sink_frames));
+}
+
+static void test_src_free(struct test_src *t)
+{
+	free(t->source.stream.addr);
+	free(t->sink.stream.addr);
+	free(t->cd.delay_lines);
+#if CONFIG_COMP_SRC_DESIGN
+	src_design_put(t->cd.param.design);
+#endif
+}
+
+/* Writes frames of a sine to the source */
+static void test_produce(struct test_src *t, int frames, int *n)
+{
+	struct audio_stream *s = &t->source.stream;
+	int32_t *x;
+	int i;
+
+	frames = MIN(frames, (int)audio_stream_get_free_frames(s));
+	for (i = 0; i < frames * TEST_CHANNELS; i++) {
+		x = audio_stream_write_frag_s32(s, i);
+		*x = 1500000000.0 * sin(0.0123 * (*n + i / TEST_CHANNELS) +
+					i % TEST_CHANNELS);
+	}
+
+	*n += frames;
+	audio_stream_produce(s, frames * audio_stream_frame_bytes(s));
+}
+
+/* One copy as src_copy() does it, returns consumed and produced frames */
+static void test_copy(struct test_src *t, int *consumed, int *produced)
+{
+	struct comp_data *cd = &t->cd;
+
+	*consumed = 0;
+	*produced = 0;
+	if (src_get_copy_limits(cd, &t->source, &t->sink))
+		return;
+
+	cd->src_func(&t->dev, &t->source.stream, &t->sink.stream,
+		     consumed, produced);
+	audio_stream_consume(&t->source.stream, *consumed *
+			     audio_stream_frame_bytes(&t->source.stream));
+	audio_stream_produce(&t->sink.stream, *produced *
+			     audio_stream_frame_bytes(&t->sink.stream));
+}
+
+/* Reads a period from the sink of both and checks that they are equal */
+static void test_consume(struct test_src *fused, struct test_src *ref,
+			 int frames)
+{
+	struct audio_stream *s1 = &fused->sink.stream;
+	struct audio_stream *s2 = &ref->sink.stream;
+	int32_t *y1;
+	int32_t *y2;
+	int i;
+
+	frames = MIN(frames, (int)audio_stream_get_avail_frames(s1));
+	for (i = 0; i < frames * TEST_CHANNELS; i++) {
+		y1 = audio_stream_read_frag_s32(s1, i);
+		y2 = audio_stream_read_frag_s32(s2, i);
+		assert_int_equal(*y1, *y2);
+	}
+
+	audio_stream_consume(s1, frames * audio_stream_frame_bytes(s1));
+	audio_stream_consume(s2, frames * audio_stream_frame_bytes(s2));
+}
+
+static void test_src_fused(void **state)
+{
+	const struct test_config *cfg = *state;
+	struct test_src *fused = malloc(sizeof(*fused));
+	struct test_src *ref = malloc(sizeof(*ref));
+	int consumed_fused;
+	int produced_fused;
+	int consumed_ref;
+	int produced_ref;
+	int produced = 0;
+	int n_fused = 0;
+	int n_ref = 0;
+	int frames;
+	int i;
+
+	test_src_setup(fused, cfg, 1);
+	test_src_setup(ref, cfg, 0);
+
+	for (i = 0; i < TEST_COPIES; i++) {
+		/* Source frames arrive at the input rate, the count varies
+		 * per period.
+		 */
+		frames = (int64_t)(i + 1) * cfg->sink_frames * cfg->fs_in /
+			 cfg->fs_out - (int64_t)i * cfg->sink_frames *
+			 cfg->fs_in / cfg->fs_out;
+		test_produce(fused, frames, &n_fused);
+		test_produce(ref, frames, &n_ref);
+		assert_int_equal(n_fused, n_ref);
+
+		test_copy(fused, &consumed_fused, &produced_fused);
+		test_copy(ref, &consumed_ref, &produced_ref);
+		assert_int_equal(consumed_fused, consumed_ref);
+		assert_int_equal(produced_fused, produced_ref);
+		produced += produced_fused;
+
+		test_consume(fused, ref, cfg->sink_frames);
+	}
+
+	/* Nearly all copies produced output */
+	assert_true(produced > (TEST_COPIES - 4) * cfg->sink_frames);
+
+	test_src_free(fused);
+	test_src_free(ref);
+	free(fused);
+	free(ref);
+}
+
+static const struct test_config test_44100_48000 = { 44100, 48000, 50 };
+static const struct test_config test_48000_44100 = { 48000, 44100, 47 };
+
+int main(void)
+{
+	const struct CMUnitTest tests[] = {
+		cmocka_unit_test_prestate(test_src_fused,
+					  (void *)&test_44100_48000),
+		cmocka_unit_test_prestate(test_src_fused,
+					  (void *)&test_48000_44100),
+	};
+
+	cmocka_set_message_output(CM_OUTPUT_TAP);
+
+	return cmocka_run_group_tests(tests, NULL, NULL);
+}
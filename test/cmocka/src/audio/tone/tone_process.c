@@ -0,0 +1,196 @@
+// SPDX-License-Identifier: BSD-3-Clause
+//
+// Copyright(c) 2020 Intel Corporation. All rights reserved.
+
+#include <stdarg.h>
+#include <stddef.h>
+#include <setjmp.h>
+#include <stdint.h>
+#include <stdlib.h>
+#include <string.h>
+#include <math.h>
+#include <cmocka.h>
+
+/* The tone generator functions are static, test them in place. The
+ * module init is not used without DECLARE_MODULE() in unit tests.
+ */
+#pragma GCC diagnostic push
+#pragma GCC diagnostic ignored "-Wunused-function"
+#include "tone.c"
+#pragma GCC diagnostic pop
+
+#define TEST_CHANNELS	2
+#define TEST_TIME_MS	200
+
+/* -115 dBFS of Q1.31 full scale */
+#define TEST_ERROR_MAX	(2147483648.0 * 1.778279410038923e-6)
+
+/* The sweep repeats with the tone period, the ramp is per 125 us block */
+#define TEST_SWEEP_LENGTH	40
+#define TEST_SWEEP_PERIOD	60
+#define TEST_SWEEP_REPEATS	20
+
+struct test_config {
+	int fs;
+	bool sweep;
+};
+
+static void test_tone_setup(struct comp_data *cd, const struct test_config *cfg)
+{
+	struct tone_state *sg;
+	int ret;
+	int ch;
+
+	memset(cd, 0, sizeof(*cd));
+	cd->channels = TEST_CHANNELS;
+	for (ch = 0; ch < TEST_CHANNELS; ch++) {
+		sg = &cd->sg[ch];
+		tonegen_reset(sg);
+		if (cfg->sweep) {
+			tonegen_set_freq_mult(sg, Q_CONVERT_FLOAT(1.05, 30));
+			tonegen_set_ampl_mult(sg, Q_CONVERT_FLOAT(0.95, 30));
+			tonegen_set_length(sg, TEST_SWEEP_LENGTH);
+			tonegen_set_period(sg, TEST_SWEEP_PERIOD);
+			tonegen_set_repeats(sg, TEST_SWEEP_REPEATS);
+			tonegen_set_linramp(sg, TONE_GAIN(0.01));
+		}
+
+		/* The swept frequencies stay below 8 kHz Nyquist */
+		ret = tonegen_init(sg, cfg->fs, TONE_FREQ(997.0 + 502.0 * ch),
+				   TONE_GAIN(0.9));
+		assert_int_equal(ret, 0);
+	}
+}
+
+/*
+ * Reference with the per sample control of the original generator: the
+ * sample counter is incremented for every sample and the 125 us block
+ * update is run when it reaches samples_in_block. The sine is computed
+ * in double precision from the phase accumulator.
+ */
+static void test_ref_tone(struct comp_data *ref, double *out, uint32_t frames)
+{
+	struct tone_state *sg;
+	uint32_t i;
+	int64_t w;
+	int ch;
+
+	for (ch = 0; ch < ref->channels; ch++) {
+		sg = &ref->sg[ch];
+		for (i = 0; i < frames; i++) {
+			sg->sample_count++;
+			if (sg->sample_count >= sg->samples_in_block)
+				tonegen_control(sg);
+
+			out[i * ref->channels + ch] = sg->mute ? 0.0 :
+				(double)sg->a * sin(sg->w / 268435456.0);
+
+			w = (int64_t)sg->w + sg->w_step;
+			sg->w = w > PI_MUL2_Q4_28 ?
+				(int32_t)(w - PI_MUL2_Q4_28) : (int32_t)w;
+		}
+	}
+}
+
+static void test_tone(void **state)
+{
+	const struct test_config *cfg = *state;
+	struct comp_dev *dev = calloc(1, sizeof(*dev));
+	struct comp_data *cd = calloc(1, sizeof(*cd));
+	struct comp_data *ref = calloc(1, sizeof(*ref));
+	struct audio_stream sink;
+	double *ref_out;
+	double err_max = 0;
+	double err;
+	int32_t peak = 0;
+	int32_t *buf;
+	int32_t x;
+	int frames_max = cfg->fs / 1000 + 7;
+	int copies = TEST_TIME_MS;
+	int frames;
+	int size;
+	int c;
+	int i;
+
+	assert_non_null(dev);
+	assert_non_null(cd);
+	assert_non_null(ref);
+	comp_set_drvdata(dev, cd);
+	test_tone_setup(cd, cfg);
+	test_tone_setup(ref, cfg);
+
+	ref_out = calloc(frames_max * TEST_CHANNELS, sizeof(double));
+	assert_non_null(ref_out);
+
+	/* Sink that is not a multiple of the copy size so that it wraps */
+	size = (frames_max * 3 + 5) * TEST_CHANNELS * sizeof(int32_t);
+	buf = malloc(size);
+	assert_non_null(buf);
+	memset(&sink, 0, sizeof(sink));
+	sink.frame_fmt = SOF_IPC_FRAME_S32_LE;
+	sink.channels = TEST_CHANNELS;
+	audio_stream_init(&sink, buf, size);
+
+	/* Copy sizes vary around 1 ms and do not align with the blocks */
+	for (c = 0; c < copies; c++) {
+		frames = frames_max - (c % 3) * 5;
+		tone_s32_default(dev, &sink, frames);
+		test_ref_tone(ref, ref_out, frames);
+
+		for (i = 0; i < frames * TEST_CHANNELS; i++) {
+			x = *(int32_t *)audio_stream_write_frag_s32(&sink, i);
+			err = fabs(x - ref_out[i]);
+			err_max = MAX(err_max, err);
+			peak = MAX(peak, abs(x));
+		}
+
+		audio_stream_produce(&sink, frames * TEST_CHANNELS *
+				     sizeof(int32_t));
+		audio_stream_consume(&sink, frames * TEST_CHANNELS *
+				     sizeof(int32_t));
+	}
+
+	print_message("fs %d sweep %d error %.1f dBFS\n", cfg->fs, cfg->sweep,
+		      20 * log10(err_max / 2147483648.0 + 1e-20));
+	assert_true(peak > TONE_GAIN(0.1));
+	assert_true(err_max < TEST_ERROR_MAX);
+
+	free(buf);
+	free(ref_out);
+	free(ref);
+	free(cd);
+	free(dev);
+}
+
+static struct test_config configs[] = {
+	{ 8000, false },
+	{ 8000, true },
+	{ 16000, false },
+	{ 16000, true },
+	{ 44100, false },
+	{ 44100, true },
+	{ 48000, false },
+	{ 48000, true },
+	{ 96000, false },
+	{ 96000, true },
+	{ 192000, false },
+	{ 192000, true },
+};
+
+int main(void)
+{
+	struct CMUnitTest tests[ARRAY_SIZE(configs)];
+	int i;
+
+	for (i = 0; i < ARRAY_SIZE(configs); i++) {
+		tests[i].name = "test_tone";
+		tests[i].test_func = test_tone;
+		tests[i].setup_func = NULL;
+		tests[i].teardown_func = NULL;
+		tests[i].initial_state = &configs[i];
+	}
+
+	cmocka_set_message_output(CM_OUTPUT_TAP);
+
+	return cmocka_run_group_tests(tests, NULL, NULL);
+}
@@ -8,6 +8,7 @@
 #include <stddef.h>
 #include <setjmp.h>
 #include <stdint.h>
+#include <stdlib.h>
 #include <cmocka.h>
 #include <sof/audio/component.h>
 #include <sof/audio/volume.h>
@@ -408,6 +409,134 @@ static void test_audio_vol(void **state)
 	vol_state->verify(vol_state->dev, vol_state->sink, vol_state->source);
 }
 
+#if CONFIG_FORMAT_S32LE
+static void test_audio_vol_ramp(void **state)
+{
+	struct vol_test_state *vol_state = *state;
+	struct comp_data *cd = comp_get_drvdata(vol_state->dev);
+	vol_scale_func scale_vol_ramp = vol_get_ramp_function(vol_state->dev);
+	int32_t *src = (int32_t *)vol_state->source->stream.r_ptr;
+	int32_t *dst = (int32_t *)vol_state->sink->stream.w_ptr;
+	int32_t gain[2];
+	int32_t target[2] = { VOL_ZERO_DB, 0 };
+	int32_t inc[2];
+	int channel;
+	int frame;
+	int i;
+
+	assert_non_null(scale_vol_ramp);
+
+	/* Q1.31 input 2^-8 scaled with Q8.16 gain g gives g << 7 */
+	for (i = 0; i < vol_state->dev->frames * 2; i++)
+		src[i] = 1 << 23;
+
+	/* ramp channel 0 up and channel 1 down, both reach the target
+	 * after 32 frames
+	 */
+	for (channel = 0; channel < 2; channel++) {
+		cd->volume[channel] = VOL_ZERO_DB - target[channel];
+		cd->tvolume[channel] = target[channel];
+		gain[channel] = cd->volume[channel] << VOL_RAMP_FRAC_BITS;
+		inc[channel] = ((target[channel] - cd->volume[channel]) <<
+				VOL_RAMP_FRAC_BITS) / 32;
+		cd->ramp_gain[channel] = gain[channel];
+		cd->ramp_frame_inc[channel] = inc[channel];
+	}
+
+	scale_vol_ramp(vol_state->dev, &vol_state->sink->stream,
+		       &vol_state->source->stream, vol_state->dev->frames);
+
+	for (frame = 0; frame < vol_state->dev->frames; frame++) {
+		for (channel = 0; channel < 2; channel++) {
+			assert_int_equal(dst[frame * 2 + channel],
+					 (gain[channel] >> VOL_RAMP_FRAC_BITS)
+					 << 7);
+
+			gain[channel] += inc[channel];
+			if (frame >= 31)
+				gain[channel] = target[channel] <<
+						VOL_RAMP_FRAC_BITS;
+		}
+	}
+
+	for (channel = 0; channel < 2; channel++)
+		assert_int_equal(cd->ramp_gain[channel],
+				 target[channel] << VOL_RAMP_FRAC_BITS);
+}
+
+static struct vol_test_parameters ramp_parameters = {
+	VOL_ZERO_DB, 2, 48, 1, SOF_IPC_FRAME_S32_LE, SOF_IPC_FRAME_S32_LE, NULL
+};
+
+static void test_audio_vol_ramp_slow(void **state)
+{
+	struct vol_test_state *vol_state = *state;
+	struct comp_data *cd = comp_get_drvdata(vol_state->dev);
+	vol_scale_func scale_vol_ramp = vol_get_ramp_function(vol_state->dev);
+	int32_t target[2] = { VOL_ZERO_DB, VOL_ZERO_DB - 6 };
+	int32_t prev[2];
+	int32_t left;
+	int channel;
+	int update;
+
+	assert_non_null(scale_vol_ramp);
+
+	/* 1 ms update interval at 384 kHz, a 6 LSB change with a long
+	 * ramp time gives the minimum step of one LSB per update
+	 */
+	cd->channels = 2;
+	cd->vol_ramp_frames = vol_state->dev->frames;
+	for (channel = 0; channel < 2; channel++) {
+		cd->volume[channel] = VOL_ZERO_DB + VOL_ZERO_DB - 6 -
+				      target[channel];
+		cd->tvolume[channel] = target[channel];
+		cd->ramp_increment[channel] = channel ? -1 : 1;
+		cd->ramp_gain[channel] = 0;
+	}
+
+	/* the ramp advances at least one LSB per update until the target */
+	for (update = 0; update < 6; update++) {
+		volume_ramp_frames_init(vol_state->dev);
+		for (channel = 0; channel < 2; channel++)
+			assert_int_equal(cd->ramp_frame_inc[channel],
+					 cd->ramp_increment[channel]);
+
+		scale_vol_ramp(vol_state->dev, &vol_state->sink->stream,
+			       &vol_state->source->stream,
+			       vol_state->dev->frames);
+
+		for (channel = 0; channel < 2; channel++)
+			prev[channel] = cd->volume[channel];
+
+		volume_ramp_frames_update(vol_state->dev);
+		for (channel = 0; channel < 2; channel++) {
+			if (prev[channel] == target[channel])
+				continue;
+
+			assert_in_range(abs(cd->volume[channel] -
+					    prev[channel]), 1, 2);
+			left = abs(target[channel] - prev[channel]);
+			assert_in_range(abs(target[channel] -
+					    cd->volume[channel]), 0, left - 1);
+		}
+
+		/* not at the target after the first update */
+		if (!update)
+			for (channel = 0; channel < 2; channel++)
+				assert_int_not_equal(cd->volume[channel],
+						     target[channel]);
+	}
+
+	for (channel = 0; channel < 2; channel++)
+		assert_int_equal(cd->volume[channel], target[channel]);
+}
+
+static struct vol_test_parameters ramp_slow_parameters = {
+	VOL_ZERO_DB, 2, 384, 1, SOF_IPC_FRAME_S32_LE, SOF_IPC_FRAME_S32_LE,
+	NULL
+};
+#endif /* CONFIG_FORMAT_S32LE */
+
 static struct vol_test_parameters parameters[] = {
 #if CONFIG_FORMAT_S16LE
 	{ VOL_MAX,        2, 48, 1, SOF_IPC_FRAME_S16_LE,
@@ -435,13 +564,33 @@ static struct vol_test_parameters parameters[] = {
 	{ VOL_MINUS_80DB, 2, 48, 1, SOF_IPC_FRAME_S32_LE,
 		SOF_IPC_FRAME_S32_LE,   verify_s32_to_s24_s32 }, /* 9 */
 #endif /* CONFIG_FORMAT_S32LE */
+
+	/* channels counts that do not divide the gain pattern length */
+#if CONFIG_FORMAT_S16LE
+	{ VOL_MAX,        3, 48, 1, SOF_IPC_FRAME_S16_LE,
+		SOF_IPC_FRAME_S16_LE,   verify_s16_to_s16 }, /* 10 */
+#endif /* CONFIG_FORMAT_S16LE */
+
+#if CONFIG_FORMAT_S24LE
+	{ VOL_ZERO_DB,    6, 47, 1, SOF_IPC_FRAME_S24_4LE,
+		SOF_IPC_FRAME_S24_4LE, verify_s24_to_s24_s32 }, /* 11 */
+#endif /* CONFIG_FORMAT_S24LE */
+
+#if CONFIG_FORMAT_S32LE
+	{ VOL_MINUS_80DB, 5, 47, 1, SOF_IPC_FRAME_S32_LE,
+		SOF_IPC_FRAME_S32_LE,   verify_s32_to_s24_s32 }, /* 12 */
+#endif /* CONFIG_FORMAT_S32LE */
 };
 
 int main(void)
 {
 	int i;
 
+#if CONFIG_FORMAT_S32LE
+	struct CMUnitTest tests[ARRAY_SIZE(parameters) + 2];
+#else
 	struct CMUnitTest tests[ARRAY_SIZE(parameters)];
+#endif
 
 	for (i = 0; i < ARRAY_SIZE(parameters); i++) {
 		tests[i].name = "test_audio_vol";
@@ -451,6 +600,21 @@ int main(void)
 		tests[i].initial_state = &parameters[i];
 	}
 
+#if CONFIG_FORMAT_S32LE
+	tests[i].name = "test_audio_vol_ramp";
+	tests[i].test_func = test_audio_vol_ramp;
+	tests[i].setup_func = setup;
+	tests[i].teardown_func = teardown;
+	tests[i].initial_state = &ramp_parameters;
+	i++;
+
+	tests[i].name = "test_audio_vol_ramp_slow";
+	tests[i].test_func = test_audio_vol_ramp_slow;
+	tests[i].setup_func = setup;
+	tests[i].teardown_func = teardown;
+	tests[i].initial_state = &ramp_slow_parameters;
+#endif /* CONFIG_FORMAT_S32LE */
+
 	cmocka_set_message_output(CM_OUTPUT_TAP);
 
 	return cmocka_run_group_tests(tests, NULL, NULL);
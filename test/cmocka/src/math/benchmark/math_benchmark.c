@@ -0,0 +1,113 @@
+// SPDX-License-Identifier: BSD-3-Clause
+//
+// Copyright(c) 2020 Intel Corporation. All rights reserved.
+
+/* Micro-benchmark of the math functions, compares the time of the scalar
+ * functions called for every value to the array versions. The timings are
+ * only reported, the accuracy of both is checked by the function tests.
+ */
+
+#include <stdint.h>
+#include <stdarg.h>
+#include <stddef.h>
+#include <setjmp.h>
+#include <time.h>
+#include <cmocka.h>
+
+#include <sof/audio/format.h>
+#include <sof/math/decibels.h>
+#include <sof/math/trig.h>
+
+#define BENCH_VALUES	4096
+#define BENCH_REPEATS	64
+
+static int32_t in[BENCH_VALUES];
+static int32_t out[BENCH_VALUES];
+
+typedef int32_t (*bench_scalar_func)(int32_t x);
+typedef void (*bench_array_func)(const int32_t *x, int32_t *y, int n);
+
+static double bench_time_us(clock_t start)
+{
+	return (double)(clock() - start) * 1000000 / CLOCKS_PER_SEC /
+		BENCH_REPEATS;
+}
+
+/* Inputs from min to max with a pseudo random order */
+static void bench_init(int32_t min, int32_t max)
+{
+	uint32_t step = ((int64_t)max - min) / BENCH_VALUES;
+	uint32_t seed = 1;
+	int i;
+
+	for (i = 0; i < BENCH_VALUES; i++) {
+		seed = seed * 1103515245 + 12345;
+		in[i] = min + step * ((seed >> 8) % BENCH_VALUES);
+	}
+}
+
+static void bench_run(const char *name, bench_scalar_func scalar,
+		      bench_array_func array)
+{
+	clock_t start;
+	double t_scalar;
+	double t_array;
+	int i;
+	int j;
+
+	start = clock();
+	for (j = 0; j < BENCH_REPEATS; j++)
+		for (i = 0; i < BENCH_VALUES; i++)
+			out[i] = scalar(in[i]);
+
+	t_scalar = bench_time_us(start);
+
+	start = clock();
+	for (j = 0; j < BENCH_REPEATS; j++)
+		array(in, out, BENCH_VALUES);
+
+	t_array = bench_time_us(start);
+
+	print_message("%s: %d values, scalar %.1f us, array %.1f us, %.2fx\n",
+		      name, BENCH_VALUES, t_scalar, t_array,
+		      t_array > 0 ? t_scalar / t_array : 0);
+}
+
+static void test_math_benchmark_sin_fixed(void **state)
+{
+	(void)state;
+
+	bench_init(0, PI_MUL2_Q4_28);
+	bench_run("sin_fixed", sin_fixed, sin_fixed_v);
+}
+
+static void test_math_benchmark_exp_fixed(void **state)
+{
+	(void)state;
+
+	bench_init(Q_CONVERT_FLOAT(-11.5, EXP_FIXED_INPUT_QY),
+		   Q_CONVERT_FLOAT(7.6, EXP_FIXED_INPUT_QY));
+	bench_run("exp_fixed", exp_fixed, exp_fixed_v);
+}
+
+static void test_math_benchmark_db2lin_fixed(void **state)
+{
+	(void)state;
+
+	bench_init(Q_CONVERT_FLOAT(-100.0, DB2LIN_FIXED_INPUT_QY),
+		   Q_CONVERT_FLOAT(66.0, DB2LIN_FIXED_INPUT_QY));
+	bench_run("db2lin_fixed", db2lin_fixed, db2lin_fixed_v);
+}
+
+int main(void)
+{
+	const struct CMUnitTest tests[] = {
+		cmocka_unit_test(test_math_benchmark_sin_fixed),
+		cmocka_unit_test(test_math_benchmark_exp_fixed),
+		cmocka_unit_test(test_math_benchmark_db2lin_fixed),
+	};
+
+	cmocka_set_message_output(CM_OUTPUT_TAP);
+
+	return cmocka_run_group_tests(tests, NULL, NULL);
+}
@@ -0,0 +1,135 @@
+// SPDX-License-Identifier: BSD-3-Clause
+//
+// Copyright(c) 2020 Intel Corporation. All rights reserved.
+
+#include <stdio.h>
+#include <stdint.h>
+#include <stdarg.h>
+#include <stddef.h>
+#include <setjmp.h>
+#include <math.h>
+#include <cmocka.h>
+
+#include <sof/audio/format.h>
+#include <sof/math/decibels.h>
+
+/* Below -80 dB the Q12.20 output resolution alone exceeds 0.1 dB error */
+#define DB_MIN			-80.0
+#define DB_MAX			66.0
+#define DB_TOLERANCE		0.1
+#define EXP_MIN			-11.5
+#define EXP_MAX			7.6
+#define EXP_REL_TOLERANCE	0.001
+#define EXP_ABS_TOLERANCE	16 /* Q12.20 LSB for small values */
+#define NUM_VALUES		2003
+
+static int32_t in[NUM_VALUES];
+static int32_t out[NUM_VALUES];
+
+/* Evenly spaced input values from min to max in fixed point */
+static void init_values(double min, double max, int qy)
+{
+	int i;
+
+	for (i = 0; i < NUM_VALUES; i++)
+		in[i] = lrint((min + (max - min) * i / (NUM_VALUES - 1)) *
+			      (1 << qy));
+}
+
+/* Zero below -100 dB and saturated above +66.2 dB, as db2lin_fixed() */
+static void test_math_decibels_db2lin_fixed_v_limits(void **state)
+{
+	int i;
+
+	(void)state;
+
+	init_values(-128.0, 127.9, DB2LIN_FIXED_INPUT_QY);
+	db2lin_fixed_v(in, out, NUM_VALUES);
+	for (i = 0; i < NUM_VALUES; i++) {
+		if (in[i] < Q_CONVERT_FLOAT(-100.0, DB2LIN_FIXED_INPUT_QY))
+			assert_int_equal(out[i], 0);
+		else if (in[i] > Q_CONVERT_FLOAT(66.3, DB2LIN_FIXED_INPUT_QY))
+			assert_int_equal(out[i], INT32_MAX);
+		else
+			assert_true(out[i] > 0);
+	}
+}
+
+static void test_math_decibels_db2lin_fixed_v_accuracy(void **state)
+{
+	double db;
+	double diff;
+	int i;
+
+	(void)state;
+
+	init_values(DB_MIN, DB_MAX, DB2LIN_FIXED_INPUT_QY);
+	db2lin_fixed_v(in, out, NUM_VALUES);
+	for (i = 0; i < NUM_VALUES; i++) {
+		db = (double)in[i] / (1 << DB2LIN_FIXED_INPUT_QY);
+		diff = fabs(20 * log10((double)out[i] /
+				       (1 << DB2LIN_FIXED_OUTPUT_QY)) - db);
+		if (diff > DB_TOLERANCE)
+			printf("%s: diff for %.3f dB = %.4f dB\n", __func__,
+			       db, diff);
+
+		assert_true(diff <= DB_TOLERANCE);
+	}
+}
+
+/* Zero below -11.5 and saturated above 7.63, as exp_fixed() */
+static void test_math_decibels_exp_fixed_v_limits(void **state)
+{
+	int i;
+
+	(void)state;
+
+	init_values(-15.9, 15.9, EXP_FIXED_INPUT_QY);
+	exp_fixed_v(in, out, NUM_VALUES);
+	for (i = 0; i < NUM_VALUES; i++) {
+		if (in[i] < Q_CONVERT_FLOAT(-11.5, EXP_FIXED_INPUT_QY))
+			assert_int_equal(out[i], 0);
+		else if (in[i] > Q_CONVERT_FLOAT(7.63, EXP_FIXED_INPUT_QY))
+			assert_int_equal(out[i], INT32_MAX);
+		else
+			assert_true(out[i] > 0);
+	}
+}
+
+static void test_math_decibels_exp_fixed_v_accuracy(void **state)
+{
+	double ref;
+	double diff;
+	int i;
+
+	(void)state;
+
+	init_values(EXP_MIN, EXP_MAX, EXP_FIXED_INPUT_QY);
+	exp_fixed_v(in, out, NUM_VALUES);
+	for (i = 0; i < NUM_VALUES; i++) {
+		ref = exp((double)in[i] / (1 << EXP_FIXED_INPUT_QY)) *
+			(1 << EXP_FIXED_OUTPUT_QY);
+		diff = fabs(out[i] - ref);
+		if (diff > EXP_ABS_TOLERANCE &&
+		    diff > EXP_REL_TOLERANCE * ref)
+			printf("%s: diff for %d = %.1f\n", __func__, in[i],
+			       diff);
+
+		assert_true(diff <= EXP_ABS_TOLERANCE ||
+			    diff <= EXP_REL_TOLERANCE * ref);
+	}
+}
+
+int main(void)
+{
+	const struct CMUnitTest tests[] = {
+		cmocka_unit_test(test_math_decibels_db2lin_fixed_v_limits),
+		cmocka_unit_test(test_math_decibels_db2lin_fixed_v_accuracy),
+		cmocka_unit_test(test_math_decibels_exp_fixed_v_limits),
+		cmocka_unit_test(test_math_decibels_exp_fixed_v_accuracy),
+	};
+
+	cmocka_set_message_output(CM_OUTPUT_TAP);
+
+	return cmocka_run_group_tests(tests, NULL, NULL);
+}
@@ -0,0 +1,119 @@
+// SPDX-License-Identifier: BSD-3-Clause
+//
+// Copyright(c) 2020 Intel Corporation. All rights reserved.
+
+#include <sof/math/fft.h>
+
+#include <errno.h>
+#include <math.h>
+#include <stdarg.h>
+#include <stdbool.h>
+#include <stddef.h>
+#include <setjmp.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <cmocka.h>
+
+/* Max. error relative to largest bin magnitude */
+#define FFT_TOLERANCE_DB	-140.0
+
+static struct icomplex32 twiddle[FFT_SIZE_MAX / 2];
+static struct icomplex32 data[FFT_SIZE_MAX];
+static double ref_real[FFT_SIZE_MAX];
+static double ref_imag[FFT_SIZE_MAX];
+
+/* Compares FFT of random input to DFT computed with doubles */
+static void test_fft_size(int size, bool ifft, double amplitude)
+{
+	struct fft_plan plan;
+	double err = 0;
+	double max = 0;
+	double a;
+	double re;
+	double im;
+	int shift;
+	int i;
+	int k;
+
+	assert_int_equal(fft_twiddle_size(size),
+			 size / 2 * sizeof(struct icomplex32));
+	fft_plan_init(&plan, size, twiddle);
+
+	/* Complex input for IFFT and real for FFT */
+	for (i = 0; i < size; i++) {
+		data[i].real = (rand() - RAND_MAX / 2) * 2 * amplitude;
+		data[i].imag = 0;
+		if (ifft)
+			data[i].imag = (rand() - RAND_MAX / 2) * 2 * amplitude;
+	}
+
+	for (k = 0; k < size; k++) {
+		ref_real[k] = 0;
+		ref_imag[k] = 0;
+		for (i = 0; i < size; i++) {
+			a = (ifft ? 2 : -2) * M_PI * i * k / size;
+			ref_real[k] += data[i].real * cos(a) -
+				data[i].imag * sin(a);
+			ref_imag[k] += data[i].real * sin(a) +
+				data[i].imag * cos(a);
+		}
+	}
+
+	shift = fft_execute_32(&plan, data, ifft);
+
+	for (k = 0; k < size; k++) {
+		re = ldexp(data[k].real, shift) - ref_real[k];
+		im = ldexp(data[k].imag, shift) - ref_imag[k];
+		err = fmax(err, hypot(re, im));
+		max = fmax(max, hypot(ref_real[k], ref_imag[k]));
+	}
+
+	if (20 * log10(err / max) > FFT_TOLERANCE_DB)
+		printf("%s: size %d, error %.1f dB\n", __func__, size,
+		       20 * log10(err / max));
+
+	assert_true(20 * log10(err / max) <= FFT_TOLERANCE_DB);
+}
+
+static void test_math_fft_forward(void **state)
+{
+	int size;
+
+	(void)state;
+
+	for (size = FFT_SIZE_MIN; size <= 2048; size *= 2)
+		test_fft_size(size, false, 1.0);
+}
+
+static void test_math_fft_inverse(void **state)
+{
+	int size;
+
+	(void)state;
+
+	for (size = FFT_SIZE_MIN; size <= 2048; size *= 2)
+		test_fft_size(size, true, 0.01);
+}
+
+static void test_math_fft_invalid_size(void **state)
+{
+	(void)state;
+
+	assert_int_equal(fft_twiddle_size(1), -EINVAL);
+	assert_int_equal(fft_twiddle_size(96), -EINVAL);
+	assert_int_equal(fft_twiddle_size(2 * FFT_SIZE_MAX), -EINVAL);
+}
+
+int main(void)
+{
+	const struct CMUnitTest tests[] = {
+		cmocka_unit_test(test_math_fft_forward),
+		cmocka_unit_test(test_math_fft_inverse),
+		cmocka_unit_test(test_math_fft_invalid_size),
+	};
+
+	cmocka_set_message_output(CM_OUTPUT_TAP);
+
+	return cmocka_run_group_tests(tests, NULL, NULL);
+}
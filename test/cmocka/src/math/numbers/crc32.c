@@ -0,0 +1,103 @@
+// SPDX-License-Identifier: BSD-3-Clause
+//
+// Copyright(c) 2020 Intel Corporation. All rights reserved.
+
+#include <sof/common.h>
+#include <sof/math/numbers.h>
+
+#include <stdarg.h>
+#include <stddef.h>
+#include <setjmp.h>
+#include <stdint.h>
+#include <cmocka.h>
+
+#define TEST_BYTES 1031
+
+static uint8_t test_data[TEST_BYTES + 8];
+
+/* Reference bitwise CRC-32 with the reversed polynomial 0xEDB88320 */
+static uint32_t crc32_ref(uint32_t base, const uint8_t *data, uint32_t bytes)
+{
+	uint32_t crc = ~base;
+	uint32_t i;
+	int j;
+
+	for (i = 0; i < bytes; i++) {
+		crc ^= data[i];
+		for (j = 0; j < 8; j++)
+			crc = crc & 1 ? (crc >> 1) ^ 0xEDB88320 : crc >> 1;
+	}
+
+	return ~crc;
+}
+
+static void fill_test_data(void)
+{
+	uint32_t seed = 1;
+	int i;
+
+	for (i = 0; i < ARRAY_SIZE(test_data); i++) {
+		seed = seed * 1103515245 + 12345;
+		test_data[i] = seed >> 16;
+	}
+}
+
+static void test_math_numbers_crc32_check_value(void **state)
+{
+	(void)state;
+
+	assert_int_equal(crc32(0, "123456789", 9), 0xCBF43926);
+}
+
+static void test_math_numbers_crc32_empty(void **state)
+{
+	(void)state;
+
+	assert_int_equal(crc32(0, test_data, 0), 0);
+	assert_int_equal(crc32(0x12345678, test_data, 0), 0x12345678);
+}
+
+/* All lengths up to TEST_BYTES at every alignment within 8 bytes */
+static void test_math_numbers_crc32_equals_reference(void **state)
+{
+	uint32_t bytes;
+	int offset;
+
+	(void)state;
+
+	fill_test_data();
+	for (offset = 0; offset < 8; offset++)
+		for (bytes = 0; bytes <= TEST_BYTES; bytes++)
+			assert_int_equal(crc32(0, test_data + offset, bytes),
+					 crc32_ref(0, test_data + offset,
+						   bytes));
+}
+
+static void test_math_numbers_crc32_chained(void **state)
+{
+	uint32_t crc;
+	uint32_t split;
+
+	(void)state;
+
+	fill_test_data();
+	for (split = 0; split <= TEST_BYTES; split += 13) {
+		crc = crc32(0, test_data, split);
+		crc = crc32(crc, test_data + split, TEST_BYTES - split);
+		assert_int_equal(crc, crc32_ref(0, test_data, TEST_BYTES));
+	}
+}
+
+int main(void)
+{
+	const struct CMUnitTest tests[] = {
+		cmocka_unit_test(test_math_numbers_crc32_check_value),
+		cmocka_unit_test(test_math_numbers_crc32_empty),
+		cmocka_unit_test(test_math_numbers_crc32_equals_reference),
+		cmocka_unit_test(test_math_numbers_crc32_chained),
+	};
+
+	cmocka_set_message_output(CM_OUTPUT_TAP);
+
+	return cmocka_run_group_tests(tests, NULL, NULL);
+}
@@ -0,0 +1,87 @@
+// SPDX-License-Identifier: BSD-3-Clause
+//
+// Copyright(c) 2020 Intel Corporation. All rights reserved.
+
+#include <stdio.h>
+#include <stdint.h>
+#include <stdarg.h>
+#include <stddef.h>
+#include <setjmp.h>
+#include <math.h>
+#include <cmocka.h>
+
+#include <sof/audio/format.h>
+#include <sof/math/trig.h>
+
+#define CMP_TOLERANCE 0.000005
+#define NUM_ANGLES 4099
+
+static int32_t w[NUM_ANGLES];
+static int32_t sine[NUM_ANGLES];
+
+/* Evenly spaced angles from min to max, the odd count avoids hitting only
+ * multiples of pi/2
+ */
+static void init_angles(int32_t min, int32_t max)
+{
+	int i;
+
+	for (i = 0; i < NUM_ANGLES; i++)
+		w[i] = min + ((int64_t)max - min) * i / (NUM_ANGLES - 1);
+}
+
+static void check_accuracy(const char *name)
+{
+	double diff;
+	int i;
+
+	sin_fixed_v(w, sine, NUM_ANGLES);
+	for (i = 0; i < NUM_ANGLES; i++) {
+		diff = fabs(sin((double)w[i] / (1 << 28)) -
+			    (double)sine[i] / (1U << 31));
+		if (diff > CMP_TOLERANCE)
+			printf("%s: diff for angle %d = %.10f\n", name,
+			       w[i], diff);
+
+		assert_true(diff <= CMP_TOLERANCE);
+	}
+}
+
+static void test_math_trig_sin_fixed_v_accuracy(void **state)
+{
+	(void)state;
+
+	init_angles(0, PI_MUL2_Q4_28);
+	check_accuracy(__func__);
+}
+
+/* Negative angles and angles beyond full turn over the Q4.28 range */
+static void test_math_trig_sin_fixed_v_wrap(void **state)
+{
+	(void)state;
+
+	init_angles(INT32_MIN, INT32_MAX);
+	check_accuracy(__func__);
+}
+
+static void test_math_trig_sin_fixed_v_zero_length(void **state)
+{
+	(void)state;
+
+	sine[0] = 1;
+	sin_fixed_v(w, sine, 0);
+	assert_int_equal(sine[0], 1);
+}
+
+int main(void)
+{
+	const struct CMUnitTest tests[] = {
+		cmocka_unit_test(test_math_trig_sin_fixed_v_accuracy),
+		cmocka_unit_test(test_math_trig_sin_fixed_v_wrap),
+		cmocka_unit_test(test_math_trig_sin_fixed_v_zero_length),
+	};
+
+	cmocka_set_message_output(CM_OUTPUT_TAP);
+
+	return cmocka_run_group_tests(tests, NULL, NULL);
+}
@@ -46,7 +46,9 @@ void *rbrealloc_align(void *ptr, uint32_t flags, uint32_t caps, size_t bytes,
 
 void heap_trace(struct mm_heap *heap, int size)
 {
-	malloc_info(0, stdout);
+	/* heap status is printed when pipelines are completed and freed */
+	if (debug)
+		malloc_info(0, stdout);
 }
 
 void heap_trace_all(int force)
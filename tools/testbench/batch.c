@@ -0,0 +1,407 @@
+// SPDX-License-Identifier: BSD-3-Clause
+//
+// Copyright(c) 2020 Intel Corporation. All rights reserved.
+
+/*
+ * Batch mode for testbench. The jobs of a manifest file are run by a pool of
+ * worker threads, each with its own firmware context. The topology file is
+ * read and the component libraries are loaded only once, every job then
+ * instantiates the pipelines from the topology copy in memory.
+ */
+
+#include <errno.h>
+#include <pthread.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+#include <sof/sof.h>
+#include <sof/drivers/ipc.h>
+#include <tplg_parser/topology.h>
+#include "testbench/common_test.h"
+#include "testbench/batch.h"
+#include "testbench/profile.h"
+#include "testbench/trace.h"
+
+/* read topology file to memory for the workers */
+static int tb_batch_load_topology(struct testbench_prm *tp)
+{
+	FILE *fh;
+	long size;
+	int ret = 0;
+
+	fh = fopen(tp->tplg_file, "rb");
+	if (!fh) {
+		fprintf(stderr, "error: opening file %s\n", tp->tplg_file);
+		return -EINVAL;
+	}
+
+	if (fseek(fh, 0, SEEK_END)) {
+		fprintf(stderr, "error: seek to end of topology\n");
+		ret = -errno;
+		goto out;
+	}
+
+	size = ftell(fh);
+	if (size <= 0 || fseek(fh, 0, SEEK_SET)) {
+		fprintf(stderr, "error: topology size\n");
+		ret = -EINVAL;
+		goto out;
+	}
+
+	tp->tplg_data = malloc(size);
+	if (!tp->tplg_data) {
+		ret = -ENOMEM;
+		goto out;
+	}
+
+	if (fread(tp->tplg_data, size, 1, fh) != 1) {
+		fprintf(stderr, "error: reading topology\n");
+		free(tp->tplg_data);
+		tp->tplg_data = NULL;
+		ret = -EINVAL;
+		goto out;
+	}
+
+	tp->tplg_size = size;
+
+out:
+	fclose(fh);
+	return ret;
+}
+
+/* job from manifest line <input> <output> <format> [<fs_in> [<fs_out>]] */
+static int tb_batch_parse_job(struct tb_batch_job *job,
+			      struct testbench_prm *tp, char *line)
+{
+	char *tokens[5];
+	char *token_line = NULL;
+	char *token;
+	int num = 0;
+	int i;
+
+	/* strip comments */
+	token = strchr(line, '#');
+	if (token)
+		*token = '\0';
+
+	token = strtok_r(line, " \t\r\n", &token_line);
+	while (token && num < ARRAY_SIZE(tokens)) {
+		tokens[num++] = token;
+		token = strtok_r(NULL, " \t\r\n", &token_line);
+	}
+
+	/* empty line */
+	if (!num)
+		return 0;
+
+	if (num < 3 || token) {
+		fprintf(stderr, "error: manifest line %d: job format\n",
+			job->line);
+		return -EINVAL;
+	}
+
+	/* same topology, channels and rates as from command line */
+	job->tp = *tp;
+	job->tp.bits_in = NULL;
+	job->tp.batch_file = NULL;
+	job->tp.input_file_num = 0;
+	job->tp.output_file_num = 0;
+	for (i = 0; i < MAX_INPUT_FILES; i++)
+		job->tp.fr_id[i] = -1;
+
+	for (i = 0; i < MAX_OUTPUT_FILES; i++)
+		job->tp.fw_id[i] = -1;
+
+	job->tp.input_file_num = tb_parse_file_list(tokens[0],
+						    job->tp.input_file,
+						    job->tp.input_widget,
+						    MAX_INPUT_FILES);
+	job->tp.output_file_num = tb_parse_file_list(tokens[1],
+						     job->tp.output_file,
+						     job->tp.output_widget,
+						     MAX_OUTPUT_FILES);
+	if (job->tp.input_file_num <= 0 || job->tp.output_file_num <= 0) {
+		fprintf(stderr, "error: manifest line %d: files\n", job->line);
+		return -EINVAL;
+	}
+
+	job->tp.bits_in = strdup(tokens[2]);
+	job->tp.frame_fmt = find_format(job->tp.bits_in);
+
+	if (num > 3)
+		job->tp.fs_in = atoi(tokens[3]);
+
+	if (num > 4)
+		job->tp.fs_out = atoi(tokens[4]);
+
+	return 1;
+}
+
+/* parse all jobs of manifest */
+static int tb_batch_parse(struct tb_batch *batch, struct testbench_prm *tp)
+{
+	struct tb_batch_job *jobs;
+	char line[TB_BATCH_LINE_LEN];
+	FILE *fh;
+	int line_num = 0;
+	int max = 0;
+	int ret = 0;
+
+	fh = fopen(tp->batch_file, "r");
+	if (!fh) {
+		fprintf(stderr, "error: opening file %s\n", tp->batch_file);
+		return -EINVAL;
+	}
+
+	while (fgets(line, sizeof(line), fh)) {
+		line_num++;
+
+		/* grow job table */
+		if (batch->num_jobs == max) {
+			max = max ? 2 * max : 64;
+			jobs = realloc(batch->jobs, max * sizeof(*jobs));
+			if (!jobs) {
+				ret = -ENOMEM;
+				break;
+			}
+
+			batch->jobs = jobs;
+		}
+
+		memset(&batch->jobs[batch->num_jobs], 0, sizeof(*batch->jobs));
+		batch->jobs[batch->num_jobs].line = line_num;
+		ret = tb_batch_parse_job(&batch->jobs[batch->num_jobs], tp,
+					 line);
+		if (ret < 0)
+			break;
+
+		batch->num_jobs += ret;
+	}
+
+	fclose(fh);
+
+	if (!ret && !batch->num_jobs) {
+		fprintf(stderr, "error: no jobs in %s\n", tp->batch_file);
+		ret = -EINVAL;
+	}
+
+	return ret < 0 ? ret : 0;
+}
+
+/*
+ * Instantiate the topology once in the main thread with the parameters of
+ * the first job but without file I/O. This checks the topology and loads
+ * the component libraries, which register their drivers to the main
+ * firmware context for the workers to copy.
+ */
+static int tb_batch_template(struct sof *sof, struct tb_batch *batch)
+{
+	struct testbench_prm tp = batch->jobs[0].tp;
+	char pipeline[DEBUG_MSG_LEN];
+	int ret;
+	int i;
+
+	for (i = 0; i < tp.input_file_num; i++)
+		tp.input_file[i] = "/dev/null";
+
+	for (i = 0; i < tp.output_file_num; i++)
+		tp.output_file[i] = "/dev/null";
+
+	tp.mmap_input = 0;
+
+	ret = parse_topology(sof, batch->lib_table, &tp, pipeline);
+	if (ret < 0)
+		fprintf(stderr, "error: parsing topology\n");
+	else
+		printf("Test Pipeline:\n%s\n", pipeline);
+
+	tb_free_comps(sof);
+	return ret;
+}
+
+/* take next job from manifest */
+static struct tb_batch_job *tb_batch_next(struct tb_batch *batch)
+{
+	struct tb_batch_job *job = NULL;
+
+	pthread_mutex_lock(&batch->lock);
+	if (batch->next_job < batch->num_jobs)
+		job = &batch->jobs[batch->next_job++];
+	pthread_mutex_unlock(&batch->lock);
+
+	return job;
+}
+
+/* run one job with firmware context of calling thread */
+static int tb_batch_job(struct sof *sof, struct tb_batch *batch,
+			struct tb_batch_job *job)
+{
+	char pipeline[DEBUG_MSG_LEN];
+	int ret;
+
+	ret = parse_topology(sof, batch->lib_table, &job->tp, pipeline);
+	if (ret < 0)
+		fprintf(stderr, "error: manifest line %d: parsing topology\n",
+			job->line);
+	else
+		ret = tb_run(sof, &job->tp, &job->res);
+
+	tb_free_comps(sof);
+	return ret;
+}
+
+static void *tb_batch_worker(void *arg)
+{
+	struct tb_batch *batch = arg;
+	struct tb_batch_job *job;
+	struct sof *sof = sof_get();
+
+	/* trace from several threads would be interleaved */
+	tb_enable_trace(false);
+
+	if (tb_pipeline_setup_worker(sof, batch->parent) < 0)
+		return NULL;
+
+	while ((job = tb_batch_next(batch))) {
+		job->ret = tb_batch_job(sof, batch, job);
+		job->done = 1;
+	}
+
+	tb_pipeline_free_worker(sof);
+	return NULL;
+}
+
+/* print result of each job in manifest order */
+static int tb_batch_print(struct tb_batch *batch, int num_workers,
+			  double t_exec)
+{
+	struct tb_batch_job *job;
+	double t_jobs = 0;
+	int failed = 0;
+	int i;
+
+	printf("==========================================================\n");
+	printf("		           Batch Summary\n");
+	printf("==========================================================\n");
+	printf("line status   in samples out samples   time ms  output\n");
+	for (i = 0; i < batch->num_jobs; i++) {
+		job = &batch->jobs[i];
+		if (!job->done || job->ret < 0) {
+			printf("%4d %-7s %11s %11s %9s  %s\n", job->line,
+			       job->done ? "failed" : "not run", "-", "-", "-",
+			       job->tp.output_file[0]);
+			failed++;
+			continue;
+		}
+
+		printf("%4d %-7s %11d %11d %9.2f  %s\n", job->line, "ok",
+		       job->res.n_in, job->res.n_out, 1e3 * job->res.t_exec,
+		       job->tp.output_file[0]);
+		t_jobs += job->res.t_exec;
+	}
+
+	printf("Jobs: %d, failed: %d, workers: %d\n", batch->num_jobs, failed,
+	       num_workers);
+	printf("Total execution time: %.2f ms, sum of jobs %.2f ms\n",
+	       1e3 * t_exec, 1e3 * t_jobs);
+
+	return failed ? -EINVAL : 0;
+}
+
+static void tb_batch_free(struct tb_batch *batch)
+{
+	struct testbench_prm *tp;
+	int i;
+	int j;
+
+	for (i = 0; i < batch->num_jobs; i++) {
+		tp = &batch->jobs[i].tp;
+		free(tp->bits_in);
+		for (j = 0; j < tp->input_file_num; j++) {
+			free(tp->input_file[j]);
+			free(tp->input_widget[j]);
+		}
+
+		for (j = 0; j < tp->output_file_num; j++) {
+			free(tp->output_file[j]);
+			free(tp->output_widget[j]);
+		}
+	}
+
+	free(batch->jobs);
+}
+
+/* run all jobs of manifest, returns error if any of the jobs failed */
+int tb_batch_run(struct sof *sof, struct testbench_prm *tp,
+		 struct shared_lib_table *lib_table)
+{
+	struct tb_batch batch = { 0 };
+	pthread_t *threads;
+	uint64_t tic, toc;
+	int num_workers = tp->batch_workers;
+	int ret;
+	int i;
+
+	if (tp->profile)
+		printf("warning: -p is not supported in batch mode\n");
+
+	batch.parent = sof;
+	batch.lib_table = lib_table;
+	pthread_mutex_init(&batch.lock, NULL);
+
+	ret = tb_batch_load_topology(tp);
+	if (ret < 0)
+		return ret;
+
+	ret = tb_batch_parse(&batch, tp);
+	if (ret < 0)
+		goto out;
+
+	ret = tb_batch_template(sof, &batch);
+	if (ret < 0)
+		goto out;
+
+	/* one worker per online CPU by default */
+	if (num_workers <= 0)
+		num_workers = sysconf(_SC_NPROCESSORS_ONLN);
+
+	if (num_workers > batch.num_jobs)
+		num_workers = batch.num_jobs;
+
+	if (num_workers <= 0)
+		num_workers = 1;
+
+	threads = calloc(num_workers, sizeof(*threads));
+	if (!threads) {
+		ret = -ENOMEM;
+		goto out;
+	}
+
+	tic = tb_profile_wall_ns();
+
+	for (i = 0; i < num_workers; i++) {
+		if (pthread_create(&threads[i], NULL, tb_batch_worker,
+				   &batch)) {
+			fprintf(stderr, "error: creating worker thread\n");
+			num_workers = i;
+			break;
+		}
+	}
+
+	for (i = 0; i < num_workers; i++)
+		pthread_join(threads[i], NULL);
+
+	toc = tb_profile_wall_ns();
+	free(threads);
+
+	ret = tb_batch_print(&batch, num_workers, 1e-9 * (toc - tic));
+
+out:
+	tb_batch_free(&batch);
+	pthread_mutex_destroy(&batch.lock);
+	free(tp->tplg_data);
+	tp->tplg_data = NULL;
+	return ret;
+}
@@ -21,6 +21,9 @@
 #include <sof/lib/wait.h>
 #include <sof/audio/pipeline.h>
 #include "testbench/common_test.h"
+#include "testbench/file.h"
+#include "testbench/profile.h"
+#include "testbench/trace.h"
 #include <tplg_parser/topology.h>
 
 /* testbench helper functions for pipeline setup and trigger */
@@ -51,35 +54,143 @@ int tb_pipeline_setup(struct sof *sof)
 	return 0;
 }
 
-/* set up pcm params, prepare and trigger pipeline */
-int tb_pipeline_start(struct ipc *ipc, struct sof_ipc_pipe_new *ipc_pipe,
-		      struct testbench_prm *tp)
+/*
+ * Set up another testbench instance for a batch worker thread. The component
+ * drivers were registered to the parent instance when their libraries were
+ * loaded, the worker gets its own list of the same drivers. Pipeline position
+ * offsets are per instance too, instead of the shared platform table.
+ */
+int tb_pipeline_setup_worker(struct sof *sof, struct sof *parent)
 {
-	struct ipc_comp_dev *pcm_dev;
-	struct pipeline *p;
-	struct comp_dev *cd;
+	struct comp_driver_info *info;
+	struct comp_driver_info *drv;
+	struct list_item *clist;
 	int ret;
 
-	/* set up pipeline params */
-	ret = tb_pipeline_params(ipc, ipc_pipe, tp);
-	if (ret < 0) {
-		fprintf(stderr, "error: pipeline params\n");
-		return -EINVAL;
+	sof->comp_drivers = calloc(1, sizeof(*sof->comp_drivers));
+	sof->pipeline_posn = calloc(1, sizeof(*sof->pipeline_posn));
+	if (!sof->comp_drivers || !sof->pipeline_posn) {
+		fprintf(stderr, "error: worker alloc\n");
+		ret = -ENOMEM;
+		goto err;
 	}
 
-	/* Get IPC component device for pipeline */
-	pcm_dev = ipc_get_comp_by_id(ipc, ipc_pipe->sched_id);
-	if (!pcm_dev) {
-		fprintf(stderr, "error: ipc get comp\n");
-		return -EINVAL;
+	list_init(&sof->comp_drivers->list);
+	spinlock_init(&sof->pipeline_posn->lock);
+
+	list_for_item(clist, &parent->comp_drivers->list) {
+		info = container_of(clist, struct comp_driver_info, list);
+		drv = calloc(1, sizeof(*drv));
+		if (!drv) {
+			fprintf(stderr, "error: worker alloc\n");
+			ret = -ENOMEM;
+			goto err;
+		}
+
+		drv->drv = info->drv;
+		comp_register(drv);
+	}
+
+	init_system_notify(sof);
+
+	/* init IPC */
+	if (ipc_init(sof) < 0) {
+		fprintf(stderr, "error: IPC init\n");
+		ret = -EINVAL;
+		goto err;
+	}
+
+	/* init scheduler */
+	if (scheduler_init_edf() < 0) {
+		fprintf(stderr, "error: edf scheduler init\n");
+		ret = -EINVAL;
+		goto err;
 	}
 
-	/* Point to pipeline */
-	cd = pcm_dev->cd;
-	p = pcm_dev->cd->pipeline;
+	return 0;
+
+err:
+	tb_pipeline_free_worker(sof);
+	return ret;
+}
 
-	/* Component prepare */
-	ret = pipeline_prepare(p, cd);
+/*
+ * Free the instance of a batch worker thread, also when it was set up only
+ * partly. The schedulers and notifier are per thread, the instance must be
+ * freed by the thread that set it up.
+ */
+void tb_pipeline_free_worker(struct sof *sof)
+{
+	struct schedulers **schedulers = arch_schedulers_get();
+	struct notify **notify = arch_notify_get();
+	struct schedule_data *sch;
+	struct comp_driver_info *drv;
+	struct list_item *clist;
+	struct list_item *temp;
+
+	if (*schedulers) {
+		schedule_free();
+		list_for_item_safe(clist, temp, &(*schedulers)->list) {
+			sch = container_of(clist, struct schedule_data, list);
+			free(sch);
+		}
+
+		free(*schedulers);
+		*schedulers = NULL;
+	}
+
+	if (sof->ipc) {
+		ipc_free(sof->ipc);
+		sof->ipc = NULL;
+	}
+
+	rfree(*notify);
+	*notify = NULL;
+
+	if (sof->comp_drivers) {
+		list_for_item_safe(clist, temp, &sof->comp_drivers->list) {
+			drv = container_of(clist, struct comp_driver_info,
+					   list);
+			free(drv);
+		}
+
+		free(sof->comp_drivers);
+		sof->comp_drivers = NULL;
+	}
+
+	free(sof->pipeline_posn);
+	sof->pipeline_posn = NULL;
+}
+
+/* set up pcm params, prepare and trigger pipeline */
+int tb_pipeline_start(struct ipc *ipc, struct pipeline *p,
+		      struct testbench_prm *tp)
+{
+	struct comp_dev *cd = p->sched_comp;
+	int ret;
+
+	/*
+	 * Pipelines downstream of an already started one have been configured
+	 * by params and prepare propagation, only trigger those.
+	 */
+	if (cd->state == COMP_STATE_READY) {
+		/* set up pipeline params */
+		ret = tb_pipeline_params(ipc, p, tp);
+		if (ret < 0) {
+			fprintf(stderr, "error: pipeline params\n");
+			return -EINVAL;
+		}
+
+		/* Component prepare */
+		ret = pipeline_prepare(p, cd);
+		if (ret < 0) {
+			fprintf(stderr, "error: pipeline prepare\n");
+			return ret;
+		}
+	}
+
+	if (cd->state != COMP_STATE_PREPARE)
+		return 0;
 
 	/* Start the pipeline */
 	ret = pipeline_trigger(p, cd, COMP_TRIGGER_START);
@@ -90,12 +201,11 @@ int tb_pipeline_start(struct ipc *ipc, struct sof_ipc_pipe_new *ipc_pipe,
 }
 
 /* pipeline pcm params */
-int tb_pipeline_params(struct ipc *ipc, struct sof_ipc_pipe_new *ipc_pipe,
+int tb_pipeline_params(struct ipc *ipc, struct pipeline *p,
 		       struct testbench_prm *tp)
 {
-	struct ipc_comp_dev *pcm_dev;
-	struct pipeline *p;
-	struct comp_dev *cd;
+	struct sof_ipc_pipe_new *ipc_pipe = &p->ipc_pipe;
+	struct comp_dev *cd = p->sched_comp;
 	struct sof_ipc_pcm_params params;
 	char message[DEBUG_MSG_LEN];
 	int fs_period;
@@ -138,27 +248,345 @@ int tb_pipeline_params(struct ipc *ipc, struct sof_ipc_pipe_new *ipc_pipe,
 		return -EINVAL;
 	}
 
-	/* get scheduling component device for pipeline*/
-	pcm_dev = ipc_get_comp_by_id(ipc, ipc_pipe->sched_id);
-	if (!pcm_dev) {
-		fprintf(stderr, "error: ipc get comp\n");
+	/* pipeline params */
+	ret = pipeline_params(p, cd, &params);
+	if (ret < 0)
+		fprintf(stderr, "error: pipeline_params\n");
+
+	return ret;
+}
+
+/* index of pipeline in array or num if not found */
+static int tb_pipeline_index(struct pipeline **pipes, int num,
+			     struct pipeline *p)
+{
+	int i;
+
+	for (i = 0; i < num; i++) {
+		if (pipes[i] == p)
+			break;
+	}
+
+	return i;
+}
+
+/*
+ * Collect all completed pipelines of the topology ordered so that a pipeline
+ * comes after every pipeline feeding it. Returns the number of pipelines.
+ */
+int tb_pipelines_get(struct ipc *ipc, struct pipeline **pipes, int max)
+{
+	struct ipc_comp_dev *icd;
+	struct list_item *clist;
+	struct comp_buffer *buffer;
+	struct pipeline *p;
+	int depth[MAX_PIPELINES];
+	int changed = 1;
+	int num = 0;
+	int pass;
+	int src;
+	int snk;
+	int i;
+	int j;
+	int d;
+
+	if (max > MAX_PIPELINES)
+		max = MAX_PIPELINES;
+
+	list_for_item(clist, &ipc->comp_list) {
+		icd = container_of(clist, struct ipc_comp_dev, list);
+		if (icd->type != COMP_TYPE_PIPELINE ||
+		    icd->pipeline->status == COMP_STATE_INIT)
+			continue;
+
+		if (num == max) {
+			fprintf(stderr, "error: more than %d pipelines\n", max);
+			return -EINVAL;
+		}
+
+		depth[num] = 0;
+		pipes[num++] = icd->pipeline;
+	}
+
+	/* a pipeline is one level below the deepest pipeline feeding it */
+	for (pass = 0; pass < num && changed; pass++) {
+		changed = 0;
+		list_for_item(clist, &ipc->comp_list) {
+			icd = container_of(clist, struct ipc_comp_dev, list);
+			if (icd->type != COMP_TYPE_BUFFER)
+				continue;
+
+			buffer = icd->cb;
+			if (!buffer->source || !buffer->sink)
+				continue;
+
+			src = tb_pipeline_index(pipes, num,
+						buffer->source->pipeline);
+			snk = tb_pipeline_index(pipes, num,
+						buffer->sink->pipeline);
+			if (src == num || snk == num || src == snk)
+				continue;
+
+			if (depth[snk] <= depth[src]) {
+				depth[snk] = depth[src] + 1;
+				changed = 1;
+			}
+		}
+	}
+
+	/* stable insertion sort by depth keeps topology order per level */
+	for (i = 1; i < num; i++) {
+		p = pipes[i];
+		d = depth[i];
+		for (j = i; j > 0 && depth[j - 1] > d; j--) {
+			pipes[j] = pipes[j - 1];
+			depth[j] = depth[j - 1];
+		}
+		pipes[j] = p;
+		depth[j] = d;
+	}
+
+	return num;
+}
+
+/* start pipelines in upstream to downstream order */
+int tb_pipelines_start(struct ipc *ipc, struct pipeline **pipes, int num,
+		       struct testbench_prm *tp)
+{
+	int ret;
+	int i;
+
+	for (i = 0; i < num; i++) {
+		ret = tb_pipeline_start(ipc, pipes[i], tp);
+		if (ret < 0)
+			return ret;
+	}
+
+	return 0;
+}
+
+/* stop and reset pipelines */
+int tb_pipelines_stop(struct pipeline **pipes, int num)
+{
+	struct comp_dev *cd;
+	int ret;
+	int i;
+
+	for (i = 0; i < num; i++) {
+		cd = pipes[i]->sched_comp;
+		if (cd->state == COMP_STATE_ACTIVE)
+			pipeline_trigger(pipes[i], cd, COMP_TRIGGER_STOP);
+	}
+
+	for (i = 0; i < num; i++) {
+		cd = pipes[i]->sched_comp;
+		if (cd->state == COMP_STATE_READY)
+			continue;
+
+		ret = pipeline_reset(pipes[i], cd);
+		if (ret < 0)
+			return ret;
+	}
+
+	return 0;
+}
+
+/* sum of samples processed by fileread or filewrite components */
+int tb_file_samples(struct ipc *ipc, int *ids, int num)
+{
+	struct ipc_comp_dev *pcm_dev;
+	struct file_comp_data *fcd;
+	int n = 0;
+	int i;
+
+	for (i = 0; i < num; i++) {
+		pcm_dev = ipc_get_comp_by_id(ipc, ids[i]);
+		fcd = comp_get_drvdata(pcm_dev->cd);
+		n += fcd->fs.n;
+	}
+
+	return n;
+}
+
+/* check if all filereads have reached end of file */
+static int tb_files_eof(struct ipc *ipc, int *ids, int num)
+{
+	struct ipc_comp_dev *pcm_dev;
+	struct file_comp_data *fcd;
+	int i;
+
+	for (i = 0; i < num; i++) {
+		pcm_dev = ipc_get_comp_by_id(ipc, ids[i]);
+		fcd = comp_get_drvdata(pcm_dev->cd);
+		if (!fcd->fs.reached_eof)
+			return 0;
+	}
+
+	return 1;
+}
+
+/* start the topology pipelines and run them until end of input files */
+int tb_run(struct sof *sof, struct testbench_prm *tp, struct tb_result *res)
+{
+	struct ipc_comp_dev *pcm_dev;
+	struct pipeline *pipes[MAX_PIPELINES];
+	struct sof_ipc_pipe_new *ipc_pipe;
+	bool trace = test_bench_trace;
+	uint64_t tic, toc;
+	int num_pipes;
+	int n_prev;
+	int n;
+	int i;
+
+	/* every file must be attached to a fileread or filewrite */
+	for (i = 0; i < tp->input_file_num; i++) {
+		if (tp->fr_id[i] < 0) {
+			fprintf(stderr, "error: no fileread for %s\n",
+				tp->input_file[i]);
+			return -EINVAL;
+		}
+	}
+
+	for (i = 0; i < tp->output_file_num; i++) {
+		if (tp->fw_id[i] < 0) {
+			fprintf(stderr, "error: no filewrite for %s\n",
+				tp->output_file[i]);
+			return -EINVAL;
+		}
+	}
+
+	/* get pipelines in scheduling order */
+	num_pipes = tb_pipelines_get(sof->ipc, pipes, MAX_PIPELINES);
+	if (num_pipes <= 0) {
+		fprintf(stderr, "error: no pipelines\n");
+		return -EINVAL;
+	}
+
+	pcm_dev = ipc_get_comp_by_id(sof->ipc, tp->sched_id);
+	ipc_pipe = &pcm_dev->cd->pipeline->ipc_pipe;
+
+	/* input and output sample rate */
+	if (!tp->fs_in)
+		tp->fs_in = ipc_pipe->period * ipc_pipe->frames_per_sched;
+
+	if (!tp->fs_out)
+		tp->fs_out = ipc_pipe->period * ipc_pipe->frames_per_sched;
+
+	/* set pipeline params and trigger start */
+	if (tb_pipelines_start(sof->ipc, pipes, num_pipes, tp) < 0) {
+		fprintf(stderr, "error: pipeline params\n");
 		return -EINVAL;
 	}
 
-	/* point to pipeline */
-	cd = pcm_dev->cd;
-	p = pcm_dev->cd->pipeline;
-	if (!p) {
-		fprintf(stderr, "error: pipeline NULL\n");
+	tb_enable_trace(false); /* reduce trace output */
+	tic = tb_profile_wall_ns();
+
+	/*
+	 * Copy all pipelines upstream first once per period until every
+	 * fileread reaches EOF. Stop early if nothing moves, e.g. a mixer
+	 * waiting for a source that has no more data.
+	 */
+	n_prev = -1;
+	while (!tb_files_eof(sof->ipc, tp->fr_id, tp->input_file_num)) {
+		for (i = 0; i < num_pipes; i++)
+			pipeline_schedule_copy(pipes[i], 0);
+
+		n = tb_file_samples(sof->ipc, tp->fr_id, tp->input_file_num) +
+			tb_file_samples(sof->ipc, tp->fw_id,
+					tp->output_file_num);
+		if (n == n_prev)
+			break;
+
+		n_prev = n;
+	}
+
+	if (!tb_files_eof(sof->ipc, tp->fr_id, tp->input_file_num))
+		printf("warning: possible pipeline xrun\n");
+
+	/* reset pipelines */
+	toc = tb_profile_wall_ns();
+	tb_enable_trace(trace);
+	if (tb_pipelines_stop(pipes, num_pipes) < 0) {
+		fprintf(stderr, "error: pipeline reset\n");
 		return -EINVAL;
 	}
 
-	/* pipeline params */
-	ret = pipeline_params(p, cd, &params);
-	if (ret < 0)
-		fprintf(stderr, "error: pipeline_params\n");
+	res->period_us = ipc_pipe->period;
+	res->n_in = tb_file_samples(sof->ipc, tp->fr_id, tp->input_file_num);
+	res->n_out = tb_file_samples(sof->ipc, tp->fw_id, tp->output_file_num);
+	res->t_exec = 1e-9 * (toc - tic);
+	return 0;
+}
 
-	return ret;
+/* free components, buffers and pipelines, pipelines first */
+void tb_free_comps(struct sof *sof)
+{
+	struct list_item *clist;
+	struct list_item *temp;
+	struct ipc_comp_dev *icd = NULL;
+
+	list_for_item_safe(clist, temp, &sof->ipc->comp_list) {
+		icd = container_of(clist, struct ipc_comp_dev, list);
+		if (icd->type == COMP_TYPE_PIPELINE) {
+			pipeline_free(icd->pipeline);
+			list_item_del(&icd->list);
+			rfree(icd);
+		}
+	}
+
+	list_for_item_safe(clist, temp, &sof->ipc->comp_list) {
+		icd = container_of(clist, struct ipc_comp_dev, list);
+		switch (icd->type) {
+		case COMP_TYPE_COMPONENT:
+			comp_free(icd->cd);
+			list_item_del(&icd->list);
+			rfree(icd);
+			break;
+		case COMP_TYPE_BUFFER:
+			rfree(icd->cb->stream.addr);
+			rfree(icd->cb);
+			list_item_del(&icd->list);
+			rfree(icd);
+			break;
+		default:
+			break;
+		}
+	}
+}
+
+/*
+ * Parse comma separated list of files. Each entry is either a file name
+ * or widget=file to attach the file to a named fileread or filewrite.
+ */
+int tb_parse_file_list(char *list, char **files, char **widgets, int max)
+{
+	char *token_file = NULL;
+	char *token;
+	char *name;
+	int num = 0;
+
+	token = strtok_r(list, ",", &token_file);
+	while (token) {
+		if (num == max) {
+			fprintf(stderr, "error: more than %d files\n", max);
+			return -EINVAL;
+		}
+
+		name = strchr(token, '=');
+		if (name) {
+			*name = '\0';
+			widgets[num] = strdup(token);
+			files[num] = strdup(name + 1);
+		} else {
+			widgets[num] = NULL;
+			files[num] = strdup(token);
+		}
+
+		num++;
+		token = strtok_r(NULL, ",", &token_file);
+	}
+
+	return num;
 }
 
 /* getindex of shared library from table */
@@ -26,7 +26,7 @@ struct edf_schedule_data {
 
 struct scheduler_ops schedule_edf_ops;
 
-static struct edf_schedule_data *sch;
+static __thread struct edf_schedule_data *sch;
 
 static int schedule_edf_task_complete(struct task *task)
 {
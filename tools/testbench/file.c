@@ -9,6 +9,9 @@
 #include <stddef.h>
 #include <errno.h>
 #include <inttypes.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
 #include <sof/sof.h>
 #include <sof/list.h>
 #include <sof/audio/stream.h>
@@ -17,6 +20,7 @@
 #include <sof/audio/component.h>
 #include <sof/audio/format.h>
 #include <sof/audio/pipeline.h>
+#include <sof/math/numbers.h>
 #include <ipc/stream.h>
 #include "testbench/common_test.h"
 #include "testbench/file.h"
@@ -43,9 +47,227 @@ static inline void buffer_check_wrap_16(int16_t **ptr, int16_t *end,
 		*ptr = (int16_t *)((size_t)*ptr - size);
 }
 
+/* number of samples converted at a time when writing 24-bit data */
+#define FILE_BOUNCE_SAMPLES	1024
+
+/* bytes of memory mapped input advised to be faulted in ahead of reads */
+#define FILE_MMAP_READ_AHEAD	(1 << 20)
+
+/* KSDATAFORMAT_SUBTYPE_PCM for WAVE_FORMAT_EXTENSIBLE headers */
+static const uint8_t wav_subformat_pcm[16] = {
+	0x01, 0x00, 0x00, 0x00, 0x00, 0x00, 0x10, 0x00,
+	0x80, 0x00, 0x00, 0xaa, 0x00, 0x38, 0x9b, 0x71,
+};
+
+static inline size_t file_sample_bytes(int fmt)
+{
+	return fmt == SOF_IPC_FRAME_S16_LE ? sizeof(int16_t) : sizeof(int32_t);
+}
+
+/* map input file read only, starting reads from current file position */
+static int file_mmap_input(struct file_comp_data *cd)
+{
+	struct stat st;
+	void *map;
+
+	if (fstat(fileno(cd->fs.rfh), &st) < 0) {
+		fprintf(stderr, "error: stat %s\n", cd->fs.fn);
+		return -errno;
+	}
+
+	/* nothing to map, stdio reads will hit eof */
+	if (!st.st_size)
+		return 0;
+
+	map = mmap(NULL, st.st_size, PROT_READ, MAP_SHARED,
+		   fileno(cd->fs.rfh), 0);
+	if (map == MAP_FAILED) {
+		fprintf(stderr, "error: mmap %s\n", cd->fs.fn);
+		return -errno;
+	}
+
+	/* read once front to back, let the kernel read ahead aggressively */
+	madvise(map, st.st_size, MADV_SEQUENTIAL);
+
+	cd->fs.map = map;
+	cd->fs.map_size = st.st_size;
+	cd->fs.map_pos = ftell(cd->fs.rfh);
+	cd->fs.map_advised = cd->fs.map_pos;
+	return 0;
+}
+
+/* read samples with stdio or memcpy() straight from the mapped file */
+static int file_read_span(struct file_comp_data *cd, void *dest,
+			  size_t sample_bytes, int n)
+{
+	size_t page = sysconf(_SC_PAGESIZE);
+	size_t bytes;
+	size_t start;
+
+	if (!cd->fs.map)
+		return fread(dest, sample_bytes, n, cd->fs.rfh);
+
+	n = MIN(n, (int)((cd->fs.map_size - cd->fs.map_pos) / sample_bytes));
+	bytes = n * sample_bytes;
+
+	/* prefault the next window before the copy gets there */
+	if (cd->fs.map_pos + bytes + FILE_MMAP_READ_AHEAD / 2 >
+	    cd->fs.map_advised && cd->fs.map_advised < cd->fs.map_size) {
+		start = cd->fs.map_advised & ~(page - 1);
+		cd->fs.map_advised = MIN(cd->fs.map_pos + bytes +
+					 FILE_MMAP_READ_AHEAD,
+					 cd->fs.map_size);
+		madvise(cd->fs.map + start, cd->fs.map_advised - start,
+			MADV_WILLNEED);
+	}
+
+	memcpy(dest, cd->fs.map + cd->fs.map_pos, bytes);
+	cd->fs.map_pos += bytes;
+	return n;
+}
+
+/*
+ * Read raw or WAVE samples from file with one fread() per contiguous
+ * span of the sink buffer, i.e. at most two calls per copy.
+ */
+static int read_samples_block(struct comp_dev *dev,
+			      const struct audio_stream *sink,
+			      int n, int fmt)
+{
+	struct file_comp_data *cd = comp_get_drvdata(dev);
+	size_t sample_bytes = file_sample_bytes(fmt);
+	uint8_t *dest = sink->w_ptr;
+	int32_t *data;
+	int n_wrap;
+	int n_min;
+	int ret;
+	int i;
+	int n_samples = 0;
+
+	/* WAVE input is limited to the data chunk payload */
+	if (cd->fs.f_format == FILE_WAV)
+		n = MIN(n, (int)(cd->fs.data_bytes / sample_bytes));
+
+	while (n > 0) {
+		/* copy up to the end of the buffer */
+		n_wrap = ((uint8_t *)sink->end_addr - dest) / sample_bytes;
+		n_min = MIN(n, n_wrap);
+		ret = file_read_span(cd, dest, sample_bytes, n_min);
+
+		/* WAVE samples are MSB aligned, raw ones are LSB aligned */
+		if (fmt == SOF_IPC_FRAME_S24_4LE) {
+			data = (int32_t *)dest;
+			if (cd->fs.f_format == FILE_WAV)
+				for (i = 0; i < ret; i++)
+					data[i] = (data[i] >> 8) & 0x00ffffff;
+			else
+				for (i = 0; i < ret; i++)
+					data[i] &= 0x00ffffff;
+		}
+
+		n_samples += ret;
+
+		/* quit if eof is reached */
+		if (ret != n_min) {
+			cd->fs.reached_eof = 1;
+			break;
+		}
+
+		n -= n_min;
+		dest += n_min * sample_bytes;
+
+		/* check for buffer wrap and update pointer */
+		if (dest >= (uint8_t *)sink->end_addr)
+			dest -= sink->size;
+	}
+
+	if (cd->fs.f_format == FILE_WAV) {
+		cd->fs.data_bytes -= n_samples * sample_bytes;
+		if (!cd->fs.data_bytes)
+			cd->fs.reached_eof = 1;
+	}
+
+	return n_samples;
+}
+
+/* convert 24-bit samples to file layout in a bounce buffer and write them */
+static int write_span_s24(struct file_comp_data *cd, const int32_t *src, int n)
+{
+	int32_t buf[FILE_BOUNCE_SAMPLES];
+	int n_samples = 0;
+	int n_min;
+	int ret;
+	int i;
+
+	while (n > 0) {
+		n_min = MIN(n, FILE_BOUNCE_SAMPLES);
+
+		if (cd->fs.f_format == FILE_WAV)
+			for (i = 0; i < n_min; i++)
+				buf[i] = src[i] << 8;
+		else
+			for (i = 0; i < n_min; i++)
+				buf[i] = sign_extend_s24(src[i]);
+
+		ret = fwrite(buf, sizeof(int32_t), n_min, cd->fs.wfh);
+		n_samples += ret;
+		if (ret != n_min)
+			break;
+
+		src += n_min;
+		n -= n_min;
+	}
+
+	return n_samples;
+}
+
+/*
+ * Write raw or WAVE samples to file with one fwrite() per contiguous
+ * span of the source buffer, i.e. at most two calls per copy.
+ */
+static int write_samples_block(struct comp_dev *dev,
+			       struct audio_stream *source,
+			       int n, int fmt)
+{
+	struct file_comp_data *cd = comp_get_drvdata(dev);
+	size_t sample_bytes = file_sample_bytes(fmt);
+	uint8_t *src = source->r_ptr;
+	int n_wrap;
+	int n_min;
+	int ret;
+	int n_samples = 0;
+
+	while (n > 0) {
+		/* copy up to the end of the buffer */
+		n_wrap = ((uint8_t *)source->end_addr - src) / sample_bytes;
+		n_min = MIN(n, n_wrap);
+
+		if (fmt == SOF_IPC_FRAME_S24_4LE)
+			ret = write_span_s24(cd, (int32_t *)src, n_min);
+		else
+			ret = fwrite(src, sample_bytes, n_min, cd->fs.wfh);
+
+		n_samples += ret;
+		if (ret != n_min)
+			break;
+
+		n -= n_min;
+		src += n_min * sample_bytes;
+
+		/* check for buffer wrap and update pointer */
+		if (src >= (uint8_t *)source->end_addr)
+			src -= source->size;
+	}
+
+	if (cd->fs.f_format == FILE_WAV)
+		cd->fs.data_bytes += n_samples * sample_bytes;
+
+	return n_samples;
+}
+
 /*
  * Read 32-bit samples from file
- * currently only supports txt files
+ * text files are parsed one sample at a time
  */
 static int read_samples_32(struct comp_dev *dev,
 			   const struct audio_stream *sink,
@@ -60,6 +282,9 @@ static int read_samples_32(struct comp_dev *dev,
 	int n_samples = 0;
 	int ret = 0;
 
+	if (cd->fs.f_format != FILE_TEXT)
+		return read_samples_block(dev, sink, n, fmt);
+
 	while (n > 0) {
 		n_wrap = (int32_t *)sink->end_addr - dest;
 
@@ -71,48 +296,22 @@ static int read_samples_32(struct comp_dev *dev,
 
 			/* copy sample per channel */
 			for (i = 0; i < nch; i++) {
-				/* read sample from file */
-				switch (cd->fs.f_format) {
-				/* text input file */
-				case FILE_TEXT:
-					if (fmt == SOF_IPC_FRAME_S32_LE)
-						ret = fscanf(cd->fs.rfh, "%d",
-							     dest);
-
-					/* mask bits if 24-bit samples */
-					if (fmt == SOF_IPC_FRAME_S24_4LE) {
-						ret = fscanf(cd->fs.rfh, "%d",
-							     &sample);
-						*dest = sample & 0x00ffffff;
-					}
-					/* quit if eof is reached */
-					if (ret == EOF) {
-						cd->fs.reached_eof = 1;
-						goto quit;
-					}
-					break;
-
-				/* raw input file */
-				default:
-					if (fmt == SOF_IPC_FRAME_S32_LE)
-						ret = fread(dest,
-							    sizeof(int32_t),
-							    1, cd->fs.rfh);
-
-					/* mask bits if 24-bit samples */
-					if (fmt == SOF_IPC_FRAME_S24_4LE) {
-						ret = fread(&sample,
-							    sizeof(int32_t),
-							    1, cd->fs.rfh);
-						*dest = sample & 0x00ffffff;
-					}
-					/* quit if eof is reached */
-					if (ret != 1) {
-						cd->fs.reached_eof = 1;
-						goto quit;
-					}
-					break;
+				/* read sample from text file */
+				if (fmt == SOF_IPC_FRAME_S32_LE)
+					ret = fscanf(cd->fs.rfh, "%d", dest);
+
+				/* mask bits if 24-bit samples */
+				if (fmt == SOF_IPC_FRAME_S24_4LE) {
+					ret = fscanf(cd->fs.rfh, "%d", &sample);
+					*dest = sample & 0x00ffffff;
 				}
+
+				/* quit if eof is reached */
+				if (ret == EOF) {
+					cd->fs.reached_eof = 1;
+					goto quit;
+				}
+
 				dest++;
 				n_samples++;
 			}
@@ -127,7 +326,7 @@ quit:
 
 /*
  * Read 16-bit samples from file
- * currently only supports txt files
+ * text files are parsed one sample at a time
  */
 static int read_samples_16(struct comp_dev *dev,
 			   const struct audio_stream *sink,
@@ -138,6 +337,9 @@ static int read_samples_16(struct comp_dev *dev,
 	int i, n_wrap, n_min, ret;
 	int n_samples = 0;
 
+	if (cd->fs.f_format != FILE_TEXT)
+		return read_samples_block(dev, sink, n, SOF_IPC_FRAME_S16_LE);
+
 	/* copy samples */
 	while (n > 0) {
 		n_wrap = (int16_t *)sink->end_addr - dest;
@@ -150,25 +352,10 @@ static int read_samples_16(struct comp_dev *dev,
 
 			/* copy sample per channel */
 			for (i = 0; i < nch; i++) {
-				switch (cd->fs.f_format) {
-				/* text input file */
-				case FILE_TEXT:
-					ret = fscanf(cd->fs.rfh, "%hd", dest);
-					if (ret == EOF) {
-						cd->fs.reached_eof = 1;
-						goto quit;
-					}
-					break;
-
-				/* rw pcm input file */
-				default:
-					ret = fread(dest, sizeof(int16_t), 1,
-						    cd->fs.rfh);
-					if (ret != 1) {
-						cd->fs.reached_eof = 1;
-						goto quit;
-					}
-					break;
+				ret = fscanf(cd->fs.rfh, "%hd", dest);
+				if (ret == EOF) {
+					cd->fs.reached_eof = 1;
+					goto quit;
 				}
 
 				dest++;
@@ -185,8 +372,8 @@ quit:
 }
 
 /*
- * Write 16-bit samples from file
- * currently only supports txt files
+ * Write 16-bit samples to file
+ * text files are printed one sample at a time
  */
 static int write_samples_16(struct comp_dev *dev, struct audio_stream *source,
 			    int n, int nch)
@@ -196,6 +383,10 @@ static int write_samples_16(struct comp_dev *dev, struct audio_stream *source,
 	int i, n_wrap, n_min, ret;
 	int n_samples = 0;
 
+	if (cd->fs.f_format != FILE_TEXT)
+		return write_samples_block(dev, source, n,
+					   SOF_IPC_FRAME_S16_LE);
+
 	/* copy samples */
 	while (n > 0) {
 		n_wrap = (int16_t *)source->end_addr - src;
@@ -208,24 +399,9 @@ static int write_samples_16(struct comp_dev *dev, struct audio_stream *source,
 
 			/* copy sample per channel */
 			for (i = 0; i < nch; i++) {
-				switch (cd->fs.f_format) {
-				/* text output file */
-				case FILE_TEXT:
-					ret = fprintf(cd->fs.wfh,
-						      "%d\n", *src);
-					if (ret < 0)
-						goto quit;
-					break;
-
-				/* raw pcm output file */
-				default:
-					ret = fwrite(src,
-						     sizeof(int16_t),
-						     1, cd->fs.wfh);
-					if (ret != 1)
-						goto quit;
-					break;
-				}
+				ret = fprintf(cd->fs.wfh, "%d\n", *src);
+				if (ret < 0)
+					goto quit;
 
 				src++;
 				n_samples++;
@@ -240,8 +416,8 @@ quit:
 }
 
 /*
- * Write 32-bit samples from file
- * currently only supports txt files
+ * Write 32-bit samples to file
+ * text files are printed one sample at a time
  */
 static int write_samples_32(struct comp_dev *dev, struct audio_stream *source,
 			    int n, int fmt, int nch)
@@ -252,6 +428,9 @@ static int write_samples_32(struct comp_dev *dev, struct audio_stream *source,
 	int n_samples = 0;
 	int32_t sample;
 
+	if (cd->fs.f_format != FILE_TEXT)
+		return write_samples_block(dev, source, n, fmt);
+
 	/* copy samples */
 	while (n > 0) {
 		n_wrap = (int32_t *)source->end_addr - src;
@@ -264,39 +443,14 @@ static int write_samples_32(struct comp_dev *dev, struct audio_stream *source,
 
 			/* copy sample per channel */
 			for (i = 0; i < nch; i++) {
-				switch (cd->fs.f_format) {
-				/* text output file */
-				case FILE_TEXT:
-					if (fmt == SOF_IPC_FRAME_S32_LE)
-						ret = fprintf(cd->fs.wfh,
-							      "%d\n", *src);
-					if (fmt == SOF_IPC_FRAME_S24_4LE) {
-						sample = *src << 8;
-						ret = fprintf(cd->fs.wfh,
-							      "%d\n",
-							      sample >> 8);
-					}
-					if (ret < 0)
-						goto quit;
-					break;
-
-				/* raw pcm output file */
-				default:
-					if (fmt == SOF_IPC_FRAME_S32_LE)
-						ret = fwrite(src,
-							     sizeof(int32_t),
-							     1, cd->fs.wfh);
-					if (fmt == SOF_IPC_FRAME_S24_4LE) {
-						sample = *src << 8;
-						sample >>= 8;
-						ret = fwrite(&sample,
-							     sizeof(int32_t),
-							     1, cd->fs.wfh);
-					}
-					if (ret != 1)
-						goto quit;
-					break;
-				}
+				if (fmt == SOF_IPC_FRAME_S24_4LE)
+					sample = sign_extend_s24(*src);
+				else
+					sample = *src;
+
+				ret = fprintf(cd->fs.wfh, "%d\n", sample);
+				if (ret < 0)
+					goto quit;
 
 				/* increment read pointer */
 				src++;
@@ -313,6 +467,148 @@ quit:
 	return n_samples;
 }
 
+/* parse RIFF/WAVE header and position file at start of data chunk */
+static int wav_read_header(struct file_comp_data *cd)
+{
+	struct wav_fmt *fmt = &cd->fs.wav_fmt;
+	struct wav_chunk_hdr chunk;
+	char wave[4];
+	size_t fmt_size = 0;
+	long skip;
+	uint32_t bits;
+
+	if (fread(&chunk, sizeof(chunk), 1, cd->fs.rfh) != 1 ||
+	    memcmp(chunk.id, "RIFF", 4) ||
+	    fread(wave, sizeof(wave), 1, cd->fs.rfh) != 1 ||
+	    memcmp(wave, "WAVE", 4)) {
+		fprintf(stderr, "error: %s is not a RIFF/WAVE file\n",
+			cd->fs.fn);
+		return -EINVAL;
+	}
+
+	/* walk chunks until data, chunks are padded to even size */
+	while (1) {
+		if (fread(&chunk, sizeof(chunk), 1, cd->fs.rfh) != 1) {
+			fprintf(stderr, "error: no data chunk in %s\n",
+				cd->fs.fn);
+			return -EINVAL;
+		}
+
+		if (!memcmp(chunk.id, "data", 4))
+			break;
+
+		skip = chunk.size + (chunk.size & 1);
+		if (!memcmp(chunk.id, "fmt ", 4)) {
+			memset(fmt, 0, sizeof(*fmt));
+			fmt_size = MIN(chunk.size, sizeof(*fmt));
+			if (fmt_size < offsetof(struct wav_fmt, ext_size) ||
+			    fread(fmt, fmt_size, 1, cd->fs.rfh) != 1) {
+				fprintf(stderr, "error: bad fmt chunk in %s\n",
+					cd->fs.fn);
+				return -EINVAL;
+			}
+			skip -= fmt_size;
+		}
+
+		if (fseek(cd->fs.rfh, skip, SEEK_CUR)) {
+			fprintf(stderr, "error: seek in %s\n", cd->fs.fn);
+			return -errno;
+		}
+	}
+
+	if (!fmt_size) {
+		fprintf(stderr, "error: no fmt chunk in %s\n", cd->fs.fn);
+		return -EINVAL;
+	}
+
+	if (fmt->format_tag != WAV_FORMAT_PCM &&
+	    !(fmt->format_tag == WAV_FORMAT_EXTENSIBLE &&
+	      !memcmp(fmt->sub_format, wav_subformat_pcm,
+		      sizeof(wav_subformat_pcm)))) {
+		fprintf(stderr, "error: %s is not integer PCM\n", cd->fs.fn);
+		return -EINVAL;
+	}
+
+	/* container must match the testbench sample format */
+	bits = 8 * file_sample_bytes(cd->frame_fmt);
+	if (fmt->bits_per_sample != bits || fmt->channels != cd->channels) {
+		fprintf(stderr, "error: %s has %d channels of %d bits, expected %d channels of %d bits\n",
+			cd->fs.fn, fmt->channels, fmt->bits_per_sample,
+			cd->channels, bits);
+		return -EINVAL;
+	}
+
+	if (cd->rate && fmt->sample_rate != cd->rate)
+		fprintf(stderr, "warning: %s rate %d differs from %d\n",
+			cd->fs.fn, fmt->sample_rate, cd->rate);
+
+	cd->fs.data_bytes = chunk.size;
+	cd->fs.data_offset = ftell(cd->fs.rfh);
+	return 0;
+}
+
+/* set up WAVE format for output stream */
+static void wav_init_fmt(struct wav_fmt *fmt, const struct audio_stream *stream)
+{
+	memset(fmt, 0, sizeof(*fmt));
+	fmt->channels = stream->channels;
+	fmt->sample_rate = stream->rate;
+	fmt->bits_per_sample = 8 * file_sample_bytes(stream->frame_fmt);
+	fmt->block_align = fmt->channels * fmt->bits_per_sample / 8;
+	fmt->byte_rate = fmt->sample_rate * fmt->block_align;
+
+	/* 24-bit in 32-bit container needs the extensible format */
+	if (stream->frame_fmt == SOF_IPC_FRAME_S24_4LE) {
+		fmt->format_tag = WAV_FORMAT_EXTENSIBLE;
+		fmt->ext_size = sizeof(*fmt) -
+			offsetof(struct wav_fmt, valid_bits_per_sample);
+		fmt->valid_bits_per_sample = 24;
+		memcpy(fmt->sub_format, wav_subformat_pcm,
+		       sizeof(wav_subformat_pcm));
+	} else {
+		fmt->format_tag = WAV_FORMAT_PCM;
+	}
+}
+
+/* write RIFF/WAVE header with current data size to start of file */
+static int wav_write_header(struct file_comp_data *cd)
+{
+	struct wav_header hdr;
+	size_t fmt_size;
+	long pos = ftell(cd->fs.wfh);
+
+	if (cd->fs.wav_fmt.format_tag == WAV_FORMAT_EXTENSIBLE)
+		fmt_size = sizeof(struct wav_fmt);
+	else
+		fmt_size = offsetof(struct wav_fmt, ext_size);
+
+	memcpy(hdr.riff.id, "RIFF", 4);
+	memcpy(hdr.wave, "WAVE", 4);
+	memcpy(hdr.fmt_hdr.id, "fmt ", 4);
+	memcpy(hdr.data_hdr.id, "data", 4);
+	hdr.fmt = cd->fs.wav_fmt;
+	hdr.fmt_hdr.size = fmt_size;
+	hdr.data_hdr.size = cd->fs.data_bytes;
+	hdr.riff.size = sizeof(hdr.wave) + 2 * sizeof(struct wav_chunk_hdr) +
+		fmt_size + cd->fs.data_bytes;
+
+	if (fseek(cd->fs.wfh, 0, SEEK_SET) ||
+	    fwrite(&hdr, offsetof(struct wav_header, fmt) + fmt_size, 1,
+		   cd->fs.wfh) != 1 ||
+	    fwrite(&hdr.data_hdr, sizeof(hdr.data_hdr), 1, cd->fs.wfh) != 1) {
+		fprintf(stderr, "error: writing header to %s\n", cd->fs.fn);
+		return -EIO;
+	}
+
+	cd->fs.data_offset = ftell(cd->fs.wfh);
+
+	/* continue from where we were if data was already written */
+	if (pos > cd->fs.data_offset)
+		fseek(cd->fs.wfh, pos, SEEK_SET);
+
+	return 0;
+}
+
 /* function for processing 32-bit samples */
 static int file_s32_default(struct comp_dev *dev, struct audio_stream *sink,
 			    struct audio_stream *source, uint32_t frames)
@@ -405,9 +701,15 @@ static enum file_format get_file_format(char *filename)
 {
 	char *ext = strrchr(filename, '.');
 
+	if (!ext)
+		return FILE_RAW;
+
 	if (!strcmp(ext, ".txt"))
 		return FILE_TEXT;
 
+	if (!strcmp(ext, ".wav"))
+		return FILE_WAV;
+
 	return FILE_RAW;
 }
 
@@ -470,6 +772,20 @@ static struct comp_dev *file_new(const struct comp_driver *drv,
 			free(dev);
 			return NULL;
 		}
+
+		if (ipc_file->mmap && cd->fs.f_format == FILE_TEXT)
+			fprintf(stderr, "warning: text file %s is not mapped\n",
+				cd->fs.fn);
+
+		if ((cd->fs.f_format == FILE_WAV && wav_read_header(cd) < 0) ||
+		    (ipc_file->mmap && cd->fs.f_format != FILE_TEXT &&
+		     file_mmap_input(cd) < 0)) {
+			fclose(cd->fs.rfh);
+			free(cd->fs.fn);
+			free(cd);
+			free(dev);
+			return NULL;
+		}
 		break;
 	case FILE_WRITE:
 		cd->fs.wfh = fopen(cd->fs.fn, "w");
@@ -499,10 +815,18 @@ static void file_free(struct comp_dev *dev)
 
 	comp_dbg(dev, "file_free()");
 
-	if (cd->fs.mode == FILE_READ)
+	if (cd->fs.mode == FILE_READ) {
+		if (cd->fs.map)
+			munmap(cd->fs.map, cd->fs.map_size);
+
 		fclose(cd->fs.rfh);
-	else
+	} else {
+		/* update WAVE header sizes with written data */
+		if (cd->fs.f_format == FILE_WAV && cd->fs.data_offset)
+			wav_write_header(cd);
+
 		fclose(cd->fs.wfh);
+	}
 
 	free(cd->fs.fn);
 	free(cd);
@@ -671,6 +995,15 @@ static int file_prepare(struct comp_dev *dev)
 	else
 		cd->sample_container_bytes = 4;
 
+	/* WAVE output header is written once the stream format is known */
+	if (cd->fs.mode == FILE_WRITE && cd->fs.f_format == FILE_WAV &&
+	    !cd->fs.data_offset) {
+		wav_init_fmt(&cd->fs.wav_fmt, stream);
+		ret = wav_write_header(cd);
+		if (ret < 0)
+			return ret;
+	}
+
 	/* calculate period size based on config */
 	cd->period_bytes = dev->frames * cd->sample_container_bytes *
 		stream->channels;
@@ -0,0 +1,38 @@
+/* SPDX-License-Identifier: BSD-3-Clause
+ *
+ * Copyright(c) 2020 Intel Corporation. All rights reserved.
+ */
+
+#ifndef _BATCH_H
+#define _BATCH_H
+
+#include <pthread.h>
+#include <sof/sof.h>
+#include "testbench/common_test.h"
+
+/* maximum length of a job line in batch manifest */
+#define TB_BATCH_LINE_LEN	1024
+
+/* one line of batch manifest */
+struct tb_batch_job {
+	struct testbench_prm tp; /* job files, format and rates */
+	struct tb_result res;
+	int line; /* manifest line number */
+	int done; /* job has been run by a worker */
+	int ret;
+};
+
+/* batch run state shared by all worker threads */
+struct tb_batch {
+	struct sof *parent; /* instance with registered component drivers */
+	struct shared_lib_table *lib_table;
+	struct tb_batch_job *jobs;
+	int num_jobs;
+	int next_job; /* next job to run, protected by lock */
+	pthread_mutex_t lock;
+};
+
+int tb_batch_run(struct sof *sof, struct testbench_prm *tp,
+		 struct shared_lib_table *lib_table);
+
+#endif
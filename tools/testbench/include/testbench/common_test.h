@@ -17,13 +17,23 @@
 #define DEBUG_MSG_LEN		256
 #define MAX_LIB_NAME_LEN	256
 
+/* maximum number of file components and pipelines in topology */
+#define MAX_INPUT_FILES		8
+#define MAX_OUTPUT_FILES	8
+#define MAX_PIPELINES		16
+
 /* number of widgets types supported in testbench */
-#define NUM_WIDGETS_SUPPORTED	7
+#define NUM_WIDGETS_SUPPORTED	11
 
 struct testbench_prm {
 	char *tplg_file; /* topology file to use */
-	char *input_file; /* input file name */
-	char *output_file; /* output file name */
+	char *input_file[MAX_INPUT_FILES]; /* input file names */
+	char *output_file[MAX_OUTPUT_FILES]; /* output file names */
+	/* widget names the files are attached to, NULL for topology order */
+	char *input_widget[MAX_INPUT_FILES];
+	char *output_widget[MAX_OUTPUT_FILES];
+	int input_file_num;
+	int output_file_num;
 	char *bits_in; /* input bit format */
 	/*
 	 * input and output sample rate parameters
@@ -34,10 +44,24 @@ struct testbench_prm {
 	uint32_t fs_in;
 	uint32_t fs_out;
 	uint32_t channels;
-	int fr_id;
-	int fw_id;
+	int fr_id[MAX_INPUT_FILES]; /* fileread comp id per input file */
+	int fw_id[MAX_OUTPUT_FILES]; /* filewrite comp id per output file */
 	int sched_id;
+	int mmap_input; /* memory map input file */
+	int profile; /* print per component execution time */
 	enum sof_ipc_frame frame_fmt;
+	void *tplg_data; /* topology file contents, NULL to read tplg_file */
+	size_t tplg_size;
+	char *batch_file; /* batch mode job manifest */
+	int batch_workers; /* batch mode worker threads */
+};
+
+/* result of running the pipelines until end of input files */
+struct tb_result {
+	uint32_t period_us; /* scheduling period of first pipeline */
+	int n_in; /* samples read from all input files */
+	int n_out; /* samples written to all output files */
+	double t_exec; /* processing wall clock time in seconds */
 };
 
 struct shared_lib_table {
@@ -58,12 +82,31 @@ void sys_comp_filewrite_init(void);
 
 int tb_pipeline_setup(struct sof *sof);
 
-int tb_pipeline_start(struct ipc *ipc, struct sof_ipc_pipe_new *ipc_pipe,
+int tb_pipeline_setup_worker(struct sof *sof, struct sof *parent);
+
+void tb_pipeline_free_worker(struct sof *sof);
+
+int tb_pipeline_start(struct ipc *ipc, struct pipeline *p,
 		      struct testbench_prm *tp);
 
-int tb_pipeline_params(struct ipc *ipc, struct sof_ipc_pipe_new *ipc_pipe,
+int tb_pipeline_params(struct ipc *ipc, struct pipeline *p,
 		       struct testbench_prm *tp);
 
+int tb_pipelines_get(struct ipc *ipc, struct pipeline **pipes, int max);
+
+int tb_pipelines_start(struct ipc *ipc, struct pipeline **pipes, int num,
+		       struct testbench_prm *tp);
+
+int tb_pipelines_stop(struct pipeline **pipes, int num);
+
+int tb_file_samples(struct ipc *ipc, int *ids, int num);
+
+int tb_run(struct sof *sof, struct testbench_prm *tp, struct tb_result *res);
+
+void tb_free_comps(struct sof *sof);
+
+int tb_parse_file_list(char *list, char **files, char **widgets, int max);
+
 void debug_print(char *message);
 
 int get_index_by_name(char *comp_name,
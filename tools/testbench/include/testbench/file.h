@@ -21,8 +21,42 @@ enum file_mode {
 enum file_format {
 	FILE_TEXT = 0,
 	FILE_RAW,
+	FILE_WAV,
 };
 
+/* RIFF/WAVE format tags */
+#define WAV_FORMAT_PCM		0x0001
+#define WAV_FORMAT_EXTENSIBLE	0xfffe
+
+/* RIFF chunk header */
+struct wav_chunk_hdr {
+	char id[4];
+	uint32_t size;
+} __attribute__((packed));
+
+/* RIFF/WAVE "fmt " chunk, with extensible format extension */
+struct wav_fmt {
+	uint16_t format_tag;
+	uint16_t channels;
+	uint32_t sample_rate;
+	uint32_t byte_rate;
+	uint16_t block_align;
+	uint16_t bits_per_sample;
+	uint16_t ext_size;
+	uint16_t valid_bits_per_sample;
+	uint32_t channel_mask;
+	uint8_t sub_format[16];
+} __attribute__((packed));
+
+/* canonical header written to WAVE output files */
+struct wav_header {
+	struct wav_chunk_hdr riff;
+	char wave[4];
+	struct wav_chunk_hdr fmt_hdr;
+	struct wav_fmt fmt;
+	struct wav_chunk_hdr data_hdr;
+} __attribute__((packed));
+
 /* file component state */
 struct file_state {
 	char *fn;
@@ -31,6 +65,13 @@ struct file_state {
 	int n;
 	enum file_mode mode;
 	enum file_format f_format;
+	struct wav_fmt wav_fmt; /* WAVE file format */
+	size_t data_bytes; /* WAVE data chunk bytes left to read or written */
+	long data_offset; /* WAVE data chunk payload position in file */
+	uint8_t *map; /* memory mapped input file, NULL for stdio reads */
+	size_t map_size;
+	size_t map_pos; /* next byte to read from map */
+	size_t map_advised; /* end of range advised to be faulted in */
 };
 
 /* file comp data */
@@ -56,5 +97,6 @@ struct sof_ipc_comp_file {
 	char *fn;
 	enum file_mode mode;
 	enum sof_ipc_frame frame_fmt;
+	uint32_t mmap; /* map input file instead of reading with stdio */
 } __attribute__((packed));
 #endif
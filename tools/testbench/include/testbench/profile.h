@@ -0,0 +1,43 @@
+/* SPDX-License-Identifier: BSD-3-Clause
+ *
+ * Copyright(c) 2020 Intel Corporation. All rights reserved.
+ */
+
+#ifndef _PROFILE_H
+#define _PROFILE_H
+
+#include <stdint.h>
+#include <sof/audio/component.h>
+#include "testbench/common_test.h"
+
+/* per component copy() timing statistics */
+struct tb_comp_prof {
+	struct comp_driver drv;	/* copy of driver with profiling copy() */
+	const struct comp_driver *orig_drv; /* driver being profiled */
+	uint32_t id;		/* component id */
+	const char *name;	/* component type name */
+	uint64_t *ns;		/* wall clock time of each copy() */
+	uint32_t count;		/* number of copy() calls */
+	uint32_t max_count;	/* size of ns array */
+	uint64_t cycles;	/* total CPU timestamp counter cycles */
+	uint64_t samples;	/* total frames times channels processed */
+	uint64_t frames;	/* total frames processed */
+	int failed;		/* profiling stopped, no timing memory */
+};
+
+/* profiler state for all components of a testbench run */
+struct tb_prof {
+	struct tb_comp_prof *comps;
+	int num_comps;
+};
+
+int tb_profile_start(struct sof *sof, struct tb_prof *prof,
+		     struct shared_lib_table *lib_table);
+
+void tb_profile_print(struct tb_prof *prof, uint32_t period_us);
+
+void tb_profile_free(struct tb_prof *prof);
+
+uint64_t tb_profile_wall_ns(void);
+
+#endif
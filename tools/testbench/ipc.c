@@ -12,7 +12,7 @@
 #include <stdlib.h>
 
 /* testbench ipc */
-struct ipc *_ipc;
+__thread struct ipc *_ipc;
 
 /* private data for IPC */
 struct ipc_data {
@@ -46,6 +46,18 @@ int platform_ipc_init(struct ipc *ipc)
 	return 0;
 }
 
+void ipc_free(struct ipc *ipc)
+{
+	struct ipc_data *iipc = ipc_get_drvdata(ipc);
+
+	if (iipc)
+		free(iipc->dh_buffer.page_table);
+
+	free(iipc);
+	rfree(ipc->comp_data);
+	rfree(ipc);
+}
+
 /* The following definition is to satisfy libsof linker errors */
 
 void ipc_msg_send(struct ipc_msg *msg, void *data, bool high_priority)
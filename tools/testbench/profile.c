@@ -0,0 +1,249 @@
+// SPDX-License-Identifier: BSD-3-Clause
+//
+// Copyright(c) 2020 Intel Corporation. All rights reserved.
+
+/*
+ * Per component profiler for testbench. The driver of every component
+ * is replaced by a copy whose copy() op measures wall clock time, CPU
+ * cycles and processed frames around the original copy() op.
+ */
+
+#include <inttypes.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include <sof/sof.h>
+#include <sof/list.h>
+#include <sof/audio/buffer.h>
+#include <sof/audio/component.h>
+#include <sof/drivers/ipc.h>
+#include "testbench/common_test.h"
+#include "testbench/profile.h"
+
+#if defined(__x86_64__) || defined(__i386__)
+#include <x86intrin.h>
+#define tb_profile_cycles()	__rdtsc()
+#define TB_PROFILE_HAS_CYCLES	1
+#else
+#define tb_profile_cycles()	0
+#define TB_PROFILE_HAS_CYCLES	0
+#endif
+
+/* initial number of copy() timings stored per component */
+#define TB_PROFILE_INIT_COUNT	4096
+
+uint64_t tb_profile_wall_ns(void)
+{
+	struct timespec ts;
+
+	clock_gettime(CLOCK_MONOTONIC, &ts);
+	return (uint64_t)ts.tv_sec * 1000000000 + ts.tv_nsec;
+}
+
+/* stream used to count frames, sink if there is one, else source */
+static struct audio_stream *tb_profile_stream(struct comp_dev *dev,
+					      int *is_sink)
+{
+	*is_sink = !list_is_empty(&dev->bsink_list);
+	if (*is_sink)
+		return &list_first_item(&dev->bsink_list, struct comp_buffer,
+					source_list)->stream;
+
+	if (!list_is_empty(&dev->bsource_list))
+		return &list_first_item(&dev->bsource_list, struct comp_buffer,
+					sink_list)->stream;
+
+	return NULL;
+}
+
+static int tb_profile_copy(struct comp_dev *dev)
+{
+	struct tb_comp_prof *cp = container_of(dev->drv, struct tb_comp_prof,
+					       drv);
+	struct audio_stream *stream;
+	uint64_t *ns;
+	uint64_t c0, c1, t0, t1;
+	uint32_t avail;
+	int is_sink;
+	int frames;
+	int ret;
+
+	stream = tb_profile_stream(dev, &is_sink);
+	avail = stream ? stream->avail : 0;
+
+	t0 = tb_profile_wall_ns();
+	c0 = tb_profile_cycles();
+	ret = cp->orig_drv->ops.copy(dev);
+	c1 = tb_profile_cycles();
+	t1 = tb_profile_wall_ns();
+
+	if (cp->count == cp->max_count) {
+		ns = realloc(cp->ns, 2 * cp->max_count * sizeof(*ns));
+		if (!ns) {
+			/* partial timings would skew the statistics */
+			fprintf(stderr, "error: profile comp %u: no memory\n",
+				cp->id);
+			dev->drv = cp->orig_drv;
+			cp->failed = 1;
+			return ret;
+		}
+
+		cp->ns = ns;
+		cp->max_count *= 2;
+	}
+
+	cp->ns[cp->count++] = t1 - t0;
+	cp->cycles += c1 - c0;
+
+	/* produced frames to sink or consumed frames from source */
+	if (stream) {
+		frames = is_sink ? stream->avail - avail :
+			avail - stream->avail;
+		frames /= (int)audio_stream_frame_bytes(stream);
+		cp->frames += frames;
+		cp->samples += (uint64_t)frames * stream->channels;
+	}
+
+	return ret;
+}
+
+static const char *tb_profile_comp_name(struct comp_dev *dev,
+					struct shared_lib_table *lib_table)
+{
+	int index;
+
+	if (dev->drv->type == SOF_COMP_HOST || dev->drv->type == SOF_COMP_DAI)
+		return list_is_empty(&dev->bsink_list) ?
+			"filewrite" : "fileread";
+
+	index = get_index_by_type(dev->drv->type, lib_table);
+	if (index < 0)
+		return "unknown";
+
+	return lib_table[index].comp_name;
+}
+
+/* hook profiling copy() into all components created from topology */
+int tb_profile_start(struct sof *sof, struct tb_prof *prof,
+		     struct shared_lib_table *lib_table)
+{
+	struct list_item *clist;
+	struct ipc_comp_dev *icd;
+	struct tb_comp_prof *cp;
+	int n = 0;
+	int i;
+
+	list_for_item(clist, &sof->ipc->comp_list) {
+		icd = container_of(clist, struct ipc_comp_dev, list);
+		if (icd->type == COMP_TYPE_COMPONENT)
+			n++;
+	}
+
+	prof->comps = calloc(n, sizeof(*prof->comps));
+	if (!prof->comps)
+		return -ENOMEM;
+
+	/* allocate all timing buffers before any driver is patched */
+	prof->num_comps = n;
+	for (i = 0; i < n; i++) {
+		cp = &prof->comps[i];
+		cp->ns = malloc(TB_PROFILE_INIT_COUNT * sizeof(*cp->ns));
+		if (!cp->ns) {
+			tb_profile_free(prof);
+			return -ENOMEM;
+		}
+
+		cp->max_count = TB_PROFILE_INIT_COUNT;
+	}
+
+	cp = prof->comps;
+	list_for_item(clist, &sof->ipc->comp_list) {
+		icd = container_of(clist, struct ipc_comp_dev, list);
+		if (icd->type != COMP_TYPE_COMPONENT)
+			continue;
+
+		cp->id = icd->id;
+		cp->name = tb_profile_comp_name(icd->cd, lib_table);
+		cp->orig_drv = icd->cd->drv;
+		cp->drv = *cp->orig_drv;
+		cp->drv.ops.copy = tb_profile_copy;
+		icd->cd->drv = &cp->drv;
+		cp++;
+	}
+
+	return 0;
+}
+
+static int tb_profile_cmp(const void *a, const void *b)
+{
+	uint64_t x = *(const uint64_t *)a;
+	uint64_t y = *(const uint64_t *)b;
+
+	return (x > y) - (x < y);
+}
+
+/* print copy() timing table, one row per component */
+void tb_profile_print(struct tb_prof *prof, uint32_t period_us)
+{
+	struct tb_comp_prof *cp;
+	uint64_t total;
+	uint64_t p99;
+	double cpf;
+	uint32_t i;
+	int n;
+
+	printf("==========================================================\n");
+	printf("		     Component Profile\n");
+	printf("==========================================================\n");
+	printf("Time per copy in ns, %u us scheduling period\n", period_us);
+	printf("%4s %-10s %8s %10s %10s %10s %10s %10s %8s %10s\n", "id",
+	       "comp", "copies", "min", "mean", "p99", "max", "frames",
+	       "load %", "cyc/fr/ch");
+
+	for (n = 0; n < prof->num_comps; n++) {
+		cp = &prof->comps[n];
+		if (!cp->count)
+			continue;
+
+		if (cp->failed) {
+			printf("%4u %-10s %8s\n", cp->id, cp->name, "failed");
+			continue;
+		}
+
+		total = 0;
+		for (i = 0; i < cp->count; i++)
+			total += cp->ns[i];
+
+		qsort(cp->ns, cp->count, sizeof(*cp->ns), tb_profile_cmp);
+		p99 = cp->ns[(uint32_t)(0.99 * (cp->count - 1))];
+
+		printf("%4u %-10s %8u %10" PRIu64 " %10" PRIu64 " %10" PRIu64
+		       " %10" PRIu64 " %10" PRIu64 " %8.3f",
+		       cp->id, cp->name, cp->count,
+		       cp->ns[0], total / cp->count, p99,
+		       cp->ns[cp->count - 1], cp->frames,
+		       period_us ? 0.1 * total / cp->count / period_us : 0.0);
+
+		if (TB_PROFILE_HAS_CYCLES && cp->samples) {
+			cpf = (double)cp->cycles / cp->samples;
+			printf(" %10.2f\n", cpf);
+		} else {
+			printf(" %10s\n", "-");
+		}
+	}
+}
+
+/* free timing data, the profiled components must be freed already */
+void tb_profile_free(struct tb_prof *prof)
+{
+	int n;
+
+	for (n = 0; n < prof->num_comps; n++)
+		free(prof->comps[n].ns);
+
+	free(prof->comps);
+	prof->comps = NULL;
+	prof->num_comps = 0;
+}
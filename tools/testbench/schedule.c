@@ -13,7 +13,8 @@
 #include <sof/lib/wait.h>
 #include <stdlib.h>
 
-static struct schedulers *testbench_schedulers_ptr; /* Initialized as NULL */
+/* Initialized as NULL, one per batch mode worker thread */
+static __thread struct schedulers *testbench_schedulers_ptr;
 
 struct schedulers **arch_schedulers_get(void)
 {
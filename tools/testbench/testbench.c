@@ -13,6 +13,8 @@
 #include <tplg_parser/topology.h>
 #include "testbench/trace.h"
 #include "testbench/file.h"
+#include "testbench/profile.h"
+#include "testbench/batch.h"
 
 #define TESTBENCH_NCH 2 /* Stereo */
 
@@ -24,11 +26,15 @@ struct shared_lib_table lib_table[NUM_WIDGETS_SUPPORTED] = {
 	{"asrc", "libsof_asrc.so", SOF_COMP_ASRC, 0, NULL},
 	{"eq-fir", "libsof_eq-fir.so", SOF_COMP_EQ_FIR, 0, NULL},
 	{"eq-iir", "libsof_eq-iir.so", SOF_COMP_EQ_IIR, 0, NULL},
-	{"dcblock", "libsof_dcblock.so", SOF_COMP_DCBLOCK, 0, NULL}
+	{"dcblock", "libsof_dcblock.so", SOF_COMP_DCBLOCK, 0, NULL},
+	{"mixer", "libsof_mixer.so", SOF_COMP_MIXER, 0, NULL},
+	{"mux", "libsof_mux.so", SOF_COMP_MUX, 0, NULL},
+	{"demux", "libsof_mux.so", SOF_COMP_DEMUX, 0, NULL},
+	{"selector", "libsof_selector.so", SOF_COMP_SELECTOR, 0, NULL}
 };
 
-/* main firmware context */
-static struct sof sof;
+/* firmware context, one per batch mode worker thread */
+static __thread struct sof sof;
 
 /* compatible variables, not used */
 intptr_t _comp_init_start, _comp_init_end;
@@ -87,59 +93,45 @@ static void print_usage(char *executable)
 {
 	printf("Usage: %s -i <input_file> -o <output_file> ", executable);
 	printf("-t <tplg_file> -b <input_format> ");
-	printf("-a <comp1=comp1_library,comp2=comp2_library>\n");
+	printf("-a <comp1=comp1_library,comp2=comp2_library> [-m] [-p]\n");
+	printf("Batch mode: %s -t <tplg_file> -B <manifest> [-j <workers>]\n",
+	       executable);
 	printf("input_format should be S16_LE, S32_LE, S24_LE or FLOAT_LE\n");
+	printf("-m memory maps a raw or WAVE input file instead of reading it\n");
+	printf("-p prints copy() execution time statistics per component\n");
+	printf("-i and -o take a comma separated list of files, ");
+	printf("use widget=file to attach\n");
+	printf("a file to a named widget, others follow topology order\n");
+	printf("-B runs the jobs of a manifest, one per line as ");
+	printf("<input> <output> <format> [<fs_in> [<fs_out>]],\n");
+	printf("in -j worker threads, default is one per online CPU\n");
 	printf("Example Usage:\n");
 	printf("%s -i in.txt -o out.txt -t test.tplg ", executable);
 	printf("-r 48000 -R 96000 ");
 	printf("-b S16_LE -a vol=libsof_volume.so\n");
 }
 
-/* free components */
-static void free_comps(void)
-{
-	struct list_item *clist;
-	struct list_item *temp;
-	struct ipc_comp_dev *icd = NULL;
-
-	list_for_item_safe(clist, temp, &sof.ipc->comp_list) {
-		icd = container_of(clist, struct ipc_comp_dev, list);
-		switch (icd->type) {
-		case COMP_TYPE_COMPONENT:
-			comp_free(icd->cd);
-			list_item_del(&icd->list);
-			rfree(icd);
-			break;
-		case COMP_TYPE_BUFFER:
-			rfree(icd->cb->stream.addr);
-			rfree(icd->cb);
-			list_item_del(&icd->list);
-			rfree(icd);
-			break;
-		default:
-			rfree(icd->pipeline);
-			list_item_del(&icd->list);
-			rfree(icd);
-			break;
-		}
-	}
-}
-
 static void parse_input_args(int argc, char **argv, struct testbench_prm *tp)
 {
 	int option = 0;
 	int ret = 0;
 
-	while ((option = getopt(argc, argv, "hdi:o:t:b:a:r:R:")) != -1) {
+	while ((option = getopt(argc, argv, "hdmpi:o:t:b:a:r:R:B:j:")) != -1) {
 		switch (option) {
 		/* input sample file */
 		case 'i':
-			tp->input_file = strdup(optarg);
+			ret = tb_parse_file_list(optarg, tp->input_file,
+						 tp->input_widget,
+						 MAX_INPUT_FILES);
+			tp->input_file_num = ret;
 			break;
 
 		/* output sample file */
 		case 'o':
-			tp->output_file = strdup(optarg);
+			ret = tb_parse_file_list(optarg, tp->output_file,
+						 tp->output_widget,
+						 MAX_OUTPUT_FILES);
+			tp->output_file_num = ret;
 			break;
 
 		/* topology file */
@@ -173,6 +165,26 @@ static void parse_input_args(int argc, char **argv, struct testbench_prm *tp)
 			debug = 1;
 			break;
 
+		/* memory map input file */
+		case 'm':
+			tp->mmap_input = 1;
+			break;
+
+		/* profile components */
+		case 'p':
+			tp->profile = 1;
+			break;
+
+		/* batch mode job manifest */
+		case 'B':
+			tp->batch_file = strdup(optarg);
+			break;
+
+		/* batch mode worker threads */
+		case 'j':
+			tp->batch_workers = atoi(optarg);
+			break;
+
 		/* print usage */
 		case 'h':
 		default:
@@ -189,29 +201,29 @@ int main(int argc, char **argv)
 {
 	struct testbench_prm tp;
 	struct ipc_comp_dev *pcm_dev;
-	struct pipeline *p;
-	struct sof_ipc_pipe_new *ipc_pipe;
-	struct comp_dev *cd;
-	struct file_comp_data *frcd, *fwcd;
+	struct file_comp_data *fcd;
+	struct tb_prof prof = { NULL, 0 };
+	struct tb_result res;
 	char pipeline[DEBUG_MSG_LEN];
-	clock_t tic, toc;
-	double c_realtime, t_exec;
-	int n_in, n_out, ret;
+	double c_realtime;
+	int ret = EXIT_SUCCESS;
 	int i;
 
 	/* initialize input and output sample rates, files, etc. */
-	tp.fs_in = 0;
-	tp.fs_out = 0;
-	tp.bits_in = 0;
-	tp.input_file = NULL;
-	tp.output_file = NULL;
+	memset(&tp, 0, sizeof(tp));
 	tp.channels = TESTBENCH_NCH;
+	for (i = 0; i < MAX_INPUT_FILES; i++)
+		tp.fr_id[i] = -1;
+
+	for (i = 0; i < MAX_OUTPUT_FILES; i++)
+		tp.fw_id[i] = -1;
 
 	/* command line arguments*/
 	parse_input_args(argc, argv, &tp);
 
 	/* check args */
-	if (!tp.tplg_file || !tp.input_file || !tp.output_file || !tp.bits_in) {
+	if (!tp.tplg_file || (!tp.batch_file && (!tp.input_file_num ||
+	    !tp.output_file_num || !tp.bits_in))) {
 		print_usage(argv[0]);
 		exit(EXIT_FAILURE);
 	}
@@ -222,63 +234,34 @@ int main(int argc, char **argv)
 		exit(EXIT_FAILURE);
 	}
 
+	/* run all jobs of manifest in worker threads */
+	if (tp.batch_file) {
+		if (tb_batch_run(&sof, &tp, lib_table) < 0)
+			ret = EXIT_FAILURE;
+
+		goto out;
+	}
+
 	/* parse topology file and create pipeline */
 	if (parse_topology(&sof, lib_table, &tp, pipeline) < 0) {
 		fprintf(stderr, "error: parsing topology\n");
 		exit(EXIT_FAILURE);
 	}
 
-	/* Get pointers to fileread and filewrite */
-	pcm_dev = ipc_get_comp_by_id(sof.ipc, tp.fw_id);
-	fwcd = comp_get_drvdata(pcm_dev->cd);
-	pcm_dev = ipc_get_comp_by_id(sof.ipc, tp.fr_id);
-	frcd = comp_get_drvdata(pcm_dev->cd);
-
-	/* Run pipeline until EOF from fileread */
-	pcm_dev = ipc_get_comp_by_id(sof.ipc, tp.sched_id);
-	p = pcm_dev->cd->pipeline;
-	ipc_pipe = &p->ipc_pipe;
-
-	/* input and output sample rate */
-	if (!tp.fs_in)
-		tp.fs_in = ipc_pipe->period * ipc_pipe->frames_per_sched;
-
-	if (!tp.fs_out)
-		tp.fs_out = ipc_pipe->period * ipc_pipe->frames_per_sched;
-
-	/* set pipeline params and trigger start */
-	if (tb_pipeline_start(sof.ipc, ipc_pipe, &tp) < 0) {
-		fprintf(stderr, "error: pipeline params\n");
+	/* measure copy() of each component */
+	if (tp.profile && tb_profile_start(&sof, &prof, lib_table) < 0) {
+		fprintf(stderr, "error: profiler init\n");
 		exit(EXIT_FAILURE);
 	}
 
-	cd = pcm_dev->cd;
-	tb_enable_trace(false); /* reduce trace output */
-	tic = clock();
-
-	while (frcd->fs.reached_eof == 0)
-		pipeline_schedule_copy(p, 0);
-
-	if (!frcd->fs.reached_eof)
-		printf("warning: possible pipeline xrun\n");
-
-	/* reset and free pipeline */
-	toc = clock();
-	tb_enable_trace(true);
-	pipeline_trigger(p, cd, COMP_TRIGGER_STOP);
-	ret = pipeline_reset(p, cd);
-	if (ret < 0) {
-		fprintf(stderr, "error: pipeline reset\n");
+	/* Run pipelines until EOF from filereads */
+	if (tb_run(&sof, &tp, &res) < 0)
 		exit(EXIT_FAILURE);
-	}
-
-	n_in = frcd->fs.n;
-	n_out = fwcd->fs.n;
-	t_exec = (double)(toc - tic) / CLOCKS_PER_SEC;
-	c_realtime = (double)n_out / TESTBENCH_NCH / tp.fs_out / t_exec;
 
-	/* free all components/buffers in pipeline */
-	free_comps();
+	pcm_dev = ipc_get_comp_by_id(sof.ipc, tp.fw_id[0]);
+	fcd = comp_get_drvdata(pcm_dev->cd);
+	c_realtime = (double)fcd->fs.n / TESTBENCH_NCH / tp.fs_out /
+		res.t_exec;
 
 	/* print test summary */
 	printf("==========================================================\n");
@@ -289,17 +272,53 @@ int main(int argc, char **argv)
 	printf("Input bit format: %s\n", tp.bits_in);
 	printf("Input sample rate: %d\n", tp.fs_in);
 	printf("Output sample rate: %d\n", tp.fs_out);
-	printf("Output written to file: \"%s\"\n", tp.output_file);
-	printf("Input sample count: %d\n", n_in);
-	printf("Output sample count: %d\n", n_out);
-	printf("Total execution time: %.2f us, %.2f x realtime\n",
-	       1e3 * t_exec, c_realtime);
+	for (i = 0; i < tp.input_file_num && tp.input_file_num > 1; i++) {
+		pcm_dev = ipc_get_comp_by_id(sof.ipc, tp.fr_id[i]);
+		fcd = comp_get_drvdata(pcm_dev->cd);
+		printf("Input file: \"%s\", %d samples\n",
+		       tp.input_file[i], fcd->fs.n);
+	}
+
+	for (i = 0; i < tp.output_file_num; i++) {
+		pcm_dev = ipc_get_comp_by_id(sof.ipc, tp.fw_id[i]);
+		fcd = comp_get_drvdata(pcm_dev->cd);
+		if (tp.output_file_num > 1)
+			printf("Output written to file: \"%s\", %d samples\n",
+			       tp.output_file[i], fcd->fs.n);
+		else
+			printf("Output written to file: \"%s\"\n",
+			       tp.output_file[i]);
+	}
+
+	printf("Input sample count: %d\n", res.n_in);
+	printf("Output sample count: %d\n", res.n_out);
+	printf("Total execution time: %.2f ms, %.2f x realtime\n",
+	       1e3 * res.t_exec, c_realtime);
+
+	if (tp.profile)
+		tb_profile_print(&prof, res.period_us);
 
+	/* free all components/buffers in pipeline, the profiled components
+	 * use drivers stored in prof so it is freed after them
+	 */
+	tb_free_comps(&sof);
+	if (tp.profile)
+		tb_profile_free(&prof);
+
+out:
 	/* free all other data */
 	free(tp.bits_in);
-	free(tp.input_file);
 	free(tp.tplg_file);
-	free(tp.output_file);
+	free(tp.batch_file);
+	for (i = 0; i < tp.input_file_num; i++) {
+		free(tp.input_file[i]);
+		free(tp.input_widget[i]);
+	}
+
+	for (i = 0; i < tp.output_file_num; i++) {
+		free(tp.output_file[i]);
+		free(tp.output_widget[i]);
+	}
 
 	/* close shared library objects */
 	for (i = 0; i < NUM_WIDGETS_SUPPORTED; i++) {
@@ -307,5 +326,5 @@ int main(int argc, char **argv)
 			dlclose(lib_table[i].handle);
 	}
 
-	return EXIT_SUCCESS;
+	return ret;
 }
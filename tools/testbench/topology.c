@@ -19,8 +19,8 @@
 #include "testbench/common_test.h"
 #include "testbench/file.h"
 
-FILE *file;
-char pipeline_string[DEBUG_MSG_LEN];
+__thread FILE *file;
+__thread char pipeline_string[DEBUG_MSG_LEN];
 struct shared_lib_table *lib_table;
 
 const struct sof_dai_types sof_dais[] = {
@@ -63,8 +63,11 @@ void register_comp(int comp_type)
 
 	/* get index of comp in shared library table */
 	index = get_index_by_type(comp_type, lib_table);
-	if (index < 0)
+	if (index < 0) {
+		fprintf(stderr, "error: comp type %d not supported\n",
+			comp_type);
 		return;
+	}
 
 	/* register comp driver if not already registered */
 	if (!lib_table[index].register_drv) {
@@ -266,6 +269,34 @@ static int tplg_load_filewrite(int comp_id, int pipeline_id, int size,
 	return 0;
 }
 
+/*
+ * Find the file for a fileread or filewrite widget. A file given on the
+ * command line as widget=file is matched by widget name, the others are
+ * assigned to the remaining widgets in topology order. Returns the file
+ * index and records the component id, or -EINVAL if no file is left.
+ */
+static int tb_find_file(char **widgets, int *ids, int num, int comp_id,
+			const char *name)
+{
+	int i;
+
+	for (i = 0; i < num; i++) {
+		if (widgets[i] && ids[i] < 0 && !strcmp(widgets[i], name))
+			goto found;
+	}
+
+	for (i = 0; i < num; i++) {
+		if (!widgets[i] && ids[i] < 0)
+			goto found;
+	}
+
+	return -EINVAL;
+
+found:
+	ids[i] = comp_id;
+	return i;
+}
+
 /* load fileread component */
 static int load_fileread(void *dev, int comp_id, int pipeline_id,
 			 struct snd_soc_tplg_dapm_widget *widget, int dir,
@@ -275,6 +306,7 @@ static int load_fileread(void *dev, int comp_id, int pipeline_id,
 	struct sof_ipc_comp_file fileread;
 	int size = widget->priv.size;
 	int ret;
+	int i;
 
 	fileread.config.frame_fmt = find_format(tp->bits_in);
 
@@ -288,16 +320,23 @@ static int load_fileread(void *dev, int comp_id, int pipeline_id,
 	}
 
 	/* configure fileread */
-	fileread.fn = strdup(tp->input_file);
+	i = tb_find_file(tp->input_widget, tp->fr_id, tp->input_file_num,
+			 comp_id, widget->name);
+	if (i < 0) {
+		fprintf(stderr, "error: no input file for %s\n", widget->name);
+		return -EINVAL;
+	}
+
+	fileread.fn = strdup(tp->input_file[i]);
 
 	/* use fileread comp as scheduling comp */
-	tp->fr_id = comp_id;
 	tp->sched_id = comp_id;
 
 	/* Set format from testbench command line*/
 	fileread.rate = tp->fs_in;
 	fileread.channels = tp->channels;
 	fileread.frame_fmt = tp->frame_fmt;
+	fileread.mmap = tp->mmap_input;
 
 	/* Set type depending on direction */
 	fileread.comp.type = (dir == SOF_IPC_STREAM_PLAYBACK) ?
@@ -322,6 +361,7 @@ static int load_filewrite(struct sof *sof, int comp_id, int pipeline_id,
 	struct sof_ipc_comp_file filewrite;
 	int size = widget->priv.size;
 	int ret;
+	int i;
 
 	ret = tplg_load_filewrite(comp_id, pipeline_id, size, &filewrite);
 	if (ret < 0)
@@ -333,8 +373,15 @@ static int load_filewrite(struct sof *sof, int comp_id, int pipeline_id,
 	}
 
 	/* configure filewrite */
-	filewrite.fn = strdup(tp->output_file);
-	tp->fw_id = comp_id;
+	i = tb_find_file(tp->output_widget, tp->fw_id, tp->output_file_num,
+			 comp_id, widget->name);
+	if (i < 0) {
+		fprintf(stderr, "error: no output file for %s\n",
+			widget->name);
+		return -EINVAL;
+	}
+
+	filewrite.fn = strdup(tp->output_file[i]);
 
 	/* Set format from testbench command line*/
 	filewrite.rate = tp->fs_out;
@@ -447,6 +494,7 @@ int load_pipeline(void *dev, int comp_id, int pipeline_id,
 {
 	struct sof *sof = (struct sof *)dev;
 	struct sof_ipc_pipe_new pipeline = {0};
+	struct ipc_comp_dev *icd;
 	int size = widget->priv.size;
 	int ret;
 
@@ -459,7 +507,22 @@ int load_pipeline(void *dev, int comp_id, int pipeline_id,
 		return -EINVAL;
 	}
 
-	pipeline.sched_id = sched_id;
+	/*
+	 * The scheduling comp is the last loaded fileread. A pipeline without
+	 * one, e.g. after a mixer, is scheduled by its own first component.
+	 */
+	icd = ipc_get_comp_by_id(sof->ipc, sched_id);
+	if (!icd || dev_comp_pipe_id(icd->cd) != pipeline.pipeline_id) {
+		icd = ipc_get_comp_by_ppl_id(sof->ipc, COMP_TYPE_COMPONENT,
+					     pipeline.pipeline_id);
+		if (!icd) {
+			fprintf(stderr, "error: no comp in pipeline %d\n",
+				pipeline.pipeline_id);
+			return -EINVAL;
+		}
+	}
+
+	pipeline.sched_id = icd->id;
 
 	/* Create pipeline */
 	if (ipc_pipeline_new(sof->ipc, &pipeline) < 0) {
@@ -649,6 +712,7 @@ int load_process(void *dev, int comp_id, int pipeline_id,
 int load_mixer(void *dev, int comp_id, int pipeline_id,
 	       struct snd_soc_tplg_dapm_widget *widget)
 {
+	struct sof *sof = (struct sof *)dev;
 	struct sof_ipc_comp_mixer mixer = {0};
 	int size = widget->priv.size;
 	int ret = 0;
@@ -662,6 +726,13 @@ int load_mixer(void *dev, int comp_id, int pipeline_id,
 		return -EINVAL;
 	}
 
+	/* load mixer component */
+	register_comp(mixer.comp.type);
+	if (ipc_comp_new(sof->ipc, (struct sof_ipc_comp *)&mixer) < 0) {
+		fprintf(stderr, "error: new mixer comp\n");
+		return -EINVAL;
+	}
+
 	return ret;
 }
 
@@ -680,14 +751,19 @@ int parse_topology(struct sof *sof, struct shared_lib_table *library_table,
 	size_t file_size;
 	size_t size;
 
-	/* open topology file */
-	file = fopen(tp->tplg_file, "rb");
+	/* open topology file or the copy of it in memory */
+	if (tp->tplg_data)
+		file = fmemopen(tp->tplg_data, tp->tplg_size, "rb");
+	else
+		file = fopen(tp->tplg_file, "rb");
+
 	if (!file) {
 		fprintf(stderr, "error: opening file %s\n", tp->tplg_file);
 		return -EINVAL;
 	}
 
 	lib_table = library_table;
+	pipeline_string[0] = '\0';
 
 	/* file size */
 	if (fseek(file, 0, SEEK_END)) {
@@ -11,8 +11,8 @@
 #include "testbench/common_test.h"
 #include "testbench/trace.h"
 
-/* enable trace by default in testbench */
-int test_bench_trace = 1;
+/* enable trace by default in testbench, one per batch mode worker thread */
+__thread int test_bench_trace = 1;
 int debug;
 
 /* look up subsystem class name from table */
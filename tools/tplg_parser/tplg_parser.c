@@ -1027,7 +1027,7 @@ int tplg_load_mixer(int comp_id, int pipeline_id, int size,
 	/* configure src */
 	mixer->comp.hdr.cmd = SOF_IPC_GLB_TPLG_MSG | SOF_IPC_TPLG_COMP_NEW;
 	mixer->comp.id = comp_id;
-	mixer->comp.hdr.size = sizeof(struct sof_ipc_comp_src);
+	mixer->comp.hdr.size = sizeof(struct sof_ipc_comp_mixer);
 	mixer->comp.type = SOF_COMP_MIXER;
 	mixer->comp.pipeline_id = pipeline_id;
 	mixer->config.hdr.size = sizeof(struct sof_ipc_comp_config);